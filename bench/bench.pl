@@ -0,0 +1,339 @@
+#!/usr/bin/perl -w
+
+#
+# bench/bench.pl
+#
+# Benchmarks for the Perl layers of Text::BibTeX: parsing entries, name
+# splitting, name formatting, sort keys and printing.  Each benchmark
+# runs over every entry (or name) in a corpus, generated by the
+# btparse benchmark generator (btparse/bench/gen_corpus), and reports
+# the cost per call and how that is split between the XS code and
+# Perl.  Results can be saved as a named baseline, and later runs
+# compared against it.
+#
+#    ./Build perlbench [--args '...']
+#    perl -Mblib bench/bench.pl [options]     (with libbtparse findable)
+#
+# Options:
+#    --corpus FILE    use FILE instead of a generated corpus
+#    --entries N      generate a corpus of N entries (default 10000)
+#    --runs N         run each benchmark N times, keep the best (3)
+#    --only A,B,...   run only the named benchmarks
+#    --save NAME      save the results as baseline NAME
+#    --compare NAME   compare the results with baseline NAME
+#    --json           print the results as JSON instead of a table
+#
+# The split between XS and Perl is measured in one extra run of each
+# benchmark, with every XSUB of Text::BibTeX wrapped in a timer; the
+# cost of the wrapper itself (measured on a trivial XSUB) is taken
+# off, and the rest of the time is Perl.  It's an estimate, but a
+# good enough one to tell which side a change made faster or slower.
+#
+# $Id$
+#
+
+use strict;
+use FindBin;
+use File::Spec::Functions qw(catfile catdir updir);
+use File::Temp ();
+use Getopt::Long;
+use JSON::PP ();
+use Time::HiRes ();
+use Scalar::Util qw(refaddr);
+use B ();
+
+use Text::BibTeX qw(:metatypes);
+use Text::BibTeX::Name;
+use Text::BibTeX::NameFormat;
+
+my $Top = catdir ($FindBin::Bin, updir);
+my $BaselineDir = catdir ($FindBin::Bin, 'baselines');
+
+my %opt = (entries => 10000, runs => 3);
+GetOptions (\%opt, 'corpus=s', 'entries=i', 'runs=i', 'only=s',
+            'save=s', 'compare=s', 'json')
+   && $opt{runs} > 0
+   or die "usage: $0 [--corpus file] [--entries n] [--runs n] " .
+          "[--only name,...] [--save name] [--compare name] [--json]\n";
+
+
+# ----------------------------------------------------------------------
+# The corpus, and the data the benchmarks share
+
+# ----------------------------------------------------------------------
+# NAME       : corpus
+# RETURNS    : the name of the corpus file, and a File::Temp object (if
+#              it was generated) that must be kept until we're done
+# DESCRIPTION: Generates a corpus with the btparse generator, unless
+#              one was given.
+# CREATED    : 2026/10/19
+# ----------------------------------------------------------------------
+sub corpus
+{
+   return ($opt{corpus}) if $opt{corpus};
+
+   my $gen = catfile ($Top, 'btparse', 'bench', 'gen_corpus');
+   $gen .= '.exe' if $^O =~ /mswin32|cygwin/i;
+   die "$gen not found: build it with \"./Build bench\", " .
+       "or give a corpus with --corpus\n" unless -x $gen;
+
+   my $tmp = File::Temp->new (SUFFIX => '.bib');
+   system ($gen, '-n', $opt{entries}, $tmp->filename) == 0
+      or die "$gen failed\n";
+   return ($tmp->filename, $tmp);
+}
+
+my ($Corpus, $Tmp) = corpus ();
+my $CorpusSize = -s $Corpus;
+
+my (@Entries, @BibEntries, @Names);
+
+sub read_entries
+{
+   my ($structure) = @_;
+   my ($bib, $entry, @entries);
+
+   Text::BibTeX::delete_all_macros ();   # no warnings about redefining
+   $bib = Text::BibTeX::File->new ($Corpus) or die "$Corpus: $!\n";
+   $bib->set_structure ($structure) if $structure;
+   while ($entry = Text::BibTeX::Entry->new ($bib))
+   {
+      push (@entries, $entry)
+         if $entry->parse_ok && $entry->metatype == BTE_REGULAR;
+   }
+   return @entries;
+}
+
+@Entries = read_entries ();
+@BibEntries = read_entries ('Bib');
+@Names = map { $_->names ('author') } @Entries;
+
+
+# ----------------------------------------------------------------------
+# The benchmarks: each one does one pass, and returns the number of
+# calls made of the method it measures
+
+my $Format = Text::BibTeX::NameFormat->new ('fvlj', 1);
+
+my @Benchmarks =
+(
+   [ 'Entry::parse' => sub {
+        my ($bib, $entry, $n);
+        Text::BibTeX::delete_all_macros ();
+        $bib = Text::BibTeX::File->new ($Corpus);
+        $n++ while ($entry = Text::BibTeX::Entry->new ($bib));
+        $n;
+     } ],
+   [ 'Entry::names' => sub {
+        my $n = 0;
+        $n += () = $_->names ('author') for @Entries;
+        $n;
+     } ],
+   [ 'NameFormat::apply' => sub {
+        $Format->apply ($_) for @Names;
+        scalar @Names;
+     } ],
+   [ 'BibSort::sort_key' => sub {
+        $_->sort_key for @BibEntries;
+        scalar @BibEntries;
+     } ],
+   [ 'Entry::print_s' => sub {
+        $_->print_s for @Entries;
+        scalar @Entries;
+     } ],
+);
+
+
+# ----------------------------------------------------------------------
+# Timing XSUBs
+
+# ----------------------------------------------------------------------
+# NAME       : xsubs
+# RETURNS    : list of [glob, code ref] for every glob in the
+#              Text::BibTeX packages that holds an XSUB of Text::BibTeX
+#              (including those imported into other packages)
+# CREATED    : 2026/10/19
+# ----------------------------------------------------------------------
+sub xsubs
+{
+   my (@found, @stashes);
+
+   no strict 'refs';
+   @stashes = ('Text::BibTeX::');
+   while (my $stash = shift @stashes)
+   {
+      for my $name (keys %$stash)
+      {
+         if ($name =~ /::$/)
+         {
+            push (@stashes, $stash . $name);
+            next;
+         }
+         my $glob = \*{$stash . $name};
+         my $code = *{$glob}{CODE} or next;
+         my $cv = B::svref_2object ($code);
+         next unless $cv->XSUB && !($cv->CvFLAGS & B::CVf_CONST());
+         next unless $cv->GV->STASH->NAME =~ /^Text::BibTeX\b/;
+         push (@found, [$glob, $code]);
+      }
+   }
+   return @found;
+}
+
+
+# ----------------------------------------------------------------------
+# NAME       : timed
+# INPUT      : $code  - an XSUB
+#              $clock - ref to the total time spent in timed XSUBs
+#              $calls - ref to the number of calls of them
+# RETURNS    : a sub that calls $code in the same context, and adds the
+#              time it took to $$clock
+# CREATED    : 2026/10/19
+# ----------------------------------------------------------------------
+sub timed
+{
+   my ($code, $clock, $calls) = @_;
+
+   return sub
+   {
+      my ($start, @result);
+
+      $$calls++;
+      if (wantarray)
+      {
+         $start = Time::HiRes::time ();
+         @result = &$code;
+         $$clock += Time::HiRes::time () - $start;
+         return @result;
+      }
+      $start = Time::HiRes::time ();
+      $result[0] = &$code;
+      $$clock += Time::HiRes::time () - $start;
+      return $result[0];
+   };
+}
+
+
+# ----------------------------------------------------------------------
+# NAME       : xs_time
+# INPUT      : $bench - the benchmark sub
+# RETURNS    : estimated time spent in XSUBs in a run of $bench
+# DESCRIPTION: Runs the benchmark once with all the XSUBs timed, and
+#              takes off the cost of the timing itself, measured on
+#              calls of a trivial XSUB.
+# CREATED    : 2026/10/19
+# ----------------------------------------------------------------------
+sub xs_time
+{
+   my ($bench) = @_;
+   my ($clock, $calls, $overhead, %wrapped);
+
+   # what timing a call of an XSUB that does nothing costs
+   my ($cal_clock, $cal_calls) = (0, 0);
+   my $trivial = timed (\&Scalar::Util::refaddr, \$cal_clock, \$cal_calls);
+   $trivial->($trivial) for 1 .. 100000;
+   my $start = Time::HiRes::time ();
+   Scalar::Util::refaddr ($trivial) for 1 .. 100000;
+   $overhead = ($cal_clock - (Time::HiRes::time () - $start)) / $cal_calls;
+   $overhead = 0 if $overhead < 0;
+
+   ($clock, $calls) = (0, 0);
+   {
+      no strict 'refs';
+      no warnings 'redefine';
+      my @xsubs = xsubs ();
+      for my $xsub (@xsubs)
+      {
+         my ($glob, $code) = @$xsub;
+         $wrapped{refaddr $code} ||= timed ($code, \$clock, \$calls);
+         *$glob = $wrapped{refaddr $code};
+      }
+      $bench->();
+      *{$_->[0]} = $_->[1] for @xsubs;
+   }
+
+   $clock -= $calls * $overhead;
+   return $clock > 0 ? $clock : 0;
+}
+
+
+# ----------------------------------------------------------------------
+# Running, reporting and baselines
+
+my %only = map { ($_ => 1) } split (/,/, $opt{only} || '');
+my %results;
+
+for my $benchmark (@Benchmarks)
+{
+   my ($name, $bench) = @$benchmark;
+   next if %only && !$only{$name};
+
+   my ($best, $calls);
+   for (1 .. $opt{runs})
+   {
+      my $start = Time::HiRes::time ();
+      $calls = $bench->();
+      my $seconds = Time::HiRes::time () - $start;
+      $best = $seconds if !defined $best || $seconds < $best;
+   }
+   my $xs = xs_time ($bench);
+   $xs = $best if $xs > $best;
+
+   $results{$name} = { calls      => $calls,
+                       seconds    => $best,
+                       us_per_call => 1e6 * $best / ($calls || 1),
+                       xs_share   => $best ? $xs / $best : 0 };
+}
+
+my $baseline;
+if ($opt{compare})
+{
+   my $file = catfile ($BaselineDir, "$opt{compare}.json");
+   open (my $fh, '<', $file) or die "$file: $!\n";
+   $baseline = JSON::PP->new->decode (do { local $/; <$fh> });
+}
+
+if ($opt{json})
+{
+   print JSON::PP->new->canonical->pretty->encode
+      ({ corpus => $Corpus, corpus_bytes => $CorpusSize,
+         results => \%results,
+         ($baseline ? (baseline => $baseline->{results}) : ()) });
+}
+else
+{
+   printf "corpus: %s (%d bytes, %d entries, %d names)\n\n",
+      $Corpus, $CorpusSize, scalar @Entries, scalar @Names;
+   printf "%-20s %8s %10s %12s %6s %6s%s\n", 'benchmark', 'calls',
+      'seconds', 'us/call', 'XS', 'Perl', $baseline ? '   vs baseline' : '';
+   for my $name (map { $_->[0] } @Benchmarks)
+   {
+      my $r = $results{$name} or next;
+      my $change = '';
+      if ($baseline && (my $old = $baseline->{results}{$name}))
+      {
+         $change = sprintf ("   %+6.1f%% (%.2f us/call, XS %d%%)",
+                            100 * ($r->{us_per_call} / $old->{us_per_call} - 1),
+                            $old->{us_per_call}, 100 * $old->{xs_share} + 0.5);
+      }
+      printf "%-20s %8d %10.4f %12.2f %5d%% %5d%%%s\n",
+         $name, $r->{calls}, $r->{seconds}, $r->{us_per_call},
+         100 * $r->{xs_share} + 0.5, 100 * (1 - $r->{xs_share}) + 0.5,
+         $change;
+   }
+}
+
+if ($opt{save})
+{
+   mkdir ($BaselineDir) unless -d $BaselineDir;
+   my $file = catfile ($BaselineDir, "$opt{save}.json");
+   open (my $fh, '>', $file) or die "$file: $!\n";
+   print $fh JSON::PP->new->canonical->pretty->encode
+      ({ corpus_bytes => $CorpusSize,
+         perl         => sprintf ("%vd", $^V),
+         text_bibtex  => $Text::BibTeX::VERSION,
+         date         => scalar localtime,
+         results      => \%results });
+   close ($fh);
+   print STDERR "saved baseline to $file\n";
+}
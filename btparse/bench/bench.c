@@ -0,0 +1,456 @@
+/* ------------------------------------------------------------------------
+@NAME       : bench.c
+@INPUT      : [-r runs] [-b benchmark[,benchmark...]] file.bib
+@OUTPUT     : one line of JSON per benchmark, to stdout
+@RETURNS    : 0 on success, 1 on a usage error
+@DESCRIPTION: Microbenchmarks for the btparse library, meant to be run on
+              the corpus made by gen_corpus.c ("./Build bench" does
+              both).  Each benchmark times one pass over the whole file,
+              or over all the names or strings found in it; the pass is
+              repeated (3 times by default) and the fastest run is
+              reported, as a line like
+
+                {"benchmark": "parse_file", "unit": "entries",
+                 "runs": 3, "bytes": 12003006, "items": 10054,
+                 "seconds": 0.4215, "mb_per_s": 27.157,
+                 "items_per_s": 23852.9}
+
+              (all on one line).  "bytes" and "items" are the amount of
+              input handled by one pass: the size of the file for the
+              lexer and parser benchmarks, or the total length of the
+              names or strings for the others; "mb_per_s" counts 2^20
+              bytes to the megabyte.  Times are processor time, from
+              clock().
+
+              The benchmarks are:
+
+                lex          the lexical scanner alone, as in biblex
+                             (items: entries, ie. "@" tokens)
+                parse_file   bt_parse_file() with the default string
+                             options (items: entries)
+                postprocess  bt_postprocess_entry() with BTO_FULL, on
+                             entries parsed with no string processing
+                             (items: regular entries)
+                split_name   bt_split_name() on every name in the author
+                             and editor fields (items: names)
+                format_name  bt_format_name() with a "{f.~}{vv~}{ll}{, jj}"
+                             format, on the same names (items: names)
+                purify       bt_purify_string() on every title,
+                             booktitle and abstract (items: strings)
+                change_case  bt_change_case() to title case, on the same
+                             strings (items: strings)
+
+              The string benchmarks include copying each string into a
+              work buffer, as the functions change their argument.
+@CALLS      : the library, and (for the lexer benchmark) its lexer
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse distribution (but not part
+              of the library itself).  This is free software; you can
+              redistribute it and/or modify it under the terms of the GNU
+              General Public License as published by the Free Software
+              Foundation; either version 2 of the License, or (at your
+              option) any later version.
+-------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <btparse.h>
+#include "stdpccts.h"                   /* for the lexer benchmark */
+
+typedef struct
+{
+   char *  name;
+   char *  unit;
+   double  (*run) (void);               /* one pass; returns the time */
+} benchmark;
+
+static char *   Filename;
+static long     FileSize;
+
+static long     Bytes;                  /* input handled by one pass */
+static long     Items;
+
+static char **  Names;                  /* from author and editor fields */
+static int      NumNames;
+static long     NameBytes;
+static bt_name ** SplitNames;
+
+static char **  Strings;                /* titles, booktitles, abstracts */
+static int      NumStrings;
+static long     StringBytes;
+static char *   WorkBuffer;
+
+
+static double
+seconds_since (clock_t start)
+{
+   return (double) (clock () - start) / CLOCKS_PER_SEC;
+}
+
+
+static void
+free_entries (AST * entries)
+{
+   AST *  next;
+
+   while (entries)                      /* one at a time: bt_free_ast() */
+   {                                    /* recurses along the list */
+      next = entries->right;
+      entries->right = NULL;
+      bt_free_ast (entries);
+      entries = next;
+   }
+}
+
+
+static void *
+xmalloc (size_t size)
+{
+   void *  p = malloc (size);
+
+   if (p == NULL)
+   {
+      fprintf (stderr, "bench: out of memory\n");
+      exit (1);
+   }
+   return p;
+}
+
+
+static void
+add_item (char *** list, int * num, long * bytes, char * text)
+{
+   if ((*num & (*num - 1)) == 0)        /* grow at each power of two */
+      *list = realloc (*list, (*num ? 2 * *num : 1) * sizeof (char *));
+   if (*list == NULL)
+   {
+      fprintf (stderr, "bench: out of memory\n");
+      exit (1);
+   }
+   (*list)[(*num)++] = strdup (text);
+   *bytes += strlen (text);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : collect_data()
+@DESCRIPTION: Parses the file once, and keeps copies of all the names
+              and strings that the name and string benchmarks work on.
+@GLOBALS    : Names, Strings and friends
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static void
+collect_data (void)
+{
+   AST *   entries, * entry, * field;
+   char *  fname;
+   boolean status;
+   size_t  longest;
+   int     i;
+
+   entries = bt_parse_file (Filename, 0, &status);
+   for (entry = entries; entry; entry = entry->right)
+   {
+      if (bt_entry_metatype (entry) != BTE_REGULAR) continue;
+
+      field = NULL;
+      while ((field = bt_next_field (entry, field, &fname)))
+      {
+         char * value = bt_get_text (field);     /* a copy */
+
+         if (value == NULL) continue;
+         if (strcmp (fname, "author") == 0 || strcmp (fname, "editor") == 0)
+         {
+            bt_stringlist * list;
+
+            list = bt_split_list (value, "and", Filename, field->line, "name");
+            for (i = 0; list && i < list->num_items; i++)
+               if (list->items[i])
+                  add_item (&Names, &NumNames, &NameBytes, list->items[i]);
+            bt_free_list (list);
+         }
+         else if (strcmp (fname, "title") == 0 ||
+                  strcmp (fname, "booktitle") == 0 ||
+                  strcmp (fname, "abstract") == 0)
+         {
+            add_item (&Strings, &NumStrings, &StringBytes, value);
+         }
+         free (value);
+      }
+   }
+   free_entries (entries);
+   bt_delete_all_macros ();
+
+   SplitNames = xmalloc ((NumNames + 1) * sizeof (bt_name *));
+   for (i = 0; i < NumNames; i++)
+      SplitNames[i] = bt_split_name (Names[i], Filename, 0, i);
+
+   longest = 0;
+   for (i = 0; i < NumStrings; i++)
+      if (strlen (Strings[i]) > longest)
+         longest = strlen (Strings[i]);
+   WorkBuffer = xmalloc (longest + 1);
+}
+
+
+static double
+bench_lex (void)
+{
+   FILE *   infile;
+   clock_t  start;
+   double   time;
+
+   infile = fopen (Filename, "r");
+   if (infile == NULL)
+   {
+      perror (Filename);
+      exit (1);
+   }
+
+   start = clock ();
+   InputFilename = Filename;
+   initialize_lexer_state ();
+   alloc_lex_buffer (ZZLEXBUFSIZE);
+   zzrdstream (infile);
+   Items = 0;
+   do
+   {
+      zzgettok ();
+      if (zztoken == AT) Items++;
+   }
+   while (zztoken != zzEOF_TOKEN);
+   free_lex_buffer ();
+   time = seconds_since (start);
+
+   fclose (infile);
+   InputFilename = NULL;
+   Bytes = FileSize;
+   return time;
+}
+
+
+static double
+bench_parse_file (void)
+{
+   AST *    entries, * entry;
+   boolean  status;
+   clock_t  start;
+   double   time;
+
+   start = clock ();
+   entries = bt_parse_file (Filename, 0, &status);
+   time = seconds_since (start);
+
+   Items = 0;
+   for (entry = entries; entry; entry = entry->right)
+      Items++;
+   free_entries (entries);
+   bt_delete_all_macros ();
+   Bytes = FileSize;
+   return time;
+}
+
+
+static double
+bench_postprocess (void)
+{
+   AST *    entries, * entry;
+   boolean  status;
+   clock_t  start;
+   double   time;
+
+   bt_set_stringopts (BTE_REGULAR, BTO_MINIMAL);
+   entries = bt_parse_file (Filename, 0, &status);
+   bt_set_stringopts (BTE_REGULAR, BTO_FULL);
+
+   Items = 0;
+   start = clock ();
+   for (entry = entries; entry; entry = entry->right)
+   {
+      if (entry->metatype != BTE_REGULAR) continue;
+      bt_postprocess_entry (entry, BTO_FULL);
+      Items++;
+   }
+   time = seconds_since (start);
+
+   free_entries (entries);
+   bt_delete_all_macros ();
+   Bytes = FileSize;
+   return time;
+}
+
+
+static double
+bench_split_name (void)
+{
+   clock_t  start;
+   int      i;
+
+   start = clock ();
+   for (i = 0; i < NumNames; i++)
+      bt_free_name (bt_split_name (Names[i], Filename, 0, i));
+
+   Items = NumNames;
+   Bytes = NameBytes;
+   return seconds_since (start);
+}
+
+
+static double
+bench_format_name (void)
+{
+   bt_name_format * format;
+   clock_t  start;
+   double   time;
+   int      i;
+
+   format = bt_create_name_format ("fvlj", TRUE);
+   start = clock ();
+   for (i = 0; i < NumNames; i++)
+      free (bt_format_name (SplitNames[i], format));
+   time = seconds_since (start);
+   bt_free_name_format (format);
+
+   Items = NumNames;
+   Bytes = NameBytes;
+   return time;
+}
+
+
+static double
+bench_purify (void)
+{
+   clock_t  start;
+   int      i;
+
+   start = clock ();
+   for (i = 0; i < NumStrings; i++)
+   {
+      strcpy (WorkBuffer, Strings[i]);
+      bt_purify_string (WorkBuffer, 0);
+   }
+
+   Items = NumStrings;
+   Bytes = StringBytes;
+   return seconds_since (start);
+}
+
+
+static double
+bench_change_case (void)
+{
+   clock_t  start;
+   int      i;
+
+   start = clock ();
+   for (i = 0; i < NumStrings; i++)
+   {
+      strcpy (WorkBuffer, Strings[i]);
+      bt_change_case ('t', WorkBuffer, 0);
+   }
+
+   Items = NumStrings;
+   Bytes = StringBytes;
+   return seconds_since (start);
+}
+
+
+static benchmark Benchmarks[] =
+{
+   { "lex",         "entries", bench_lex },
+   { "parse_file",  "entries", bench_parse_file },
+   { "postprocess", "entries", bench_postprocess },
+   { "split_name",  "names",   bench_split_name },
+   { "format_name", "names",   bench_format_name },
+   { "purify",      "strings", bench_purify },
+   { "change_case", "strings", bench_change_case },
+   { NULL, NULL, NULL }
+};
+
+
+static int
+wanted (char * name, char * selection)
+{
+   size_t  len = strlen (name);
+   char *  p;
+
+   if (selection == NULL) return 1;
+   for (p = selection; (p = strstr (p, name)) != NULL; p += len)
+   {
+      if ((p == selection || p[-1] == ',') && (p[len] == ',' || p[len] == 0))
+         return 1;
+   }
+   return 0;
+}
+
+
+int main (int argc, char * argv[])
+{
+   char *      selection = NULL;
+   int         runs = 3;
+   benchmark * b;
+   FILE *      infile;
+   int         i;
+
+   for (i = 1; i < argc; i++)
+   {
+      if (strcmp (argv[i], "-r") == 0 && i+1 < argc)
+         runs = atoi (argv[++i]);
+      else if (strcmp (argv[i], "-b") == 0 && i+1 < argc)
+         selection = argv[++i];
+      else if (argv[i][0] != '-' && Filename == NULL)
+         Filename = argv[i];
+      else
+         break;
+   }
+   if (i < argc || Filename == NULL || runs < 1)
+   {
+      fprintf (stderr, "usage: bench [-r runs] [-b benchmark[,...]] file.bib\n");
+      return 1;
+   }
+
+   infile = fopen (Filename, "r");
+   if (infile == NULL)
+   {
+      perror (Filename);
+      return 1;
+   }
+   fseek (infile, 0L, SEEK_END);
+   FileSize = ftell (infile);
+   fclose (infile);
+
+   bt_initialize ();
+   collect_data ();
+
+   for (b = Benchmarks; b->name; b++)
+   {
+      double  best = -1.0;
+      double  seconds;
+      int     run;
+
+      if (! wanted (b->name, selection)) continue;
+      for (run = 0; run < runs; run++)
+      {
+         seconds = b->run ();
+         if (best < 0 || seconds < best)
+            best = seconds;
+      }
+      if (best <= 0)                    /* below the clock's resolution */
+         best = 1.0 / CLOCKS_PER_SEC;
+
+      printf ("{\"benchmark\": \"%s\", \"unit\": \"%s\", \"runs\": %d, "
+              "\"bytes\": %ld, \"items\": %ld, \"seconds\": %.6f, "
+              "\"mb_per_s\": %.3f, \"items_per_s\": %.1f}\n",
+              b->name, b->unit, runs, Bytes, Items, best,
+              Bytes / best / (1024.0 * 1024.0), Items / best);
+      fflush (stdout);
+   }
+
+   bt_cleanup ();
+   return 0;
+}
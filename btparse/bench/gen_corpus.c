@@ -0,0 +1,354 @@
+/* ------------------------------------------------------------------------
+@NAME       : gen_corpus.c
+@INPUT      : [-n entries] [-s seed] [output file]
+@OUTPUT     : a synthetic BibTeX database, to stdout or the output file
+@RETURNS    : 0 on success, 1 on a usage or output error
+@DESCRIPTION: Generates a deterministic BibTeX corpus for the benchmarks
+              in bench.c.  The same entry count and seed always produce
+              the same bytes, on every platform: the generator uses its
+              own pseudo-random number generator rather than rand().
+
+              The corpus is meant to look like a large real-world
+              database, with a few of the things that make real databases
+              slow to process exaggerated somewhat:
+
+                * a block of @string definitions, used by most entries,
+                  with "#" concatenation (journal names, months, series)
+                * mostly short author lists, and now and then a very long
+                  one (50 to 300 names), in both "First von Last" and
+                  "von Last, Jr, First" forms
+                * TeX accents and special characters ({\"o}, \c{c},
+                  {\ss}, ...), and raw UTF-8, in names and titles
+                * titles with protected {Words}, $math$ and \emph{...}
+                * the occasional huge abstract (thousands of words)
+                * @comment and @preamble entries, both entry delimiters,
+                  and both quoted and braced values
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse distribution (but not part
+              of the library itself).  This is free software; you can
+              redistribute it and/or modify it under the terms of the GNU
+              General Public License as published by the Free Software
+              Foundation; either version 2 of the License, or (at your
+              option) any later version.
+-------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM(a) ((int) (sizeof (a) / sizeof ((a)[0])))
+
+static unsigned long Seed = 1;          /* state of the generator */
+
+static char * FirstNames[] =
+{
+   "John", "Mary", "Wei", "Ana", "Pierre", "Yuki", "Ahmed", "Olga",
+   "Rajesh", "Laura", "Thomas", "Ingrid", "Carlos", "Fatima", "David",
+   "Hiroshi", "Elena", "Michael", "Sofia", "Kwame", "J. R.", "A.~B.",
+   "{\\'E}mile", "Fran{\\c{c}}ois", "J{\\\"u}rgen", "G{\\\"o}ran",
+   "{\\AA}sa", "Ren{\\'e}e", "S{\\o}ren", "Jos{\\'e} Mar{\\'\\i}a",
+   "Zo\xc3\xab", "J\xc3\xbcrgen", "\xc5\x81ukasz", "Bj\xc3\xb6rn",
+   "Fran\xc3\xa7oise", "\xe5\xb0\x8f\xe6\x98\x8e"
+};
+
+static char * LastNames[] =
+{
+   "Smith", "Nguyen", "Garcia", "M{\\\"u}ller", "Kowalski", "Tanaka",
+   "Ivanova", "Okafor", "Johansson", "Rossi", "Dubois", "Patel",
+   "Schr{\\\"o}dinger", "Erd{\\H{o}}s", "Stra{\\ss}e", "Dvo{\\v{r}}{\\'a}k",
+   "M\xc3\xbcller", "Dvo\xc5\x99\xc3\xa1k", "\xc3\x85ngstr\xc3\xb6m",
+   "Gonz\xc3\xa1lez", "\xe6\x9d\x8e", "{Barnes and Noble}",
+   "Knuth", "Lamport", "Patashnik", "Ward", "Hoare", "Dijkstra"
+};
+
+static char * VonParts[] =
+{
+   "van der", "von", "de la", "di", "van", "de"
+};
+
+static char * JrParts[] =
+{
+   "Jr.", "Sr.", "III", "Jr"
+};
+
+static char * TitleWords[] =
+{
+   "a", "an", "the", "of", "on", "for", "and", "with", "in",
+   "analysis", "efficient", "parsing", "bibliographic", "databases",
+   "algorithm", "distributed", "learning", "theory", "approach",
+   "towards", "scalable", "semantic", "model", "evaluation", "study",
+   "systems", "networks", "optimal", "fast", "robust", "structure",
+   "{BibTeX}", "{TeX}", "{Unix}", "{Markov}", "{Bayesian}", "{SQL}",
+   "$O(n \\log n)$", "$\\lambda$-calculus", "\\emph{in situ}",
+   "{\\\"U}ber", "na{\\\"\\i}ve", "caf{\\'e}", "r\xc3\xa9sum\xc3\xa9",
+   "Stra\xc3\x9f" "e", "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e",
+   "co-operative", "state-of-the-art", "--", "{\\TeX}book"
+};
+
+static char * Journals[][2] =
+{
+   { "jacm",   "Journal of the {ACM}" },
+   { "cacm",   "Communications of the {ACM}" },
+   { "tcs",    "Theoretical Computer Science" },
+   { "siamjc", "{SIAM} Journal on Computing" },
+   { "ipl",    "Information Processing Letters" },
+   { "tugboat", "{TUGboat}" },
+   { "spe",    "Software---Practice and Experience" },
+   { "jlm",    "Journal of Logic and Computation" }
+};
+
+static char * Months[] =
+{
+   "jan", "feb", "mar", "apr", "may", "jun",
+   "jul", "aug", "sep", "oct", "nov", "dec"
+};
+
+static char * Publishers[] =
+{
+   "Addison-Wesley", "Springer-Verlag", "{MIT} Press", "Elsevier",
+   "Cambridge University Press", "O'Reilly"
+};
+
+
+/* ------------------------------------------------------------------------
+@NAME       : rnd()
+@INPUT      : n
+@RETURNS    : a pseudo-random number in [0, n)
+@DESCRIPTION: A 32-bit xorshift generator, kept in an unsigned long
+              masked to 32 bits so that it gives the same sequence
+              whatever the size of long.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static int
+rnd (int n)
+{
+   Seed ^= (Seed << 13) & 0xffffffffUL;
+   Seed ^= Seed >> 17;
+   Seed ^= (Seed << 5) & 0xffffffffUL;
+   return (int) (Seed % (unsigned long) n);
+}
+
+#define PICK(a) ((a)[rnd (NUM (a))])
+
+
+static void
+put_name (FILE * out)
+{
+   int style = rnd (10);
+
+   if (style < 6)                       /* First Last */
+      fprintf (out, "%s %s", PICK (FirstNames), PICK (LastNames));
+   else if (style < 8)                  /* Last, First */
+      fprintf (out, "%s, %s", PICK (LastNames), PICK (FirstNames));
+   else if (style < 9)                  /* First von Last */
+      fprintf (out, "%s %s %s",
+               PICK (FirstNames), PICK (VonParts), PICK (LastNames));
+   else                                 /* von Last, Jr, First */
+      fprintf (out, "%s %s, %s, %s", PICK (VonParts), PICK (LastNames),
+               PICK (JrParts), PICK (FirstNames));
+}
+
+
+static void
+put_names (FILE * out, char * field, int num_names)
+{
+   int  i;
+
+   fprintf (out, "  %s = {", field);
+   for (i = 0; i < num_names; i++)
+   {
+      if (i > 0)
+         fputs (i % 4 == 0 ? "\n             and " : " and ", out);
+      put_name (out);
+   }
+   fputs ("},\n", out);
+}
+
+
+static void
+put_words (FILE * out, int num_words, int line_length)
+{
+   int  i, col;
+
+   col = 0;
+   for (i = 0; i < num_words; i++)
+   {
+      char * word = PICK (TitleWords);
+
+      if (i > 0)
+      {
+         if (line_length && col > line_length)
+         {
+            fputs ("\n    ", out);
+            col = 0;
+         }
+         else
+            putc (' ', out);
+      }
+      fputs (word, out);
+      col += strlen (word) + 1;
+   }
+}
+
+
+static void
+put_strings (FILE * out)
+{
+   int  i;
+
+   fputs ("@preamble{ \"\\newcommand{\\noopsort}[1]{}\" }\n\n", out);
+   for (i = 0; i < NUM (Journals); i++)
+      fprintf (out, "@string{%s = \"%s\"}\n", Journals[i][0], Journals[i][1]);
+   for (i = 0; i < NUM (Months); i++)   /* not predefined by btparse */
+      fprintf (out, "@string{%s = {%c%s}}\n", Months[i],
+               Months[i][0] - 'a' + 'A', Months[i] + 1);
+   fputs ("@string{lncs = \"Lecture Notes in Computer Science\"}\n"
+          "@string{procof = \"Proceedings of the \"}\n"
+          "@string(tr = {Technical Report})\n\n", out);
+}
+
+
+static void
+put_entry (FILE * out, int num)
+{
+   static char * types[] =
+      { "article", "article", "article", "inproceedings", "inproceedings",
+        "book", "incollection", "techreport", "phdthesis", "misc" };
+   char *  type = PICK (types);
+   int     parens = rnd (20) == 0;
+   int     num_authors;
+
+   fprintf (out, "@%s%ckey%d,\n", type, parens ? '(' : '{', num);
+
+   num_authors = rnd (40) == 0 ? 50 + rnd (251) : 1 + rnd (5);
+   put_names (out, "author", num_authors);
+
+   if (rnd (2))
+   {
+      fputs ("  title = {", out);
+      put_words (out, 4 + rnd (12), 50);
+      fputs ("},\n", out);
+   }
+   else
+   {
+      fputs ("  title = \"", out);
+      put_words (out, 4 + rnd (12), 50);
+      fputs ("\",\n", out);
+   }
+
+   switch (type[0])
+   {
+      case 'a':                         /* article */
+         fprintf (out, "  journal = %s,\n", PICK (Journals)[0]);
+         fprintf (out, "  volume = %d,\n  number = {%d},\n",
+                  1 + rnd (60), 1 + rnd (12));
+         fprintf (out, "  pages = {%d--%d},\n",
+                  num % 500, num % 500 + rnd (40));
+         break;
+      case 'i':                         /* inproceedings, incollection */
+         fputs ("  booktitle = procof # {", out);
+         put_words (out, 3 + rnd (5), 0);
+         fputs ("},\n", out);
+         if (rnd (3) == 0)
+         {
+            put_names (out, "editor", 1 + rnd (4));
+            fprintf (out, "  series = lncs,\n  volume = {%d},\n",
+                     1000 + rnd (9000));
+         }
+         break;
+      case 'b':                         /* book */
+         fprintf (out, "  publisher = {%s},\n", PICK (Publishers));
+         fprintf (out, "  edition = \"%s\",\n", rnd (2) ? "Second" : "Third");
+         break;
+      case 't':                         /* techreport */
+         fprintf (out, "  type = tr # \" (revised)\",\n"
+                  "  institution = {%s University},\n", PICK (LastNames));
+         break;
+      case 'p':                         /* phdthesis */
+         fprintf (out, "  school = {Universit{\\'e} de %s},\n",
+                  PICK (LastNames));
+         break;
+      default:                          /* misc */
+         fprintf (out, "  howpublished = {\\url{http://example.org/%d}},\n",
+                  num);
+         break;
+   }
+
+   fprintf (out, "  year = %d,\n", 1950 + rnd (76));
+   if (rnd (2))
+      fprintf (out, "  month = %s # \"~%d\",\n", PICK (Months), 1 + rnd (28));
+   if (rnd (4) == 0)
+   {
+      fputs ("  note = \"Also in \" # ", out);
+      fprintf (out, "%s # \", \" # {%d}", PICK (Journals)[0], 1990 + rnd (30));
+      fputs (",\n", out);
+   }
+   if (rnd (3) == 0)
+   {
+      int  huge = rnd (25) == 0;
+
+      fputs ("  abstract = {", out);
+      put_words (out, huge ? 1000 + rnd (4000) : 50 + rnd (200), 70);
+      fputs ("},\n", out);
+   }
+   fprintf (out, "  keywords = {%s, %s}\n%c\n\n",
+            PICK (TitleWords), PICK (TitleWords), parens ? ')' : '}');
+}
+
+
+int main (int argc, char * argv[])
+{
+   int     num_entries = 10000;
+   char *  filename = NULL;
+   FILE *  out;
+   int     i;
+
+   for (i = 1; i < argc; i++)
+   {
+      if (strcmp (argv[i], "-n") == 0 && i+1 < argc)
+         num_entries = atoi (argv[++i]);
+      else if (strcmp (argv[i], "-s") == 0 && i+1 < argc)
+         Seed = strtoul (argv[++i], NULL, 10) & 0xffffffffUL;
+      else if (argv[i][0] != '-' && filename == NULL)
+         filename = argv[i];
+      else
+      {
+         fprintf (stderr, "usage: gen_corpus [-n entries] [-s seed] [file]\n");
+         return 1;
+      }
+   }
+   if (Seed == 0)                       /* xorshift never leaves 0 */
+      Seed = 1;
+
+   if (filename)
+   {
+      out = fopen (filename, "w");
+      if (out == NULL)
+      {
+         perror (filename);
+         return 1;
+      }
+   }
+   else
+      out = stdout;
+
+   fprintf (out, "%% Synthetic benchmark corpus: %d entries, seed %lu\n\n",
+            num_entries, Seed);
+   put_strings (out);
+   for (i = 0; i < num_entries; i++)
+   {
+      if (i % 1000 == 999)
+         fprintf (out, "@comment{ ---- %d entries so far ---- }\n\n", i+1);
+      put_entry (out, i);
+   }
+
+   if (fclose (out) != 0)
+   {
+      perror (filename ? filename : "(stdout)");
+      return 1;
+   }
+   return 0;
+}
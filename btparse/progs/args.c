@@ -40,6 +40,7 @@ parser_options options =
 #endif
 
 static boolean quote_strings = FALSE;
+static boolean bibtex = FALSE;
 static boolean convert_numbers = TRUE;
 static boolean expand_macros = TRUE;
 static boolean paste_strings = TRUE;
@@ -54,6 +55,7 @@ struct option option_table[] =
    { "check",      0, &check_only, 1 },
    { "noquotes",   0, &quote_strings, 0 },
    { "quote",      0, &quote_strings, 1 },
+   { "bibtex",     0, &bibtex, 1 },
    { "convert",    0, &convert_numbers, 1 },
    { "noconvert",  0, &convert_numbers, 0 },
    { "expand",     0, &expand_macros, 1 },
@@ -97,8 +99,11 @@ parser_options *parse_args (int argc, char **argv)
    options->string_opts |= (collapse_whitespace ? BTO_COLLAPSE : 0);
    
    options->other_opts = 0;       /* do store macro text */
+   if (check_only)                /* but don't build values at all */
+      options->other_opts |= BTO_CHECKONLY;
    
    options->quote_strings = quote_strings;
+   options->bibtex = bibtex;
    options->check_only = check_only;
    options->dump_ast = dump_ast;
    options->whole_file = whole_file;
@@ -25,6 +25,7 @@ typedef struct
    btshort   other_opts;
    boolean   check_only;
    boolean   quote_strings;
+   boolean   bibtex;
    boolean   dump_ast;
    boolean   whole_file;
 } parser_options;
@@ -39,9 +39,10 @@ char *  Usage = "usage: bibparse [options] file [...]\n";
 char *  Help = 
 "\n"
 "Options:\n"
-"  -check         check syntax only (ie. don't print entries out)\n"
+"  -check         check syntax only (ie. don't process or print entries)\n"
 "  -noquote       don't quote strings [default]\n"
 "  -quote         put quotes around strings (warning: not bulletproof)\n"
+"  -bibtex        print entries as BibTeX (strings are always quoted)\n"
 "  -convert       convert numeric values to strings\n"
 "  -noconvert     don't\n"
 "  -expand        expand macros [default]\n"
@@ -71,135 +72,45 @@ void dprintf (char *format, ...) {}
 #endif
 
 /* ------------------------------------------------------------------------
-@NAME       : print_assigned_entry()
-@INPUT      : stream
-              top
-@OUTPUT     : 
-@RETURNS    : 
-@DESCRIPTION: Prints out a "field-assignment"-type entry (ie. a macro 
-              definition or regular entry).
-@GLOBALS    : 
-@CALLS      : btparse traversal functions
-@CALLERS    : print_entry()
-@CREATED    : 1997/08/12, GPW
-@MODIFIED   : 
--------------------------------------------------------------------------- */
-static void
-print_assigned_entry (FILE *stream, AST *top, boolean quote_strings)
-{
-   char  *type, *key;
-   char  *field_name;
-   AST   *field;
-
-   type = bt_entry_type (top);
-   key = bt_entry_key (top);
-
-   fprintf (stream, "@%s", type);
-   if (key) fprintf (stream, " %s", key);
-   fputc ('\n', stream);
-
-   field = NULL;
-   while ((field = bt_next_field (top, field, &field_name)))
-   {
-      AST *   value;
-      bt_nodetype nodetype;
-      char *  text;
-      boolean first;
-
-      fprintf (stream, "%s=", field_name);
-
-      value = NULL;
-      first = TRUE;
-      
-      while ((value = bt_next_value (field, value, &nodetype, &text)))
-      {
-         if (!first) fputc ('#', stream);
-         if (text) 
-         {
-            if (nodetype == BTAST_STRING && quote_strings)
-               fprintf (stream, "{%s}", text);
-            else
-               fputs (text, stream);
-         }
-         first = FALSE;
-      }
-
-      fputc ('\n', stream);             /* newline between fields */
-   }
-
-   fputc ('\n', stream);                /* blank line to end the entry */
-} /* print_assigned_entry() */
-
-
-/* ------------------------------------------------------------------------
-@NAME       : print_value_entry()
+@NAME       : print_entry()
 @INPUT      : stream
               top
+              options
 @OUTPUT     : 
 @RETURNS    : 
-@DESCRIPTION: Prints out a "value-only" entry (ie. comment or preamble).
+@DESCRIPTION: Prints a BibTeX entry, either in a very simplistic form
+              (a line for the type and key, then a line for each field)
+              or, with -bibtex, as BibTeX.  The work is done by
+              bt_write_entry(); see write.c for how it uses the AST
+              traversal routines in the btparse library.
 @GLOBALS    : 
-@CALLS      : btparse traversal functions
-@CALLERS    : print_entry()
-@CREATED    : 1997/08/13, GPW
-@MODIFIED   : 
--------------------------------------------------------------------------- */
-static void
-print_value_entry (FILE *stream, AST *top)
-{
-   char *  type;
-   AST *   value;
-   char *  text;
-
-   type = bt_entry_type (top);
-   fprintf (stream, "@%s\n", type);
-
-   value = NULL;
-      
-   while ((value = bt_next_value (top, value, NULL, &text)))
-   {
-      if (text) fprintf (stream, "%s\n", text);
-   }
-
-   fputc ('\n', stream);
-   
-} /* print_value_entry() */
-
-
-/* ------------------------------------------------------------------------
-@NAME       : print_entry()
-@INPUT      : 
-@OUTPUT     : 
-@RETURNS    : 
-@DESCRIPTION: Prints a BibTeX entry in a very simplistic form by calling
-              either print_assigned_entry() or print_value_entry().  These
-              in turn work by calling the AST traversal routines in the
-              btparse library, providing canonical examples of how to use
-              these routines.
-@GLOBALS    : 
-@CALLS      : 
+@CALLS      : bt_write_entry()
 @CREATED    : 1997/01/22, GPW
 @MODIFIED   : 1997/08/13, GPW: changed to differentiate between the two,
                                ahem, meta-meta-types of entries
+              2026/10/19: print_assigned_entry() and print_value_entry()
+                          replaced by bt_write_entry()
 -------------------------------------------------------------------------- */
 static void
-print_entry (FILE *stream, AST *top, boolean quote_strings)
+print_entry (FILE *stream, AST *top, parser_options *options)
 {
+   bt_write_options  write_options = { TRUE, BTW_BRACES, "  ", 0, NULL, 0 };
 
 #if DEBUG
    dump_ast ("print_entry: AST before traversing =\n", top);
 #endif
 
+   write_options.flat = !options->bibtex;
+   if (write_options.flat && !options->quote_strings)
+      write_options.quote = BTW_BARE;
+
    switch (bt_entry_metatype (top))
    {
       case BTE_MACRODEF:
       case BTE_REGULAR:
-         print_assigned_entry (stream, top, quote_strings);
-         break;
-
       case BTE_COMMENT:
       case BTE_PREAMBLE:
-         print_value_entry (stream, top);
+         bt_write_entry (stream, top, &write_options);
          break;
 
       default:
@@ -210,7 +121,7 @@ print_entry (FILE *stream, AST *top, boolean quote_strings)
 #if DEBUG
    dump_ast ("print_entry: AST after traversing =\n", top);
 #endif
-} /* print_entry() [2nd version] */
+} /* print_entry() [3rd version] */
 
 
 /* ------------------------------------------------------------------------
@@ -271,7 +182,7 @@ process_file (char *filename, parser_options *options)
       overall_status &= status;
       if (!cur_entry) break;
       if (!options->check_only)
-         print_entry (stdout, cur_entry, options->quote_strings);
+         print_entry (stdout, cur_entry, options);
       if (options->dump_ast)
          dump_ast ("AST for whole entry:\n", cur_entry);
       bt_free_ast (cur_entry);
@@ -0,0 +1,158 @@
+/* ------------------------------------------------------------------------
+@NAME       : btextract.c
+@INPUT      : a LaTeX .aux file, and any number of BibTeX files
+@OUTPUT     : one BibTeX file, with just the entries cited
+@RETURNS    :
+@DESCRIPTION: Makes a BibTeX file with only what a LaTeX document needs:
+              the entries it cites (as \citation in its .aux file), the
+              entries they cross-reference, the @string entries defining
+              the macros they use, and every @preamble.  Entries are
+              copied exactly as they are.  If no BibTeX files are given,
+              the ones named by \bibdata in the .aux file are read.
+
+                -o file   write to `file' instead of stdout
+                -c key    cite `key' too (or "*", for every entry);
+                          with -c, the .aux file may be left out
+
+              The exit status is 1 if any file couldn't be read or had
+              syntax errors.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse distribution (but not part
+              of the library itself).  This is free software; you can
+              redistribute it and/or modify it under the terms of the GNU
+              General Public License as published by the Free Software
+              Foundation; either version 2 of the License, or (at your
+              option) any later version.
+-------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "btparse.h"
+
+char *Usage = "usage: btextract [-o output] [-c key ...] [file.aux] [file.bib ...]\n";
+
+
+/* prototypes */
+boolean read_bib (bt_extract * extract, char * name);
+
+
+/* Reads a .bib file, adding ".bib" to the name if that's what it takes. */
+boolean read_bib (bt_extract * extract, char * name)
+{
+   char *  filename;
+   int     len;
+
+   if (bt_extract_file (extract, name) >= 0)
+      return TRUE;
+
+   len = strlen (name);
+   if (len < 4 || strcmp (name + len - 4, ".bib") != 0)
+   {
+      filename = (char *) malloc (len + 5);
+      strcpy (filename, name);
+      strcat (filename, ".bib");
+      if (bt_extract_file (extract, filename) >= 0)
+      {
+         free (filename);
+         return TRUE;
+      }
+      free (filename);
+   }
+   perror (name);
+   return FALSE;
+
+} /* read_bib () */
+
+
+int main (int argc, char **argv)
+{
+   bt_extract *  extract;
+   char *        output;
+   FILE *        outfile;
+   char **       bibdata;
+   boolean       ok, cited;
+   int           i, len, num_bibdata;
+
+   bt_initialize ();
+   extract = bt_extract_new ();
+   output = NULL;
+   cited = FALSE;
+   for (i = 1; i < argc && argv[i][0] == '-' && i+1 < argc; i += 2)
+   {
+      if (strcmp (argv[i], "-o") == 0)
+         output = argv[i+1];
+      else if (strcmp (argv[i], "-c") == 0)
+      {
+         bt_extract_cite (extract, argv[i+1]);
+         cited = TRUE;
+      }
+      else
+         break;
+   }
+   if ((i >= argc && !cited) || (i < argc && argv[i][0] == '-'))
+   {
+      fprintf (stderr, "%s", Usage);
+      exit (1);
+   }
+
+   ok = TRUE;
+   len = i < argc ? strlen (argv[i]) : 0;
+   if (len > 4 && strcmp (argv[i] + len - 4, ".aux") == 0)
+   {
+      if (bt_extract_aux (extract, argv[i]) < 0)
+      {
+         perror (argv[i]);
+         exit (1);
+      }
+      i++;
+   }
+
+   if (i < argc)
+   {
+      for ( ; i < argc; i++)
+         ok &= read_bib (extract, argv[i]);
+   }
+   else
+   {
+      bibdata = bt_extract_bibdata (extract, &num_bibdata);
+      if (num_bibdata == 0)
+      {
+         fprintf (stderr, "%s", Usage);
+         fprintf (stderr, "No BibTeX files given, or named by \\bibdata\n");
+         exit (1);
+      }
+      for (i = 0; i < num_bibdata; i++)
+         ok &= read_bib (extract, bibdata[i]);
+   }
+
+   if (output != NULL)
+   {
+      outfile = fopen (output, "w");
+      if (outfile == NULL)
+      {
+         perror (output);
+         exit (1);
+      }
+   }
+   else
+   {
+      outfile = stdout;
+   }
+
+   bt_extract_write (extract, outfile);
+   if (bt_get_error_count (BTERR_LEXERR) > 0 ||
+       bt_get_error_count (BTERR_SYNTAX) > 0)
+      ok = FALSE;
+
+   bt_extract_free (extract);
+   bt_cleanup ();
+   if (outfile != stdout && fclose (outfile) != 0)
+   {
+      perror (output);
+      ok = FALSE;
+   }
+   exit (ok ? 0 : 1);
+}
@@ -0,0 +1,315 @@
+/* ------------------------------------------------------------------------
+@NAME       : btindex.c
+@INPUT      : a BibTeX file (to index it), or an index and a query
+@OUTPUT     : the index, or the entries matching the query
+@RETURNS    :
+@DESCRIPTION: Builds a full-text index of a BibTeX file, or searches one:
+
+                btindex [-j jobs] [-f field,...] -o index file.bib
+                btindex [-e] -q query index
+
+              With -f, the given fields are indexed instead of title,
+              author, editor, abstract and keywords.  With -j, the file
+              is split into that many ranges, which are indexed in
+              parallel, each by a process of its own, and the indexes
+              of the ranges merged (where there's no fork(), -j is
+              ignored).  A search prints
+              the byte offset of each entry matched, one per line; with
+              -e, it prints the entries themselves, read from the
+              indexed file.  The exit status is 1 if a file couldn't be
+              read or written, the BibTeX file had syntax errors, or the
+              query did; for a search, it is 2 if nothing matched.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse distribution (but not part
+              of the library itself).  This is free software; you can
+              redistribute it and/or modify it under the terms of the GNU
+              General Public License as published by the Free Software
+              Foundation; either version 2 of the License, or (at your
+              option) any later version.
+-------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+# include <unistd.h>
+# include <sys/types.h>
+# include <sys/wait.h>
+#endif
+#include "btparse.h"
+
+char *Usage =
+"usage: btindex [-j jobs] [-f field,...] -o index file.bib\n"
+"       btindex [-e] -q query index\n";
+
+
+/* prototypes */
+int build (char * fieldlist, char * indexname, char * filename, int jobs);
+#ifndef _WIN32
+int build_ranges (bt_index * index, char ** fields, int num_fields,
+                  char * indexname, char * filename, int jobs);
+#endif
+int search (char * query, char * indexname, boolean entries);
+
+
+static boolean
+syntax_errors (void)
+{
+   return bt_get_error_count (BTERR_LEXERR) > 0 ||
+          bt_get_error_count (BTERR_SYNTAX) > 0;
+}
+
+
+#ifndef _WIN32
+/*
+ * Indexes `filename' in `jobs' ranges of about the same size, each in a
+ * child process that writes the index of its range to indexname.N, and
+ * merges those into `index'.  Returns 0 if everything went well, 1 if
+ * there were syntax errors, and 2 if a range couldn't be indexed (and
+ * so the index is incomplete).
+ */
+int build_ranges (bt_index * index, char ** fields, int num_fields,
+                  char * indexname, char * filename, int jobs)
+{
+   bt_index *  range;
+   FILE *      infile;
+   char **     names;
+   long        size;
+   pid_t       pid;
+   int         i, status, child_status;
+
+   infile = fopen (filename, "r");
+   if (infile == NULL || fseek (infile, 0, SEEK_END) != 0 ||
+       (size = ftell (infile)) < 0)
+   {
+      perror (filename);
+      if (infile) fclose (infile);
+      return 2;
+   }
+   fclose (infile);
+
+   names = (char **) malloc (jobs * sizeof (char *));
+   fflush (stdout);
+   fflush (stderr);
+   status = 0;
+   for (i = 0; i < jobs; i++)
+   {
+      names[i] = (char *) malloc (strlen (indexname) + 16);
+      sprintf (names[i], "%s.%d", indexname, i);
+      pid = fork ();
+      if (pid < 0)
+      {
+         perror ("fork");
+         free (names[i]);
+         status = 2;
+         break;
+      }
+      if (pid > 0)
+         continue;
+
+      /* the child: index range i, and write it out */
+      infile = fopen (filename, "r");
+      if (infile == NULL)
+      {
+         perror (filename);
+         exit (2);
+      }
+      range = bt_index_new (fields, num_fields);
+      bt_index_range (range, infile, filename, size / jobs * i,
+                      (i == jobs - 1) ? -1 : size / jobs * (i + 1));
+      fclose (infile);
+      if (bt_index_write (range, names[i]) != 0)
+      {
+         perror (names[i]);
+         exit (2);
+      }
+      exit (syntax_errors () ? 1 : 0);
+   }
+   jobs = i;                            /* the ones started */
+
+   for (i = 0; i < jobs; i++)
+   {
+      if (wait (&child_status) < 0 || !WIFEXITED (child_status))
+         status = 2;
+      else if (WEXITSTATUS (child_status) > status)
+         status = WEXITSTATUS (child_status);
+   }
+
+   for (i = 0; i < jobs; i++)
+   {
+      if (status < 2 && bt_index_merge (index, names[i]) < 0)
+      {
+         perror (names[i]);
+         status = 2;
+      }
+      unlink (names[i]);
+      free (names[i]);
+   }
+   free (names);
+   return status;
+
+} /* build_ranges () */
+#endif
+
+
+int build (char * fieldlist, char * indexname, char * filename, int jobs)
+{
+   bt_index *  index;
+   FILE *      infile;
+   char **     fields;
+   char *      p;
+   int         num_fields;
+   int         status;
+
+   fields = NULL;
+   num_fields = 0;
+   if (fieldlist != NULL)
+   {
+      fields = (char **) malloc ((strlen (fieldlist) / 2 + 1) * sizeof (char *));
+      for (p = strtok (fieldlist, ","); p; p = strtok (NULL, ","))
+         fields[num_fields++] = p;
+   }
+
+   index = bt_index_new (fields, num_fields);
+#ifndef _WIN32
+   if (jobs > 1)
+      status = build_ranges (index, fields, num_fields, indexname, filename,
+                             jobs);
+   else
+#endif
+   {
+      infile = fopen (filename, "r");
+      if (infile == NULL)
+      {
+         perror (filename);
+         bt_index_free (index);
+         if (fields) free (fields);
+         return 1;
+      }
+      bt_index_file (index, infile, filename);
+      fclose (infile);
+      status = syntax_errors () ? 1 : 0;
+   }
+
+   if (status < 2 && bt_index_write (index, indexname) != 0)
+   {
+      perror (indexname);
+      status = 1;
+   }
+   if (status > 1)
+      status = 1;
+
+   bt_index_free (index);
+   if (fields) free (fields);
+   return status;
+
+} /* build () */
+
+
+int search (char * query, char * indexname, boolean entries)
+{
+   bt_search *    search;
+   bt_reader *    reader;
+   bt_entry_text  text;
+   FILE *         bibfile;
+   char *         filename;
+   long *         offsets;
+   int            num, i;
+
+   search = bt_search_open (indexname);
+   if (search == NULL)
+   {
+      perror (indexname);
+      return 1;
+   }
+   offsets = bt_search_query (search, query, &num);
+   if (offsets == NULL)
+   {
+      bt_search_close (search);
+      return 1;
+   }
+
+   bibfile = NULL;
+   if (entries)
+   {
+      filename = bt_search_filename (search);
+      bibfile = fopen (filename, "r");
+      if (bibfile == NULL)
+      {
+         perror (filename);
+         free (offsets);
+         bt_search_close (search);
+         return 1;
+      }
+   }
+
+   for (i = 0; i < num; i++)
+   {
+      if (bibfile == NULL)
+      {
+         printf ("%ld\n", offsets[i]);
+         continue;
+      }
+      fseek (bibfile, offsets[i], SEEK_SET);
+      reader = bt_open_reader (bibfile);
+      if (bt_read_entry_text (reader, &text))
+      {
+         fwrite (text.text, 1, text.length, stdout);
+         fputs ("\n\n", stdout);
+      }
+      bt_close_reader (reader);
+   }
+
+   if (bibfile) fclose (bibfile);
+   free (offsets);
+   bt_search_close (search);
+   return num > 0 ? 0 : 2;
+
+} /* search () */
+
+
+int main (int argc, char **argv)
+{
+   char *   fieldlist;
+   char *   output;
+   char *   query;
+   boolean  entries;
+   int      jobs, i, status;
+
+   fieldlist = output = query = NULL;
+   entries = FALSE;
+   jobs = 1;
+   for (i = 1; i < argc && argv[i][0] == '-'; i++)
+   {
+      if (strcmp (argv[i], "-e") == 0)
+         entries = TRUE;
+      else if (strcmp (argv[i], "-j") == 0 && i+1 < argc &&
+               (jobs = atoi (argv[i+1])) > 0)
+         i++;
+      else if (strcmp (argv[i], "-f") == 0 && i+1 < argc)
+         fieldlist = argv[++i];
+      else if (strcmp (argv[i], "-o") == 0 && i+1 < argc)
+         output = argv[++i];
+      else if (strcmp (argv[i], "-q") == 0 && i+1 < argc)
+         query = argv[++i];
+      else
+         break;
+   }
+   if (i != argc - 1 || argv[i][0] == '-' ||
+       (output == NULL) == (query == NULL))
+   {
+      fprintf (stderr, "%s", Usage);
+      exit (1);
+   }
+
+   bt_initialize ();
+   bt_set_name_cache (4096);            /* the same authors turn up a lot */
+   if (output != NULL)
+      status = build (fieldlist, output, argv[i], jobs);
+   else
+      status = search (query, argv[i], entries);
+   bt_cleanup ();
+   exit (status);
+}
@@ -0,0 +1,152 @@
+/* ------------------------------------------------------------------------
+@NAME       : btjson.c
+@INPUT      : any number of BibTeX files
+@OUTPUT     : their entries, as JSON
+@RETURNS    :
+@DESCRIPTION: Converts BibTeX files to JSON as they are parsed, one entry
+              at a time: by default, as JSON Lines (an object per entry,
+              on a line of its own, with every field), or as a CSL-JSON
+              array of the regular entries.
+
+                -csl      write CSL-JSON
+                -unicode  convert the TeX in strings to Unicode
+                -o file   write to `file' instead of stdout
+
+              The usual month macros (jan, feb, ...) are defined first.
+              Entries with syntax errors are left out, and the exit
+              status is 1 if any file couldn't be read or had any.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse distribution (but not part
+              of the library itself).  This is free software; you can
+              redistribute it and/or modify it under the terms of the GNU
+              General Public License as published by the Free Software
+              Foundation; either version 2 of the License, or (at your
+              option) any later version.
+-------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "btparse.h"
+
+char *Usage = "usage: btjson [-csl] [-unicode] [-o output] file ...\n";
+
+static char *Months[12][2] =
+{
+   { "jan", "January" },   { "feb", "February" }, { "mar", "March" },
+   { "apr", "April" },     { "may", "May" },      { "jun", "June" },
+   { "jul", "July" },      { "aug", "August" },   { "sep", "September" },
+   { "oct", "October" },   { "nov", "November" }, { "dec", "December" }
+};
+
+
+/* prototypes */
+boolean json_file (char * filename, FILE * outfile,
+                   bt_json_options * options, int * num_written);
+
+
+boolean json_file (char * filename, FILE * outfile,
+                   bt_json_options * options, int * num_written)
+{
+   FILE *     infile;
+   AST *      entry;
+   bt_buffer  buf;
+   boolean    status, ok;
+
+   infile = fopen (filename, "r");
+   if (infile == NULL)
+   {
+      perror (filename);
+      return FALSE;
+   }
+
+   memset (&buf, 0, sizeof (buf));
+   ok = TRUE;
+   while ((entry = bt_parse_entry (infile, filename, 0, &status)))
+   {
+      ok &= status;
+      buf.length = 0;
+      if (status && bt_json_entry_s (&buf, entry, options))
+      {
+         if (options->style == BTJS_CSL)        /* an array element */
+            fputs (*num_written > 0 ? ",\n" : "[\n", outfile);
+         fputs (buf.text, outfile);
+         if (options->style != BTJS_CSL)        /* a line */
+            fputc ('\n', outfile);
+         (*num_written)++;
+      }
+      bt_free_ast (entry);
+   }
+   ok &= status;
+
+   bt_free_buffer (&buf);
+   fclose (infile);
+   return ok;
+
+} /* json_file () */
+
+
+int main (int argc, char **argv)
+{
+   bt_json_options  options;
+   char *           output;
+   FILE *           outfile;
+   boolean          ok;
+   int              i, m, num_written;
+
+   options.style = BTJS_PLAIN;
+   options.unicode = FALSE;
+   output = NULL;
+   for (i = 1; i < argc && argv[i][0] == '-'; i++)
+   {
+      if (strcmp (argv[i], "-csl") == 0)
+         options.style = BTJS_CSL;
+      else if (strcmp (argv[i], "-unicode") == 0)
+         options.unicode = TRUE;
+      else if (strcmp (argv[i], "-o") == 0 && i+1 < argc)
+         output = argv[++i];
+      else
+         break;
+   }
+   if (i >= argc || argv[i][0] == '-')
+   {
+      fprintf (stderr, "%s", Usage);
+      exit (1);
+   }
+
+   if (output != NULL)
+   {
+      outfile = fopen (output, "w");
+      if (outfile == NULL)
+      {
+         perror (output);
+         exit (1);
+      }
+   }
+   else
+   {
+      outfile = stdout;
+   }
+
+   bt_initialize ();
+   bt_set_name_cache (4096);            /* the same authors turn up a lot */
+   for (m = 0; m < 12; m++)
+      bt_add_macro_text (Months[m][0], Months[m][1], NULL, 0);
+
+   ok = TRUE;
+   num_written = 0;
+   for ( ; i < argc; i++)
+      ok &= json_file (argv[i], outfile, &options, &num_written);
+   if (options.style == BTJS_CSL)
+      fputs (num_written > 0 ? "\n]\n" : "[]\n", outfile);
+
+   bt_cleanup ();
+   if (outfile != stdout && fclose (outfile) != 0)
+   {
+      perror (output);
+      ok = FALSE;
+   }
+   exit (ok ? 0 : 1);
+}
@@ -0,0 +1,132 @@
+/* ------------------------------------------------------------------------
+@NAME       : btmerge.c
+@INPUT      : any number of BibTeX files
+@OUTPUT     : one BibTeX file, with all their entries
+@RETURNS    :
+@DESCRIPTION: Merges BibTeX files: all their @string and @preamble
+              entries first, then everything else, in order.  Entries are
+              copied exactly as they are; what to do when a key turns up
+              again is up to the command-line options:
+
+                -first   keep the first entry with a key (the default)
+                -rename  give later ones a new key (key-2, key-3, ...)
+                -report  keep them all
+
+              The conflicts are reported (as warnings) either way.  The
+              exit status is 1 if any file couldn't be read or had syntax
+              errors, or if there were conflicts under -report.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse distribution (but not part
+              of the library itself).  This is free software; you can
+              redistribute it and/or modify it under the terms of the GNU
+              General Public License as published by the Free Software
+              Foundation; either version 2 of the License, or (at your
+              option) any later version.
+-------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "btparse.h"
+
+char *Usage = "usage: btmerge [-first | -rename | -report] [-o output] file ...\n";
+
+
+/* prototypes */
+boolean merge_file (bt_merge * merge, char * filename, FILE * outfile,
+                    int pass);
+
+
+boolean merge_file (bt_merge * merge, char * filename, FILE * outfile,
+                    int pass)
+{
+   FILE *  infile;
+
+   infile = fopen (filename, "r");
+   if (infile == NULL)
+   {
+      if (pass == 1)
+         perror (filename);
+      return FALSE;
+   }
+
+   if (pass == 1)
+      bt_merge_strings (merge, infile, filename, outfile);
+   else
+      bt_merge_entries (merge, infile, filename, outfile);
+   fclose (infile);
+   return TRUE;
+
+} /* merge_file () */
+
+
+int main (int argc, char **argv)
+{
+   bt_merge_policy  policy;
+   char *           output;
+   FILE *           outfile;
+   bt_merge *       merge;
+   boolean          ok;
+   int              first, i, pass;
+
+   policy = BTM_FIRST;
+   output = NULL;
+   for (first = 1; first < argc && argv[first][0] == '-'; first++)
+   {
+      if (strcmp (argv[first], "-first") == 0)
+         policy = BTM_FIRST;
+      else if (strcmp (argv[first], "-rename") == 0)
+         policy = BTM_RENAME;
+      else if (strcmp (argv[first], "-report") == 0)
+         policy = BTM_REPORT;
+      else if (strcmp (argv[first], "-o") == 0 && first+1 < argc)
+         output = argv[++first];
+      else
+         break;
+   }
+   if (first >= argc || argv[first][0] == '-')
+   {
+      fprintf (stderr, "%s", Usage);
+      exit (1);
+   }
+
+   if (output != NULL)
+   {
+      outfile = fopen (output, "w");
+      if (outfile == NULL)
+      {
+         perror (output);
+         exit (1);
+      }
+   }
+   else
+   {
+      outfile = stdout;
+   }
+
+   bt_initialize ();
+   merge = bt_merge_new (policy);
+   ok = TRUE;
+   for (pass = 1; pass <= 2; pass++)
+   {
+      for (i = first; i < argc; i++)
+         ok &= merge_file (merge, argv[i], outfile, pass);
+   }
+
+   if (bt_get_error_count (BTERR_LEXERR) > 0 ||
+       bt_get_error_count (BTERR_SYNTAX) > 0)
+      ok = FALSE;
+   if (policy == BTM_REPORT && bt_merge_conflicts (merge) > 0)
+      ok = FALSE;
+
+   bt_merge_free (merge);
+   bt_cleanup ();
+   if (outfile != stdout && fclose (outfile) != 0)
+   {
+      perror (output);
+      ok = FALSE;
+   }
+   exit (ok ? 0 : 1);
+}
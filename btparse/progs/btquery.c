@@ -0,0 +1,132 @@
+/* ------------------------------------------------------------------------
+@NAME       : btquery.c
+@INPUT      : a query, and any number of BibTeX files
+@OUTPUT     : the entries that match it
+@RETURNS    :
+@DESCRIPTION: Picks out the entries of BibTeX files that match a query
+              on their fields, as the files are parsed:
+
+                btquery [-k|-r|-e] [-o output] query file ...
+
+              such as
+
+                btquery 'type=article and year>=2015 and author~knuth' \
+                        big.bib
+
+              For each entry that matches, it writes its key (-k, the
+              default), its byte offset and length in its file (-r),
+              or its text (-e).  The usual month macros (jan, feb, ...)
+              are defined first.  The exit status is 1 if the query was
+              wrong, or a file couldn't be read or had syntax errors;
+              otherwise, it is 2 if nothing matched.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse distribution (but not part
+              of the library itself).  This is free software; you can
+              redistribute it and/or modify it under the terms of the GNU
+              General Public License as published by the Free Software
+              Foundation; either version 2 of the License, or (at your
+              option) any later version.
+-------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "btparse.h"
+
+char *Usage = "usage: btquery [-k|-r|-e] [-o output] query file ...\n";
+
+static char *Months[12][2] =
+{
+   { "jan", "January" },   { "feb", "February" }, { "mar", "March" },
+   { "apr", "April" },     { "may", "May" },      { "jun", "June" },
+   { "jul", "July" },      { "aug", "August" },   { "sep", "September" },
+   { "oct", "October" },   { "nov", "November" }, { "dec", "December" }
+};
+
+
+int main (int argc, char **argv)
+{
+   bt_query *       query;
+   bt_query_output  what;
+   char *           output;
+   FILE *           infile;
+   FILE *           outfile;
+   boolean          ok;
+   int              i, m, count;
+
+   what = BTQ_KEYS;
+   output = NULL;
+   for (i = 1; i < argc && argv[i][0] == '-'; i++)
+   {
+      if (strcmp (argv[i], "-k") == 0)
+         what = BTQ_KEYS;
+      else if (strcmp (argv[i], "-r") == 0)
+         what = BTQ_RANGES;
+      else if (strcmp (argv[i], "-e") == 0)
+         what = BTQ_ENTRIES;
+      else if (strcmp (argv[i], "-o") == 0 && i+1 < argc)
+         output = argv[++i];
+      else
+         break;
+   }
+   if (i + 1 >= argc || argv[i][0] == '-')
+   {
+      fprintf (stderr, "%s", Usage);
+      exit (1);
+   }
+
+   bt_initialize ();
+   bt_set_name_cache (4096);            /* the same authors turn up a lot */
+   query = bt_query_new (argv[i++]);
+   if (query == NULL)
+   {
+      bt_cleanup ();
+      exit (1);
+   }
+
+   if (output != NULL)
+   {
+      outfile = fopen (output, "w");
+      if (outfile == NULL)
+      {
+         perror (output);
+         exit (1);
+      }
+   }
+   else
+   {
+      outfile = stdout;
+   }
+
+   for (m = 0; m < 12; m++)
+      bt_add_macro_text (Months[m][0], Months[m][1], NULL, 0);
+
+   ok = TRUE;
+   count = 0;
+   for ( ; i < argc; i++)
+   {
+      infile = fopen (argv[i], "r");
+      if (infile == NULL)
+      {
+         perror (argv[i]);
+         ok = FALSE;
+         continue;
+      }
+      count += bt_query_file (query, infile, argv[i], what, outfile);
+      fclose (infile);
+   }
+   if (bt_get_error_count (BTERR_LEXERR) > 0 ||
+       bt_get_error_count (BTERR_SYNTAX) > 0)
+      ok = FALSE;
+
+   bt_query_free (query);
+   bt_cleanup ();
+   if (outfile != stdout && fclose (outfile) != 0)
+   {
+      perror (output);
+      ok = FALSE;
+   }
+   exit (!ok ? 1 : count > 0 ? 0 : 2);
+}
@@ -21,6 +21,18 @@
 #include "parse_auxiliary.h"
 
 extern char * InputFilename;            /* for zzcr_ast call in pccts/ast.c */
+extern boolean CheckOnly;               /* no value nodes wanted */
+
+/*
+ * Makes the AST node for a value token, unless parsing with
+ * BTO_CHECKONLY: then the token is just matched, with nothing allocated.
+ */
+#define VALUE_NODE(type)                                        \
+   if (!CheckOnly)                                              \
+   {                                                            \
+      zzsubchild (_root, &_sibling, &_tail);                    \
+      zzastArg(1)->nodetype = (type);                           \
+   }
 #define GENAST
 
 #include "../pccts/ast.h"
@@ -123,8 +135,8 @@ AST **_root;
     {
 	if ( LA(1)==STRING) {
             if (!(metatype == BTE_COMMENT )) {zzfailed_pred("   metatype == BTE_COMMENT ");}
-            zzmatch(STRING); zzsubchild(_root, &_sibling, &_tail);
-            zzastArg(1)->nodetype = BTAST_STRING;   
+            zzmatch(STRING); 
+            VALUE_NODE (BTAST_STRING);   
             zzCONSUME;
 
 	}
@@ -220,9 +232,20 @@ AST **_root;
 			zzBLOCK(zztasp2);
 			zzMake0;
 			{
-			if ( LA(1)==COMMA) {
+			while ( LA(1)==COMMA) {
 				zzmatch(COMMA);  zzCONSUME;
-				fields(zzSTR); zzlink(_root, &_sibling, &_tail);
+				if (LA(1) != NAME)
+				{
+					if (LA(1) != ENTRY_CLOSE)
+					{
+						zzFAIL(1,zzerr4,&zzMissSet,&zzMissText,
+						&zzBadTok,&zzBadText,&zzErrk);
+						goto fail;
+					}
+					break;
+				}
+				field(zzSTR); zzlink(_root, &_sibling, &_tail);
+				zzLOOP(zztasp2);
 			}
 			zzEXIT(zztasp2);
 			}
@@ -322,20 +345,20 @@ AST **_root;
 	zzMake0;
 	{
             if ( LA(1)==STRING) {
-		zzmatch(STRING); zzsubchild(_root, &_sibling, &_tail);
-		zzastArg(1)->nodetype = BTAST_STRING;   
+		zzmatch(STRING); 
+		VALUE_NODE (BTAST_STRING);   
                 zzCONSUME;
             }
             else {
 		if ( LA(1)==NUMBER)  {
-                    zzmatch(NUMBER); zzsubchild(_root, &_sibling, &_tail);
-                    zzastArg(1)->nodetype = BTAST_NUMBER;   
+                    zzmatch(NUMBER); 
+                    VALUE_NODE (BTAST_NUMBER);   
                     zzCONSUME;
 		}
 		else {
                     if ( LA(1)==NAME)  {
-                        zzmatch(NAME); zzsubchild(_root, &_sibling, &_tail);
-                        zzastArg(1)->nodetype = BTAST_MACRO;   
+                        zzmatch(NAME); 
+                        VALUE_NODE (BTAST_MACRO);   
                         zzCONSUME;
                     }
                     else {zzFAIL(1,zzerr5,&zzMissSet,&zzMissText,&zzBadTok,&zzBadText,&zzErrk); goto fail;}
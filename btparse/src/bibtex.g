@@ -69,6 +69,18 @@
 #include "my_dmalloc.h"
 
 extern char * InputFilename;            /* for zzcr_ast call in pccts/ast.c */
+extern boolean CheckOnly;               /* no value nodes wanted */
+
+/*
+ * Makes the AST node for a value token, unless parsing with
+ * BTO_CHECKONLY: then the token is just matched, with nothing allocated.
+ */
+#define VALUE_NODE(type)                                        \
+   if (!CheckOnly)                                              \
+   {                                                            \
+      zzsubchild (_root, &_sibling, &_tail);                    \
+      zzastArg(1)->nodetype = (type);                           \
+   }
 >>
 
 /*
@@ -349,7 +361,7 @@ entry        : << bt_metatype metatype; >>
  */
 body [bt_metatype metatype]
              : << metatype == BTE_COMMENT >>?
-               STRING     << #1->nodetype = BTAST_STRING; >>
+               STRING!    << VALUE_NODE (BTAST_STRING); >>
              | ENTRY_OPEN! contents[metatype] ENTRY_CLOSE!
              ;
 
@@ -382,11 +394,28 @@ contents [bt_metatype metatype]
 /*
  * `fields' is a comma-separated list of fields.  Note that BibTeX has a
  * little wart in that it allows a single extra comma after the last field
- * only.  This is easy enough to handle, we just have to do it in the
- * traditional BNFish way (loop by recursion) rather than use EBNF
- * trickery.
+ * only.  This used to be done in the traditional BNFish way (loop by
+ * recursion), but that uses a level of the attribute and AST stacks for
+ * every field, and blew them up with about 90 fields.  So now it's a
+ * loop, which we leave after a comma that isn't followed by a field; a
+ * second comma, or anything else that doesn't end the entry, is then a
+ * syntax error in `fields'.
  */
-fields       : field { COMMA! fields }
+fields       : field
+               ( COMMA!
+                 << if (LA(1) != NAME)
+                    {
+                       if (LA(1) != ENTRY_CLOSE)
+                       {
+                          zzFAIL(1,zzerr4,&zzMissSet,&zzMissText,
+                                 &zzBadTok,&zzBadText,&zzErrk);
+                          goto fail;
+                       }
+                       break;
+                    }
+                 >>
+                 field
+               )*
              | /* epsilon */
              ;
 
@@ -406,8 +435,12 @@ field        : NAME^
 /* `value' is a sequence of simple_values, joined by the '#' operator. */
 value        : simple_value ( HASH! simple_value )* ;
 
-/* `simple_value' is a single string, number, or macro invocation. */
-simple_value : STRING      << #1->nodetype = BTAST_STRING; >>
-             | NUMBER      << #1->nodetype = BTAST_NUMBER; >>
-             | NAME        << #1->nodetype = BTAST_MACRO; >>
+/*
+ * `simple_value' is a single string, number, or macro invocation.  Its
+ * node is made by hand (see VALUE_NODE), so that none is made at all when
+ * only checking the syntax.
+ */
+simple_value : STRING!     << VALUE_NODE (BTAST_STRING); >>
+             | NUMBER!     << VALUE_NODE (BTAST_NUMBER); >>
+             | NAME!       << VALUE_NODE (BTAST_MACRO); >>
              ;
@@ -40,6 +40,8 @@ typedef int boolean;
 
 #define BTO_NOSTORE   16
 
+#define BTO_CHECKONLY 32                /* validate only: build no values */
+
 #define BTO_FULL (BTO_CONVERT | BTO_EXPAND | BTO_PASTE | BTO_COLLAPSE)
 #define BTO_MACRO (BTO_CONVERT | BTO_EXPAND | BTO_PASTE)
 #define BTO_MINIMAL 0
@@ -134,12 +136,27 @@ typedef struct
 } bt_stringlist;
 
 
+typedef struct
+{
+   /* 
+    * Where a substring found by bt_split_spans() is in the string that
+    * was split: `length' bytes from `offset'.  Empty substrings have a
+    * `length' of 0.
+    */
+
+   int     offset;
+   int     length;
+} bt_span;
+
+
 typedef struct
 {
    bt_stringlist * tokens;              /* flat list of all tokens in name */
    char ** parts[BT_MAX_NAMEPARTS];     /* each elt. is list of pointers */
                                         /* into `tokens->string' */
    int     part_len[BT_MAX_NAMEPARTS];  /* length in tokens */
+   int     refcount;                    /* holders, if shared (see */
+                                        /* bt_split_name_cached()) */
 } bt_name;
 
 
@@ -147,6 +164,7 @@ typedef struct tex_tree_s
 {
    char * start;
    int    len;
+   int    depth;                        /* number of enclosing groups */
    struct tex_tree_s
         * child,
         * next;
@@ -202,11 +220,164 @@ typedef struct
    int         line;
    char *      item_desc;
    int         item;
-   char *      message;
+   char *      message;         /* NULL if not formatted yet */
+   char *      format;          /* private: see bt_error_message() */
+   void *      args;
 } bt_error;
 
 typedef void (*bt_err_handler) (bt_error *);
 
+/*
+ * An in-memory list of errors (see bt_set_errlist()).  The strings that
+ * each bt_error points to are copied into storage owned by the list, and
+ * remain valid until the list is cleared or freed.
+ */
+typedef struct bt_errblock_s bt_errblock;
+
+typedef struct
+{
+   int           num_errors;    /* number of errors recorded */
+   int           max_errors;    /* allocated size of `errors' */
+   bt_error *    errors;
+   boolean       echo;          /* also report errors in the usual way? */
+   bt_errblock * text;          /* private: storage for the strings */
+} bt_errlist;
+
+/*
+ * A filter for the regular entries read from a file (see
+ * bt_set_entry_filter()): called with the entry type (in lowercase) and
+ * key, returns false to skip the entry.
+ */
+typedef boolean (*bt_entry_filter) (char * type, char * key, void * data);
+
+/*
+ * An index for finding duplicate entries (see bt_dedup_new()); its
+ * contents are private to dedup.c.
+ */
+typedef struct bt_dedup_s bt_dedup;
+
+/*
+ * How bt_write_entry() and friends write entries: as BibTeX, or in the
+ * flat form of bibparse (a line for the type and key, then one for each
+ * field); how strings are quoted (BTW_QUOTES falls back to braces for
+ * strings with a '"' in them); and the fields to write first, in order.
+ */
+typedef enum
+{
+   BTW_BRACES,                  /* {string} */
+   BTW_QUOTES,                  /* "string" */
+   BTW_BARE                     /* string -- not BibTeX! */
+} bt_quotestyle;
+
+typedef struct
+{
+   boolean       flat;
+   bt_quotestyle quote;
+   char *        indent;        /* before each field name */
+   int           align;         /* pad field names to this width */
+   char **       field_order;
+   int           num_ordered;
+} bt_write_options;
+
+/*
+ * An index for resolving cross-references (see bt_xref_new()); its
+ * contents are private to crossref.c.
+ */
+typedef struct bt_xref_s bt_xref;
+
+typedef enum
+{
+   BTX_NONE,                    /* no crossref field */
+   BTX_RESOLVED,
+   BTX_MISSING,                 /* crossref'd entry not found */
+   BTX_CYCLE                    /* crossrefs go round in circles */
+} bt_xref_status;
+
+/*
+ * The raw text of an entry, as read by bt_read_entry_text(); the reader
+ * itself is private to reader.c.
+ */
+typedef struct bt_reader_s bt_reader;
+
+typedef struct
+{
+   char *       text;           /* from the '@' to the closing delimiter */
+   int          length;
+   long         offset;         /* of the '@', in bytes, in the file */
+   int          line;           /* of the '@' */
+   bt_metatype  metatype;       /* going by the entry type only */
+   char *       key;            /* in text, for a regular entry (or NULL) */
+   int          key_length;
+   int          junk;           /* characters of junk before the entry */
+} bt_entry_text;
+
+/*
+ * What bt_merge_entries() does with an entry whose key has already been
+ * written (see bt_merge_new()); the merge itself is private to merge.c.
+ */
+typedef enum
+{
+   BTM_FIRST,                   /* skip it: the first entry wins */
+   BTM_RENAME,                  /* give it a new key: key-2, key-3, ... */
+   BTM_REPORT                   /* write it anyway */
+} bt_merge_policy;
+
+typedef struct bt_merge_s bt_merge;
+
+/*
+ * The entries cited by a LaTeX document, found in its .aux files, and
+ * where they (and the macros they use) are in the .bib files (see
+ * bt_extract_new()); private to extract.c.
+ */
+typedef struct bt_extract_s bt_extract;
+
+/*
+ * How bt_json_entry() writes entries: as plain JSON (every entry, and
+ * every field), or as CSL-JSON items (regular entries only); and
+ * whether their TeX is converted to Unicode first.
+ */
+typedef enum
+{
+   BTJS_PLAIN,
+   BTJS_CSL
+} bt_json_style;
+
+typedef struct
+{
+   bt_json_style style;
+   boolean       unicode;
+} bt_json_options;
+
+/*
+ * A full-text index being built (see bt_index_new()), and a search of
+ * one that has been written (see bt_search_open()); both private to
+ * index.c.
+ */
+typedef struct bt_index_s bt_index;
+typedef struct bt_search_s bt_search;
+
+/*
+ * A compiled query on the fields of entries (see bt_query_new()),
+ * private to query.c; and what bt_query_file() writes for each entry
+ * that matches one.
+ */
+typedef struct bt_query_s bt_query;
+
+typedef enum
+{
+   BTQ_KEYS,                            /* its key */
+   BTQ_RANGES,                          /* its byte offset and length */
+   BTQ_ENTRIES                          /* its text */
+} bt_query_output;
+
+/* A growable string (see write.c); initialize to all zeroes */
+typedef struct
+{
+   char *  text;
+   int     length;
+   int     size;
+} bt_buffer;
+
 
 #if defined(__cplusplus__) || defined(__cplusplus) || defined(c_plusplus)
 extern "C" {
@@ -244,6 +415,8 @@ void  bt_cleanup (void);
 
 /* input.c */
 void    bt_set_stringopts (bt_metatype metatype, btshort options);
+void    bt_set_projection (char ** fields, int num_fields);
+void    bt_set_entry_filter (bt_entry_filter filter, void * data);
 AST * bt_parse_entry_s (char *    entry_text,
                         char *    filename,
                         int       line,
@@ -253,12 +426,16 @@ AST * bt_parse_entry   (FILE *    infile,
                         char *    filename,
                         btshort    options,
                         boolean * status);
+AST * bt_parse_next_entry (bt_reader * reader,
+                          char *      filename,
+                          btshort     options,
+                          boolean *   status);
 AST * bt_parse_file    (char *    filename, 
                         btshort    options, 
                         boolean * overall_status);
 
 /* post_parse.c */
-void bt_postprocess_string (char * s, btshort options);
+int  bt_postprocess_string (char * s, btshort options);
 char * bt_postprocess_value (AST * value, btshort options, boolean replace);
 char * bt_postprocess_field (AST * field, btshort options, boolean replace);
 void bt_postprocess_entry (AST * entry, btshort options);
@@ -268,6 +445,12 @@ void   bt_reset_error_counts (void);
 int    bt_get_error_count (bt_errclass errclass);
 int *  bt_get_error_counts (int *counts);
 btshort bt_error_status (int *saved_counts);
+bt_errlist * bt_new_errlist (boolean echo);
+void   bt_clear_errlist (bt_errlist * list);
+void   bt_free_errlist (bt_errlist * list);
+bt_errlist * bt_set_errlist (bt_errlist * list);
+char * bt_error_message (bt_errlist * list, bt_error * err);
+int    bt_format_error (bt_error * err, char * buf, int size);
 
 /* macros.c */
 void bt_add_macro_value (AST *assignment, btshort options);
@@ -295,6 +478,12 @@ void bt_set_text (AST * node, char * new_text);
 void bt_entry_set_key (AST * entry, char * new_key);
 
 /* names.c */
+bt_span * bt_split_spans (char *   string,
+                          char *   delim,
+                          char *   filename,
+                          int      line,
+                          char *   description,
+                          int *    num_spans);
 bt_stringlist * bt_split_list (char *   string,
                                char *   delim,
                                char *   filename,
@@ -306,17 +495,115 @@ bt_name * bt_split_name (char *  name,
                          int     line,
                          int     name_num);
 void bt_free_name (bt_name * name);
+void bt_set_name_cache (int size);
+bt_name * bt_split_name_cached (char *  name,
+                                char *  filename,
+                                int     line,
+                                int     name_num);
+void bt_name_cache_stats (unsigned long * hits, unsigned long * misses);
 
 /* tex_tree.c */
 bt_tex_tree * bt_build_tex_tree (char * string);
 void          bt_free_tex_tree (bt_tex_tree **top);
 void          bt_dump_tex_tree (bt_tex_tree *node, int depth, FILE *stream);
 char *        bt_flatten_tex_tree (bt_tex_tree *top);
+bt_tex_tree * bt_rebuild_tex_tree (bt_tex_tree *top, char * string);
+int           bt_tex_depth (bt_tex_tree *top, int offset);
+boolean       bt_tex_protected (bt_tex_tree *top, int offset);
+bt_tex_tree * bt_tex_span (bt_tex_tree *top, int offset);
 
 /* string_util.c */
 void bt_purify_string (char * string, btshort options);
 void bt_change_case (char transform, char * string, btshort options);
 
+/* dedup.c */
+char *     bt_fingerprint (char * title, char * names, char * year);
+bt_dedup * bt_dedup_new (int bands, int rows, double threshold);
+int        bt_dedup_add (bt_dedup * index, char * fingerprint);
+int        bt_dedup_cluster (bt_dedup * index, int id);
+double     bt_dedup_similarity (bt_dedup * index, int id1, int id2);
+int        bt_dedup_count (bt_dedup * index);
+void       bt_dedup_free (bt_dedup * index);
+
+/* crossref.c */
+bt_xref *      bt_xref_new (int min_crossrefs);
+void           bt_xref_add_rule (bt_xref * xref,
+                                 char * child_type, char * parent_type,
+                                 char * parent_field, char * child_field);
+void           bt_xref_index (bt_xref * xref, AST * entry);
+int            bt_xref_index_file (bt_xref * xref, FILE * infile,
+                                   char * filename);
+bt_xref_status bt_xref_resolve (bt_xref * xref, AST * entry);
+int            bt_xref_children (bt_xref * xref, char * key);
+void           bt_xref_free (bt_xref * xref);
+
+/* write.c */
+void bt_write_entry (FILE * stream, AST * entry, bt_write_options * options);
+void bt_write_entry_s (bt_buffer * buf, AST * entry,
+                       bt_write_options * options);
+void bt_write_head (bt_buffer * buf, bt_metatype metatype,
+                    char * type, char * key, bt_write_options * options);
+void bt_write_field (bt_buffer * buf, char * name, int num_values,
+                     bt_nodetype * types, char ** texts,
+                     bt_write_options * options);
+void bt_write_tail (bt_buffer * buf, bt_write_options * options);
+void bt_free_buffer (bt_buffer * buf);
+
+/* reader.c */
+bt_reader * bt_open_reader (FILE * infile);
+boolean     bt_set_reader_range (bt_reader * reader, long start, long end,
+                                 int line);
+boolean     bt_read_entry_text (bt_reader * reader, bt_entry_text * entry);
+void        bt_close_reader (bt_reader * reader);
+
+/* merge.c */
+bt_merge * bt_merge_new (bt_merge_policy policy);
+int        bt_merge_strings (bt_merge * merge, FILE * infile,
+                             char * filename, FILE * outfile);
+int        bt_merge_entries (bt_merge * merge, FILE * infile,
+                             char * filename, FILE * outfile);
+int        bt_merge_conflicts (bt_merge * merge);
+void       bt_merge_free (bt_merge * merge);
+
+/* extract.c */
+bt_extract * bt_extract_new (void);
+void         bt_extract_cite (bt_extract * extract, char * key);
+int          bt_extract_aux (bt_extract * extract, char * auxname);
+char **      bt_extract_bibdata (bt_extract * extract, int * num_names);
+int          bt_extract_file (bt_extract * extract, char * filename);
+int          bt_extract_write (bt_extract * extract, FILE * outfile);
+void         bt_extract_free (bt_extract * extract);
+
+/* index.c */
+bt_index *  bt_index_new (char ** fields, int num_fields);
+int         bt_index_file (bt_index * index, FILE * infile, char * filename);
+int         bt_index_range (bt_index * index, FILE * infile, char * filename,
+                            long start, long end);
+int         bt_index_merge (bt_index * index, char * indexname);
+int         bt_index_write (bt_index * index, char * indexname);
+void        bt_index_free (bt_index * index);
+bt_search * bt_search_open (char * indexname);
+long *      bt_search_query (bt_search * search, char * query,
+                             int * num_results);
+char *      bt_search_filename (bt_search * search);
+void        bt_search_close (bt_search * search);
+
+/* query.c */
+bt_query * bt_query_new (char * text);
+char **    bt_query_fields (bt_query * query, int * num_fields);
+boolean    bt_query_match (bt_query * query, AST * entry);
+int        bt_query_file (bt_query * query, FILE * infile, char * filename,
+                          bt_query_output output, FILE * outfile);
+void       bt_query_free (bt_query * query);
+
+/* json.c */
+boolean bt_json_entry (FILE * stream, AST * entry, bt_json_options * options);
+boolean bt_json_entry_s (bt_buffer * buf, AST * entry,
+                         bt_json_options * options);
+
+/* tex_unicode.c */
+char * bt_tex_to_unicode (char * string);
+
 /* format_name.c */
 bt_name_format * bt_create_name_format (char * parts, boolean abbrev_first);
 void bt_free_name_format (bt_name_format * format);
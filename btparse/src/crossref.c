@@ -0,0 +1,834 @@
+/* ------------------------------------------------------------------------
+@NAME       : crossref.c
+@DESCRIPTION: Resolving cross-references (the `crossref' field) between
+              entries, in one or more files:
+                bt_xref_new
+                bt_xref_add_rule
+                bt_xref_index
+                bt_xref_index_file
+                bt_xref_resolve
+                bt_xref_children
+                bt_xref_free
+
+              Resolving takes two passes over the entries.  The first
+              (bt_xref_index()) builds an index of entry keys, counts
+              the children of every entry, and keeps a copy of the
+              fields of every parent -- reading again, at the end of
+              each file, the parents that came before their first
+              child (which BibTeX doesn't allow).  The second
+              (bt_xref_resolve(), as the entries are read again) merges
+              the parents' fields into their children, one entry at a
+              time; only the index and the parents are held in memory.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse library.  This library is
+              free software; you can redistribute it and/or modify it under
+              the terms of the GNU Library General Public License as
+              published by the Free Software Foundation; either version 2
+              of the License, or (at your option) any later version.
+-------------------------------------------------------------------------- */
+
+#include "bt_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "btparse.h"
+#include "prototypes.h"
+#include "error.h"
+#include "my_dmalloc.h"
+#include "bt_debug.h"
+
+
+#define DEFAULT_MIN_CROSSREFS  2
+
+extern btshort StringOptions[];         /* from input.c */
+
+/*
+ * A field copied from a parent entry: its name, and its simple values
+ * (as they were when it was copied, so normally not yet post-processed).
+ */
+typedef struct
+{
+   bt_nodetype  type;
+   char *       text;
+} xvalue;
+
+typedef struct
+{
+   char *    name;
+   int       num_values;
+   xvalue *  values;
+} xfield;
+
+/*
+ * Everything known about one key: whether an entry with that key has
+ * been seen, the key it cross-references, how many entries
+ * cross-reference it, and (for parents) a copy of its type and fields.
+ */
+typedef struct
+{
+   char *    key;                       /* lowercased */
+   int       parent;                    /* id of crossref'd key, or -1 */
+   int       children;
+   boolean   defined;
+   char *    type;                      /* NULL until copied */
+   int       num_fields;
+   xfield *  fields;
+   int       visited;                   /* for finding cycles */
+   int       file;                      /* into `filenames', or -1 */
+   long      offset;                    /* of its text in that file */
+} xentry;
+
+typedef struct
+{
+   char *    child_type;                /* NULL for any */
+   char *    parent_type;               /* NULL for any */
+   char *    parent_field;              /* NULL for any */
+   char *    child_field;               /* NULL: not inherited */
+} xrule;
+
+struct bt_xref_s
+{
+   int       min_crossrefs;
+   int       count;                     /* keys known */
+   int       alloc;
+   xentry *  entries;
+   htable    table;                     /* of entries, by key */
+   int       num_rules;
+   xrule *   rules;
+   int       stamp;                     /* for `visited' */
+   int       num_files;
+   char **   filenames;                 /* indexed by bt_xref_index_file() */
+   int       num_pending;
+   int *     pending;                   /* parents to read again */
+};
+
+
+/* ------------------------------------------------------------------------
+ * The key index
+ */
+
+static boolean
+same_key (char * lowered, char * key)
+{
+   for ( ; *key; lowered++, key++)
+   {
+      if (*lowered != tolower ((unsigned char) *key))
+         return FALSE;
+   }
+   return *lowered == (char) 0;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : lookup()
+@INPUT      : xref
+              key    - in any case
+              create - whether to add the key if it's not there
+@RETURNS    : the id of the key, or -1 if it's not known (and `create'
+              is false)
+@DESCRIPTION: Finds a key in the index, ignoring case as BibTeX does.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static int
+lookup (bt_xref * xref, char * key, boolean create)
+{
+   unsigned long  hash[2];
+   int            slot, id;
+   xentry *       entry;
+
+   hash_text (key, strlen (key), hash);
+   slot = -1;
+   while ((id = htable_find (&xref->table, hash[0], &slot)) >= 0)
+   {
+      if (same_key (xref->entries[id].key, key))
+         return id;
+   }
+   if (!create)
+      return -1;
+
+   if (xref->count == xref->alloc)
+   {
+      xref->alloc = xref->alloc ? 2 * xref->alloc : 256;
+      xref->entries = (xentry *)
+         realloc (xref->entries, xref->alloc * sizeof (xentry));
+   }
+
+   id = xref->count++;
+   entry = &xref->entries[id];
+   memset (entry, 0, sizeof (xentry));
+   entry->key = strlwr (strdup (key));
+   entry->parent = -1;
+   entry->num_fields = -1;
+   entry->file = -1;
+   htable_add (&xref->table, hash[0], id);
+   return id;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Looking at entries
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : crossref_of()
+@INPUT      : entry - a regular entry
+@OUTPUT     : *field - its crossref field (if not NULL)
+@RETURNS    : the key it cross-references (newly allocated, with
+              surrounding whitespace removed), or NULL
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static char *
+crossref_of (AST * entry, AST ** field)
+{
+   AST *   cur;
+   char *  name;
+   char *  key;
+   char *  start;
+   char *  end;
+
+   cur = NULL;
+   while ((cur = bt_next_field (entry, cur, &name)))
+   {
+      if (strcmp (name, "crossref") == 0)
+         break;
+   }
+   if (field) *field = cur;
+   if (cur == NULL || (key = bt_get_text (cur)) == NULL)
+      return NULL;
+
+   for (start = key; isspace ((unsigned char) *start); start++)
+      ;
+   for (end = start + strlen (start);
+        end > start && isspace ((unsigned char) end[-1]);
+        end--)
+      ;
+   if (end == start)
+   {
+      free (key);
+      return NULL;
+   }
+   *end = (char) 0;
+   memmove (key, start, end - start + 1);
+   return key;
+}
+
+
+static boolean
+has_field (AST * entry, char * name)
+{
+   AST *   cur;
+   char *  field;
+
+   cur = NULL;
+   while ((cur = bt_next_field (entry, cur, &field)))
+   {
+      if (strcmp (field, name) == 0)
+         return TRUE;
+   }
+   return FALSE;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : copy_fields()
+@INPUT      : copy  - where to keep the copy
+              entry - a regular entry (whose key is copy->key)
+@DESCRIPTION: Copies the type and fields of a parent entry, for
+              merging into its children later.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static void
+copy_fields (xentry * copy, AST * entry)
+{
+   AST *        field;
+   AST *        value;
+   char *       name;
+   char *       text;
+   bt_nodetype  type;
+   int          num, i, j;
+
+   num = 0;
+   field = NULL;
+   while ((field = bt_next_field (entry, field, &name)))
+      num++;
+
+   copy->type = strdup (bt_entry_type (entry));
+   copy->num_fields = num;
+   copy->fields = (xfield *) malloc ((num ? num : 1) * sizeof (xfield));
+
+   field = NULL;
+   for (i = 0; (field = bt_next_field (entry, field, &name)); i++)
+   {
+      num = 0;
+      value = NULL;
+      while ((value = bt_next_value (field, value, NULL, NULL)))
+         num++;
+
+      copy->fields[i].name = strdup (name);
+      copy->fields[i].num_values = num;
+      copy->fields[i].values =
+         (xvalue *) malloc ((num ? num : 1) * sizeof (xvalue));
+      value = NULL;
+      for (j = 0; (value = bt_next_value (field, value, &type, &text)); j++)
+      {
+         copy->fields[i].values[j].type = type;
+         copy->fields[i].values[j].text = strdup (text ? text : "");
+      }
+   }
+}
+
+
+/* ------------------------------------------------------------------------
+ * Creating and filling the index
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_xref_new()
+@INPUT      : min_crossrefs - how many children a parent must have for
+                              them to keep their crossref fields (as
+                              BibTeX's min-crossrefs); 0 means 2
+@RETURNS    : a new, empty index
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+bt_xref * bt_xref_new (int min_crossrefs)
+{
+   bt_xref *  xref;
+
+   xref = (bt_xref *) calloc (1, sizeof (bt_xref));
+   xref->min_crossrefs =
+      min_crossrefs > 0 ? min_crossrefs : DEFAULT_MIN_CROSSREFS;
+   return xref;
+}
+
+
+static char *
+rule_name (char * name)
+{
+   if (name == NULL || strcmp (name, "*") == 0)
+      return NULL;
+   return strlwr (strdup (name));
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_xref_add_rule()
+@INPUT      : xref
+              child_type   - type of the child entry ("*" or NULL: any)
+              parent_type  - type of the parent entry ("*" or NULL: any)
+              parent_field - field of the parent ("*" or NULL: any)
+              child_field  - name it is inherited under; NULL if it is
+                             not to be inherited at all, and "*" for the
+                             same name as in the parent
+@DESCRIPTION: Adds a rule for inheriting fields.  For each field of a
+              parent, the first rule that matches decides; fields that
+              no rule matches are inherited under their own names.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_xref_add_rule (bt_xref * xref,
+                       char *    child_type,
+                       char *    parent_type,
+                       char *    parent_field,
+                       char *    child_field)
+{
+   xrule *  rule;
+
+   xref->rules = (xrule *)
+      realloc (xref->rules, (xref->num_rules + 1) * sizeof (xrule));
+   rule = &xref->rules[xref->num_rules++];
+   rule->child_type = rule_name (child_type);
+   rule->parent_type = rule_name (parent_type);
+   rule->parent_field = rule_name (parent_field);
+   if (child_field == NULL)
+      rule->child_field = NULL;
+   else if (strcmp (child_field, "*") == 0 && rule->parent_field)
+      rule->child_field = strdup (rule->parent_field);
+   else
+      rule->child_field = strlwr (strdup (child_field));
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : index_entry()
+@INPUT      : xref
+              entry  - an entry (not necessarily regular)
+              file   - where it is: the index of its file in
+                       xref->filenames, or -1 if it's not known
+              offset
+@DESCRIPTION: Adds an entry to the index, keeping a copy of its fields
+              if it is known to be a parent by now.  A parent indexed
+              before its first child is copied later, by copy_pending(),
+              if it's known where it is.  If the same key is used twice,
+              the first entry wins.
+@CALLS      : lookup(), copy_fields()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static void
+index_entry (bt_xref * xref, AST * entry, int file, long offset)
+{
+   char *    key;
+   char *    target;
+   int       id, parent;
+   xentry *  p;
+
+   if (entry == NULL || bt_entry_metatype (entry) != BTE_REGULAR ||
+       (key = bt_entry_key (entry)) == NULL)
+      return;
+
+   id = lookup (xref, key, TRUE);
+   if (xref->entries[id].defined)
+      return;
+   xref->entries[id].defined = TRUE;
+   xref->entries[id].file = file;
+   xref->entries[id].offset = offset;
+
+   if ((target = crossref_of (entry, NULL)) != NULL)
+   {
+      parent = lookup (xref, target, TRUE);
+      xref->entries[id].parent = parent;
+      p = &xref->entries[parent];
+      if (p->children++ == 0 && p->defined && p->file >= 0)
+      {
+         xref->pending = (int *)
+            realloc (xref->pending, (xref->num_pending+1) * sizeof (int));
+         xref->pending[xref->num_pending++] = parent;
+      }
+      free (target);
+   }
+
+   if (xref->entries[id].children > 0)
+      copy_fields (&xref->entries[id], entry);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_xref_index()
+@INPUT      : xref
+              entry - an entry, as returned by bt_parse_entry() and
+                      friends (entries that are not regular are
+                      ignored)
+@DESCRIPTION: The first pass: adds an entry to the index, and, if it
+              is known to be a parent by now, keeps a copy of its
+              fields.  If the same key is used twice, the first entry
+              wins.  A parent added here before its first child can't
+              be read again, so it is only copied when it is passed to
+              bt_xref_resolve().
+@CALLS      : index_entry()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_xref_index (bt_xref * xref, AST * entry)
+{
+   index_entry (xref, entry, -1, -1L);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : copy_pending()
+@INPUT      : xref
+              infile - the file just indexed (the last in xref->filenames)
+@RETURNS    : the number of entries parsed
+@DESCRIPTION: Copies the fields of the parents that were indexed before
+              their first child, reading each again from where it is:
+              from `infile', or from an earlier file, opened again by
+              name.  A parent that can't be read again (its file is
+              gone, or isn't seekable) is left to bt_xref_resolve().
+@CALLS      : bt_read_entry_text(), bt_parse_entry_s(), copy_fields()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static int
+copy_pending (bt_xref * xref, FILE * infile)
+{
+   xentry *       parent;
+   FILE *         file;
+   bt_reader *    reader;
+   bt_entry_text  text;
+   AST *          entry;
+   boolean        status;
+   int            i, parsed;
+
+   parsed = 0;
+   for (i = 0; i < xref->num_pending; i++)
+   {
+      parent = &xref->entries[xref->pending[i]];
+      if (parent->num_fields >= 0)
+         continue;
+      if (parent->file == xref->num_files - 1)
+         file = infile;
+      else if ((file = fopen (xref->filenames[parent->file], "r")) == NULL)
+         continue;
+
+      if (fseek (file, parent->offset, SEEK_SET) == 0)
+      {
+         reader = bt_open_reader (file);
+         if (bt_read_entry_text (reader, &text))
+         {
+            entry = bt_parse_entry_s (text.text,
+                                      xref->filenames[parent->file],
+                                      text.line, BTO_NOSTORE, &status);
+            parsed++;
+            if (entry)
+            {
+               copy_fields (parent, entry);
+               bt_free_ast (entry);
+            }
+         }
+         bt_close_reader (reader);
+      }
+      if (file != infile)
+         fclose (file);
+   }
+
+   free (xref->pending);
+   xref->pending = NULL;
+   xref->num_pending = 0;
+   return parsed;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_xref_index_file()
+@INPUT      : xref
+              infile   - file to read (to the end)
+              filename - its name (for error messages, and for reading
+                         it again)
+@RETURNS    : the number of entries read
+@DESCRIPTION: Does the first pass over a whole file.  Entries are read
+              with no string processing, and without storing macros
+              (which are expanded in parents' fields when these are
+              merged into their children); errors are not reported,
+              since they will be when the file is read again.  Parents
+              that came before their first child (here or in an
+              earlier file) are read again at the end, so that by the
+              time the last file is indexed, every parent is copied.
+@GLOBALS    : StringOptions
+@CALLS      : bt_read_entry_text(), bt_parse_entry_s(), index_entry(),
+              copy_pending()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_xref_index_file (bt_xref * xref, FILE * infile, char * filename)
+{
+   btshort        saved[NUM_METATYPES];
+   bt_errlist *   quiet, * previous;
+   bt_reader *    reader;
+   bt_entry_text  text;
+   AST *          entry;
+   boolean        status;
+   int            file, count, parsed;
+
+   file = xref->num_files++;
+   xref->filenames = (char **)
+      realloc (xref->filenames, xref->num_files * sizeof (char *));
+   xref->filenames[file] = strdup (filename ? filename : "(unknown)");
+
+   save_stringopts (saved, BTO_MINIMAL);
+   quiet = bt_new_errlist (FALSE);
+   previous = bt_set_errlist (quiet);
+   reader = bt_open_reader (infile);
+
+   count = parsed = 0;
+   while (bt_read_entry_text (reader, &text))
+   {
+      count++;
+      if (text.metatype != BTE_REGULAR)
+         continue;
+      entry = bt_parse_entry_s (text.text, filename, text.line,
+                                BTO_NOSTORE, &status);
+      parsed++;
+      index_entry (xref, entry, file, text.offset);
+      bt_free_ast (entry);
+   }
+   bt_close_reader (reader);
+   parsed += copy_pending (xref, infile);
+
+   if (parsed)                          /* clean up after the parser */
+      bt_parse_entry_s (NULL, NULL, 0, 0, NULL);
+   bt_set_errlist (previous);
+   bt_free_errlist (quiet);
+   restore_stringopts (saved);
+   return count;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Resolving
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : inherited_name()
+@INPUT      : xref
+              child_type, parent_type
+              field       - name of a field of the parent
+@RETURNS    : the name the child inherits the field under, or NULL if it
+              doesn't inherit it
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static char *
+inherited_name (bt_xref * xref,
+                char *    child_type,
+                char *    parent_type,
+                char *    field)
+{
+   xrule *  rule;
+   int      i;
+
+   if (strcmp (field, "crossref") == 0)
+      return NULL;
+
+   for (i = 0; i < xref->num_rules; i++)
+   {
+      rule = &xref->rules[i];
+      if ((rule->child_type && strcmp (rule->child_type, child_type) != 0) ||
+          (rule->parent_type && strcmp (rule->parent_type, parent_type) != 0) ||
+          (rule->parent_field && strcmp (rule->parent_field, field) != 0))
+         continue;
+      if (rule->child_field == NULL)
+         return NULL;
+      return rule->parent_field ? rule->child_field : field;
+   }
+   return field;
+}
+
+
+static AST *
+new_node (bt_nodetype nodetype, char * text, AST * like)
+{
+   AST *  node;
+
+   node = (AST *) calloc (1, sizeof (AST));
+   node->nodetype = nodetype;
+   node->text = strdup (text);
+   node->filename = like->filename;
+   node->line = like->line;
+   return node;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : inherit()
+@INPUT      : xref
+              entry  - the child
+              parent - copy of a parent (or grandparent...)
+              tail   - last field node of the child
+@RETURNS    : the new last field node of the child
+@DESCRIPTION: Appends to `entry' the fields of `parent' that it should
+              inherit and doesn't have yet, post-processed in the same
+              way as the entry itself was.
+@GLOBALS    : StringOptions
+@CALLS      : inherited_name(), bt_postprocess_field()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static AST *
+inherit (bt_xref * xref, AST * entry, xentry * parent, AST * tail)
+{
+   xfield *  field;
+   char *    name;
+   AST *     node;
+   AST *     value, * last;
+   int       i, j;
+
+   for (i = 0; i < parent->num_fields; i++)
+   {
+      field = &parent->fields[i];
+      name = inherited_name (xref, bt_entry_type (entry), parent->type,
+                             field->name);
+      if (name == NULL || has_field (entry, name))
+         continue;
+
+      node = new_node (BTAST_FIELD, name, entry);
+      last = NULL;
+      for (j = 0; j < field->num_values; j++)
+      {
+         value = new_node (field->values[j].type, field->values[j].text,
+                           entry);
+         if (last) last->right = value;
+         else node->down = value;
+         last = value;
+      }
+      bt_postprocess_field (node, StringOptions[BTE_REGULAR] | BTO_NOSTORE,
+                            TRUE);
+
+      if (tail) tail->right = node;
+      else entry->down = node;
+      tail = node;
+   }
+   return tail;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_xref_resolve()
+@INPUT      : xref
+              entry - an entry, as returned by bt_parse_entry() and
+                      friends
+@OUTPUT     : entry - with its parents' fields merged in
+@RETURNS    : BTX_NONE if the entry has no crossref field (or isn't a
+              regular entry); BTX_RESOLVED if it was resolved; or
+              BTX_MISSING or BTX_CYCLE if it couldn't be (which is
+              also reported as an error of class BTERR_CONTENT)
+@DESCRIPTION: The second pass.  Fields the entry doesn't have are
+              inherited from its parent, then from its parent's parent,
+              and so on, as the rules say (see bt_xref_add_rule()).  If
+              the parent has fewer than min_crossrefs children, the
+              crossref field is then dropped, as BibTeX does -- the
+              entry stands on its own.
+
+              A parent that came before its children, and couldn't be
+              read again in the first pass (it was given to
+              bt_xref_index(), or its file wasn't seekable), has its
+              fields copied now, as it is passed here: so its children
+              only inherit from it if it is passed here too, whole.
+@CALLS      : copy_fields(), inherit()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+bt_xref_status bt_xref_resolve (bt_xref * xref, AST * entry)
+{
+   char *    key;
+   char *    target;
+   AST *     crossref;
+   AST *     tail;
+   AST **    link;
+   int       id, parent, p;
+
+   if (entry == NULL || bt_entry_metatype (entry) != BTE_REGULAR ||
+       (key = bt_entry_key (entry)) == NULL)
+      return BTX_NONE;
+
+   id = lookup (xref, key, FALSE);
+   if (id >= 0 && xref->entries[id].children > 0 &&
+       xref->entries[id].num_fields < 0)
+      copy_fields (&xref->entries[id], entry);
+
+   if ((target = crossref_of (entry, &crossref)) == NULL)
+      return BTX_NONE;
+
+   parent = lookup (xref, target, FALSE);
+   if (parent < 0 || !xref->entries[parent].defined)
+   {
+      ast_error (BTERR_CONTENT, entry,
+                 "crossref to undefined entry \"%s\"", target);
+      free (target);
+      return BTX_MISSING;
+   }
+   if (xref->entries[parent].num_fields < 0)
+   {
+      ast_error (BTERR_CONTENT, entry,
+                 "crossref'd entry \"%s\" came before its children, "
+                 "and its fields weren't kept", target);
+      free (target);
+      return BTX_MISSING;
+   }
+
+   /* Follow the chain of parents, looking for a cycle */
+   xref->stamp++;
+   if (id >= 0)
+      xref->entries[id].visited = xref->stamp;
+   for (p = parent; p >= 0; p = xref->entries[p].parent)
+   {
+      if (xref->entries[p].visited == xref->stamp)
+      {
+         ast_error (BTERR_CONTENT, entry,
+                    "crossref cycle through entry \"%s\"",
+                    xref->entries[p].key);
+         free (target);
+         return BTX_CYCLE;
+      }
+      xref->entries[p].visited = xref->stamp;
+   }
+
+   tail = NULL;
+   for (link = &entry->down; *link != NULL; link = &(*link)->right)
+      tail = *link;
+   for (p = parent;
+        p >= 0 && xref->entries[p].num_fields >= 0;
+        p = xref->entries[p].parent)
+      tail = inherit (xref, entry, &xref->entries[p], tail);
+
+   if (xref->entries[parent].children < xref->min_crossrefs)
+   {
+      for (link = &entry->down; *link != crossref; link = &(*link)->right)
+         ;
+      *link = crossref->right;
+      crossref->right = NULL;
+      bt_free_ast (crossref);
+   }
+
+   free (target);
+   return BTX_RESOLVED;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_xref_children()
+@INPUT      : xref
+              key
+@RETURNS    : the number of entries (in the first pass) that
+              cross-reference `key'
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_xref_children (bt_xref * xref, char * key)
+{
+   int  id = lookup (xref, key, FALSE);
+
+   return id >= 0 ? xref->entries[id].children : 0;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_xref_free()
+@INPUT      : xref
+@DESCRIPTION: Frees an index, and all the parent fields kept in it.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_xref_free (bt_xref * xref)
+{
+   xentry *  entry;
+   int       i, j, k;
+
+   for (i = 0; i < xref->count; i++)
+   {
+      entry = &xref->entries[i];
+      free (entry->key);
+      if (entry->type) free (entry->type);
+      for (j = 0; j < entry->num_fields; j++)
+      {
+         free (entry->fields[j].name);
+         for (k = 0; k < entry->fields[j].num_values; k++)
+            free (entry->fields[j].values[k].text);
+         free (entry->fields[j].values);
+      }
+      if (entry->num_fields >= 0)
+         free (entry->fields);
+   }
+   for (i = 0; i < xref->num_rules; i++)
+   {
+      if (xref->rules[i].child_type) free (xref->rules[i].child_type);
+      if (xref->rules[i].parent_type) free (xref->rules[i].parent_type);
+      if (xref->rules[i].parent_field) free (xref->rules[i].parent_field);
+      if (xref->rules[i].child_field) free (xref->rules[i].child_field);
+   }
+   free (xref->rules);
+   for (i = 0; i < xref->num_files; i++)
+      free (xref->filenames[i]);
+   free (xref->filenames);
+   free (xref->pending);
+   free (xref->entries);
+   htable_free (&xref->table);
+   free (xref);
+}
@@ -0,0 +1,600 @@
+/* ------------------------------------------------------------------------
+@NAME       : dedup.c
+@DESCRIPTION: Finding duplicate entries, across any number of files:
+                bt_fingerprint
+                bt_dedup_new
+                bt_dedup_add
+                bt_dedup_cluster
+                bt_dedup_similarity
+                bt_dedup_count
+                bt_dedup_free
+
+              An entry's fingerprint is a normalized form of its title,
+              the last names of its authors, and its year.  Entries are
+              added to an index one at a time; entries whose
+              fingerprints are the same, or similar enough (as
+              estimated by MinHash over the character trigrams of the
+              fingerprints, with locality-sensitive hashing to find the
+              candidates), are joined into clusters as they are added.
+              The index never keeps the fingerprints themselves.  With
+              the default 10 bands, it takes about 200 bytes per entry
+              for the entry's hashes and chains, and 11 hash table keys
+              (one for the exact hash, one per band) at 16 bytes a slot,
+              with the tables between a quarter and half full: about
+              550 to 900 bytes per entry in all.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse library.  This library is
+              free software; you can redistribute it and/or modify it under
+              the terms of the GNU Library General Public License as
+              published by the Free Software Foundation; either version 2
+              of the License, or (at your option) any later version.
+-------------------------------------------------------------------------- */
+
+#include "bt_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "btparse.h"
+#include "prototypes.h"
+#include "error.h"
+#include "my_dmalloc.h"
+#include "bt_debug.h"
+
+
+#define MAX_NAMES       8       /* names used in a fingerprint */
+#define MAX_CANDIDATES  64      /* entries looked at per LSH bucket */
+#define SIGNATURE_SIZE  128     /* minhashes kept to estimate similarity */
+
+#define HASH32(h)  ((h) & 0xffffffffUL)
+
+/*
+ * One hash table maps the exact hash of a fingerprint, and another the
+ * hash of each band of a MinHash signature, to the most recently added
+ * entry with that hash; the others are chained through `exact_next' and
+ * `band_next'.
+ */
+struct bt_dedup_s
+{
+   int      bands;                      /* LSH parameters: the signature */
+   int      rows;                       /* is bands * rows minhashes */
+   double   threshold;                  /* least similarity for a match */
+   int      num_hashes;                 /* bands*rows + SIGNATURE_SIZE */
+   unsigned long * seeds;               /* one per minhash */
+
+   int      count;                      /* entries added */
+   int      alloc;                      /* entries allocated for */
+   unsigned long  * exact;              /* 2 per entry: exact hash */
+   unsigned char * signature;           /* SIGNATURE_SIZE per entry: low */
+                                        /* 8 bits of each minhash */
+   int *    parent;                     /* union-find forest */
+   int *    exact_next;                 /* chains of the hash tables */
+   int *    band_next;                  /* (bands per entry) */
+   int *    compared;                   /* last entry each was compared */
+                                        /* with (as a candidate) */
+
+   htable   exact_table;
+   htable   band_table;
+};
+
+
+/* ------------------------------------------------------------------------
+ * Normalizing fields into a fingerprint
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : append_folded()
+@INPUT      : text   - a field value (or part of one)
+@INOUT      : buf    - where the fingerprint is being built
+@DESCRIPTION: Folds `text' with fold_text() and appends its words to
+              `buf', separated by single spaces -- and by a space from
+              any words already appended since the last '|'.
+@CALLS      : fold_text()
+@CREATED    : 2026/10/19
+@MODIFIED   : 2026/10/19: folds with fold_text(), keeping letters
+-------------------------------------------------------------------------- */
+static void
+append_folded (char * text, bt_buffer * buf)
+{
+   char *  folded;
+
+   folded = fold_text (text, FALSE);
+   if (*folded && buf->length > 0 && buf->text[buf->length-1] != '|')
+      buf_append_char (buf, ' ');
+   buf_append_str (buf, folded);
+   free (folded);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_fingerprint()
+@INPUT      : title - the entry's title (may be NULL)
+              names - its author (or editor) field (may be NULL)
+              year  - its year (may be NULL)
+@OUTPUT     :
+@RETURNS    : the fingerprint, in a newly allocated string
+@DESCRIPTION: Builds the normalized fingerprint of an entry from the
+              (post-processed) values of three of its fields: the title,
+              folded by fold_text() (so lowercased, and without
+              accents, however they're written: TeX, UTF-8 and plain
+              ASCII spellings of a title all fold alike); the last names
+              of the first few names in the list, likewise; and the
+              first four-digit number in the year.  These are separated
+              by '|', and the words in them by single spaces, eg.
+
+                 the art of computer programming|knuth|1968
+
+              Names that can't be split cleanly are still used, but the
+              warnings about them are not reported.
+@GLOBALS    :
+@CALLS      : bt_split_list(), bt_split_name_cached(), fold_text()
+@CREATED    : 2026/10/19
+@MODIFIED   : 2026/10/19: folds with fold_text(), keeping letters
+-------------------------------------------------------------------------- */
+char * bt_fingerprint (char * title, char * names, char * year)
+{
+   bt_errlist *    quiet, * saved;
+   bt_stringlist * list;
+   bt_name *       name;
+   bt_buffer       fingerprint;
+   int             num, i, j;
+
+   memset (&fingerprint, 0, sizeof (fingerprint));
+   buf_reserve (&fingerprint, (title ? strlen (title) : 0) + 16);
+   fingerprint.text[0] = (char) 0;
+
+   if (title)
+      append_folded (title, &fingerprint);
+   buf_append_char (&fingerprint, '|');
+
+   if (names && *names)
+   {
+      quiet = bt_new_errlist (FALSE);
+      saved = bt_set_errlist (quiet);
+      list = bt_split_list (names, "and", NULL, 0, "name");
+      num = 0;
+      for (i = 0; list && i < list->num_items && num < MAX_NAMES; i++)
+      {
+         if (list->items[i] == NULL || strcmp (list->items[i], "others") == 0)
+            continue;
+         name = bt_split_name_cached (list->items[i], NULL, 0, i+1);
+         for (j = 0; j < name->part_len[BTN_LAST]; j++)
+            append_folded (name->parts[BTN_LAST][j], &fingerprint);
+         bt_free_name (name);
+         num++;
+      }
+      bt_free_list (list);
+      bt_set_errlist (saved);
+      bt_free_errlist (quiet);
+   }
+   buf_append_char (&fingerprint, '|');
+
+   for ( ; year && *year; year++)
+   {
+      if (isdigit ((unsigned char) year[0]) && isdigit ((unsigned char) year[1])
+          && isdigit ((unsigned char) year[2]) && isdigit ((unsigned char) year[3]))
+      {
+         buf_append (&fingerprint, year, 4);
+         break;
+      }
+   }
+
+   return fingerprint.text;
+} /* bt_fingerprint() */
+
+
+/* ------------------------------------------------------------------------
+ * Hashing
+ */
+
+static unsigned long
+hash_bytes (char * text, int len, unsigned long hash)
+{
+   while (len-- > 0)                    /* FNV-1a */
+      hash = HASH32 ((hash ^ (unsigned char) *text++) * 16777619UL);
+   return hash;
+}
+
+
+static unsigned long
+mix (unsigned long h)                   /* MurmurHash3's finalizer */
+{
+   h ^= h >> 16;
+   h = HASH32 (h * 0x85ebca6bUL);
+   h ^= h >> 13;
+   h = HASH32 (h * 0xc2b2ae35UL);
+   h ^= h >> 16;
+   return h;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : minhash()
+@INPUT      : index
+              text - a fingerprint
+@OUTPUT     : minhash - the num_hashes minhashes of `text'
+@DESCRIPTION: Computes the MinHash signature of the set of character
+              trigrams of `text' (or of `text' as a whole, if it's
+              shorter than that): each minhash is the least value of one
+              hash function over the set, and the chance that two sets
+              have the same least value is their Jaccard similarity.
+              The hash functions are a single trigram hash, mixed with a
+              different seed for each.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static void
+minhash (bt_dedup * index, char * text, unsigned long * minhash)
+{
+   int           len, num, pos, i;
+   unsigned long h, v;
+
+   len = strlen (text);
+   num = index->num_hashes;
+   for (i = 0; i < num; i++)
+      minhash[i] = 0xffffffffUL;
+
+   pos = 0;
+   do
+   {
+      h = hash_bytes (text + pos, len < 3 ? len : 3, 2166136261UL);
+      for (i = 0; i < num; i++)
+      {
+         v = mix (h ^ index->seeds[i]);
+         if (v < minhash[i])
+            minhash[i] = v;
+      }
+      pos++;
+   }
+   while (pos + 3 <= len);
+}
+
+
+/* ------------------------------------------------------------------------
+ * The index: hash tables of entries, and clusters
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : push_head()
+@INPUT      : table
+              key
+              id    - a new entry
+@RETURNS    : the entry that was the head of the chain for `key', or -1
+              if there was none
+@DESCRIPTION: Makes a new entry the head of the chain for a key.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static int
+push_head (htable * table, unsigned long key, int id)
+{
+   int  slot, head;
+
+   slot = -1;
+   if ((head = htable_find (table, key, &slot)) >= 0)
+      table->slots[slot].id = id;
+   else
+      htable_add (table, key, id);
+   return head;
+}
+
+
+static int
+find_root (bt_dedup * index, int id)
+{
+   int * parent = index->parent;
+
+   while (parent[id] != id)             /* path halving */
+   {
+      parent[id] = parent[parent[id]];
+      id = parent[id];
+   }
+   return id;
+}
+
+
+static void
+join (bt_dedup * index, int id1, int id2)
+{
+   id1 = find_root (index, id1);
+   id2 = find_root (index, id2);
+   if (id1 < id2)                       /* the root of a cluster is its */
+      index->parent[id2] = id1;         /* first entry */
+   else if (id2 < id1)
+      index->parent[id1] = id2;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : similar_enough()
+@INPUT      : index
+              id1, id2 - two entries in the index
+@RETURNS    : true if their estimated similarity is at least the
+              threshold (as bt_dedup_similarity() would estimate it)
+@DESCRIPTION: Compares the signatures of two entries, but stops as soon
+              as too many minhashes disagree -- which, for most of the
+              candidates that LSH turns up, is well before the end.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static boolean
+similar_enough (bt_dedup * index, int id1, int id2)
+{
+   unsigned char * sig1, * sig2;
+   int     allowed, differ, i, j;
+
+   /* the most minhashes that may disagree, with estimate >= threshold */
+   allowed = (int) (SIGNATURE_SIZE *
+                    (1.0 - index->threshold) * (1.0 - 1.0/256));
+   sig1 = index->signature + id1 * SIGNATURE_SIZE;
+   sig2 = index->signature + id2 * SIGNATURE_SIZE;
+   differ = 0;
+   for (i = 0; i < SIGNATURE_SIZE; i += 32)
+   {
+      for (j = i; j < i + 32; j++)      /* (a loop compilers vectorize) */
+         differ += (sig1[j] != sig2[j]);
+      if (differ > allowed)
+         return FALSE;
+   }
+   return TRUE;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_dedup_new()
+@INPUT      : bands     - number of LSH bands (default 10)
+              rows      - number of minhashes per band (default 4)
+              threshold - least estimated similarity for two entries to
+                          be put in the same cluster (default 0.7)
+@OUTPUT     :
+@RETURNS    : a new, empty index
+@DESCRIPTION: Creates an index for finding duplicates.  Any parameter
+              that is zero (or less) gets its default.
+
+              Two fingerprints with similarity s (the Jaccard similarity
+              of their sets of trigrams) share at least one band, and so
+              get compared, with a probability of 1 - (1 - s^rows)^bands:
+              more bands catch more pairs that are less similar, and
+              more rows fewer; the defaults catch 99% of the pairs with
+              s = 0.8, and 94% with s = 0.7.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+bt_dedup * bt_dedup_new (int bands, int rows, double threshold)
+{
+   bt_dedup * index;
+   int        i;
+
+   index = (bt_dedup *) calloc (1, sizeof (bt_dedup));
+   index->bands = bands > 0 ? bands : 10;
+   index->rows = rows > 0 ? rows : 4;
+   index->threshold = threshold > 0 ? threshold : 0.7;
+
+   index->num_hashes = index->bands * index->rows + SIGNATURE_SIZE;
+   index->seeds = (unsigned long *)
+      malloc (index->num_hashes * sizeof (unsigned long));
+   for (i = 0; i < index->num_hashes; i++)
+      index->seeds[i] = mix (HASH32 ((i + 1) * 0x9e3779b9UL));
+
+   return index;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : grow()
+@INPUT      : index
+@DESCRIPTION: Makes room in the per-entry arrays for (at least) one more
+              entry.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static void
+grow (bt_dedup * index)
+{
+   int  n;
+
+   n = index->alloc ? 2 * index->alloc : 1024;
+   index->exact = (unsigned long *)
+      realloc (index->exact, 2 * n * sizeof (unsigned long));
+   index->signature = (unsigned char *)
+      realloc (index->signature, n * SIGNATURE_SIZE);
+   index->parent = (int *) realloc (index->parent, n * sizeof (int));
+   index->exact_next = (int *) realloc (index->exact_next, n * sizeof (int));
+   index->band_next = (int *)
+      realloc (index->band_next, n * index->bands * sizeof (int));
+   index->compared = (int *) realloc (index->compared, n * sizeof (int));
+   index->alloc = n;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_dedup_add()
+@INPUT      : index
+              fingerprint - of the entry to add (from bt_fingerprint())
+@OUTPUT     :
+@RETURNS    : the id of the new entry: 0 for the first one added, 1 for
+              the second, and so on
+@DESCRIPTION: Adds an entry to the index, and joins it to the cluster of
+              every earlier entry with the same fingerprint, or with one
+              similar enough.  Only the entries that share at least one
+              LSH band with the new one are compared with it -- and of
+              those, at most the last 64 for each band.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_dedup_add (bt_dedup * index, char * fingerprint)
+{
+   int             id, num, head, other, seen, b, r;
+   unsigned long   h1, h2, key;
+   unsigned long * work;
+
+   if (index->count == index->alloc)
+      grow (index);
+   id = index->count++;
+   index->parent[id] = id;
+   index->compared[id] = -1;
+
+   /* Exact matches first: two 32-bit hashes of the whole fingerprint */
+   num = strlen (fingerprint);
+   h1 = hash_bytes (fingerprint, num, 2166136261UL);
+   h2 = mix (hash_bytes (fingerprint, num, 0x5bd1e995UL));
+   index->exact[2*id] = h1;
+   index->exact[2*id+1] = h2;
+
+   head = push_head (&index->exact_table, h1, id);
+   for (other = head; other >= 0; other = index->exact_next[other])
+   {
+      if (index->exact[2*other+1] == h2)
+      {
+         join (index, id, other);
+         break;
+      }
+   }
+   index->exact_next[id] = head;
+
+   /*
+    * Then near matches, among the entries in the same LSH buckets.  The
+    * similarity is estimated from minhashes other than those the bands
+    * are made of -- those are biased, since a candidate always agrees
+    * on all the minhashes of at least one band.
+    */
+   work = (unsigned long *) malloc (index->num_hashes * sizeof (unsigned long));
+   minhash (index, fingerprint, work);
+   num = index->bands * index->rows;
+   for (r = 0; r < SIGNATURE_SIZE; r++)
+      index->signature[id*SIGNATURE_SIZE + r] =
+         (unsigned char) (work[num + r] & 0xff);
+
+   for (b = 0; b < index->bands; b++)
+   {
+      key = mix (HASH32 ((b + 1) * 0x9e3779b9UL));
+      for (r = 0; r < index->rows; r++)
+         key = mix (key ^ work[b * index->rows + r]);
+
+      head = push_head (&index->band_table, key, id);
+      seen = 0;
+      for (other = head;
+           other >= 0 && seen < MAX_CANDIDATES;
+           other = index->band_next[other * index->bands + b], seen++)
+      {
+         if (index->compared[other] == id)      /* found in an earlier */
+            continue;                           /* band already */
+         index->compared[other] = id;
+         if (find_root (index, other) != find_root (index, id) &&
+             similar_enough (index, id, other))
+            join (index, id, other);
+      }
+      index->band_next[id * index->bands + b] = head;
+   }
+
+   free (work);
+   return id;
+} /* bt_dedup_add() */
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_dedup_similarity()
+@INPUT      : index
+              id1, id2 - two entries in the index
+@OUTPUT     :
+@RETURNS    : 1.0 if the entries have the same fingerprint; otherwise
+              the estimated similarity of their fingerprints, from 0.0
+              to (just under) 1.0; -1.0 if either id is not in the index
+@DESCRIPTION: Estimates the similarity of two entries from the fraction
+              of their 128 minhashes that agree.  Only the low 8 bits
+              of each minhash are kept, so there's a small (1 in 256)
+              chance of agreeing by accident, which is allowed for.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+double bt_dedup_similarity (bt_dedup * index, int id1, int id2)
+{
+   unsigned char * sig1, * sig2;
+   int     same, i;
+   double  estimate;
+
+   if (id1 < 0 || id1 >= index->count || id2 < 0 || id2 >= index->count)
+      return -1.0;
+   if (index->exact[2*id1] == index->exact[2*id2] &&
+       index->exact[2*id1+1] == index->exact[2*id2+1])
+      return 1.0;
+
+   sig1 = index->signature + id1 * SIGNATURE_SIZE;
+   sig2 = index->signature + id2 * SIGNATURE_SIZE;
+   same = 0;
+   for (i = 0; i < SIGNATURE_SIZE; i++)
+      same += (sig1[i] == sig2[i]);
+
+   estimate = ((double) same / SIGNATURE_SIZE - 1.0/256) / (1.0 - 1.0/256);
+   if (estimate < 0.0) estimate = 0.0;
+   if (estimate >= 1.0) estimate = 0.999;
+   return estimate;
+} /* bt_dedup_similarity() */
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_dedup_cluster()
+@INPUT      : index
+              id    - an entry in the index
+@OUTPUT     :
+@RETURNS    : the id of the first entry in the cluster of `id' (which is
+              `id' itself if it has no duplicates, or is the first of
+              them), or -1 if `id' is not in the index
+@DESCRIPTION: Tells which cluster an entry is in, as things stand: a
+              later entry can still join two clusters into one.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_dedup_cluster (bt_dedup * index, int id)
+{
+   if (id < 0 || id >= index->count)
+      return -1;
+   return find_root (index, id);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_dedup_count()
+@INPUT      : index
+@RETURNS    : the number of entries added to the index
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_dedup_count (bt_dedup * index)
+{
+   return index->count;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_dedup_free()
+@INPUT      : index
+@DESCRIPTION: Frees an index and everything in it.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_dedup_free (bt_dedup * index)
+{
+   if (index == NULL) return;
+   free (index->seeds);
+   free (index->exact);
+   free (index->signature);
+   free (index->parent);
+   free (index->exact_next);
+   free (index->band_next);
+   free (index->compared);
+   htable_free (&index->exact_table);
+   htable_free (&index->band_table);
+   free (index);
+}
@@ -24,6 +24,7 @@
 #include "my_dmalloc.h"
 
 extern char * InputFilename;            /* for zzcr_ast call in pccts/ast.c */
+extern boolean CheckOnly;               /* no value nodes wanted */
 #define zzSET_SIZE 4
 #include "../pccts/antlr.h"
 #include "../pccts/ast.h"
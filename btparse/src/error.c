@@ -6,7 +6,7 @@
               err_actions
               err_handlers
               errclass_counts
-              error_buf
+              error_list
 @CALLS      : 
 @CREATED    : 1996/08/28, Greg Ward
 @MODIFIED   : 
@@ -32,6 +32,10 @@
 
 #define NUM_ERRCLASSES ((int) BTERR_INTERNAL + 1)
 
+#ifndef va_copy
+# define va_copy(dst, src) memcpy (&(dst), &(src), sizeof (va_list))
+#endif
+
 
 static char *errclass_names[NUM_ERRCLASSES] = 
 {
@@ -72,7 +76,65 @@ static bt_err_handler err_handlers[NUM_ERRCLASSES] =
 };
 
 static int errclass_counts[NUM_ERRCLASSES] = { 0, 0, 0, 0, 0, 0, 0, 0 };
-static char error_buf[MAX_ERROR+1];
+
+/* 
+ * If not NULL, errors are recorded here (and only passed on to
+ * err_handlers if error_list->echo is true) -- see bt_set_errlist().
+ */
+static bt_errlist * error_list = NULL;
+
+
+/*
+ * Strings in a bt_errlist live in a chain of blocks, which are never
+ * moved; so the pointers in the list's bt_error structs stay valid as
+ * the list grows.  So do the arguments of messages that haven't been
+ * formatted yet: one errarg for each `*' and each conversion in the
+ * format, in order.
+ */
+#define ERRBLOCK_SIZE 4096
+
+typedef enum
+{
+   ARG_INT, ARG_UINT, ARG_LONG, ARG_ULONG, ARG_LLONG, ARG_ULLONG,
+   ARG_SIZE, ARG_DOUBLE, ARG_LDOUBLE, ARG_STRING, ARG_POINTER
+} errarg_type;
+
+typedef union
+{
+   int                i;
+   unsigned int       u;
+   long               l;
+   unsigned long      ul;
+   long long          ll;
+   unsigned long long ull;
+   size_t             z;
+   double             d;
+   long double        ld;
+   char *             s;
+   void *             p;
+} errarg;
+
+/* one conversion of a format, as found by scan_conversion() */
+typedef struct
+{
+   char *       flags;                  /* after the `%' */
+   int          num_flags;
+   char *       width;                  /* digits, or "*" */
+   int          width_len;
+   char *       precision;              /* digits or "*" after the `.' */
+   int          precision_len;          /* (-1 if no `.') */
+   char *       conversion;             /* length modifier, and letter */
+   int          conversion_len;
+   errarg_type  type;
+} errconv;
+
+struct bt_errblock_s
+{
+   bt_errblock * next;
+   int           size;
+   int           used;
+   char          text[1];               /* really `size' chars */
+};
 
 
 /* ----------------------------------------------------------------------
@@ -126,6 +188,380 @@ void print_error (bt_error *err)
 
 
 
+/* ----------------------------------------------------------------------
+ * Recording errors in an error list (bt_errlist).
+ */
+
+/*
+ * Room for `len' chars in the list's current block (or a new one),
+ * starting at a multiple of `align' bytes.
+ */
+static char *
+reserve_error_space (bt_errlist * list, int len, int align)
+{
+   bt_errblock * block;
+   int           pad = 0;
+
+   block = list->text;
+   if (block != NULL)
+      pad = (int) (align - (size_t) (block->text + block->used) % align)
+            % align;
+   if (block == NULL || block->used + pad + len > block->size)
+   {
+      int   size = (len + align > ERRBLOCK_SIZE) ? len + align : ERRBLOCK_SIZE;
+
+      block = (bt_errblock *) malloc (sizeof (bt_errblock) + size);
+      block->next = list->text;
+      block->size = size;
+      block->used = 0;
+      list->text = block;
+      pad = (int) (align - (size_t) block->text % align) % align;
+   }
+
+   block->used += pad + len;
+   return block->text + block->used - len;
+}
+
+
+/* room for `len' chars of text */
+static char *
+reserve_error_text (bt_errlist * list, int len)
+{
+   return reserve_error_space (list, len, 1);
+}
+
+
+static char *
+save_error_text (bt_errlist * list, char * text)
+{
+   int     len = strlen (text) + 1;
+   char *  copy = reserve_error_text (list, len);
+
+   memcpy (copy, text, len);
+   return copy;
+}
+
+
+/*
+ * Finds the parts of the conversion that starts at `p' (just after a
+ * `%' that doesn't start "%%"), and returns the first character after
+ * it -- or NULL if it isn't one that save_error_args() can save.
+ */
+static char *
+scan_conversion (char * p, errconv * conv)
+{
+   char   length = 0;                   /* 'h', 'l', 'q' (ll), 'z' or 'L' */
+
+   conv->flags = p;
+   while (*p && strchr ("-+ #0", *p))
+      p++;
+   conv->num_flags = p - conv->flags;
+
+   conv->width = p;
+   if (*p == '*')
+      p++;
+   else
+      while (*p >= '0' && *p <= '9')
+         p++;
+   conv->width_len = p - conv->width;
+
+   conv->precision = NULL;
+   conv->precision_len = -1;
+   if (*p == '.')
+   {
+      conv->precision = ++p;
+      if (*p == '*')
+         p++;
+      else
+         while (*p >= '0' && *p <= '9')
+            p++;
+      conv->precision_len = p - conv->precision;
+   }
+
+   conv->conversion = p;
+   if (*p == 'h')
+   {
+      length = *p++;
+      if (*p == 'h') p++;
+   }
+   else if (*p == 'l')
+   {
+      length = *p++;
+      if (*p == 'l') { length = 'q'; p++; }
+   }
+   else if (*p == 'z' || *p == 'L')
+   {
+      length = *p++;
+   }
+
+   switch (*p)
+   {
+      case 'd': case 'i': case 'c':
+         conv->type = (length == 'l') ? ARG_LONG
+                    : (length == 'q') ? ARG_LLONG
+                    : (length == 'z') ? ARG_SIZE : ARG_INT;
+         break;
+      case 'u': case 'x': case 'X': case 'o':
+         conv->type = (length == 'l') ? ARG_ULONG
+                    : (length == 'q') ? ARG_ULLONG
+                    : (length == 'z') ? ARG_SIZE : ARG_UINT;
+         break;
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+         conv->type = (length == 'L') ? ARG_LDOUBLE : ARG_DOUBLE;
+         break;
+      case 's':
+         conv->type = ARG_STRING;
+         break;
+      case 'p':
+         conv->type = ARG_POINTER;
+         break;
+      default:                          /* %n, %ls, ...: not worth it */
+         return NULL;
+   }
+   conv->conversion_len = ++p - conv->conversion;
+
+   /* save_error_arg() and format_error_args() assume these */
+   if (conv->num_flags > 5 || conv->width_len > 10 ||
+       conv->precision_len > 10 || conv->conversion_len > 3)
+      return NULL;
+   return p;
+}
+
+
+/*
+ * Copies the arguments of an error message into the list's storage, so
+ * that it can be formatted later (by format_error_args()); strings are
+ * copied too.  Returns NULL (having saved nothing) if the format has
+ * conversions that can't be saved.
+ */
+static errarg *
+save_error_args (bt_errlist * list, char * fmt, va_list arglist)
+{
+   errconv  conv;
+   errarg * args;
+   char *   p;
+   int      num_args = 0;
+   int      i = 0;
+
+   for (p = fmt; (p = strchr (p, '%')) != NULL; )
+   {
+      if (*++p == '%') { p++; continue; }
+      if ((p = scan_conversion (p, &conv)) == NULL)
+         return NULL;
+      num_args += 1 + (conv.width_len && conv.width[0] == '*')
+                    + (conv.precision_len > 0 && conv.precision[0] == '*');
+   }
+   if (num_args == 0)
+      return NULL;
+
+   args = (errarg *) reserve_error_space (list, num_args * sizeof (errarg),
+                                          sizeof (errarg));
+   for (p = fmt; (p = strchr (p, '%')) != NULL; )
+   {
+      int      precision = -1;
+
+      if (*++p == '%') { p++; continue; }
+      p = scan_conversion (p, &conv);
+      if (conv.width_len && conv.width[0] == '*')
+         args[i++].i = va_arg (arglist, int);
+      if (conv.precision_len > 0 && conv.precision[0] == '*')
+         precision = args[i++].i = va_arg (arglist, int);
+      else if (conv.precision_len >= 0)
+         precision = atoi (conv.precision);
+
+      switch (conv.type)
+      {
+         case ARG_INT:     args[i].i = va_arg (arglist, int); break;
+         case ARG_UINT:    args[i].u = va_arg (arglist, unsigned int); break;
+         case ARG_LONG:    args[i].l = va_arg (arglist, long); break;
+         case ARG_ULONG:   args[i].ul = va_arg (arglist, unsigned long); break;
+         case ARG_LLONG:   args[i].ll = va_arg (arglist, long long); break;
+         case ARG_ULLONG:
+            args[i].ull = va_arg (arglist, unsigned long long); break;
+         case ARG_SIZE:    args[i].z = va_arg (arglist, size_t); break;
+         case ARG_DOUBLE:  args[i].d = va_arg (arglist, double); break;
+         case ARG_LDOUBLE: args[i].ld = va_arg (arglist, long double); break;
+         case ARG_POINTER: args[i].p = va_arg (arglist, void *); break;
+         case ARG_STRING:
+         {
+            /* the string may not outlive the call, or end where printed */
+            char * string = va_arg (arglist, char *);
+            int    len;
+
+            args[i].s = NULL;
+            if (string == NULL)
+               break;
+            if (precision >= 0 && memchr (string, '\0', precision) == NULL)
+               len = precision;
+            else
+               len = strlen (string);
+            args[i].s = reserve_error_text (list, len + 1);
+            memcpy (args[i].s, string, len);
+            args[i].s[len] = '\0';
+            break;
+         }
+      }
+      i++;
+   }
+   return args;
+}
+
+
+/*
+ * Formats a message from its saved arguments into `buf' (of `size'
+ * chars, which may be 0), like snprintf(): returns the length of the
+ * whole message, and truncates it to fit if necessary.
+ */
+static int
+format_error_args (char * fmt, errarg * args, char * buf, int size)
+{
+   errconv  conv;
+   char     spec[48];
+   char *   p;
+   char *   s;
+   int      len = 0;
+   int      room;
+   int      n;
+
+#define PUT(c)                                                  \
+   {                                                            \
+      if (len < size - 1) buf[len] = (c);                       \
+      len++;                                                    \
+   }
+
+   for (p = fmt; *p; )
+   {
+      if (*p != '%' || p[1] == '%')
+      {
+         PUT (*p);
+         p += (*p == '%') ? 2 : 1;
+         continue;
+      }
+
+      /* the conversion, with its `*'s replaced by their values */
+      p = scan_conversion (p + 1, &conv);
+      s = spec;
+      *s++ = '%';
+      memcpy (s, conv.flags, conv.num_flags);
+      s += conv.num_flags;
+      if (conv.width_len && conv.width[0] == '*')
+      {
+         n = (args++)->i;
+         s += sprintf (s, (n < 0) ? "-%d" : "%d", (n < 0) ? -n : n);
+      }
+      else
+      {
+         memcpy (s, conv.width, conv.width_len);
+         s += conv.width_len;
+      }
+      if (conv.precision_len > 0 && conv.precision[0] == '*')
+      {
+         n = (args++)->i;
+         if (n >= 0)
+            s += sprintf (s, ".%d", n);
+      }
+      else if (conv.precision_len >= 0)
+      {
+         *s++ = '.';
+         memcpy (s, conv.precision, conv.precision_len);
+         s += conv.precision_len;
+      }
+      memcpy (s, conv.conversion, conv.conversion_len);
+      s[conv.conversion_len] = '\0';
+
+      room = (len < size) ? size - len : 0;
+      s = room ? buf + len : NULL;
+      switch (conv.type)
+      {
+         case ARG_INT:     n = snprintf (s, room, spec, args->i); break;
+         case ARG_UINT:    n = snprintf (s, room, spec, args->u); break;
+         case ARG_LONG:    n = snprintf (s, room, spec, args->l); break;
+         case ARG_ULONG:   n = snprintf (s, room, spec, args->ul); break;
+         case ARG_LLONG:   n = snprintf (s, room, spec, args->ll); break;
+         case ARG_ULLONG:  n = snprintf (s, room, spec, args->ull); break;
+         case ARG_SIZE:    n = snprintf (s, room, spec, args->z); break;
+         case ARG_DOUBLE:  n = snprintf (s, room, spec, args->d); break;
+         case ARG_LDOUBLE: n = snprintf (s, room, spec, args->ld); break;
+         case ARG_STRING:  n = snprintf (s, room, spec, args->s); break;
+         case ARG_POINTER: n = snprintf (s, room, spec, args->p); break;
+         default:          n = 0;
+      }
+      args++;
+      if (n > 0)
+         len += n;
+   }
+   if (size > 0)
+      buf[(len < size) ? len : size - 1] = '\0';
+   return len;
+
+#undef PUT
+}
+
+
+/*
+ * Formats an error message straight into the list's storage: once to
+ * find its length, and then for real, so it's never truncated.  This is
+ * only for the formats that save_error_args() can't save.
+ */
+static char *
+save_error_message (bt_errlist * list, char * fmt, va_list arglist)
+{
+   va_list  args;
+   int      len;
+   char *   message;
+
+   va_copy (args, arglist);
+   len = vsnprintf (NULL, 0, fmt, args) + 1;
+   va_end (args);
+   if (len < 1)                         /* bad format: keep it as it is */
+      return save_error_text (list, fmt);
+   message = reserve_error_text (list, len);
+   vsnprintf (message, len, fmt, arglist);
+   return message;
+}
+
+
+static void
+record_error (bt_errlist * list, bt_error * err)
+{
+   bt_error * new_err;
+   bt_error * prev;
+
+   if (list->num_errors == list->max_errors)
+   {
+      list->max_errors = list->max_errors ? list->max_errors * 2 : 16;
+      list->errors = (bt_error *)
+         realloc (list->errors, list->max_errors * sizeof (bt_error));
+   }
+
+   prev = list->num_errors ? &list->errors[list->num_errors-1] : NULL;
+   new_err = &list->errors[list->num_errors++];
+   *new_err = *err;
+
+   /* 
+    * Most errors come from the same file, and (if any) the same sort of
+    * item as the previous one, so share those strings where we can.
+    */
+   if (err->filename)
+   {
+      if (prev && prev->filename && strcmp (prev->filename, err->filename) == 0)
+         new_err->filename = prev->filename;
+      else
+         new_err->filename = save_error_text (list, err->filename);
+   }
+   if (err->item_desc)
+   {
+      if (prev && prev->item_desc && strcmp (prev->item_desc, err->item_desc) == 0)
+         new_err->item_desc = prev->item_desc;
+      else
+         new_err->item_desc = save_error_text (list, err->item_desc);
+   }
+   /* err->message and err->args are already in the list */
+
+} /* record_error() */
+
+
+
 /* ----------------------------------------------------------------------
  * Error-reporting functions: these are called anywhere in the library
  * when we encounter an error.
@@ -141,9 +577,10 @@ report_error (bt_errclass errclass,
               va_list     arglist)
 {
    bt_error  err;
-#if !HAVE_VSNPRINTF
-   int       msg_len;
-#endif
+   char      buf[MAX_ERROR+1];
+   char *    big_buf = NULL;
+   va_list   args;
+   int       len;
 
    err.errclass = errclass;
    err.filename = filename;
@@ -152,37 +589,61 @@ report_error (bt_errclass errclass,
    err.item = item;
 
    errclass_counts[(int) errclass]++;
-
+   err.message = NULL;
+   err.format = NULL;
+   err.args = NULL;
 
    /* 
-    * Blech -- we're writing to a static buffer because there's no easy
-    * way to know how long the error message is going to be.  (Short of
-    * reimplementing printf(), or maybe printf()'ing to a dummy file
-    * and using the return value -- ugh!)  The GNU C library conveniently
-    * supplies vsnprintf(), which neatly solves this problem by truncating
-    * the output string if it gets too long.  (I could check for this
-    * truncation if I wanted to, but I don't think it's necessary given the
-    * ample size of the message buffer.)  For non-GNU systems, though,
-    * we're stuck with using vsprintf()'s return value.  This can't be
-    * trusted on all systems -- thus there's a check for it in configure.
-    * Also, this won't necessarily trigger the internal_error() if we
-    * do overflow; it's conceivable that vsprintf() itself would crash.  
-    * At least doing it this way we avoid the possibility of vsprintf() 
-    * silently corrupting some memory, and crashing unpredictably at some
-    * later point.
+    * The message is only formatted if something is going to see it.  An
+    * error list just keeps the format, which is always a string literal,
+    * and a copy of the arguments, for bt_error_message() to format the
+    * message if it's ever asked for (if the arguments can't be copied,
+    * it's formatted straight into the list's storage).  The message for
+    * a handler goes into a buffer on the stack -- a bigger one, from the
+    * heap, if it doesn't fit.
     */
+   if (error_list)
+   {
+      va_copy (args, arglist);
+      err.args = save_error_args (error_list, fmt, args);
+      va_end (args);
+      if (err.args || strchr (fmt, '%') == NULL)
+         err.format = fmt;
+      else
+         err.message = save_error_message (error_list, fmt, arglist);
+      record_error (error_list, &err);
+      if (error_list->echo && err_handlers[errclass] && err.format)
+      {
+         len = format_error_args (err.format, (errarg *) err.args,
+                                  buf, sizeof (buf));
+         err.message = buf;
+         if (len >= (int) sizeof (buf) &&
+             (big_buf = (char *) malloc (len + 1)) != NULL)
+         {
+            format_error_args (err.format, (errarg *) err.args,
+                               big_buf, len + 1);
+            err.message = big_buf;
+         }
+      }
+   }
+   else if (err_handlers[errclass])
+   {
+      va_copy (args, arglist);
+      len = vsnprintf (buf, sizeof (buf), fmt, args);
+      va_end (args);
+      err.message = (len < 0) ? fmt : buf;
+      if (len >= (int) sizeof (buf) &&
+          (big_buf = (char *) malloc (len + 1)) != NULL)
+      {
+         vsnprintf (big_buf, len + 1, fmt, arglist);
+         err.message = big_buf;
+      }
+   }
 
-#if HAVE_VSNPRINTF
-   vsnprintf (error_buf, MAX_ERROR, fmt, arglist);
-#else
-   msg_len = vsprintf (error_buf, fmt, arglist);   // protected by cpp
-   if (msg_len > MAX_ERROR)
-      internal_error ("static error message buffer overflowed");
-#endif
-
-   err.message = error_buf;
-   if (err_handlers[errclass])
+   if ((error_list == NULL || error_list->echo) && err_handlers[errclass])
       (*err_handlers[errclass]) (&err);
+   if (big_buf)
+      free (big_buf);
 
    switch (err_actions[errclass])
    {
@@ -348,3 +809,233 @@ btshort bt_error_status (int *saved_counts)
 
    return status;
 } /* bt_error_status () */
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_new_errlist()
+@INPUT      : echo - whether errors recorded in the list should also be
+                     reported in the usual way (printed to stderr)
+@OUTPUT     : 
+@RETURNS    : a new, empty error list
+@DESCRIPTION: Creates an error list, which can be installed with 
+              bt_set_errlist() to record errors in memory.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+bt_errlist * bt_new_errlist (boolean echo)
+{
+   bt_errlist * list;
+
+   list = (bt_errlist *) malloc (sizeof (bt_errlist));
+   list->num_errors = 0;
+   list->max_errors = 0;
+   list->errors = NULL;
+   list->echo = echo;
+   list->text = NULL;
+   return list;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_clear_errlist()
+@INPUT      : list
+@OUTPUT     : 
+@RETURNS    : 
+@DESCRIPTION: Forgets all errors recorded in `list' (and frees the 
+              storage for their strings), but keeps the list itself
+              ready for re-use.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+void bt_clear_errlist (bt_errlist * list)
+{
+   bt_errblock * block;
+   bt_errblock * next;
+
+   if (list == NULL) return;
+
+   /* keep the first (most recent) text block around for the next errors */
+   block = list->text;
+   if (block)
+   {
+      for (next = block->next; next != NULL; )
+      {
+         bt_errblock * tmp = next->next;
+         free (next);
+         next = tmp;
+      }
+      block->next = NULL;
+      block->used = 0;
+   }
+   list->num_errors = 0;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_free_errlist()
+@INPUT      : list
+@OUTPUT     : 
+@RETURNS    : 
+@DESCRIPTION: Frees an error list and everything in it.  If `list' is
+              the currently installed error list, it is uninstalled
+              first.
+@GLOBALS    : error_list
+@CALLS      : 
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+void bt_free_errlist (bt_errlist * list)
+{
+   bt_errblock * block;
+
+   if (list == NULL) return;
+   if (list == error_list)
+      error_list = NULL;
+
+   while (list->text)
+   {
+      block = list->text->next;
+      free (list->text);
+      list->text = block;
+   }
+   if (list->errors)
+      free (list->errors);
+   free (list);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_set_errlist()
+@INPUT      : list - error list to install, or NULL to stop recording
+@OUTPUT     : 
+@RETURNS    : the previously installed error list (or NULL)
+@DESCRIPTION: Makes `list' the place where all errors and warnings are
+              recorded from now on.  They are only formatted and
+              printed as well if list->echo is true.  (Error counts and
+              the actions taken for fatal errors are not affected.)
+@GLOBALS    : error_list
+@CALLS      : 
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+bt_errlist * bt_set_errlist (bt_errlist * list)
+{
+   bt_errlist * previous = error_list;
+
+   error_list = list;
+   return previous;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_error_message()
+@INPUT      : list - an error list
+              err  - one of the errors recorded in it
+@OUTPUT     : 
+@RETURNS    : the error's message (without its location)
+@DESCRIPTION: Returns err->message, formatting it first (into the list's
+              storage) if it hasn't been yet: errors are recorded with
+              their format and a copy of its arguments, and not
+              formatted until they're asked for.
+@GLOBALS    : 
+@CALLS      : format_error_args()
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+char * bt_error_message (bt_errlist * list, bt_error * err)
+{
+   int      len;
+
+   if (err->message == NULL && err->format != NULL)
+   {
+      len = format_error_args (err->format, (errarg *) err->args, NULL, 0);
+      err->message = reserve_error_text (list, len + 1);
+      format_error_args (err->format, (errarg *) err->args,
+                         err->message, len + 1);
+   }
+   return err->message;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_format_error()
+@INPUT      : err  - the error to format
+              size - size of `buf'
+@OUTPUT     : buf  - the formatted error message, without a newline
+                     (truncated to fit, and always NUL-terminated if
+                     size > 0)
+@RETURNS    : the length of the complete message (so if it's >= size,
+              the message was truncated)
+@DESCRIPTION: Formats an error message exactly as the default error
+              handler prints it, eg. for a recorded error (see
+              bt_set_errlist()).
+@GLOBALS    : errclass_names
+@CALLS      : 
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+int bt_format_error (bt_error * err, char * buf, int size)
+{
+   char    num[32];
+   char *  name;
+   boolean something_printed = FALSE;
+   int     len = 0;
+
+   if (size > 0) buf[0] = '\0';
+
+#define APPEND(s)                                               \
+   {                                                            \
+      if (len < size - 1)                                       \
+         strncat (buf + len, s, size - 1 - len);                \
+      len += strlen (s);                                        \
+   }
+#define SEPARATE                                                \
+   {                                                            \
+      if (something_printed)                                    \
+         APPEND (", ");                                         \
+      something_printed = TRUE;                                 \
+   }
+
+   if (err->filename)
+   {
+      SEPARATE;
+      APPEND (err->filename);
+   }
+   if (err->line > 0)
+   {
+      SEPARATE;
+      sprintf (num, "line %d", err->line);
+      APPEND (num);
+   }
+   if (err->item_desc && err->item > 0)
+   {
+      SEPARATE;
+      sprintf (num, " %d", err->item);
+      APPEND (err->item_desc);
+      APPEND (num);
+   }
+   name = errclass_names[(int) err->errclass];
+   if (name)
+   {
+      SEPARATE;
+      APPEND (name);
+   }
+   if (something_printed)
+      APPEND (": ");
+   if (err->message)
+      APPEND (err->message)
+   else if (err->format)                /* recorded, and not formatted yet */
+      len += format_error_args (err->format, (errarg *) err->args,
+                                (len < size) ? buf + len : NULL,
+                                (len < size) ? size - len : 0);
+
+#undef SEPARATE
+#undef APPEND
+
+   return len;
+
+} /* bt_format_error() */
@@ -46,6 +46,11 @@ static GEN_ERRFUNC(name,params,class,filename,line,item_desc,item,format)
  * in btparse.h.
  */
 
+/*
+ * The format given to any of these must be a string literal: an error
+ * list keeps just a pointer to it, to format the message later.
+ */
+
 void print_error (bt_error *err);
 void report_error (bt_errclass class, 
                    char * filename, int line, char * item_desc, int item,
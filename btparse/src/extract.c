@@ -0,0 +1,743 @@
+/* ------------------------------------------------------------------------
+@NAME       : extract.c
+@DESCRIPTION: Extracts the entries cited by a LaTeX document from any
+              number of BibTeX files:
+
+                bt_extract_new
+                bt_extract_cite
+                bt_extract_aux
+                bt_extract_bibdata
+                bt_extract_file
+                bt_extract_write
+                bt_extract_free
+
+              The citations are read from the document's .aux files.  The
+              .bib files are then scanned with bt_read_entry_text(), which
+              finds each entry's key without parsing it, to build an index
+              of where every entry and macro definition is; only the cited
+              entries (and their crossref parents, and the @string entries
+              defining the macros they use) are ever parsed, each from its
+              own slice of the file.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse library.  This library is
+              free software; you can redistribute it and/or modify it under
+              the terms of the GNU Library General Public License as
+              published by the Free Software Foundation; either version 2
+              of the License, or (at your option) any later version.
+-------------------------------------------------------------------------- */
+
+#include "bt_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "btparse.h"
+#include "prototypes.h"
+#include "error.h"
+#include "my_dmalloc.h"
+#include "bt_debug.h"
+
+
+#define MAX_AUX_DEPTH 16
+
+/*
+ * Where an entry (or, for a macro, the @string entry defining it) is:
+ * which file, its byte offset and line there, and its position in the
+ * order of all entries.  `hash' is the two hashes of the key (or macro
+ * name) from hash_text().
+ */
+typedef struct
+{
+   unsigned long  hash[2];
+   int            file;
+   int            line;
+   long           offset;
+   int            order;
+   int            wanted;               /* 0, or how it got wanted */
+} xslot;
+
+#define WANT_CITED   1
+#define WANT_PARENT  2
+
+typedef struct
+{
+   int      count;
+   int      alloc;
+   xslot *  slots;
+   htable   index;                      /* of slots, by hash[0] */
+} xtable;
+
+struct bt_extract_s
+{
+   int       num_cited;
+   char **   cited;                     /* keys, as cited */
+   boolean   cite_all;                  /* \citation{*} */
+   int       num_bibdata;
+   char **   bibdata;
+   int       num_files;
+   char **   filenames;
+   FILE **   files;
+   xtable    entries;                   /* regular entries, by key */
+   xtable    macros;                    /* @string entries, by macro */
+   int       num_preambles;
+   xslot *   preambles;
+   int       order;                     /* entries seen so far */
+   int       parsed;                    /* since the parser was reset */
+};
+
+
+/* ------------------------------------------------------------------------
+ * The index
+ */
+
+static xslot *
+find_slot (xtable * table, unsigned long * hash)
+{
+   int  slot, id;
+
+   slot = -1;
+   while ((id = htable_find (&table->index, hash[0], &slot)) >= 0)
+   {
+      if (table->slots[id].hash[1] == hash[1])
+         return &table->slots[id];
+   }
+   return NULL;
+}
+
+
+static xslot *
+add_slot (xtable * table, unsigned long * hash)
+{
+   xslot *  slot;
+
+   if (table->count == table->alloc)
+   {
+      table->alloc = table->alloc ? 2 * table->alloc : 256;
+      table->slots = (xslot *)
+         realloc (table->slots, table->alloc * sizeof (xslot));
+   }
+   htable_add (&table->index, hash[0], table->count);
+   slot = &table->slots[table->count++];
+   memset (slot, 0, sizeof (xslot));
+   slot->hash[0] = hash[0];
+   slot->hash[1] = hash[1];
+   return slot;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_extract_new()
+@RETURNS    : a new extraction, with nothing cited
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+bt_extract * bt_extract_new (void)
+{
+   return (bt_extract *) calloc (1, sizeof (bt_extract));
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_extract_cite()
+@INPUT      : extract
+              key     - a cited key, or "*" for every entry
+@DESCRIPTION: Cites an entry, as \citation{key} in an .aux file does.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_extract_cite (bt_extract * extract, char * key)
+{
+   if (strcmp (key, "*") == 0)
+   {
+      extract->cite_all = TRUE;
+      return;
+   }
+   extract->cited = (char **)
+      realloc (extract->cited, (extract->num_cited + 1) * sizeof (char *));
+   extract->cited[extract->num_cited++] = strdup (key);
+}
+
+
+/* ------------------------------------------------------------------------
+ * Reading .aux files
+ */
+
+/* Calls `fn' for each comma-separated item in `list' (modified). */
+static void
+each_item (char * list, void (*fn) (bt_extract *, char *),
+           bt_extract * extract)
+{
+   char *  item;
+   char *  end;
+
+   for (item = strtok (list, ","); item; item = strtok (NULL, ","))
+   {
+      while (isspace ((unsigned char) *item))
+         item++;
+      for (end = item + strlen (item);
+           end > item && isspace ((unsigned char) end[-1]);
+           end--)
+         ;
+      *end = (char) 0;
+      if (*item)
+         (*fn) (extract, item);
+   }
+}
+
+
+static void
+add_bibdata (bt_extract * extract, char * name)
+{
+   int  i;
+
+   for (i = 0; i < extract->num_bibdata; i++)
+   {
+      if (strcmp (extract->bibdata[i], name) == 0)
+         return;
+   }
+   extract->bibdata = (char **)
+      realloc (extract->bibdata, (extract->num_bibdata + 1) * sizeof (char *));
+   extract->bibdata[extract->num_bibdata++] = strdup (name);
+}
+
+
+/*
+ * Returns the argument of `command' if `line' starts with it (in
+ * `line', nul-terminated at the closing brace), or NULL.
+ */
+static char *
+command_arg (char * line, char * command)
+{
+   int     len;
+   char *  end;
+
+   len = strlen (command);
+   if (strncmp (line, command, len) != 0 || line[len] != '{')
+      return NULL;
+   line += len + 1;
+   if ((end = strchr (line, '}')) == NULL)
+      return NULL;
+   *end = (char) 0;
+   return line;
+}
+
+
+static int
+read_aux (bt_extract * extract, char * auxname, char * dir, int depth)
+{
+   FILE *   auxfile;
+   char *   line;
+   char *   arg;
+   char *   path;
+   int      size, len, c, count;
+
+   if ((auxfile = fopen (auxname, "r")) == NULL)
+      return -1;
+
+   count = 0;
+   size = 256;
+   line = (char *) malloc (size);
+   for (;;)
+   {
+      len = 0;
+      while ((c = getc (auxfile)) != EOF && c != '\n')
+      {
+         if (len + 1 >= size)
+            line = (char *) realloc (line, size *= 2);
+         line[len++] = (char) c;
+      }
+      if (len == 0 && c == EOF)
+         break;
+      line[len] = (char) 0;
+
+      if ((arg = command_arg (line, "\\citation")))
+      {
+         each_item (arg, bt_extract_cite, extract);
+         count++;
+      }
+      else if ((arg = command_arg (line, "\\bibdata")))
+      {
+         each_item (arg, add_bibdata, extract);
+      }
+      else if ((arg = command_arg (line, "\\@input")))
+      {
+         if (depth >= MAX_AUX_DEPTH)
+         {
+            error (BTERR_CONTENT, auxname, -1,
+                   "\\@input nested too deeply: \"%s\" skipped", arg);
+            continue;
+         }
+         path = (char *) malloc (strlen (dir) + strlen (arg) + 1);
+         strcpy (path, arg[0] == '/' ? "" : dir);
+         strcat (path, arg);
+         len = read_aux (extract, path, dir, depth + 1);
+         if (len < 0)
+            error (BTERR_CONTENT, auxname, -1,
+                   "can't open \"%s\" (from \\@input)", path);
+         else
+            count += len;
+         free (path);
+      }
+   }
+
+   free (line);
+   fclose (auxfile);
+   return count;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_extract_aux()
+@INPUT      : extract
+              auxname - name of a LaTeX .aux file
+@RETURNS    : the number of \citation commands read, or -1 if the file
+              couldn't be opened
+@DESCRIPTION: Reads the citations (\citation{key,...}) and the database
+              names (\bibdata{name,...}) from an .aux file, and from the
+              files it \@input's (as \include does), which are looked
+              for in the same directory as the first.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_extract_aux (bt_extract * extract, char * auxname)
+{
+   char *  dir;
+   char *  slash;
+   int     count;
+
+   dir = strdup (auxname);
+   slash = strrchr (dir, '/');
+   if (slash)
+      slash[1] = (char) 0;
+   else
+      dir[0] = (char) 0;
+   count = read_aux (extract, auxname, dir, 0);
+   free (dir);
+   return count;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_extract_bibdata()
+@INPUT      : extract
+@OUTPUT     : *num_names - number of database names
+@RETURNS    : the database names from the \bibdata commands read so far
+              (as they were given, usually without ".bib"); the array
+              belongs to the extraction
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+char ** bt_extract_bibdata (bt_extract * extract, int * num_names)
+{
+   *num_names = extract->num_bibdata;
+   return extract->bibdata;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Scanning .bib files
+ */
+
+/* Records where the macros defined by an @string entry are. */
+static void
+index_macros (bt_extract * extract, bt_entry_text * text, int file)
+{
+   AST *          entry;
+   AST *          field;
+   char *         name;
+   boolean        status;
+   unsigned long  hash[2];
+   xslot *        slot;
+
+   entry = bt_parse_entry_s (text->text, extract->filenames[file],
+                             text->line, BTO_CHECKONLY | BTO_NOSTORE,
+                             &status);
+   if (entry == NULL)
+      return;
+   field = NULL;
+   while ((field = bt_next_field (entry, field, &name)))
+   {
+      hash_text (name, strlen (name), hash);
+      if ((slot = find_slot (&extract->macros, hash)) == NULL)
+         slot = add_slot (&extract->macros, hash);
+      slot->file = file;                /* the last definition counts */
+      slot->line = text->line;
+      slot->offset = text->offset;
+      slot->order = extract->order;
+   }
+   bt_free_ast (entry);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_extract_file()
+@INPUT      : extract
+              filename - a .bib file
+@RETURNS    : the number of entries found, or -1 if the file couldn't be
+              opened
+@DESCRIPTION: Scans a .bib file, noting where each regular entry is (by
+              key, found without parsing the entry), where each macro is
+              defined (by parsing the @string entries, which are usually
+              few), and where the preambles are.  The file is kept open
+              for bt_extract_write(), until bt_extract_free().  When a
+              key is in more than one entry, the first one counts, as it
+              does for BibTeX.
+@GLOBALS    : StringOptions
+@CALLS      : bt_read_entry_text()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_extract_file (bt_extract * extract, char * filename)
+{
+   FILE *          infile;
+   btshort         saved[NUM_METATYPES];
+   bt_reader *     reader;
+   bt_entry_text   text;
+   int             file, count, parsed;
+   unsigned long   hash[2];
+   xslot *         slot;
+
+   if ((infile = fopen (filename, "r")) == NULL)
+      return -1;
+   file = extract->num_files++;
+   extract->filenames = (char **)
+      realloc (extract->filenames, extract->num_files * sizeof (char *));
+   extract->files = (FILE **)
+      realloc (extract->files, extract->num_files * sizeof (FILE *));
+   extract->filenames[file] = strdup (filename);
+   extract->files[file] = infile;
+
+   save_stringopts (saved, BTO_MINIMAL);
+   reader = bt_open_reader (infile);
+   count = parsed = 0;
+   while (bt_read_entry_text (reader, &text))
+   {
+      count++;
+      extract->order++;
+      switch (text.metatype)
+      {
+         case BTE_REGULAR:
+            if (text.key == NULL)
+               break;
+            hash_text (text.key, text.key_length, hash);
+            if (find_slot (&extract->entries, hash))
+               break;
+            slot = add_slot (&extract->entries, hash);
+            slot->file = file;
+            slot->line = text.line;
+            slot->offset = text.offset;
+            slot->order = extract->order;
+            break;
+
+         case BTE_MACRODEF:
+            index_macros (extract, &text, file);
+            parsed++;
+            break;
+
+         case BTE_PREAMBLE:
+            extract->preambles = (xslot *)
+               realloc (extract->preambles,
+                        (extract->num_preambles + 1) * sizeof (xslot));
+            slot = &extract->preambles[extract->num_preambles++];
+            memset (slot, 0, sizeof (xslot));
+            slot->file = file;
+            slot->line = text.line;
+            slot->offset = text.offset;
+            slot->order = extract->order;
+            break;
+
+         default:
+            break;
+      }
+   }
+
+   if (parsed)                          /* clean up after the parser */
+      bt_parse_entry_s (NULL, NULL, 0, 0, NULL);
+   bt_close_reader (reader);
+   restore_stringopts (saved);
+   return count;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Writing the extract
+ */
+
+/* Reads and parses the entry at `slot'; *text is left for writing. */
+static AST *
+read_slot (bt_extract * extract, xslot * slot, bt_entry_text * text,
+           bt_reader ** reader)
+{
+   FILE *   infile;
+   boolean  status;
+
+   infile = extract->files[slot->file];
+   if (fseek (infile, slot->offset, SEEK_SET) != 0)
+      return NULL;
+   bt_close_reader (*reader);
+   *reader = bt_open_reader (infile);
+   if (!bt_read_entry_text (*reader, text))
+      return NULL;
+   text->line = slot->line;
+   extract->parsed++;
+   return bt_parse_entry_s (text->text, extract->filenames[slot->file],
+                            slot->line, BTO_NOSTORE, &status);
+}
+
+
+/* Wants the @string entry defining `macro' (if any: it may be one of the
+ * month names every style defines), and adds it to the list `strings'. */
+static void want_macros (bt_extract * extract, AST * entry,
+                         xslot *** strings, int * num_strings);
+
+static void
+want_macro (bt_extract * extract, char * macro,
+            xslot *** strings, int * num_strings)
+{
+   unsigned long  hash[2];
+   xslot *        slot;
+   bt_entry_text  text;
+   bt_reader *    reader;
+   AST *          entry;
+
+   hash_text (macro, strlen (macro), hash);
+   if ((slot = find_slot (&extract->macros, hash)) == NULL || slot->wanted)
+      return;
+   slot->wanted = WANT_CITED;
+   *strings = (xslot **)
+      realloc (*strings, (*num_strings + 1) * sizeof (xslot *));
+   (*strings)[(*num_strings)++] = slot;
+
+   /* the macros used in its definitions are wanted too */
+   reader = NULL;
+   entry = read_slot (extract, slot, &text, &reader);
+   if (entry)
+   {
+      want_macros (extract, entry, strings, num_strings);
+      bt_free_ast (entry);
+   }
+   bt_close_reader (reader);
+}
+
+
+static void
+want_macros (bt_extract * extract, AST * entry,
+             xslot *** strings, int * num_strings)
+{
+   AST *        field;
+   AST *        value;
+   char *       name;
+   char *       text;
+   bt_nodetype  type;
+
+   field = NULL;
+   while ((field = bt_next_field (entry, field, &name)))
+   {
+      value = NULL;
+      while ((value = bt_next_value (field, value, &type, &text)))
+      {
+         if (type == BTAST_MACRO && text)
+            want_macro (extract, text, strings, num_strings);
+      }
+   }
+}
+
+
+static int
+compare_order (const void * a, const void * b)
+{
+   return (*(xslot **) a)->order - (*(xslot **) b)->order;
+}
+
+
+static void
+write_slot (bt_extract * extract, xslot * slot, FILE * outfile,
+            bt_reader ** reader)
+{
+   bt_entry_text  text;
+   FILE *         infile;
+
+   infile = extract->files[slot->file];
+   if (fseek (infile, slot->offset, SEEK_SET) != 0)
+      return;
+   bt_close_reader (*reader);
+   *reader = bt_open_reader (infile);
+   if (bt_read_entry_text (*reader, &text))
+   {
+      fwrite (text.text, 1, text.length, outfile);
+      fputs ("\n\n", outfile);
+   }
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_extract_write()
+@INPUT      : extract
+              outfile
+@RETURNS    : the number of regular entries written
+@DESCRIPTION: Writes every preamble, then the @string entries defining
+              the macros used by the wanted entries, then the wanted
+              entries themselves, each exactly as it was in its file.
+              The wanted entries are the cited ones, and the entries
+              they cross-reference (and so on up); only these are parsed.
+              Cited entries are written in the order of the files, and
+              parents that weren't cited themselves come after all of
+              them, as BibTeX needs.  Citations that aren't found are
+              reported as warnings.
+@GLOBALS    : StringOptions
+@CALLS      : bt_parse_entry_s(), bt_read_entry_text()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_extract_write (bt_extract * extract, FILE * outfile)
+{
+   btshort         saved[NUM_METATYPES];
+   xslot **        wanted;
+   xslot **        strings;
+   int             num_wanted, num_strings, num_cited, i;
+   unsigned long   hash[2];
+   xslot *         slot;
+   bt_reader *     reader;
+   bt_entry_text   text;
+   AST *           entry;
+   AST *           field;
+   char *          name;
+   char *          parent;
+
+   wanted = NULL;
+   num_wanted = 0;
+   strings = NULL;
+   num_strings = 0;
+   reader = NULL;
+   save_stringopts (saved, BTO_MINIMAL);
+
+   /* the cited entries */
+   if (extract->cite_all)
+   {
+      for (i = 0; i < extract->entries.count; i++)
+      {
+         slot = &extract->entries.slots[i];
+         slot->wanted = WANT_CITED;
+         wanted = (xslot **) realloc (wanted, (num_wanted+1) * sizeof (xslot *));
+         wanted[num_wanted++] = slot;
+      }
+   }
+   for (i = 0; i < extract->num_cited; i++)
+   {
+      hash_text (extract->cited[i], strlen (extract->cited[i]), hash);
+      if ((slot = find_slot (&extract->entries, hash)) == NULL)
+      {
+         error (BTERR_CONTENT, NULL, -1,
+                "no entry for citation \"%s\"", extract->cited[i]);
+         continue;
+      }
+      if (slot->wanted)
+         continue;
+      slot->wanted = WANT_CITED;
+      wanted = (xslot **) realloc (wanted, (num_wanted+1) * sizeof (xslot *));
+      wanted[num_wanted++] = slot;
+   }
+   num_cited = num_wanted;
+
+   /*
+    * Parse each wanted entry, for the macros it uses and the entry it
+    * cross-references (which is added to the end of the list).
+    */
+   for (i = 0; i < num_wanted; i++)
+   {
+      entry = read_slot (extract, wanted[i], &text, &reader);
+      if (entry == NULL)
+         continue;
+      want_macros (extract, entry, &strings, &num_strings);
+
+      field = NULL;
+      while ((field = bt_next_field (entry, field, &name)))
+      {
+         if (strcmp (name, "crossref") == 0)
+            break;
+      }
+      if (field && (parent = bt_get_text (field)))
+      {
+         hash_text (parent, strlen (parent), hash);
+         if ((slot = find_slot (&extract->entries, hash)) == NULL)
+         {
+            ast_error (BTERR_CONTENT, field,
+                       "crossref to undefined entry \"%s\"", parent);
+         }
+         else if (!slot->wanted)
+         {
+            slot->wanted = WANT_PARENT;
+            wanted = (xslot **)
+               realloc (wanted, (num_wanted+1) * sizeof (xslot *));
+            wanted[num_wanted++] = slot;
+         }
+         free (parent);
+      }
+      bt_free_ast (entry);
+   }
+   if (extract->parsed)                 /* clean up after the parser */
+      bt_parse_entry_s (NULL, NULL, 0, 0, NULL);
+   extract->parsed = 0;
+   restore_stringopts (saved);
+
+   /* and write it all out */
+   for (i = 0; i < extract->num_preambles; i++)
+      write_slot (extract, &extract->preambles[i], outfile, &reader);
+
+   qsort (strings, num_strings, sizeof (xslot *), compare_order);
+   for (i = 0; i < num_strings; i++)
+   {
+      if (i > 0 && strings[i]->order == strings[i-1]->order)
+         continue;                      /* one entry, several macros */
+      write_slot (extract, strings[i], outfile, &reader);
+   }
+
+   qsort (wanted, num_cited, sizeof (xslot *), compare_order);
+   qsort (wanted + num_cited, num_wanted - num_cited, sizeof (xslot *),
+          compare_order);
+   for (i = 0; i < num_wanted; i++)
+      write_slot (extract, wanted[i], outfile, &reader);
+
+   bt_close_reader (reader);
+   free (wanted);
+   free (strings);
+   return num_wanted;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_extract_free()
+@INPUT      : extract
+@DESCRIPTION: Frees an extraction, and closes its .bib files.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_extract_free (bt_extract * extract)
+{
+   int  i;
+
+   if (extract == NULL)
+      return;
+   for (i = 0; i < extract->num_cited; i++)
+      free (extract->cited[i]);
+   free (extract->cited);
+   for (i = 0; i < extract->num_bibdata; i++)
+      free (extract->bibdata[i]);
+   free (extract->bibdata);
+   for (i = 0; i < extract->num_files; i++)
+   {
+      fclose (extract->files[i]);
+      free (extract->filenames[i]);
+   }
+   free (extract->filenames);
+   free (extract->files);
+   free (extract->entries.slots);
+   htable_free (&extract->entries.index);
+   free (extract->macros.slots);
+   htable_free (&extract->macros.index);
+   free (extract->preambles);
+   free (extract);
+}
@@ -371,6 +371,13 @@ count_virtual_char (char *    string,
            /* Have to take care with UTF-8 chars here - we need to increment
               only when we have a full character which could be multi-byte */
          {
+           /* plain ASCII, not followed by a combining mark: one char */
+           if (*utf8_length == 0 &&
+               !((string[offset] | string[offset+1]) & 0x80))
+           {
+             (*vchar_count)++;
+             return;
+           }
            /* not tracking utf8 char yet, so start */ 
            if (*utf8_length == 0)
              *utf8_length = get_uchar(string, offset);
@@ -404,9 +411,10 @@ count_virtual_char (char *    string,
               "H{\\'e}ll{\\\"o}".  "{\\noop Hello there how are you?}" has
               virtual length one.
 @CALLS      : count_virtual_char()
+              ascii_span()
 @CALLERS    : format_name()
 @CREATED    : 1997/11/03, GPW
-@MODIFIED   : 
+@MODIFIED   : 2026/10/19: fast path for plain ASCII
 -------------------------------------------------------------------------- */
 static int
 string_length (char * string)
@@ -420,6 +428,12 @@ string_length (char * string)
    if (string == NULL)
       return 0;
 
+   /* plain ASCII without braces is just what it looks like */
+   length = strlen (string);
+   if (ascii_span (string, length) == length &&
+       strpbrk (string, "{}") == NULL)
+      return length;
+
    length = 0;
    depth = 0;
    in_special = FALSE;
@@ -0,0 +1,330 @@
+#!/usr/bin/perl -w
+
+# gen_tex_chars.pl
+#
+# Generates the tables of TeX control sequences used by string_util.c
+# and tex_unicode.c from tex_chars.dat (and Perl's Unicode database):
+#
+#    perl gen_tex_chars.pl tex_chars.dat tex_chars.h tex_composed.h tex_fold.h
+#
+# tex_chars.h is a perfect hash table: every control sequence has a slot
+# of its own, found by hashing its name twice with tex_char_hash() (in
+# string_util.c, which must hash just as hash() here does): once with
+# the number of buckets as seed, to pick a bucket, and then with the
+# bucket's seed, chosen below.  So a lookup is two hashes of a few
+# characters and one comparison.
+#
+# tex_composed.h has, for each accent and each letter, the precomposed
+# character that Unicode canonical composition (NFC) makes of the letter
+# and the accent's combining character, or 0 if there isn't one.
+#
+# tex_fold.h says what fold_text() (in tex_unicode.c) makes of each
+# non-ASCII character of the Basic Multilingual Plane, in ranges: a
+# letter or digit is lowercased, stripped of its accents (after
+# compatibility decomposition, NFKD) and spelled as the foreign letters
+# of tex_chars.dat are purified, so that `\x{d8}' and `\x{1fe}' are
+# both `o', just as `{\O}' and `\'{\O}' are -- or, keeping its accents,
+# just lowercased (after NFKC); a space or dash separates words;
+# anything else (punctuation, symbols, and combining marks if the
+# accents go) is dropped.
+#
+# $Id$
+
+use strict;
+use Unicode::Normalize qw(NFC NFKC NFKD);
+use Unicode::UCD ();
+
+die "usage: $0 datafile header composed_header fold_header\n"
+   unless @ARGV == 4;
+my ($datafile, $header, $composed_header, $fold_header) = @ARGV;
+(my $dataname = $datafile) =~ s{.*[/\\]}{};
+
+my (@chars, %seen, @accents);
+open (DATA, '<', $datafile) or die "$datafile: $!\n";
+while (<DATA>)
+{
+   next if /^\s*(#|$)/;
+   my ($name, $kind, @forms) = split;
+   die "$datafile, line $.: expected 6 columns\n" unless @forms == 4;
+   die "$datafile, line $.: bad kind \"$kind\"\n"
+      unless $kind =~ /^(letter|accent|symbol|command|skip)$/;
+   die "$datafile, line $.: \\$name seen already\n" if $seen{$name}++;
+   die "$datafile, line $.: bad control sequence \"$name\"\n"
+      unless $name =~ /^([a-zA-Z]+|[^a-zA-Z\s])$/;
+
+   my $unicode = pop @forms;
+   my $code = 0;
+   if ($unicode ne '-')
+   {
+      die "$datafile, line $.: bad character \"$unicode\"\n"
+         unless $unicode =~ /^U\+([0-9A-Fa-f]{4,6})$/;
+      $code = hex $1;
+   }
+   die "$datafile, line $.: a $kind needs a character\n"
+      if $kind =~ /^(letter|accent|symbol)$/ && !$code;
+   die "$datafile, line $.: a $kind has no character\n"
+      if $kind =~ /^(command|skip)$/ && $code;
+
+   @forms = map { $_ eq '-' ? undef : $_ } @forms;
+   for my $form (@forms)
+   {
+      die "$datafile, line $.: \"$form\" longer than \\$name\n"
+         if defined $form && length ($form) > length ($name) + 1;
+   }
+   die "$datafile, line $.: a letter needs all three forms\n"
+      if $kind eq 'letter' && grep { !defined } @forms;
+   die "$datafile, line $.: only a letter has forms\n"
+      if $kind ne 'letter' && grep { defined } @forms;
+
+   my $char = { name => $name, kind => $kind, forms => \@forms,
+                code => $code, accent => -1 };
+   if ($kind eq 'accent')
+   {
+      $char->{accent} = @accents;
+      push (@accents, $char);
+   }
+   push (@chars, $char);
+}
+close (DATA);
+
+# must match tex_char_hash() in string_util.c
+sub hash
+{
+   my ($name, $seed) = @_;
+   my $h = $seed;
+   $h = (($h * 33) ^ ord ($_)) % 4294967296 for split (//, $name);
+   $h ^ ($h >> 15);
+}
+
+# "Hash and displace": the control sequences are hashed (with a fixed
+# seed) into buckets, and each bucket gets a seed of its own that hashes
+# all of its control sequences into empty slots of the table.  The
+# biggest buckets are placed first, while the table is emptiest.
+my $buckets = 1;
+$buckets *= 2 while $buckets < @chars / 2;
+my $size = 1;
+$size *= 2 while $size < @chars * 1.5;
+
+my (@bucket, @seeds, @slots);
+push (@{$bucket[hash ($_->{name}, $buckets) % $buckets]}, $_) for @chars;
+
+BUCKET:
+for my $k (sort { @{$bucket[$b] || []} <=> @{$bucket[$a] || []} }
+           0 .. $buckets-1)
+{
+   $seeds[$k] = 0;
+   next BUCKET unless $bucket[$k];
+   SEED:
+   for my $seed (1 .. 1000000)
+   {
+      my %taken;
+      for my $char (@{$bucket[$k]})
+      {
+         my $slot = hash ($char->{name}, $seed) % $size;
+         next SEED if $slots[$slot] || $taken{$slot}++;
+      }
+      $slots[hash ($_->{name}, $seed) % $size] = $_ for @{$bucket[$k]};
+      $seeds[$k] = $seed;
+      next BUCKET;
+   }
+   die "$0: no seed places bucket $k; try a bigger table\n";
+}
+
+my $maxlen = 0;
+for (@chars) { $maxlen = length $_->{name} if length $_->{name} > $maxlen }
+
+sub c_string
+{
+   my ($s) = @_;
+   return 'NULL' unless defined $s;
+   $s =~ s/([\\"])/\\$1/g;
+   "\"$s\"";
+}
+
+open (OUT, '>', $header) or die "$header: $!\n";
+print OUT <<"EOT";
+/*
+ * tex_chars.h
+ *
+ * Generated from $dataname by gen_tex_chars.pl -- don't edit it, edit
+ * $dataname.  The types are in prototypes.h.
+ */
+
+#define TEX_CHARS_SIZE    $size
+#define TEX_CHARS_BUCKETS $buckets
+#define TEX_CHARS_MAXLEN  $maxlen
+
+static unsigned long tex_chars_seeds[TEX_CHARS_BUCKETS] =
+{
+EOT
+
+my @s = @seeds;
+while (@s)
+{
+   print OUT "   ", join (', ', map { "${_}UL" } splice (@s, 0, 8)),
+      (@s ? ",\n" : "\n");
+}
+print OUT "};\n\nstatic tex_char tex_chars[TEX_CHARS_SIZE] =\n{\n";
+
+for my $i (0 .. $size-1)
+{
+   my $char = $slots[$i];
+   my $sep = $i < $size-1 ? ',' : '';
+   if ($char)
+   {
+      printf OUT "   { %s, %s, %s, %s, %s, 0x%04X, %d }%s\n",
+         c_string ($char->{name}), 'TEX_' . uc $char->{kind},
+         map (c_string ($_), @{$char->{forms}}),
+         $char->{code}, $char->{accent}, $sep;
+   }
+   else
+   {
+      print OUT "   { NULL, TEX_NONE, NULL, NULL, NULL, 0, -1 }$sep\n";
+   }
+}
+print OUT "};\n";
+close (OUT) or die "$header: $!\n";
+
+# the letters that accents go on: A-Z, then a-z
+my @letters = ('A' .. 'Z', 'a' .. 'z');
+my $num_accents = @accents;
+my $num_letters = @letters;
+
+open (OUT, '>', $composed_header) or die "$composed_header: $!\n";
+print OUT <<"EOT";
+/*
+ * tex_composed.h
+ *
+ * Generated from $dataname by gen_tex_chars.pl -- don't edit it, edit
+ * $dataname.  tex_composed[accent][letter] is the precomposed character
+ * for an accent (its index among the accents of $dataname) on a
+ * letter (A-Z, then a-z), or 0 if Unicode has none.
+ */
+
+#define TEX_NUM_ACCENTS  $num_accents
+#define TEX_NUM_LETTERS  $num_letters
+
+static int tex_composed[TEX_NUM_ACCENTS][TEX_NUM_LETTERS] =
+{
+EOT
+
+for my $i (0 .. $#accents)
+{
+   my @codes;
+   for my $letter (@letters)
+   {
+      my $nfc = NFC ($letter . chr ($accents[$i]{code}));
+      push (@codes, length ($nfc) == 1 ? sprintf ("0x%04X", ord $nfc) : 0);
+   }
+   print OUT "   {                                    /* \\$accents[$i]{name} */\n";
+   while (@codes)
+   {
+      print OUT "      ", join (', ', splice (@codes, 0, 8)),
+         (@codes ? ",\n" : "\n");
+   }
+   print OUT "   }", ($i < $#accents ? ",\n" : "\n");
+}
+print OUT "};\n";
+close (OUT) or die "$composed_header: $!\n";
+
+# Folding: what each character becomes -- without its accents, or
+# (for looking for accented text) with them.  undef means it's kept as
+# it is; ' ' that it separates words; '' that it's dropped.
+my %letter_fold;
+for (grep { $_->{kind} eq 'letter' } @chars)
+{
+   $letter_fold{chr $_->{code}} = lc $_->{forms}[0];
+}
+
+sub fold
+{
+   my ($char, $accents) = @_;
+
+   return undef if $char =~ /\p{Hangul}/;   # syllables are letters as is
+   return ' ' if $char =~ /[\p{Zs}\p{Pd}]/;
+   return ($accents ? undef : '') if $char =~ /\p{M}/;
+   return '' unless $char =~ /[\p{L}\p{N}]/;
+
+   my $folded = '';
+   for my $c (split (//, lc ($accents ? NFKC ($char) : NFKD ($char))))
+   {
+      next if $c =~ /\p{M}/ && !$accents;
+      $c = $letter_fold{$c} if !$accents && exists $letter_fold{$c};
+      if ($c =~ /^[\p{L}\p{N}\p{M}]+$/)
+      {
+         $folded .= $c;
+      }
+      elsif ($c =~ /^[\p{Zs}\p{Pd}]$/)
+      {
+         $folded .= ' ' unless $folded =~ / $/;
+      }
+   }
+   $folded =~ s/^ | $//g;
+   return $folded eq $char ? undef : $folded;
+}
+
+sub c_utf8
+{
+   my ($s) = @_;
+   return 'NULL' unless defined $s;
+   utf8::encode ($s);
+   $s =~ s/([^a-z0-9 ])/sprintf ("\\%03o", ord $1)/ge;
+   "\"$s\"";
+}
+
+sub same
+{
+   my ($x, $y) = @_;
+   defined $x ? defined $y && $x eq $y : !defined $y;
+}
+
+# consecutive characters that fold alike (kept, dropped, or made into
+# spaces, both ways) share a range; the others have one each
+my @ranges;
+for my $code (0x80 .. 0xFFFF)
+{
+   my @folded = ($code >= 0xD800 && $code <= 0xDFFF)
+              ? (undef, undef)
+              : (fold (chr $code, 0), fold (chr $code, 1));
+   my $last = $ranges[-1];
+   my $letters = grep { defined && !/^ ?$/ } @folded;
+   if ($last && !$letters &&
+       same ($last->[2], $folded[0]) && same ($last->[3], $folded[1]))
+   {
+      $last->[1] = $code;
+   }
+   else
+   {
+      push (@ranges, [$code, $code, @folded]);
+   }
+}
+my $num_ranges = @ranges;
+my $unicode_version = Unicode::UCD::UnicodeVersion ();
+
+open (OUT, '>', $fold_header) or die "$fold_header: $!\n";
+print OUT <<"EOT";
+/*
+ * tex_fold.h
+ *
+ * Generated from $dataname and Perl's Unicode database (version
+ * $unicode_version) by gen_tex_chars.pl -- don't edit it.  tex_fold[]
+ * covers U+0080 to U+FFFF in ascending ranges, each with what its
+ * characters fold to, without their accents and with them: NULL (kept
+ * as they are), " " (a word separator), "" (dropped), or the UTF-8 of
+ * the folded letters.  The type is in tex_unicode.c.
+ */
+
+#define TEX_FOLD_SIZE  $num_ranges
+
+static fold_range tex_fold[TEX_FOLD_SIZE] =
+{
+EOT
+for my $i (0 .. $#ranges)
+{
+   printf OUT "   { 0x%04X, 0x%04X, %s, %s }%s\n",
+      $ranges[$i][0], $ranges[$i][1],
+      c_utf8 ($ranges[$i][2]), c_utf8 ($ranges[$i][3]),
+      ($i < $#ranges ? ',' : '');
+}
+print OUT "};\n";
+close (OUT) or die "$fold_header: $!\n";
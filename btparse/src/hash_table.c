@@ -0,0 +1,195 @@
+/* ------------------------------------------------------------------------
+@NAME       : hash_table.c
+@DESCRIPTION: The hash table shared by the modules that index entries
+              by key (crossref.c, extract.c, merge.c, dedup.c), terms
+              (index.c) or names (names.c), and the key hash they use:
+
+                hash_text
+                htable_find
+                htable_add
+                htable_remove
+                htable_free
+
+              A table maps hashes to ids -- indexes into an array kept
+              by the caller, which holds whatever goes with a key
+              (usually including the key itself, or a second hash of
+              it).  Several ids can have the same hash, so htable_find()
+              hands back each in turn, for the caller to compare keys.
+              The table uses open addressing with linear probing, and
+              is kept at most half full; a slot (a hash and an id) is
+              16 bytes on most 64-bit systems.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse library.  This library is
+              free software; you can redistribute it and/or modify it under
+              the terms of the GNU Library General Public License as
+              published by the Free Software Foundation; either version 2
+              of the License, or (at your option) any later version.
+-------------------------------------------------------------------------- */
+
+#include "bt_config.h"
+#include <stdlib.h>
+#include <ctype.h>
+#include "btparse.h"
+#include "prototypes.h"
+#include "my_dmalloc.h"
+#include "bt_debug.h"
+
+
+#define MIN_SIZE 256
+
+
+/* ------------------------------------------------------------------------
+@NAME       : hash_text()
+@INPUT      : text   - a key or macro name (need not be terminated)
+              length - its length
+@OUTPUT     : hash   - two independent 32-bit hashes of it, lowercased:
+                       FNV-1a, then djb2 (which is never zero)
+@DESCRIPTION: Hashes a key ignoring case, as BibTeX compares keys.
+              hash[0] is what goes in a table; hash[1] is for telling
+              keys apart without keeping them.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void hash_text (char * text, int length, unsigned long * hash)
+{
+   unsigned long  h1 = 2166136261UL;    /* FNV-1a */
+   unsigned long  h2 = 5381;            /* djb2 */
+   int            c, i;
+
+   for (i = 0; i < length; i++)
+   {
+      c = tolower ((unsigned char) text[i]);
+      h1 = ((h1 ^ c) * 16777619UL) & 0xffffffffUL;
+      h2 = ((h2 * 33) ^ c) & 0xffffffffUL;
+   }
+   hash[0] = h1;
+   hash[1] = h2 | 1;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : htable_find()
+@INPUT      : table
+              hash
+@INOUT      : slot  - -1 to start with; then where the last id was found
+@RETURNS    : the next id with this hash, or -1 if there are no more
+@DESCRIPTION: Finds the ids with a given hash, one at a time:
+
+                 slot = -1;
+                 while ((id = htable_find (table, hash, &slot)) >= 0)
+                    if (<id's key is the one wanted>)
+                       break;
+
+              Once found, an id can be replaced in place by setting
+              table->slots[slot].id.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int htable_find (htable * table, unsigned long hash, int * slot)
+{
+   int  mask, i;
+
+   if (table->size == 0)
+      return -1;
+   mask = table->size - 1;
+   i = (*slot < 0) ? (int) (hash & mask) : ((*slot + 1) & mask);
+   for ( ; table->slots[i].id >= 0; i = (i + 1) & mask)
+   {
+      if (table->slots[i].hash == hash)
+      {
+         *slot = i;
+         return table->slots[i].id;
+      }
+   }
+   return -1;
+}
+
+
+static void
+put (htable * table, unsigned long hash, int id)
+{
+   int  mask, i;
+
+   mask = table->size - 1;
+   for (i = hash & mask; table->slots[i].id >= 0; i = (i + 1) & mask)
+      ;
+   table->slots[i].hash = hash;
+   table->slots[i].id = id;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : htable_add()
+@INPUT      : table
+              hash
+              id    - (not negative)
+@DESCRIPTION: Adds an id to the table, whether or not its hash is there
+              already, doubling the table first if it's half full.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void htable_add (htable * table, unsigned long hash, int id)
+{
+   hslot *  old_slots;
+   int      old_size, i;
+
+   if (2 * (table->count + 1) > table->size)
+   {
+      old_size = table->size;
+      old_slots = table->slots;
+      table->size = old_size ? 2 * old_size : MIN_SIZE;
+      table->slots = (hslot *) malloc (table->size * sizeof (hslot));
+      for (i = 0; i < table->size; i++)
+         table->slots[i].id = -1;
+      for (i = 0; i < old_size; i++)
+      {
+         if (old_slots[i].id >= 0)
+            put (table, old_slots[i].hash, old_slots[i].id);
+      }
+      if (old_slots) free (old_slots);
+   }
+
+   put (table, hash, id);
+   table->count++;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : htable_remove()
+@INPUT      : table
+              slot  - where an id was found by htable_find()
+@DESCRIPTION: Takes an id out of the table.  The ids after it in the
+              same run of full slots are moved back as need be, so that
+              none is cut off from the slot its hash starts at.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void htable_remove (htable * table, int slot)
+{
+   int  mask, i, home;
+
+   mask = table->size - 1;
+   for (i = (slot + 1) & mask; table->slots[i].id >= 0; i = (i + 1) & mask)
+   {
+      home = table->slots[i].hash & mask;
+      if (((i - home) & mask) >= ((i - slot) & mask))
+      {
+         table->slots[slot] = table->slots[i];
+         slot = i;
+      }
+   }
+   table->slots[slot].id = -1;
+   table->count--;
+}
+
+
+void htable_free (htable * table)
+{
+   if (table->slots) free (table->slots);
+   table->slots = NULL;
+   table->size = table->count = 0;
+}
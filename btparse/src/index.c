@@ -0,0 +1,1453 @@
+/* ------------------------------------------------------------------------
+@NAME       : index.c
+@DESCRIPTION: A full-text index of a BibTeX file, and searching it:
+                bt_index_new
+                bt_index_file
+                bt_index_range
+                bt_index_write
+                bt_index_merge
+                bt_index_free
+                bt_search_open
+                bt_search_query
+                bt_search_filename
+                bt_search_close
+
+              The words of some fields of each regular entry -- their
+              values folded by fold_text() (so without case or accents,
+              however they are written), or for author and editor the
+              von and last parts of the names -- are indexed by field,
+              with their positions, so that queries can ask for words
+              and phrases in any or all of those fields.  A query
+              returns the byte offsets of the entries it matches, so
+              that they can be read (with bt_read_entry_text()) without
+              reading the rest of the file.  A big file can be indexed
+              in ranges, in parallel, and the indexes of the ranges
+              merged (bt_index_range(), bt_index_merge()).
+
+              The index file is written in one go, at the end:
+
+                "BTIX1\n"
+                the name of the BibTeX file
+                the number of fields, and their names
+                the number of entries, and their offsets
+                the number of terms, and for each: its field, its
+                  text, its number of entries, and the length of its
+                  postings
+                all the postings, term after term
+
+              Strings are a length and their bytes, and all numbers are
+              varints (7 bits a byte, low bits first, high bit set on
+              all but the last byte).  Offsets are written as the
+              difference from the one before; terms are sorted by field
+              and then text.  A term's postings are, for each entry it
+              is in, the difference between its entry number and the
+              last one (the first, plus one), then the differences
+              between its positions (the first, plus one), then a zero.
+
+              Searching reads everything but the postings into memory,
+              and the postings of just the terms in a query.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse library.  This library is
+              free software; you can redistribute it and/or modify it under
+              the terms of the GNU Library General Public License as
+              published by the Free Software Foundation; either version 2
+              of the License, or (at your option) any later version.
+-------------------------------------------------------------------------- */
+
+#include "bt_config.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include "btparse.h"
+#include "prototypes.h"
+#include "error.h"
+#include "my_dmalloc.h"
+#include "bt_debug.h"
+
+
+#define MAGIC        "BTIX1\n"
+#define MAGIC_LEN    6
+
+static char * default_fields[] =
+{
+   "title", "author", "editor", "abstract", "keywords"
+};
+
+#define NUM_DEFAULT_FIELDS \
+   ((int) (sizeof (default_fields) / sizeof (default_fields[0])))
+
+/* The fields whose values are lists of names */
+static char * name_fields[] = { "author", "editor", NULL };
+
+
+/*
+ * A term of the index being built: a word in one field, and its
+ * postings so far.  The last entry's positions are only terminated
+ * (with a zero) when the next entry is added, or the index written.
+ */
+typedef struct
+{
+   char *     text;
+   int        field;
+   int        num_docs;
+   int        last_doc;
+   int        last_pos;
+   bt_buffer  postings;
+} iterm;
+
+struct bt_index_s
+{
+   int        num_fields;
+   char **    fields;
+   boolean *  is_names;
+   char *     filename;                 /* of the file indexed */
+   int        num_docs;
+   int        max_docs;
+   long *     offsets;
+   int        num_terms;
+   int        max_terms;
+   iterm **   terms;
+   htable     table;                    /* of terms, by term_hash() */
+};
+
+/* A term in a search's dictionary */
+typedef struct
+{
+   int        field;
+   char *     text;
+   int        num_docs;
+   long       start;                    /* of its postings */
+   long       length;
+} sterm;
+
+struct bt_search_s
+{
+   FILE *     file;
+   char *     filename;                 /* of the file indexed */
+   int        num_fields;
+   char **    fields;
+   boolean *  is_names;
+   int        num_docs;
+   long *     offsets;
+   int        num_terms;
+   sterm *    terms;                    /* sorted by field and text */
+   long       postings;                 /* where the postings start */
+   char *     query;                    /* the query being parsed, */
+   char *     pos;                      /* and where we are in it */
+};
+
+/*
+ * A term's postings, decoded: the entries it's in, and where its
+ * positions in each one start in `positions' (for docs[i], they are
+ * positions[starts[i]] to positions[starts[i+1]-1]).
+ */
+typedef struct
+{
+   int        num_docs;
+   int *      docs;
+   int *      starts;
+   int *      positions;
+} plist;
+
+/* A set of entries (their numbers, in order) */
+typedef struct
+{
+   int        num;
+   int *      docs;
+} docset;
+
+
+/* ------------------------------------------------------------------------
+ * Varints
+ */
+
+static void
+put_varint (bt_buffer * buf, unsigned long value)
+{
+   while (value >= 0x80)
+   {
+      buf_append_char (buf, (char) ((value & 0x7f) | 0x80));
+      value >>= 7;
+   }
+   buf_append_char (buf, (char) value);
+}
+
+
+static void
+put_string (bt_buffer * buf, char * text)
+{
+   int  len = strlen (text);
+
+   put_varint (buf, len);
+   buf_append (buf, text, len);
+}
+
+
+/* Reads a varint from a stream; returns FALSE at EOF */
+static boolean
+read_varint (FILE * file, unsigned long * value)
+{
+   int  c, shift;
+
+   *value = 0;
+   for (shift = 0; shift < 64; shift += 7)
+   {
+      if ((c = getc (file)) == EOF)
+         return FALSE;
+      *value |= (unsigned long) (c & 0x7f) << shift;
+      if (!(c & 0x80))
+         return TRUE;
+   }
+   return FALSE;
+}
+
+
+static char *
+read_string (FILE * file)
+{
+   unsigned long  len;
+   char *         text;
+
+   if (!read_varint (file, &len) || len > 0xffff)
+      return NULL;
+   text = (char *) malloc (len + 1);
+   if (fread (text, 1, len, file) != len)
+   {
+      free (text);
+      return NULL;
+   }
+   text[len] = (char) 0;
+   return text;
+}
+
+
+/* Decodes a varint from memory, moving *p past it */
+static unsigned long
+get_varint (unsigned char ** p, unsigned char * end)
+{
+   unsigned long  value = 0;
+   int            shift;
+
+   for (shift = 0; *p < end && shift < 64; shift += 7)
+   {
+      value |= (unsigned long) (**p & 0x7f) << shift;
+      if (!(*(*p)++ & 0x80))
+         break;
+   }
+   return value;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Words
+ */
+
+static boolean
+is_name_field (char * field)
+{
+   int  i;
+
+   for (i = 0; name_fields[i]; i++)
+      if (strcmp (field, name_fields[i]) == 0)
+         return TRUE;
+   return FALSE;
+}
+
+
+/*
+ * Turns text into words, the same way for entries and queries: folds it
+ * (see fold_text()) into a copy, which is returned, and puts pointers to
+ * its words in *words (which has to be freed too, if there are any).
+ */
+static char *
+split_words (char * text, char *** words, int * num_words)
+{
+   char *  copy;
+   char *  p;
+   int     max;
+
+   copy = fold_text (text, FALSE);
+
+   *words = NULL;
+   *num_words = max = 0;
+   for (p = copy; *p; )
+   {
+      while (*p == ' ')
+         p++;
+      if (*p == (char) 0)
+         break;
+      if (*num_words == max)
+      {
+         max = max ? 2 * max : 16;
+         *words = (char **) realloc (*words, max * sizeof (char *));
+      }
+      (*words)[(*num_words)++] = p;
+      while (*p && *p != ' ')
+         p++;
+      if (*p)
+         *p++ = (char) 0;
+   }
+   return copy;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Building an index
+ */
+
+static unsigned long
+term_hash (int field, char * text)
+{
+   unsigned long  hash = 2166136261UL ^ (unsigned long) field;
+
+   for ( ; *text; text++)
+      hash = ((hash ^ (unsigned char) *text) * 16777619UL) & 0xffffffffUL;
+   return hash;
+}
+
+
+/* Finds a term of the index, adding it (with no postings) if it's new */
+static iterm *
+get_term (bt_index * index, int field, char * text)
+{
+   unsigned long  hash;
+   iterm *        term;
+   int            slot, id;
+
+   hash = term_hash (field, text);
+   slot = -1;
+   while ((id = htable_find (&index->table, hash, &slot)) >= 0)
+   {
+      term = index->terms[id];
+      if (term->field == field && strcmp (term->text, text) == 0)
+         return term;
+   }
+
+   if (index->num_terms == index->max_terms)
+   {
+      index->max_terms = index->max_terms ? 2 * index->max_terms : 1024;
+      index->terms = (iterm **)
+         realloc (index->terms, index->max_terms * sizeof (iterm *));
+   }
+   term = (iterm *) calloc (1, sizeof (iterm));
+   term->text = strdup (text);
+   term->field = field;
+   term->last_doc = -1;
+   htable_add (&index->table, hash, index->num_terms);
+   index->terms[index->num_terms++] = term;
+   return term;
+}
+
+
+/* Adds one occurrence of a word to the index */
+static void
+add_posting (bt_index * index, int field, char * text, int doc, int pos)
+{
+   iterm *  term;
+
+   term = get_term (index, field, text);
+   if (term->last_doc != doc)
+   {
+      if (term->last_doc >= 0 && term->last_pos >= -1)
+         put_varint (&term->postings, 0);
+      put_varint (&term->postings, doc - term->last_doc);
+      term->last_doc = doc;
+      term->last_pos = -1;
+      term->num_docs++;
+   }
+   if (pos > term->last_pos)            /* (a word twice in a place can't */
+   {                                    /* happen, but don't write a 0) */
+      put_varint (&term->postings, pos - term->last_pos);
+      term->last_pos = pos;
+   }
+}
+
+
+static void
+add_words (bt_index * index, int field, char * text, int doc, int * pos)
+{
+   char *   copy;
+   char **  words;
+   int      num_words, i;
+
+   copy = split_words (text, &words, &num_words);
+   for (i = 0; i < num_words; i++)
+      add_posting (index, field, words[i], doc, (*pos)++);
+   if (words)
+      free (words);
+   free (copy);
+}
+
+
+/*
+ * Adds the von and last parts of a list of names; there's a gap in the
+ * positions after each name, so that phrases don't run from one name
+ * into the next.
+ */
+static void
+add_names (bt_index * index, int field, char * text, AST * entry, int doc)
+{
+   bt_stringlist * list;
+   bt_name *       name;
+   int             i, j, pos;
+
+   list = bt_split_list (text, "and", entry->filename, entry->line, "name");
+   if (list == NULL)
+      return;
+
+   pos = 0;
+   for (i = 0; i < list->num_items; i++)
+   {
+      if (list->items[i] == NULL || strcmp (list->items[i], "others") == 0)
+         continue;
+      name = bt_split_name_cached (list->items[i], entry->filename,
+                                   entry->line, i);
+      for (j = 0; j < name->part_len[BTN_VON]; j++)
+         add_words (index, field, name->parts[BTN_VON][j], doc, &pos);
+      for (j = 0; j < name->part_len[BTN_LAST]; j++)
+         add_words (index, field, name->parts[BTN_LAST][j], doc, &pos);
+      pos++;
+      bt_free_name (name);
+   }
+   bt_free_list (list);
+}
+
+
+static void
+add_entry (bt_index * index, AST * entry, long offset)
+{
+   AST *    field;
+   char *   name;
+   char *   text;
+   int      doc, i, pos;
+
+   if (index->num_docs == index->max_docs)
+   {
+      index->max_docs = index->max_docs ? 2 * index->max_docs : 1024;
+      index->offsets = (long *)
+         realloc (index->offsets, index->max_docs * sizeof (long));
+   }
+   doc = index->num_docs++;
+   index->offsets[doc] = offset;
+
+   field = NULL;
+   while ((field = bt_next_field (entry, field, &name)))
+   {
+      for (i = 0; i < index->num_fields; i++)
+         if (strcmp (name, index->fields[i]) == 0)
+            break;
+      if (i == index->num_fields)
+         continue;
+
+      text = bt_get_text (field);
+      if (text == NULL)
+         continue;
+      if (index->is_names[i])
+         add_names (index, i, text, entry, doc);
+      else
+      {
+         pos = 0;
+         add_words (index, i, text, doc, &pos);
+      }
+      free (text);
+   }
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_index_new()
+@INPUT      : fields     - the fields to index (in lowercase), or NULL
+                           for title, author, editor, abstract and
+                           keywords
+              num_fields
+@RETURNS    : a new, empty index
+@DESCRIPTION: Starts an index.  Author and editor fields are indexed by
+              the words of the von and last parts of their names;
+              other fields by all their words.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+bt_index * bt_index_new (char ** fields, int num_fields)
+{
+   bt_index *  index;
+   int         i;
+
+   if (fields == NULL)
+   {
+      fields = default_fields;
+      num_fields = NUM_DEFAULT_FIELDS;
+   }
+
+   index = (bt_index *) calloc (1, sizeof (bt_index));
+   index->num_fields = num_fields;
+   index->fields = (char **) malloc (num_fields * sizeof (char *));
+   index->is_names = (boolean *) malloc (num_fields * sizeof (boolean));
+   for (i = 0; i < num_fields; i++)
+   {
+      index->fields[i] = strdup (fields[i]);
+      index->is_names[i] = is_name_field (fields[i]);
+   }
+   return index;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_index_file()
+@INOUT      : index
+@INPUT      : infile   - a BibTeX file, at its start
+              filename - its name (kept in the index, and used in
+                         error messages)
+@RETURNS    : the number of entries indexed, or -1 if the index already
+              has a file
+@DESCRIPTION: Reads a file to the end, indexing its regular entries (see
+              bt_index_range()).  An index is of one file.
+@CALLS      : bt_index_range()
+@CREATED    : 2026/10/19
+@MODIFIED   : 2026/10/19: the whole of bt_index_range()
+-------------------------------------------------------------------------- */
+int bt_index_file (bt_index * index, FILE * infile, char * filename)
+{
+   return bt_index_range (index, infile, filename, 0, -1);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_index_range()
+@INOUT      : index
+@INPUT      : infile   - a BibTeX file, at its start
+              filename - its name (kept in the index, and used in
+                         error messages)
+              start    - byte offset of the first entry to index
+              end      - and of the first not to (-1: to end-of-file)
+@RETURNS    : the number of entries indexed, or -1 if the index already
+              has a file
+@DESCRIPTION: Indexes the regular entries of a file that start (at
+              their '@') in a range of it.  Each entry is found with
+              bt_read_entry_text(), and then parsed with only the
+              indexed fields (see bt_set_projection()); @string entries
+              are parsed too, so that the values of the fields have
+              their macros expanded -- the ones before `start' quietly,
+              since any warnings about them are some other range's.
+              Nothing from `end' on is read at all, as later @strings
+              can't change an entry.
+
+              The ranges of a file can be indexed separately (in
+              separate processes, say) and the indexes merged, in order,
+              with bt_index_merge(): the result is just what
+              bt_index_file() would have made of the whole file.
+@GLOBALS    : StringOptions
+@CALLS      : bt_read_entry_text(), bt_parse_entry_s()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_index_range (bt_index * index, FILE * infile, char * filename,
+                    long start, long end)
+{
+   bt_reader *    reader;
+   bt_entry_text  text;
+   bt_errlist *   quiet, * saved;
+   AST *          entry;
+   btshort        saved_options[NUM_METATYPES];
+   boolean        status, quieted;
+   int            count, parsed;
+
+   if (index->filename != NULL)
+   {
+      usage_warning ("bt_index_file: index already has a file (%s)",
+                     index->filename);
+      return -1;
+   }
+   index->filename = strdup (filename);
+
+   save_stringopts (saved_options, BTO_MACRO);
+   bt_set_projection (index->fields, index->num_fields);
+   reader = bt_open_reader (infile);
+   quiet = bt_new_errlist (FALSE);
+   saved = NULL;
+   quieted = FALSE;
+
+   count = parsed = 0;
+   while (bt_read_entry_text (reader, &text))
+   {
+      if (end >= 0 && text.offset >= end)
+         break;
+      if (text.metatype != BTE_MACRODEF &&
+          (text.metatype != BTE_REGULAR || text.offset < start))
+         continue;
+
+      if (quieted != (text.offset < start))
+      {
+         quieted = !quieted;
+         if (quieted)
+            saved = bt_set_errlist (quiet);
+         else
+            bt_set_errlist (saved);
+      }
+
+      entry = bt_parse_entry_s (text.text, index->filename, text.line,
+                                0, &status);
+      parsed++;
+      if (entry == NULL)
+         continue;
+      if (bt_entry_metatype (entry) == BTE_REGULAR)
+      {
+         add_entry (index, entry, text.offset);
+         count++;
+      }
+      bt_free_ast (entry);
+   }
+
+   if (parsed)                          /* clean up after the parser */
+      bt_parse_entry_s (NULL, NULL, 0, 0, NULL);
+   if (quieted)
+      bt_set_errlist (saved);
+   bt_free_errlist (quiet);
+   bt_close_reader (reader);
+   bt_set_projection (NULL, 0);
+   restore_stringopts (saved_options);
+   return count;
+}
+
+
+static int
+compare_iterms (const void * a, const void * b)
+{
+   iterm *  t1 = *(iterm **) a;
+   iterm *  t2 = *(iterm **) b;
+
+   if (t1->field != t2->field)
+      return t1->field - t2->field;
+   return strcmp (t1->text, t2->text);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_index_write()
+@INPUT      : index
+              indexname - file to write it to
+@RETURNS    : 0, or -1 if the file couldn't be written (with errno set)
+@DESCRIPTION: Writes the index, in the format described at the top of
+              this file.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_index_write (bt_index * index, char * indexname)
+{
+   FILE *     file;
+   bt_buffer  buf;
+   iterm **   sorted;
+   iterm *    term;
+   int        i;
+   long       last;
+   boolean    ok;
+
+   file = fopen (indexname, "wb");
+   if (file == NULL)
+      return -1;
+
+   sorted = (iterm **) malloc ((index->num_terms + 1) * sizeof (iterm *));
+   for (i = 0; i < index->num_terms; i++)
+   {
+      term = index->terms[i];
+      if (term->last_doc >= 0 && term->last_pos >= -1)
+      {
+         put_varint (&term->postings, 0);
+         term->last_pos = -2;           /* (terminated) */
+      }
+      sorted[i] = term;
+   }
+   qsort (sorted, index->num_terms, sizeof (iterm *), compare_iterms);
+
+   memset (&buf, 0, sizeof (buf));
+   buf_append (&buf, MAGIC, MAGIC_LEN);
+   put_string (&buf, index->filename ? index->filename : "");
+   put_varint (&buf, index->num_fields);
+   for (i = 0; i < index->num_fields; i++)
+      put_string (&buf, index->fields[i]);
+   put_varint (&buf, index->num_docs);
+   for (i = 0, last = 0; i < index->num_docs; i++)
+   {
+      put_varint (&buf, index->offsets[i] - last);
+      last = index->offsets[i];
+   }
+   put_varint (&buf, index->num_terms);
+   for (i = 0; i < index->num_terms; i++)
+   {
+      put_varint (&buf, sorted[i]->field);
+      put_string (&buf, sorted[i]->text);
+      put_varint (&buf, sorted[i]->num_docs);
+      put_varint (&buf, sorted[i]->postings.length);
+      if (buf.length > 65536)
+      {
+         fwrite (buf.text, 1, buf.length, file);
+         buf.length = 0;
+      }
+   }
+   fwrite (buf.text, 1, buf.length, file);
+   bt_free_buffer (&buf);
+
+   for (i = 0; i < index->num_terms; i++)
+      fwrite (sorted[i]->postings.text, 1, sorted[i]->postings.length, file);
+   free (sorted);
+
+   ok = !ferror (file);
+   if (fclose (file) != 0)
+      ok = FALSE;
+   return ok ? 0 : -1;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_index_merge()
+@INOUT      : index
+@INPUT      : indexname - a file written by bt_index_write()
+@RETURNS    : the number of entries merged, or -1 if the file couldn't
+              be read (with errno set), isn't an index, or is of other
+              fields
+@DESCRIPTION: Adds the entries of an index file (one range of a BibTeX
+              file, from bt_index_range()) after those of `index'.  The
+              postings of each term are copied as they are, but for the
+              first entry number, which now follows on from `index''s
+              entries: merging is a pass over the postings, and nothing
+              is parsed again.  The index takes the file's BibTeX
+              filename if it hasn't one.
+@CALLS      : bt_search_open()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_index_merge (bt_index * index, char * indexname)
+{
+   bt_search *      shard;
+   sterm *          st;
+   iterm *          term;
+   unsigned char *  data;
+   unsigned char *  p;
+   unsigned char *  end;
+   int              base, count, doc, i;
+   boolean          ok;
+
+   shard = bt_search_open (indexname);
+   if (shard == NULL)
+      return -1;
+   ok = (shard->num_fields == index->num_fields);
+   for (i = 0; ok && i < index->num_fields; i++)
+      ok = (strcmp (shard->fields[i], index->fields[i]) == 0);
+   if (!ok)
+   {
+      usage_warning ("%s: index is of other fields", indexname);
+      bt_search_close (shard);
+      errno = EINVAL;
+      return -1;
+   }
+   if (index->filename == NULL)
+      index->filename = strdup (shard->filename);
+
+   base = index->num_docs;
+   if (base + shard->num_docs > index->max_docs)
+   {
+      index->max_docs = base + shard->num_docs + 1024;
+      index->offsets = (long *)
+         realloc (index->offsets, index->max_docs * sizeof (long));
+   }
+   memcpy (index->offsets + base, shard->offsets,
+           shard->num_docs * sizeof (long));
+   index->num_docs += shard->num_docs;
+   count = shard->num_docs;
+
+   data = NULL;
+   if (shard->num_terms > 0 &&
+       fseek (shard->file, shard->postings, SEEK_SET) != 0)
+      shard->num_terms = 0;
+   for (i = 0; i < shard->num_terms; i++)
+   {
+      st = &shard->terms[i];
+      data = (unsigned char *) realloc (data, st->length + 1);
+      if (fread (data, 1, st->length, shard->file) != (size_t) st->length)
+      {
+         usage_warning ("%s: index is truncated or corrupt", indexname);
+         break;
+      }
+      if (st->num_docs == 0)
+         continue;
+
+      /* the first entry number is relative to the shard's start */
+      p = data;
+      end = data + st->length;
+      doc = base + get_varint (&p, end) - 1;
+
+      term = get_term (index, st->field, st->text);
+      if (term->last_doc >= 0 && term->last_pos >= -1)
+         put_varint (&term->postings, 0);
+      put_varint (&term->postings, doc - term->last_doc);
+      buf_append (&term->postings, (char *) p, end - p);
+      term->num_docs += st->num_docs;
+
+      /* and the rest are relative to each other, so find the last */
+      while (p < end)
+      {
+         while (p < end && get_varint (&p, end) != 0)
+            ;
+         if (p < end)
+            doc += get_varint (&p, end);
+      }
+      term->last_doc = doc;
+      term->last_pos = -2;              /* (terminated) */
+   }
+
+   if (data) free (data);
+   bt_search_close (shard);
+   return count;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_index_free()
+@INPUT      : index
+@DESCRIPTION: Frees an index.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_index_free (bt_index * index)
+{
+   int  i;
+
+   for (i = 0; i < index->num_terms; i++)
+   {
+      free (index->terms[i]->text);
+      bt_free_buffer (&index->terms[i]->postings);
+      free (index->terms[i]);
+   }
+   if (index->terms) free (index->terms);
+   htable_free (&index->table);
+   for (i = 0; i < index->num_fields; i++)
+      free (index->fields[i]);
+   free (index->fields);
+   free (index->is_names);
+   if (index->offsets) free (index->offsets);
+   if (index->filename) free (index->filename);
+   free (index);
+}
+
+
+/* ------------------------------------------------------------------------
+ * Searching
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_search_open()
+@INPUT      : indexname - a file written by bt_index_write()
+@RETURNS    : a search of that index, or NULL if the file couldn't be
+              read (with errno set) or isn't an index
+@DESCRIPTION: Reads everything in an index but its postings, and keeps
+              the file open for reading them.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+bt_search * bt_search_open (char * indexname)
+{
+   bt_search *    search;
+   FILE *         file;
+   char           magic[MAGIC_LEN];
+   unsigned long  n, value;
+   long           start;
+   int            i;
+   boolean        ok;
+
+   file = fopen (indexname, "rb");
+   if (file == NULL)
+      return NULL;
+
+   if (fread (magic, 1, MAGIC_LEN, file) != MAGIC_LEN ||
+       memcmp (magic, MAGIC, MAGIC_LEN) != 0)
+   {
+      usage_warning ("%s: not a btparse index", indexname);
+      fclose (file);
+      errno = EINVAL;
+      return NULL;
+   }
+
+   search = (bt_search *) calloc (1, sizeof (bt_search));
+   search->file = file;
+   ok = (search->filename = read_string (file)) != NULL;
+
+   if (ok && (ok = read_varint (file, &n) && n < 0x10000))
+   {
+      search->fields = (char **) calloc (n, sizeof (char *));
+      search->is_names = (boolean *) calloc (n, sizeof (boolean));
+      search->num_fields = n;
+      for (i = 0; ok && i < search->num_fields; i++)
+      {
+         ok = (search->fields[i] = read_string (file)) != NULL;
+         if (ok)
+            search->is_names[i] = is_name_field (search->fields[i]);
+      }
+   }
+
+   if (ok && (ok = read_varint (file, &n) && n < 0x7fffffff))
+   {
+      search->offsets = (long *) malloc ((n + 1) * sizeof (long));
+      for (i = 0, start = 0; ok && i < (int) n; i++)
+      {
+         ok = read_varint (file, &value);
+         start += value;
+         search->offsets[i] = start;
+      }
+      search->num_docs = n;
+   }
+
+   if (ok && (ok = read_varint (file, &n) && n < 0x7fffffff))
+   {
+      search->terms = (sterm *) calloc (n + 1, sizeof (sterm));
+      search->num_terms = n;
+      for (i = 0, start = 0; ok && i < search->num_terms; i++)
+      {
+         sterm *  term = &search->terms[i];
+
+         ok = read_varint (file, &value) && (int) value < search->num_fields;
+         term->field = value;
+         ok = ok && (term->text = read_string (file)) != NULL;
+         ok = ok && read_varint (file, &value);
+         term->num_docs = value;
+         ok = ok && read_varint (file, &value);
+         term->start = start;
+         term->length = value;
+         start += value;
+      }
+   }
+   search->postings = ftell (file);
+
+   if (!ok)
+   {
+      usage_warning ("%s: index is truncated or corrupt", indexname);
+      bt_search_close (search);
+      errno = EINVAL;
+      return NULL;
+   }
+   return search;
+}
+
+
+/* The number of a field in an index, or -1 */
+static int
+search_field (bt_search * search, char * name)
+{
+   int  i;
+
+   for (i = 0; i < search->num_fields; i++)
+      if (strcmp (search->fields[i], name) == 0)
+         return i;
+   return -1;
+}
+
+
+/* A term in the dictionary, or NULL */
+static sterm *
+find_term (bt_search * search, int field, char * text)
+{
+   int      lo, hi, mid, cmp;
+   sterm *  term;
+
+   lo = 0;
+   hi = search->num_terms - 1;
+   while (lo <= hi)
+   {
+      mid = (lo + hi) / 2;
+      term = &search->terms[mid];
+      cmp = (term->field != field) ? term->field - field
+                                   : strcmp (term->text, text);
+      if (cmp == 0)
+         return term;
+      if (cmp < 0)
+         lo = mid + 1;
+      else
+         hi = mid - 1;
+   }
+   return NULL;
+}
+
+
+/* Reads and decodes a term's postings (the list is empty if it has none) */
+static void
+read_postings (bt_search * search, sterm * term, plist * list)
+{
+   unsigned char *  data;
+   unsigned char *  p;
+   unsigned char *  end;
+   unsigned long    delta;
+   int              doc, pos, num_pos, max_pos;
+
+   memset (list, 0, sizeof (plist));
+   if (term == NULL || term->num_docs == 0)
+      return;
+
+   data = (unsigned char *) malloc (term->length);
+   if (fseek (search->file, search->postings + term->start, SEEK_SET) != 0 ||
+       fread (data, 1, term->length, search->file) != (size_t) term->length)
+   {
+      usage_warning ("error reading postings of \"%s\"", term->text);
+      free (data);
+      return;
+   }
+
+   list->docs = (int *) malloc (term->num_docs * sizeof (int));
+   list->starts = (int *) malloc ((term->num_docs + 1) * sizeof (int));
+   max_pos = term->num_docs + 16;
+   list->positions = (int *) malloc (max_pos * sizeof (int));
+   num_pos = 0;
+   doc = -1;
+   p = data;
+   end = data + term->length;
+   while (p < end && list->num_docs < term->num_docs)
+   {
+      doc += get_varint (&p, end);
+      list->docs[list->num_docs] = doc;
+      list->starts[list->num_docs++] = num_pos;
+      pos = -1;
+      while (p < end && (delta = get_varint (&p, end)) != 0)
+      {
+         pos += delta;
+         if (num_pos == max_pos)
+         {
+            max_pos *= 2;
+            list->positions = (int *)
+               realloc (list->positions, max_pos * sizeof (int));
+         }
+         list->positions[num_pos++] = pos;
+      }
+   }
+   list->starts[list->num_docs] = num_pos;
+   free (data);
+}
+
+
+static void
+free_postings (plist * list)
+{
+   if (list->docs) free (list->docs);
+   if (list->starts) free (list->starts);
+   if (list->positions) free (list->positions);
+}
+
+
+static boolean
+has_position (plist * list, int i, int pos)
+{
+   int  lo, hi, mid;
+
+   lo = list->starts[i];
+   hi = list->starts[i+1] - 1;
+   while (lo <= hi)
+   {
+      mid = (lo + hi) / 2;
+      if (list->positions[mid] == pos)
+         return TRUE;
+      if (list->positions[mid] < pos)
+         lo = mid + 1;
+      else
+         hi = mid - 1;
+   }
+   return FALSE;
+}
+
+
+/* The entries with a phrase (of one or more words) in one field */
+static docset
+phrase_in_field (bt_search * search, int field, char ** words, int num_words)
+{
+   plist *  lists;
+   int *    at;
+   docset   result;
+   int      i, j, k, doc;
+   boolean  found;
+
+   result.num = 0;
+   result.docs = NULL;
+   lists = (plist *) malloc (num_words * sizeof (plist));
+   at = (int *) calloc (num_words, sizeof (int));
+   for (i = 0; i < num_words; i++)
+      read_postings (search, find_term (search, field, words[i]), &lists[i]);
+
+   if (lists[0].num_docs > 0)
+      result.docs = (int *) malloc (lists[0].num_docs * sizeof (int));
+   for (j = 0; j < lists[0].num_docs; j++)
+   {
+      doc = lists[0].docs[j];
+      found = TRUE;
+      for (i = 1; found && i < num_words; i++)
+      {
+         while (at[i] < lists[i].num_docs && lists[i].docs[at[i]] < doc)
+            at[i]++;
+         found = at[i] < lists[i].num_docs && lists[i].docs[at[i]] == doc;
+      }
+      if (!found)
+         continue;
+
+      found = (num_words == 1);
+      for (k = lists[0].starts[j]; !found && k < lists[0].starts[j+1]; k++)
+      {
+         found = TRUE;
+         for (i = 1; found && i < num_words; i++)
+            found = has_position (&lists[i], at[i],
+                                  lists[0].positions[k] + i);
+      }
+      if (found)
+         result.docs[result.num++] = doc;
+   }
+
+   for (i = 0; i < num_words; i++)
+      free_postings (&lists[i]);
+   free (lists);
+   free (at);
+   return result;
+}
+
+
+static docset
+union_docs (docset a, docset b)
+{
+   docset  result;
+   int     i, j;
+
+   result.num = 0;
+   result.docs = (int *) malloc ((a.num + b.num + 1) * sizeof (int));
+   for (i = j = 0; i < a.num || j < b.num; )
+   {
+      if (j == b.num || (i < a.num && a.docs[i] < b.docs[j]))
+         result.docs[result.num++] = a.docs[i++];
+      else if (i == a.num || b.docs[j] < a.docs[i])
+         result.docs[result.num++] = b.docs[j++];
+      else
+      {
+         result.docs[result.num++] = a.docs[i++];
+         j++;
+      }
+   }
+   if (a.docs) free (a.docs);
+   if (b.docs) free (b.docs);
+   return result;
+}
+
+
+static docset
+intersect_docs (docset a, docset b)
+{
+   docset  result;
+   int     i, j;
+
+   result.num = 0;
+   result.docs = (int *) malloc (((a.num < b.num ? a.num : b.num) + 1)
+                                 * sizeof (int));
+   for (i = j = 0; i < a.num && j < b.num; )
+   {
+      if (a.docs[i] < b.docs[j])
+         i++;
+      else if (b.docs[j] < a.docs[i])
+         j++;
+      else
+      {
+         result.docs[result.num++] = a.docs[i++];
+         j++;
+      }
+   }
+   if (a.docs) free (a.docs);
+   if (b.docs) free (b.docs);
+   return result;
+}
+
+
+/* ------------------------------------------------------------------------
+ * The query parser: a recursive-descent parser of
+
+     query  : and { "OR" and }
+     and    : term { ["AND"] term }
+     term   : "(" query ")"  |  [field ":"] word  |  [field ":"] '"' words '"'
+
+   where a word is anything up to a space, parenthesis, colon or double
+   quote.  `ok' is cleared on a syntax error (which is reported).
+ */
+
+static docset parse_or (bt_search * search, boolean * ok);
+
+
+static void
+skip_space (bt_search * search)
+{
+   while (isspace ((unsigned char) *search->pos))
+      search->pos++;
+}
+
+
+/* Is the next word `keyword' (AND or OR)?  If so, skips it. */
+static boolean
+next_keyword (bt_search * search, char * keyword)
+{
+   int  len = strlen (keyword);
+
+   skip_space (search);
+   if (strncmp (search->pos, keyword, len) == 0 &&
+       (search->pos[len] == (char) 0 || isspace ((unsigned char) search->pos[len]) ||
+        search->pos[len] == '(' || search->pos[len] == '"'))
+   {
+      search->pos += len;
+      return TRUE;
+   }
+   return FALSE;
+}
+
+
+static void
+query_error (bt_search * search, boolean * ok, char * message)
+{
+   if (*ok)
+      usage_warning ("query \"%s\", at character %d: %s", search->query,
+                     (int) (search->pos - search->query) + 1, message);
+   *ok = FALSE;
+}
+
+
+static boolean
+word_char (char c)
+{
+   return c && !isspace ((unsigned char) c) &&
+      c != '(' && c != ')' && c != ':' && c != '"';
+}
+
+
+/* A word or phrase, in one field (if field >= 0) or any */
+static docset
+match_text (bt_search * search, int field, char * text)
+{
+   docset   result;
+   char *   copy;
+   char **  words;
+   int      num_words, i;
+
+   result.num = 0;
+   result.docs = NULL;
+   copy = split_words (text, &words, &num_words);
+   if (num_words > 0)
+   {
+      for (i = 0; i < search->num_fields; i++)
+      {
+         if (field >= 0 && i != field)
+            continue;
+         result = union_docs (result,
+                              phrase_in_field (search, i, words, num_words));
+      }
+      free (words);
+   }
+   free (copy);
+   return result;
+}
+
+
+static docset
+parse_term (bt_search * search, boolean * ok)
+{
+   docset  result;
+   char *  start;
+   char *  text;
+   int     field;
+
+   result.num = 0;
+   result.docs = NULL;
+   skip_space (search);
+
+   if (*search->pos == '(')
+   {
+      search->pos++;
+      result = parse_or (search, ok);
+      skip_space (search);
+      if (*search->pos != ')')
+         query_error (search, ok, "expected \")\"");
+      else
+         search->pos++;
+      return result;
+   }
+
+   field = -1;
+   start = search->pos;
+   while (word_char (*search->pos))
+      search->pos++;
+   if (*search->pos == ':' && search->pos > start)
+   {
+      text = (char *) malloc (search->pos - start + 1);
+      memcpy (text, start, search->pos - start);
+      text[search->pos - start] = (char) 0;
+      field = search_field (search, text);
+      free (text);
+      if (field < 0)
+      {
+         search->pos = start;
+         query_error (search, ok, "field not indexed");
+         return result;
+      }
+      start = ++search->pos;
+      while (word_char (*search->pos))
+         search->pos++;
+   }
+
+   if (*search->pos == '"' && search->pos == start)
+   {
+      start = ++search->pos;
+      while (*search->pos && *search->pos != '"')
+         search->pos++;
+      if (*search->pos != '"')
+      {
+         query_error (search, ok, "unterminated phrase");
+         return result;
+      }
+      text = (char *) malloc (search->pos - start + 1);
+      memcpy (text, start, search->pos - start);
+      text[search->pos - start] = (char) 0;
+      search->pos++;
+   }
+   else if (search->pos > start)
+   {
+      text = (char *) malloc (search->pos - start + 1);
+      memcpy (text, start, search->pos - start);
+      text[search->pos - start] = (char) 0;
+   }
+   else
+   {
+      query_error (search, ok, "expected a word or phrase");
+      return result;
+   }
+
+   result = match_text (search, field, text);
+   free (text);
+   return result;
+}
+
+
+static docset
+parse_and (bt_search * search, boolean * ok)
+{
+   docset  result;
+   char *  save;
+
+   result = parse_term (search, ok);
+   while (*ok)
+   {
+      skip_space (search);
+      save = search->pos;
+      if (*search->pos == (char) 0 || *search->pos == ')' ||
+          next_keyword (search, "OR"))
+      {
+         search->pos = save;
+         break;
+      }
+      next_keyword (search, "AND");
+      result = intersect_docs (result, parse_term (search, ok));
+   }
+   return result;
+}
+
+
+static docset
+parse_or (bt_search * search, boolean * ok)
+{
+   docset  result;
+
+   result = parse_and (search, ok);
+   while (*ok && next_keyword (search, "OR"))
+      result = union_docs (result, parse_and (search, ok));
+   return result;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_search_query()
+@INPUT      : search
+              query  - see below
+@OUTPUT     : num_results - the number of entries matched
+@RETURNS    : their byte offsets in the file indexed, in order (newly
+              allocated), or NULL if the query has a syntax error (which
+              is reported, as a usage warning)
+@DESCRIPTION: A query is words and phrases (in double quotes) to look
+              for, each in a given field (as in "title:knuth") or in
+              any field, joined by AND (or just juxtaposed) and OR, and
+              grouped with parentheses.  AND binds more tightly than OR.
+              Words and phrases are turned into terms as the fields'
+              values were, so case and TeX make no difference.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+long * bt_search_query (bt_search * search, char * query, int * num_results)
+{
+   docset   docs;
+   boolean  ok;
+   long *   offsets;
+   int      i;
+
+   *num_results = 0;
+   search->query = search->pos = query;
+   ok = TRUE;
+   docs = parse_or (search, &ok);
+   skip_space (search);
+   if (ok && *search->pos != (char) 0)
+      query_error (search, &ok, "expected AND, OR or the end");
+
+   if (!ok)
+   {
+      if (docs.docs) free (docs.docs);
+      return NULL;
+   }
+
+   offsets = (long *) malloc ((docs.num + 1) * sizeof (long));
+   for (i = 0; i < docs.num; i++)
+      offsets[i] = search->offsets[docs.docs[i]];
+   *num_results = docs.num;
+   if (docs.docs) free (docs.docs);
+   return offsets;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_search_filename()
+@INPUT      : search
+@RETURNS    : the name of the file indexed, as given to bt_index_file()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+char * bt_search_filename (bt_search * search)
+{
+   return search->filename;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_search_close()
+@INPUT      : search
+@DESCRIPTION: Closes the index file, and frees the search.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_search_close (bt_search * search)
+{
+   int  i;
+
+   fclose (search->file);
+   if (search->terms)
+   {
+      for (i = 0; i < search->num_terms; i++)
+         if (search->terms[i].text) free (search->terms[i].text);
+      free (search->terms);
+   }
+   if (search->fields)
+   {
+      for (i = 0; i < search->num_fields; i++)
+         if (search->fields[i]) free (search->fields[i]);
+      free (search->fields);
+   }
+   if (search->is_names) free (search->is_names);
+   if (search->offsets) free (search->offsets);
+   if (search->filename) free (search->filename);
+   free (search);
+}
@@ -39,4 +39,5 @@ void bt_free_ast (AST *ast)
 void bt_cleanup (void)
 {
    done_macros ();
+   bt_set_name_cache (0);
 }
@@ -3,6 +3,9 @@
 @DESCRIPTION: Routines for input of BibTeX data.
 @GLOBALS    : InputFilename
               StringOptions
+              CheckOnly
+              Projection, NumProjected
+              EntryFilter, FilterData, Filtering, Verdict
 @CALLS      : 
 @CREATED    : 1997/10/14, Greg Ward (from code in bibparse.c)
 @MODIFIED   : 
@@ -38,6 +41,22 @@ btshort   StringOptions[NUM_METATYPES] =
    BTO_MINIMAL,                         /* BTE_PREAMBLE */
    BTO_MACRO                            /* BTE_MACRODEF */
 };
+boolean  CheckOnly = FALSE;             /* tells the parser to make no */
+                                        /* value nodes (BTO_CHECKONLY) */
+
+static char ** Projection = NULL;       /* fields wanted from regular */
+static int     NumProjected = 0;        /* entries (NULL means all) */
+
+static bt_entry_filter EntryFilter = NULL; /* which regular entries to */
+static void *  FilterData = NULL;       /* return from bt_parse_entry() */
+static boolean Filtering = FALSE;       /* filter the entry being parsed? */
+static int     Verdict;                 /* filter's verdict on it (or -1) */
+
+static boolean ReaderParsing = FALSE;   /* bt_parse_next_entry() has */
+                                        /* something to clean up */
+
+GEN_PRIVATE_ERRFUNC (junk_warning, (int line, char * fmt, ...),
+                     BTERR_LEXWARN, InputFilename, line, NULL, -1, fmt)
 
 
 /* ------------------------------------------------------------------------
@@ -84,6 +103,157 @@ void bt_set_stringopts (bt_metatype metatype, btshort options)
 }
 
 
+/* ------------------------------------------------------------------------
+@NAME       : save_stringopts
+@INPUT      : macro_options - options for @string entries
+@OUTPUT     : saved         - the options in force, for every metatype
+@DESCRIPTION: Saves the string-processing options, and sets them for a
+              pass over a file that only looks at entries: no processing
+              at all, except `macro_options' for macro definitions.
+              restore_stringopts() puts them back.
+@GLOBALS    : StringOptions
+@CALLERS    : crossref.c, extract.c, merge.c, index.c, query.c
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void save_stringopts (btshort * saved, btshort macro_options)
+{
+   int  i;
+
+   for (i = 0; i < NUM_METATYPES; i++)
+   {
+      saved[i] = StringOptions[i];
+      StringOptions[i] = (i == BTE_MACRODEF) ? macro_options : BTO_MINIMAL;
+   }
+}
+
+
+void restore_stringopts (btshort * saved)
+{
+   int  i;
+
+   for (i = 0; i < NUM_METATYPES; i++)
+      StringOptions[i] = saved[i];
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_set_projection
+@INPUT      : fields     - names of the fields wanted from regular entries,
+                           or NULL to get all fields again
+              num_fields - number of names in fields
+@OUTPUT     : 
+@RETURNS    : 
+@DESCRIPTION: Restricts the fields returned by bt_parse_* for regular
+              entries to the ones named here (case doesn't matter).  The
+              values of other fields are skipped over by the lexer, and
+              the fields are dropped from the AST before post-processing.
+              The names are copied, so the caller may free them.
+@GLOBALS    : Projection, NumProjected
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+void bt_set_projection (char ** fields, int num_fields)
+{
+   int    i;
+
+   for (i = 0; i < NumProjected; i++)
+      free (Projection[i]);
+   if (Projection != NULL)
+      free (Projection);
+   Projection = NULL;
+   NumProjected = 0;
+
+   if (fields == NULL)
+      return;
+   if (num_fields < 0)
+      usage_error ("bt_set_projection: illegal number of fields (%d)",
+                   num_fields);
+
+   /* an empty projection is still a projection: we allocate a slot */
+   Projection = (char **) malloc ((num_fields + 1) * sizeof (char *));
+   for (i = 0; i < num_fields; i++)
+      Projection[i] = strlwr (strdup (fields[i]));
+   NumProjected = num_fields;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : field_wanted
+@INPUT      : name - a field name, as found in the input
+@OUTPUT     : 
+@RETURNS    : TRUE if no projection is set, or if name is in it
+@DESCRIPTION: Tells the lexer (and project_fields()) whether the value of
+              a field in a regular entry is wanted.
+@GLOBALS    : Projection, NumProjected
+@CALLERS    : the lexer (scan_direct.c), project_fields()
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+boolean field_wanted (char * name)
+{
+   int    i;
+
+   if (Projection == NULL)
+      return TRUE;
+   for (i = 0; i < NumProjected; i++)
+   {
+      if (strcasecmp (name, Projection[i]) == 0)
+         return TRUE;
+   }
+   return FALSE;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_set_entry_filter
+@INPUT      : filter - function to decide which regular entries are
+                       wanted, or NULL to get them all again
+              data   - passed on to filter
+@OUTPUT     : 
+@RETURNS    : 
+@DESCRIPTION: Installs a filter for the regular entries read by
+              bt_parse_entry() and bt_parse_file().  As soon as the type
+              and key of an entry have been seen, filter is called as
+                 (*filter) (type, key, data)
+              with the type in lowercase; if it returns false, the rest of
+              the entry is skipped by the lexer, and the entry is never
+              returned.
+@GLOBALS    : EntryFilter, FilterData
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+void bt_set_entry_filter (bt_entry_filter filter, void * data)
+{
+   EntryFilter = filter;
+   FilterData = data;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : entry_wanted
+@INPUT      : type - type of a regular entry (in lowercase)
+              key  - its key
+@OUTPUT     : 
+@RETURNS    : TRUE if the entry is to be parsed and returned
+@DESCRIPTION: Asks the entry filter (if any) about the regular entry
+              currently being parsed by bt_parse_entry() (or
+              bt_parse_next_entry()), and remembers the answer.  Called
+              by the lexer as soon as it has seen the key.
+@GLOBALS    : EntryFilter, FilterData, Filtering, Verdict
+@CALLERS    : the lexer (scan_direct.c)
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+boolean entry_wanted (char * type, char * key)
+{
+   if (!Filtering || EntryFilter == NULL)
+      return TRUE;
+   Verdict = (*EntryFilter) (type, key, FilterData) ? 1 : 0;
+   return Verdict;
+}
+
+
 /* ------------------------------------------------------------------------
 @NAME       : start_parse
 @INPUT      : infile     input stream we'll read from (or NULL if reading 
@@ -190,6 +360,78 @@ parse_status (int *saved_counts)
 }   
 
 
+/* ------------------------------------------------------------------------
+@NAME       : filter_entry()
+@INPUT      : entry - AST for a freshly-parsed entry
+@OUTPUT     : 
+@RETURNS    : FALSE if the entry filter rejected the entry
+@DESCRIPTION: Returns the entry filter's verdict on a regular entry,
+              asking for it now if the lexer didn't (eg. because the
+              lexer doesn't know how, or the entry header was unusual).
+@GLOBALS    : EntryFilter, FilterData, Verdict
+@CALLS      : 
+@CALLERS    : bt_parse_entry(), bt_parse_next_entry()
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+static boolean
+filter_entry (AST * entry)
+{
+   char *  key;
+
+   if (Verdict < 0 && EntryFilter != NULL &&
+       entry->metatype == BTE_REGULAR &&
+       (key = bt_entry_key (entry)) != NULL)
+   {
+      strlwr (entry->text);             /* post-processing does it anyway */
+      Verdict = (*EntryFilter) (entry->text, key, FilterData) ? 1 : 0;
+   }
+   return Verdict != 0;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : project_fields()
+@INPUT      : entry - AST for a freshly-parsed entry
+@OUTPUT     : 
+@RETURNS    : 
+@DESCRIPTION: Removes from a regular entry the fields not wanted by the
+              current projection (see bt_set_projection()).  The
+              hand-written lexer (scan_direct.c) drops them as it goes,
+              so the parser never sees them, and there are none left to
+              remove; the DLG lexer (scan.c) doesn't.
+@GLOBALS    : Projection
+@CALLS      : field_wanted()
+@CALLERS    : bt_parse_entry_s(), bt_parse_entry()
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+static void
+project_fields (AST * entry)
+{
+   AST *  field;
+   AST ** link;
+
+   if (Projection == NULL || entry->metatype != BTE_REGULAR)
+      return;
+
+   link = &entry->down;
+   while ((field = *link) != NULL)
+   {
+      if (field->nodetype == BTAST_FIELD && !field_wanted (field->text))
+      {
+         *link = field->right;
+         field->right = NULL;
+         bt_free_ast (field);
+      }
+      else
+      {
+         link = &field->right;
+      }
+   }
+} /* project_fields() */
+
+
 /* ------------------------------------------------------------------------
 @NAME       : bt_parse_entry_s()
 @INPUT      : entry_text - string containing the entire entry to parse,
@@ -243,6 +485,7 @@ AST * bt_parse_entry_s (char *    entry_text,
 
    start_parse (NULL, entry_text, line);
 
+   CheckOnly = (options & BTO_CHECKONLY) != 0;
    entry (&entry_ast);                  /* enter the parser */
    ++zzasp;                             /* why is this done? */
 
@@ -256,8 +499,10 @@ AST * bt_parse_entry_s (char *    entry_text,
    dump_ast ("bt_parse_entry_s: single entry, after parsing:\n", 
              entry_ast);
 #endif
-   bt_postprocess_entry (entry_ast,
-                         StringOptions[entry_ast->metatype] | options);
+   project_fields (entry_ast);
+   if (!(options & BTO_CHECKONLY))      /* just validating: no values */
+      bt_postprocess_entry (entry_ast,
+                            StringOptions[entry_ast->metatype] | options);
 #if DEBUG
    dump_ast ("bt_parse_entry_s: single entry, after post-processing:\n",
              entry_ast);
@@ -316,6 +561,7 @@ AST * bt_parse_entry (FILE *    infile,
    }
 
    InputFilename = filename;
+next_entry:
    err_counts = bt_get_error_counts (err_counts);
 
    if (feof (infile))
@@ -392,8 +638,12 @@ AST * bt_parse_entry (FILE *    infile,
    }
    assert (prev_file == infile);
 
+   CheckOnly = (options & BTO_CHECKONLY) != 0;
+   Filtering = TRUE;
+   Verdict = -1;
    entry (&entry_ast);                  /* enter the parser */
    ++zzasp;                             /* why is this done? */
+   Filtering = FALSE;
 
    if (entry_ast == NULL)               /* can happen with very bad input */
    {
@@ -401,12 +651,21 @@ AST * bt_parse_entry (FILE *    infile,
       return entry_ast;
    }
 
+   if (!filter_entry (entry_ast))       /* not wanted: on to the next one */
+   {
+      bt_free_ast (entry_ast);
+      entry_ast = NULL;
+      goto next_entry;
+   }
+
 #if DEBUG
    dump_ast ("bt_parse_entry(): single entry, after parsing:\n", 
              entry_ast);
 #endif
-   bt_postprocess_entry (entry_ast,
-                         StringOptions[entry_ast->metatype] | options);
+   project_fields (entry_ast);
+   if (!(options & BTO_CHECKONLY))      /* just validating: no values */
+      bt_postprocess_entry (entry_ast,
+                            StringOptions[entry_ast->metatype] | options);
 #if DEBUG
    dump_ast ("bt_parse_entry(): single entry, after post-processing:\n", 
              entry_ast);
@@ -418,6 +677,69 @@ AST * bt_parse_entry (FILE *    infile,
 } /* bt_parse_entry() */
 
 
+/* ------------------------------------------------------------------------
+@NAME       : bt_parse_next_entry()
+@INPUT      : reader   - reading the file (see bt_open_reader()), or NULL
+                         meaning we're done, please cleanup
+              filename - for error messages
+              options  - standard btparse options bitmap
+@OUTPUT     : *status  - as for bt_parse_entry_s()
+@RETURNS    : AST for the next entry, or NULL if no entries are left (in
+              the reader's range)
+@DESCRIPTION: Like bt_parse_entry(), but finds each entry with
+              bt_read_entry_text() and parses its text with
+              bt_parse_entry_s() -- so that a reader restricted to a
+              range of the file (see bt_set_reader_range()) can start
+              and stop anywhere between entries.  Junk before an entry
+              is warned about, and the entry filter consulted, just as
+              by bt_parse_entry(); line numbers are those of the file.
+@GLOBALS    : Filtering, Verdict, ReaderParsing
+@CALLS      : bt_read_entry_text(), bt_parse_entry_s()
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+AST * bt_parse_next_entry (bt_reader * reader,
+                           char *      filename,
+                           btshort     options,
+                           boolean *   status)
+{
+   bt_entry_text  text;
+   AST *          entry_ast;
+
+   for (;;)
+   {
+      if (reader == NULL || !bt_read_entry_text (reader, &text))
+      {
+         if (!ReaderParsing)            /* nothing was ever parsed */
+         {
+            if (status) *status = TRUE;
+            return NULL;
+         }
+         ReaderParsing = FALSE;
+         return bt_parse_entry_s (NULL, NULL, 0, 0, status);
+      }
+
+      InputFilename = filename;
+      if (text.junk > 0)
+         junk_warning (text.line, "%d characters of junk seen at toplevel",
+                       text.junk);
+
+      Filtering = TRUE;
+      Verdict = -1;
+      ReaderParsing = TRUE;
+      entry_ast = bt_parse_entry_s (text.text, filename, text.line,
+                                    options, status);
+      Filtering = FALSE;
+
+      if (entry_ast == NULL)            /* very bad input: it's reported */
+         continue;
+      if (filter_entry (entry_ast))
+         return entry_ast;
+      bt_free_ast (entry_ast);          /* not wanted: on to the next one */
+   }
+} /* bt_parse_next_entry() */
+
+
 /* ------------------------------------------------------------------------
 @NAME       : bt_parse_file ()
 @INPUT      : filename - name of file to open.  If NULL or "-", we read
@@ -0,0 +1,619 @@
+/* ------------------------------------------------------------------------
+@NAME       : json.c
+@DESCRIPTION: Writing entries as JSON, one object per entry:
+                bt_json_entry
+                bt_json_entry_s
+
+              There are two styles: plain JSON, which keeps every entry
+              (and every field, under its BibTeX name), and CSL-JSON,
+              the input format of citeproc processors, which has only
+              the regular entries, with their types and fields mapped to
+              CSL's and their names split into parts.  Either way, an
+              entry's object is written on one line, so a file's entries
+              can be written as JSON Lines as they are parsed.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse library.  This library is
+              free software; you can redistribute it and/or modify it under
+              the terms of the GNU Library General Public License as
+              published by the Free Software Foundation; either version 2
+              of the License, or (at your option) any later version.
+-------------------------------------------------------------------------- */
+
+#include "bt_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "btparse.h"
+#include "prototypes.h"
+#include "my_dmalloc.h"
+#include "bt_debug.h"
+
+
+static bt_json_options default_options =
+{
+   BTJS_PLAIN,                          /* style */
+   FALSE                                /* unicode */
+};
+
+
+/* BibTeX entry types, and their CSL types (the rest are "document") */
+static char * csl_types[][2] =
+{
+   { "article",       "article-journal" },
+   { "book",          "book" },
+   { "booklet",       "pamphlet" },
+   { "inbook",        "chapter" },
+   { "incollection",  "chapter" },
+   { "inproceedings", "paper-conference" },
+   { "conference",    "paper-conference" },
+   { "manual",        "report" },
+   { "mastersthesis", "thesis" },
+   { "phdthesis",     "thesis" },
+   { "proceedings",   "book" },
+   { "techreport",    "report" },
+   { "unpublished",   "manuscript" },
+   { "online",        "webpage" },
+   { "misc",          "document" }
+};
+
+#define NUM_CSL_TYPES ((int) (sizeof (csl_types) / sizeof (csl_types[0])))
+
+/*
+ * CSL variables, and the BibTeX fields they are taken from.  A variable
+ * with several rows gets the first of its fields the entry has.
+ */
+static char * csl_fields[][2] =
+{
+   { "title",            "title" },
+   { "container-title",  "journal" },
+   { "container-title",  "booktitle" },
+   { "collection-title", "series" },
+   { "publisher",        "publisher" },
+   { "publisher",        "school" },
+   { "publisher",        "institution" },
+   { "publisher",        "organization" },
+   { "publisher-place",  "address" },
+   { "volume",           "volume" },
+   { "page",             "pages" },
+   { "edition",          "edition" },
+   { "chapter-number",   "chapter" },
+   { "note",             "note" },
+   { "abstract",         "abstract" },
+   { "keyword",          "keywords" },
+   { "language",         "language" },
+   { "DOI",              "doi" },
+   { "URL",              "url" },
+   { "ISBN",             "isbn" },
+   { "ISSN",             "issn" }
+};
+
+#define NUM_CSL_FIELDS ((int) (sizeof (csl_fields) / sizeof (csl_fields[0])))
+
+static char * months[] =
+{
+   "jan", "feb", "mar", "apr", "may", "jun",
+   "jul", "aug", "sep", "oct", "nov", "dec"
+};
+
+
+/* ------------------------------------------------------------------------
+ * JSON strings
+ */
+
+/*
+ * Appends text as a JSON string.  JSON is UTF-8, so valid UTF-8 is
+ * copied as it is, but a byte that isn't part of a valid sequence is
+ * taken to be Latin-1 (see utf8_decode()) and written as the UTF-8 for
+ * that character -- so a Latin-1 file comes out right, and anything
+ * else at least comes out as valid JSON.
+ */
+static void
+append_json_string (bt_buffer * buf, char * text, int len)
+{
+   static char  hex[] = "0123456789abcdef";
+   char *       end;
+   unsigned char c;
+   int          n;
+
+   buf_reserve (buf, len + 2);
+   buf_append_char (buf, '"');
+   for (end = text + len; text < end; text++)
+   {
+      c = (unsigned char) *text;
+      switch (c)
+      {
+         case '"':  buf_append (buf, "\\\"", 2); break;
+         case '\\': buf_append (buf, "\\\\", 2); break;
+         case '\n': buf_append (buf, "\\n", 2); break;
+         case '\r': buf_append (buf, "\\r", 2); break;
+         case '\t': buf_append (buf, "\\t", 2); break;
+         default:
+            if (c < 0x20)
+            {
+               buf_append (buf, "\\u00", 4);
+               buf_append_char (buf, hex[c >> 4]);
+               buf_append_char (buf, hex[c & 0xF]);
+            }
+            else if (c < 0x80)
+               buf_append_char (buf, (char) c);
+            else if (utf8_decode (text, &n) >= 0 && n > 1 && text + n <= end)
+            {
+               buf_append (buf, text, n);
+               text += n - 1;
+            }
+            else                        /* Latin-1 */
+            {
+               buf_append_char (buf, (char) (0xC0 | (c >> 6)));
+               buf_append_char (buf, (char) (0x80 | (c & 0x3F)));
+            }
+      }
+   }
+   buf_append_char (buf, '"');
+}
+
+
+/* Appends `"name":' (after a comma, unless `first') */
+static void
+append_member (bt_buffer * buf, char * name, boolean * first)
+{
+   if (!*first)
+      buf_append_char (buf, ',');
+   *first = FALSE;
+   append_json_string (buf, name, strlen (name));
+   buf_append_char (buf, ':');
+}
+
+
+/*
+ * Appends a value, converting its TeX first if the options say so.
+ * (The text is left alone.)
+ */
+static void
+append_value (bt_buffer * buf, char * text, bt_json_options * options)
+{
+   char *  converted;
+
+   if (options->unicode)
+   {
+      converted = bt_tex_to_unicode (text);
+      append_json_string (buf, converted, strlen (converted));
+      free (converted);
+   }
+   else
+   {
+      append_json_string (buf, text, strlen (text));
+   }
+}
+
+
+/* ------------------------------------------------------------------------
+ * Plain JSON
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : plain_entry()
+@INOUT      : buf
+@INPUT      : entry
+              options
+@DESCRIPTION: Writes an entry as {"type":..., "key":..., "fields":{...}}
+              (macro definitions have no key, and their macros for
+              fields); comments and preambles as {"type":..., "value":...}.
+              Field values are fully processed (see bt_get_text()); a
+              preamble's TeX is never converted.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static void
+plain_entry (bt_buffer * buf, AST * entry, bt_json_options * options)
+{
+   bt_metatype  metatype;
+   AST *        field;
+   char *       name;
+   char *       text;
+   boolean      first;
+
+   metatype = bt_entry_metatype (entry);
+   first = TRUE;
+   buf_append_char (buf, '{');
+   append_member (buf, "type", &first);
+   text = bt_entry_type (entry);
+   append_json_string (buf, text, strlen (text));
+
+   if (metatype == BTE_COMMENT || metatype == BTE_PREAMBLE)
+   {
+      append_member (buf, "value", &first);
+      text = bt_get_text (entry);
+      if (metatype == BTE_PREAMBLE)     /* TeX code, not text */
+         append_json_string (buf, text ? text : "", text ? strlen (text) : 0);
+      else
+         append_value (buf, text ? text : "", options);
+      if (text) free (text);
+      buf_append_char (buf, '}');
+      return;
+   }
+
+   if (metatype == BTE_REGULAR && (text = bt_entry_key (entry)))
+   {
+      append_member (buf, "key", &first);
+      append_json_string (buf, text, strlen (text));
+   }
+
+   append_member (buf, "fields", &first);
+   buf_append_char (buf, '{');
+   first = TRUE;
+   field = NULL;
+   while ((field = bt_next_field (entry, field, &name)))
+   {
+      append_member (buf, name, &first);
+      text = bt_get_text (field);
+      append_value (buf, text ? text : "", options);
+      if (text) free (text);
+   }
+   buf_append_str (buf, "}}");
+}
+
+
+/* ------------------------------------------------------------------------
+ * CSL-JSON
+ */
+
+/* The text of an entry's field (newly allocated), or NULL */
+static char *
+field_text (AST * entry, char * wanted)
+{
+   AST *   field;
+   char *  name;
+
+   field = NULL;
+   while ((field = bt_next_field (entry, field, &name)))
+   {
+      if (strcmp (name, wanted) == 0)
+         return bt_get_text (field);
+   }
+   return NULL;
+}
+
+
+/* Appends the tokens of one part of a name, separated by spaces */
+static void
+append_name_part (bt_buffer * buf, bt_name * name, bt_namepart part,
+                  bt_json_options * options)
+{
+   bt_buffer  joined;
+   int        i;
+
+   memset (&joined, 0, sizeof (joined));
+   for (i = 0; i < name->part_len[part]; i++)
+   {
+      if (i > 0)
+         buf_append_char (&joined, ' ');
+      buf_append_str (&joined, name->parts[part][i]);
+   }
+   append_value (buf, joined.text ? joined.text : "", options);
+   bt_free_buffer (&joined);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : csl_names()
+@INOUT      : buf
+@INPUT      : variable - "author" or "editor"
+              text     - the field's value
+              entry    - for the filename and line in warnings
+              options
+              first    - for append_member()
+@DESCRIPTION: Writes a list of names as CSL name objects: the last part
+              is the family name, the first the given name, the von part
+              the non-dropping particle, and the jr part the suffix.  A
+              name that is all one braced token (a corporate author)
+              becomes a literal, without its braces; "others" is left out.
+@CALLS      : bt_split_list(), bt_split_name_cached()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static void
+csl_names (bt_buffer * buf, char * variable, char * text, AST * entry,
+           bt_json_options * options, boolean * first)
+{
+   bt_stringlist * list;
+   bt_name *       name;
+   char *          token;
+   boolean         first_name, first_part;
+   int             i, len;
+
+   list = bt_split_list (text, "and", entry->filename, entry->line, "name");
+   if (list == NULL)
+      return;
+
+   append_member (buf, variable, first);
+   buf_append_char (buf, '[');
+   first_name = TRUE;
+   for (i = 0; i < list->num_items; i++)
+   {
+      if (list->items[i] == NULL || strcmp (list->items[i], "others") == 0)
+         continue;
+      name = bt_split_name_cached (list->items[i], entry->filename,
+                                   entry->line, i);
+      if (!first_name)
+         buf_append_char (buf, ',');
+      first_name = FALSE;
+      buf_append_char (buf, '{');
+      first_part = TRUE;
+
+      token = name->part_len[BTN_LAST] == 1 ? name->parts[BTN_LAST][0] : NULL;
+      len = token ? strlen (token) : 0;
+      if (name->tokens->num_items == 1 && len >= 2 &&
+          token[0] == '{' && token[len-1] == '}')
+      {
+         append_member (buf, "literal", &first_part);
+         token = strdup (token);
+         token[len-1] = (char) 0;
+         append_value (buf, token + 1, options);
+         free (token);
+      }
+      else
+      {
+         append_member (buf, "family", &first_part);
+         append_name_part (buf, name, BTN_LAST, options);
+         if (name->part_len[BTN_FIRST] > 0)
+         {
+            append_member (buf, "given", &first_part);
+            append_name_part (buf, name, BTN_FIRST, options);
+         }
+         if (name->part_len[BTN_VON] > 0)
+         {
+            append_member (buf, "non-dropping-particle", &first_part);
+            append_name_part (buf, name, BTN_VON, options);
+         }
+         if (name->part_len[BTN_JR] > 0)
+         {
+            append_member (buf, "suffix", &first_part);
+            append_name_part (buf, name, BTN_JR, options);
+         }
+      }
+      buf_append_char (buf, '}');
+      bt_free_name (name);
+   }
+   buf_append_char (buf, ']');
+   bt_free_list (list);
+}
+
+
+/*
+ * The number of a month: 1-12, for a number or anything starting with
+ * the first three letters of its English name; otherwise 0.
+ */
+static int
+month_number (char * text)
+{
+   int  i, num;
+
+   while (*text == ' ')
+      text++;
+   if (isdigit ((unsigned char) *text))
+   {
+      num = atoi (text);
+      return (num >= 1 && num <= 12) ? num : 0;
+   }
+   for (i = 0; i < 12; i++)
+   {
+      if (tolower ((unsigned char) text[0]) == months[i][0] &&
+          tolower ((unsigned char) text[1]) == months[i][1] &&
+          tolower ((unsigned char) text[2]) == months[i][2])
+         return i + 1;
+   }
+   return 0;
+}
+
+
+/* Writes "issued", from the year and month fields */
+static void
+csl_issued (bt_buffer * buf, AST * entry, bt_json_options * options,
+            boolean * first)
+{
+   char *  year;
+   char *  month;
+   char *  p;
+   char    num[16];
+   int     m;
+
+   year = field_text (entry, "year");
+   if (year == NULL)
+      return;
+   month = field_text (entry, "month");
+
+   append_member (buf, "issued", first);
+   for (p = year; isdigit ((unsigned char) *p); p++)
+      ;
+   if (p == year || *p != (char) 0 || p - year > 8)
+   {                                    /* not just a number */
+      buf_append_str (buf, "{\"literal\":");
+      append_value (buf, year, options);
+      buf_append_char (buf, '}');
+   }
+   else
+   {
+      buf_append_str (buf, "{\"date-parts\":[[");
+      buf_append_str (buf, year);
+      if (month && (m = month_number (month)) > 0)
+      {
+         sprintf (num, ",%d", m);
+         buf_append_str (buf, num);
+      }
+      buf_append_str (buf, "]]}");
+   }
+
+   free (year);
+   if (month) free (month);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : csl_entry()
+@INOUT      : buf
+@INPUT      : entry   - a regular entry
+              options
+@DESCRIPTION: Writes a regular entry as a CSL-JSON item: its key is the
+              id, and its type and fields are mapped as the tables above
+              say.  The number field is the issue of an article, and
+              the number of anything else; a thesis gets a genre (its
+              type field, if it has one); and "--" in pages becomes "-".
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static void
+csl_entry (bt_buffer * buf, AST * entry, bt_json_options * options)
+{
+   char *   type;
+   char *   key;
+   char *   csl_type;
+   char *   last_variable;
+   char *   text;
+   char *   p;
+   boolean  first;
+   int      i;
+
+   type = bt_entry_type (entry);
+   key = bt_entry_key (entry);
+   csl_type = "document";
+   for (i = 0; i < NUM_CSL_TYPES; i++)
+   {
+      if (strcmp (type, csl_types[i][0]) == 0)
+      {
+         csl_type = csl_types[i][1];
+         break;
+      }
+   }
+
+   first = TRUE;
+   buf_append_char (buf, '{');
+   append_member (buf, "id", &first);
+   append_json_string (buf, key ? key : "", key ? strlen (key) : 0);
+   append_member (buf, "type", &first);
+   append_json_string (buf, csl_type, strlen (csl_type));
+
+   if ((text = field_text (entry, "author")))
+   {
+      csl_names (buf, "author", text, entry, options, &first);
+      free (text);
+   }
+   if ((text = field_text (entry, "editor")))
+   {
+      csl_names (buf, "editor", text, entry, options, &first);
+      free (text);
+   }
+   csl_issued (buf, entry, options, &first);
+
+   last_variable = NULL;
+   for (i = 0; i < NUM_CSL_FIELDS; i++)
+   {
+      if (last_variable && strcmp (csl_fields[i][0], last_variable) == 0)
+         continue;                      /* already have this one */
+      text = field_text (entry, csl_fields[i][1]);
+      if (text == NULL)
+         continue;
+      last_variable = csl_fields[i][0];
+      if (strcmp (last_variable, "page") == 0)
+      {
+         for (p = text; (p = strstr (p, "--")); )
+            memmove (p, p + 1, strlen (p));
+      }
+      append_member (buf, last_variable, &first);
+      append_value (buf, text, options);
+      free (text);
+   }
+
+   if ((text = field_text (entry, "number")))
+   {
+      append_member (buf, strcmp (type, "article") == 0 ? "issue" : "number",
+                     &first);
+      append_value (buf, text, options);
+      free (text);
+   }
+
+   if (strcmp (csl_type, "thesis") == 0 || strcmp (csl_type, "report") == 0)
+   {
+      text = field_text (entry, "type");
+      if (text || strcmp (csl_type, "thesis") == 0)
+      {
+         append_member (buf, "genre", &first);
+         if (text)
+            append_value (buf, text, options);
+         else
+            buf_append_str (buf, strcmp (type, "phdthesis") == 0
+                            ? "\"PhD thesis\"" : "\"Master's thesis\"");
+      }
+      if (text) free (text);
+   }
+
+   buf_append_char (buf, '}');
+}
+
+
+/* ------------------------------------------------------------------------
+ * Whole entries
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_json_entry_s()
+@INOUT      : buf
+@INPUT      : entry   - an entry, as returned by bt_parse_entry() and
+                        friends
+              options - may be NULL, for plain JSON without conversion
+@RETURNS    : TRUE if anything was written (only regular entries are
+              written as CSL-JSON)
+@DESCRIPTION: Appends an entry's JSON object to `buf', with no newline
+              after it.  With options->unicode, the TeX in every string
+              is converted with bt_tex_to_unicode().
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+boolean bt_json_entry_s (bt_buffer * buf, AST * entry, bt_json_options * options)
+{
+   if (options == NULL) options = &default_options;
+
+   if (options->style == BTJS_CSL)
+   {
+      if (bt_entry_metatype (entry) != BTE_REGULAR)
+         return FALSE;
+      csl_entry (buf, entry, options);
+   }
+   else
+   {
+      plain_entry (buf, entry, options);
+   }
+   return TRUE;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_json_entry()
+@INPUT      : stream
+              entry
+              options - may be NULL, for plain JSON without conversion
+@RETURNS    : TRUE if anything was written
+@DESCRIPTION: Writes an entry's JSON object to `stream', on a line of
+              its own (so that a file's entries make JSON Lines).
+@CALLS      : bt_json_entry_s()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+boolean bt_json_entry (FILE * stream, AST * entry, bt_json_options * options)
+{
+   bt_buffer  buf;
+   boolean    written;
+
+   memset (&buf, 0, sizeof (buf));
+   written = bt_json_entry_s (&buf, entry, options);
+   if (written)
+   {
+      buf_append_char (&buf, '\n');
+      fwrite (buf.text, 1, buf.length, stream);
+   }
+   bt_free_buffer (&buf);
+   return written;
+}
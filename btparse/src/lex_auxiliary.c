@@ -189,6 +189,7 @@ void zzd_attr (Attrib *attr)
  *   realloc_lex_buffer()
  *   free_lex_buffer()
  *   lexer_overflow()
+ *   lexer_grow()
  *   zzcopy()              (only if ZZCOPY_FUNCTION is defined and true)
  */
 
@@ -315,6 +316,26 @@ void lexer_overflow (unsigned char **lastpos, unsigned char **nextpos)
 } /* lexer_overflow () */
 
 
+/*
+ * lexer_grow()
+ *
+ * Makes room for at least `needed' more characters (plus the terminating
+ * NUL) after *nextpos.  Used by the direct-coded scanner (scan_direct.c),
+ * which copies whole runs of characters at once; the buffer at least
+ * doubles in size, so a long token costs only a few reallocations.
+ */
+void lexer_grow (int needed, unsigned char **lastpos, unsigned char **nextpos)
+{
+   int   used = *nextpos - (unsigned char *) zzlextext;
+   int   increment = zzbufsize;
+
+   while (used + needed >= zzbufsize + increment)
+      increment *= 2;
+   realloc_lex_buffer (increment, lastpos, nextpos);
+
+} /* lexer_grow () */
+
+
 #if ZZCOPY_FUNCTION
 /*
  * zzcopy()
@@ -42,6 +42,7 @@ void zzcr_attr (Attrib *a, int tok, char *txt);
 void alloc_lex_buffer (int size);
 void free_lex_buffer (void);
 void lexer_overflow (unsigned char **lastpos, unsigned char **nextpos);
+void lexer_grow (int needed, unsigned char **lastpos, unsigned char **nextpos);
 #if ZZCOPY_FUNCTION
 void zzcopy (char **nextpos, char **lastpos, int *ovf_flag);
 #endif
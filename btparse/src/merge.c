@@ -0,0 +1,622 @@
+/* ------------------------------------------------------------------------
+@NAME       : merge.c
+@DESCRIPTION: Merges any number of BibTeX files into one, a file at a
+              time:
+
+                bt_merge_new
+                bt_merge_strings
+                bt_merge_entries
+                bt_merge_conflicts
+                bt_merge_free
+
+              Macro definitions and preambles go first, so every input
+              is read twice: once by bt_merge_strings() and then again by
+              bt_merge_entries().  Entries are read with bt_read_entry_text()
+              and, unless their key has to change, copied out exactly as
+              they were.  All that is kept from one entry to the next is a
+              set of hashes of the keys (and macro names) already written
+              -- and, for renaming, of the keys in all the inputs -- so
+              memory use grows with the number of keys, not with the size
+              of the files.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse library.  This library is
+              free software; you can redistribute it and/or modify it under
+              the terms of the GNU Library General Public License as
+              published by the Free Software Foundation; either version 2
+              of the License, or (at your option) any later version.
+-------------------------------------------------------------------------- */
+
+#include "bt_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include "btparse.h"
+#include "prototypes.h"
+#include "error.h"
+#include "my_dmalloc.h"
+#include "bt_debug.h"
+
+
+/*
+ * A key (or macro name, or preamble) that has been written: its two
+ * hashes from hash_text(), and where it was first seen.  For a macro,
+ * `value' is a hash of its value.
+ */
+typedef struct
+{
+   unsigned long  hash[2];
+   unsigned long  value;
+   int            file;
+   int            line;
+} mkey;
+
+typedef struct
+{
+   int      count;
+   int      alloc;
+   mkey *   keys;
+   htable   index;                      /* of keys, by hash[0] */
+} keyset;
+
+struct bt_merge_s
+{
+   bt_merge_policy policy;
+   keyset          keys;
+   keyset          used;                /* keys in the inputs (BTM_RENAME) */
+   keyset          macros;
+   keyset          preambles;
+   int             num_files;
+   char **         filenames;
+   int             conflicts;
+};
+
+
+/* ------------------------------------------------------------------------
+ * Key sets
+ */
+
+static mkey *
+find_key (keyset * set, unsigned long * hash)
+{
+   int  slot, id;
+
+   slot = -1;
+   while ((id = htable_find (&set->index, hash[0], &slot)) >= 0)
+   {
+      if (set->keys[id].hash[1] == hash[1])
+         return &set->keys[id];
+   }
+   return NULL;
+}
+
+
+static mkey *
+add_key (keyset * set, unsigned long * hash, int file, int line)
+{
+   mkey *  key;
+
+   if (set->count == set->alloc)
+   {
+      set->alloc = set->alloc ? 2 * set->alloc : 256;
+      set->keys = (mkey *) realloc (set->keys, set->alloc * sizeof (mkey));
+   }
+   htable_add (&set->index, hash[0], set->count);
+   key = &set->keys[set->count++];
+   key->hash[0] = hash[0];
+   key->hash[1] = hash[1];
+   key->value = 0;
+   key->file = file;
+   key->line = line;
+   return key;
+}
+
+
+static void
+free_keys (keyset * set)
+{
+   if (set->keys) free (set->keys);
+   htable_free (&set->index);
+}
+
+
+/* ------------------------------------------------------------------------
+ * Helpers
+ */
+
+static int
+file_id (bt_merge * merge, char * filename)
+{
+   int  i;
+
+   if (filename == NULL)
+      filename = "(unknown)";
+   for (i = 0; i < merge->num_files; i++)
+   {
+      if (strcmp (merge->filenames[i], filename) == 0)
+         return i;
+   }
+   merge->filenames = (char **)
+      realloc (merge->filenames, (merge->num_files + 1) * sizeof (char *));
+   merge->filenames[merge->num_files] = strdup (filename);
+   return merge->num_files++;
+}
+
+
+/* hash of a field's value, for spotting different definitions */
+static unsigned long
+hash_value (AST * field)
+{
+   AST *          value;
+   bt_nodetype    type;
+   char *         text;
+   unsigned long  hash = 2166136261UL;
+
+   value = NULL;
+   while ((value = bt_next_value (field, value, &type, &text)))
+   {
+      hash = ((hash ^ (unsigned long) type) * 16777619UL) & 0xffffffffUL;
+      for ( ; text && *text; text++)
+         hash = ((hash ^ (unsigned char) *text) * 16777619UL) & 0xffffffffUL;
+   }
+   return hash;
+}
+
+
+static void
+write_text (FILE * outfile, char * text, int length)
+{
+   fwrite (text, 1, length, outfile);
+   fputs ("\n\n", outfile);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_merge_new()
+@INPUT      : policy - what to do with an entry whose key has already
+                       been written
+@RETURNS    : a new, empty merge
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+bt_merge * bt_merge_new (bt_merge_policy policy)
+{
+   bt_merge *  merge;
+
+   merge = (bt_merge *) calloc (1, sizeof (bt_merge));
+   merge->policy = policy;
+   return merge;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Pass 1: macro definitions and preambles
+ */
+
+static void
+write_macro (bt_buffer * buf, char * name, AST * field)
+{
+   AST *          value;
+   bt_nodetype *  types;
+   char **        texts;
+   bt_nodetype    type;
+   char *         text;
+   int            num;
+
+   num = 0;
+   value = NULL;
+   while ((value = bt_next_value (field, value, &type, &text)))
+      num++;
+   types = (bt_nodetype *) malloc ((num + 1) * sizeof (bt_nodetype));
+   texts = (char **) malloc ((num + 1) * sizeof (char *));
+
+   num = 0;
+   value = NULL;
+   while ((value = bt_next_value (field, value, &type, &text)))
+   {
+      types[num] = type;
+      texts[num] = text;
+      num++;
+   }
+   bt_write_field (buf, name, num, types, texts, NULL);
+   free (types);
+   free (texts);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : merge_macros()
+@INPUT      : merge
+              entry   - a parsed @string entry
+              text    - its text
+              file    - id of its file
+              outfile
+@RETURNS    : the number of entries written (0 or 1)
+@DESCRIPTION: Writes the macros of an @string entry that haven't been
+              defined yet.  A macro defined again with the same value is
+              just left out; with a different value, that's a conflict,
+              and the first definition wins unless the policy is
+              BTM_REPORT.  If every macro is written, so is the entry's
+              text; if only some are, they're written as a new entry.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static int
+merge_macros (bt_merge *       merge,
+              AST *            entry,
+              bt_entry_text *  text,
+              int              file,
+              FILE *           outfile)
+{
+   AST *          field;
+   char *         name;
+   unsigned long  hash[2], value_hash;
+   mkey *         key;
+   int            num_fields, num_kept, i;
+   boolean *      keep;
+   bt_buffer      buf;
+
+   num_fields = 0;
+   field = NULL;
+   while ((field = bt_next_field (entry, field, &name)))
+      num_fields++;
+   keep = (boolean *) malloc ((num_fields + 1) * sizeof (boolean));
+
+   num_kept = 0;
+   field = NULL;
+   for (i = 0; (field = bt_next_field (entry, field, &name)); i++)
+   {
+      hash_text (name, strlen (name), hash);
+      value_hash = hash_value (field);
+      keep[i] = FALSE;
+      if ((key = find_key (&merge->macros, hash)) == NULL)
+      {
+         key = add_key (&merge->macros, hash, file, field->line);
+         key->value = value_hash;
+         keep[i] = TRUE;
+      }
+      else if (key->value != value_hash)
+      {
+         merge->conflicts++;
+         keep[i] = (merge->policy == BTM_REPORT);
+         error (BTERR_CONTENT, merge->filenames[file], field->line,
+                "macro \"%s\" already defined differently (%s, line %d)%s",
+                name, merge->filenames[key->file], key->line,
+                keep[i] ? "" : ": definition skipped");
+      }
+      if (keep[i])
+         num_kept++;
+   }
+
+   if (num_kept > 0 && num_kept == num_fields)
+   {
+      write_text (outfile, text->text, text->length);
+   }
+   else if (num_kept > 0)
+   {
+      memset (&buf, 0, sizeof (buf));
+      bt_write_head (&buf, BTE_MACRODEF, bt_entry_type (entry), NULL, NULL);
+      field = NULL;
+      for (i = 0; (field = bt_next_field (entry, field, &name)); i++)
+      {
+         if (keep[i])
+            write_macro (&buf, name, field);
+      }
+      bt_write_tail (&buf, NULL);
+      fwrite (buf.text, 1, buf.length, outfile);
+      bt_free_buffer (&buf);
+   }
+
+   free (keep);
+   return num_kept > 0;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_merge_strings()
+@INPUT      : merge
+              infile   - file to read (to the end)
+              filename - its name (for error messages)
+              outfile  - where to write
+@RETURNS    : the number of entries written
+@DESCRIPTION: The first pass over a file: writes its @string entries
+              (see merge_macros()) and its @preamble entries, except for
+              preambles already written.  All other entries are skipped
+              without being parsed; with BTM_RENAME, the keys of regular
+              entries are noted, so that renaming avoids them.
+@GLOBALS    : StringOptions
+@CALLS      : bt_read_entry_text(), bt_parse_entry_s()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_merge_strings (bt_merge * merge,
+                      FILE *     infile,
+                      char *     filename,
+                      FILE *     outfile)
+{
+   btshort        saved[NUM_METATYPES];
+   bt_reader *    reader;
+   bt_entry_text  text;
+   AST *          entry;
+   boolean        status;
+   unsigned long  hash[2];
+   int            file, count, parsed;
+
+   file = file_id (merge, filename);
+   save_stringopts (saved, BTO_MINIMAL);
+   reader = bt_open_reader (infile);
+
+   count = parsed = 0;
+   while (bt_read_entry_text (reader, &text))
+   {
+      if (text.metatype == BTE_REGULAR && merge->policy == BTM_RENAME &&
+          text.key != NULL)
+      {
+         hash_text (text.key, text.key_length, hash);
+         if (find_key (&merge->used, hash) == NULL)
+            add_key (&merge->used, hash, file, text.line);
+      }
+      if (text.metatype != BTE_MACRODEF && text.metatype != BTE_PREAMBLE)
+         continue;
+      entry = bt_parse_entry_s (text.text, merge->filenames[file],
+                                text.line, BTO_NOSTORE, &status);
+      parsed++;
+      if (entry == NULL)
+         continue;
+
+      if (!status)                      /* already complained about */
+      {
+         write_text (outfile, text.text, text.length);
+         count++;
+      }
+      else if (text.metatype == BTE_MACRODEF)
+      {
+         count += merge_macros (merge, entry, &text, file, outfile);
+      }
+      else
+      {
+         hash[0] = hash_value (entry);
+         hash[1] = text.length | 1;
+         if (find_key (&merge->preambles, hash) == NULL)
+         {
+            add_key (&merge->preambles, hash, file, text.line);
+            write_text (outfile, text.text, text.length);
+            count++;
+         }
+      }
+      bt_free_ast (entry);
+   }
+
+   if (parsed)                          /* clean up after the parser */
+      bt_parse_entry_s (NULL, NULL, 0, 0, NULL);
+   bt_close_reader (reader);
+   restore_stringopts (saved);
+   return count;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Pass 2: everything else
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : write_renamed()
+@INPUT      : outfile
+              text    - an entry's text
+              key     - its key, as it is in the text
+              new_key
+@RETURNS    : TRUE if the key was found (where it should be) and replaced
+@DESCRIPTION: Writes an entry with a new key, leaving the rest of its
+              text alone.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static boolean
+write_renamed (FILE * outfile, bt_entry_text * text, char * key,
+               char * new_key)
+{
+   int  start, key_len;
+
+   key_len = strlen (key);
+   if (text->key == NULL || strncmp (text->key, key, key_len) != 0)
+      return FALSE;
+
+   start = text->key - text->text;
+   fwrite (text->text, 1, start, outfile);
+   fputs (new_key, outfile);
+   write_text (outfile, text->key + key_len,
+               text->length - start - key_len);
+   return TRUE;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : merge_entry()
+@INPUT      : merge
+              entry   - a regular entry (parsed with BTO_CHECKONLY)
+              text    - its text
+              file    - id of its file
+              outfile
+@RETURNS    : the number of entries written (0 or 1)
+@DESCRIPTION: Writes an entry whose key hasn't been seen yet as it is.
+              If the key has been seen (ignoring case), that's a
+              conflict, dealt with according to the merge's policy:
+              BTM_FIRST skips the entry, BTM_RENAME gives it the first
+              key of the form "key-2", "key-3", ... that is neither
+              written yet nor used by any input (as seen by
+              bt_merge_strings()), and BTM_REPORT writes it anyway.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static int
+merge_entry (bt_merge *       merge,
+             AST *            entry,
+             bt_entry_text *  text,
+             int              file,
+             FILE *           outfile)
+{
+   char *         key;
+   char *         new_key;
+   unsigned long  hash[2];
+   mkey *         seen;
+   int            n;
+
+   key = bt_entry_key (entry);
+   if (key == NULL)
+   {
+      write_text (outfile, text->text, text->length);
+      return 1;
+   }
+
+   hash_text (key, strlen (key), hash);
+   if ((seen = find_key (&merge->keys, hash)) == NULL)
+   {
+      add_key (&merge->keys, hash, file, text->line);
+      write_text (outfile, text->text, text->length);
+      return 1;
+   }
+
+   merge->conflicts++;
+   switch (merge->policy)
+   {
+      case BTM_FIRST:
+         error (BTERR_CONTENT, merge->filenames[file], text->line,
+                "duplicate key \"%s\" (%s, line %d): entry skipped",
+                key, merge->filenames[seen->file], seen->line);
+         return 0;
+
+      case BTM_RENAME:
+         new_key = (char *) malloc (strlen (key) + 16);
+         for (n = 2; ; n++)
+         {
+            sprintf (new_key, "%s-%d", key, n);
+            hash_text (new_key, strlen (new_key), hash);
+            if (find_key (&merge->keys, hash) == NULL &&
+                find_key (&merge->used, hash) == NULL)
+               break;
+         }
+         error (BTERR_CONTENT, merge->filenames[file], text->line,
+                "duplicate key \"%s\" (%s, line %d): renamed to \"%s\"",
+                key, merge->filenames[seen->file], seen->line, new_key);
+         add_key (&merge->keys, hash, file, text->line);
+         if (!write_renamed (outfile, text, key, new_key))
+            internal_error ("couldn't find key \"%s\" in entry text", key);
+         free (new_key);
+         return 1;
+
+      default:
+         error (BTERR_CONTENT, merge->filenames[file], text->line,
+                "duplicate key \"%s\" (%s, line %d)",
+                key, merge->filenames[seen->file], seen->line);
+         write_text (outfile, text->text, text->length);
+         return 1;
+   }
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_merge_entries()
+@INPUT      : merge
+              infile   - file to read (to the end)
+              filename - its name (for error messages)
+              outfile  - where to write
+@RETURNS    : the number of entries written
+@DESCRIPTION: The second pass over a file: writes its regular entries
+              (see merge_entry()) and its comments, skipping @string and
+              @preamble entries.  Regular entries are only checked by the
+              parser (with BTO_CHECKONLY), for their keys; one that has
+              syntax errors is written as it is.
+@GLOBALS    : StringOptions
+@CALLS      : bt_read_entry_text(), bt_parse_entry_s()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_merge_entries (bt_merge * merge,
+                      FILE *     infile,
+                      char *     filename,
+                      FILE *     outfile)
+{
+   btshort        saved[NUM_METATYPES];
+   bt_reader *    reader;
+   bt_entry_text  text;
+   AST *          entry;
+   boolean        status;
+   int            file, count, parsed;
+
+   file = file_id (merge, filename);
+   save_stringopts (saved, BTO_MINIMAL);
+   reader = bt_open_reader (infile);
+
+   count = parsed = 0;
+   while (bt_read_entry_text (reader, &text))
+   {
+      if (text.metatype == BTE_MACRODEF || text.metatype == BTE_PREAMBLE)
+         continue;
+      if (text.metatype == BTE_COMMENT)
+      {
+         write_text (outfile, text.text, text.length);
+         count++;
+         continue;
+      }
+
+      entry = bt_parse_entry_s (text.text, merge->filenames[file], text.line,
+                                BTO_CHECKONLY | BTO_NOSTORE, &status);
+      parsed++;
+      if (entry == NULL || !status)
+      {
+         write_text (outfile, text.text, text.length);
+         count++;
+      }
+      else
+      {
+         count += merge_entry (merge, entry, &text, file, outfile);
+      }
+      if (entry)
+         bt_free_ast (entry);
+   }
+
+   if (parsed)                          /* clean up after the parser */
+      bt_parse_entry_s (NULL, NULL, 0, 0, NULL);
+   bt_close_reader (reader);
+   restore_stringopts (saved);
+   return count;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_merge_conflicts()
+@INPUT      : merge
+@RETURNS    : the number of conflicts (duplicate keys, and macros defined
+              differently) seen so far
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_merge_conflicts (bt_merge * merge)
+{
+   return merge->conflicts;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_merge_free()
+@INPUT      : merge
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_merge_free (bt_merge * merge)
+{
+   int  i;
+
+   if (merge == NULL)
+      return;
+   free_keys (&merge->keys);
+   free_keys (&merge->used);
+   free_keys (&merge->macros);
+   free_keys (&merge->preambles);
+   for (i = 0; i < merge->num_files; i++)
+      free (merge->filenames[i]);
+   free (merge->filenames);
+   free (merge);
+}
@@ -1,13 +1,19 @@
 /* ------------------------------------------------------------------------
 @NAME       : names.c
 @DESCRIPTION: Functions for dealing with BibTeX names and lists of names:
+                bt_split_spans
                 bt_split_list 
                 bt_split_name
+                bt_free_name
+                bt_set_name_cache
+                bt_split_name_cached
+                bt_name_cache_stats
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : 1997/05/05, Greg Ward (as string_util.c)
 @MODIFIED   : 1997/05/14-05/16, GW: added all the code to split individual 
                                     names, renamed file to names.c
+              2026/10/19: added the cache of split names
 @VERSION    : $Id$
 @COPYRIGHT  : Copyright (c) 1996-99 by Gregory P. Ward.  All rights reserved.
 
@@ -26,7 +32,6 @@
 #include "btparse.h"
 #include "prototypes.h"
 #include "error.h"
-#include "my_alloca.h"
 #include "my_dmalloc.h"
 #include "bt_debug.h"
 
@@ -63,7 +68,7 @@ GEN_PRIVATE_ERRFUNC (name_warning,
 
 
 /* ------------------------------------------------------------------------
-@NAME       : bt_split_list()
+@NAME       : bt_split_spans()
 @INPUT      : string - string to split up; whitespace must be collapsed
                        eg. by bt_postprocess_string()
               delim  - delimiter to use; must be lowercase and should be
@@ -73,172 +78,182 @@ GEN_PRIVATE_ERRFUNC (name_warning,
               line     - 1-based line number into file (for warning messages)
               description - what substrings are (eg. "name") (for warning
                             messages); if NULL will use "substring"
-@OUTPUT     : substrings (*substrings is allocated by bt_split_list() for you)
-@RETURNS    : number of substrings found
+@OUTPUT     : num_spans - number of substrings found
+@RETURNS    : newly-allocated array of num_spans spans (offset and length
+              of each substring in string), or NULL if string is NULL or
+              empty
 @DESCRIPTION: Splits a string using a fixed delimiter, in the BibTeX way:
                 * delimiters at beginning or end of string are ignored
                 * delimiters in string must be surrounded by whitespace
                 * case insensitive
                 * delimiters at non-zero brace depth are ignored
 
-              The list of substrings is returned as *substrings, which
-              is an array of pointers into a duplicate of string.  This
-              duplicate copy has been scribbled on such that there is 
-              a nul byte at the end of every substring.  You should
-              call bt_free_list() to free both the duplicate copy
-              of string and *substrings itself.  Do *not* walk over
-              the array free()'ing the substrings yourself, as this is
-              invalid -- they were not malloc()'d!
+              Nothing is copied: the substrings are given by where they
+              are in string.  An empty substring (as between the two
+              delimiters of "and and") has a length of 0, and is warned
+              about.
+
+              The string is scanned once, a word at a time: only the
+              first character of a word at brace depth 0 can start a
+              delimiter, so the delimiter is compared with whole words,
+              and the rest of a word is only looked at for braces.
 @GLOBALS    : 
 @CALLS      : 
-@CALLERS    : anyone (exported by library)
-@CREATED    : 1997/05/05, GPW
+@CALLERS    : anyone (exported by library), bt_split_list()
+@CREATED    : 2026/10/19
 @MODIFIED   : 
 -------------------------------------------------------------------------- */
-bt_stringlist *
-bt_split_list (char *   string,
-               char *   delim,
-               char *   filename,
-               int      line,
-               char *   description)
+bt_span *
+bt_split_spans (char *   string,
+                char *   delim,
+                char *   filename,
+                int      line,
+                char *   description,
+                int *    num_spans)
 {
-   int    depth;                        /* brace depth */
-   int    i, j;                         /* offset into string and delim */
-   int    inword;                       /* flag telling if prev. char == ws */
-   int    string_len;
-   int    delim_len;
-   int    maxdiv;                       /* upper limit on no. of divisions */
-   int    maxoffs;                      /* max offset of delim in string */
-   int    numdiv;                       /* number of divisions */
-   int *  start;                        /* start of each division */
-   int *  stop;                         /* stop of each division */
-   bt_stringlist *
-          list;                         /* structure to return */
-   name_loc loc;
+   int        depth;                    /* brace depth */
+   int        i, j;                     /* offset into string and delim */
+   int        start;                    /* of the current substring */
+   int        delim_len;
+   int        max_spans;
+   bt_span *  spans;
+   name_loc   loc;
+
+   *num_spans = 0;
+   if (string == NULL || *string == (char) 0)
+      return NULL;
+   if (description == NULL)
+      description = "substring";
 
    loc.filename = filename;
    loc.line = line;
    loc.name_num = 0;
 
-   if (string == NULL)
-      return NULL;
-   if (description == NULL)
-      description = "substring";
-
-   string_len = strlen (string);
    delim_len = strlen (delim);
-   maxdiv = (string_len / delim_len) + 1;
-   /* Originally, maxoffs = string_len - delim_len + 1, making the code 
-      a little faster (well, if delim has a considerable length.
-      Given the tests added to validate braces nesting, we need to look
-      up to the end of the string. */
-   maxoffs = string_len;
-
-   /* 
-    * This is a bit of a band-aid solution to the "split empty string"
-    * bug (formerly hit the internal_error() at the end of hte function).
-    * Still need a general "detect and fix unpreprocessed string" -- 
-    * admittedly a different bug/misfeature.
-    */
-   if (string_len == 0)
-      return NULL;
-
-   start = (int *) alloca (maxdiv * sizeof (int));
-   stop = (int *) alloca (maxdiv * sizeof (int));
-
-   list = (bt_stringlist *) malloc (sizeof (bt_stringlist));
+   max_spans = 8;
+   spans = (bt_span *) malloc (max_spans * sizeof (bt_span));
 
    depth = 0;
-   i = j = 0;
-   inword = 1;                          /* so leading delim ignored */
-   numdiv = 0;
-   start[0] = 0;                        /* first substring @ start of string */
-
-   while (i < maxoffs)
+   start = 0;
+   for (i = 0; string[i]; i++)
    {
-      /* does current char. in string match current char. in delim? */
-      if (depth == 0 && !inword && tolower (string[i]) == delim[j])
+      if (string[i] != ' ')
       {
-         j++; i++;
-
-         /* have we found an entire delim, followed by a space? */
-         if (j == delim_len && string[i] == ' ')
-         {
+         update_depth (string[i], depth, &loc);
+         continue;
+      }
+      if (depth > 0)
+         continue;
 
-            stop[numdiv] = i - delim_len - 1;
-            start[++numdiv] = ++i;
-            j = 0;
+      /* a space at depth 0: is the next word the delimiter? */
+      for (j = 0; j < delim_len; j++)
+         if (tolower ((unsigned char) string[i+1+j]) != delim[j])
+            break;
+      if (j < delim_len || string[i+1+j] != ' ')
+         continue;
 
-#if DEBUG
-            printf ("found complete delim; i == %d, numdiv == %d: "
-                    "stop[%d] == %d, start[%d] == %d\n",
-                    i, numdiv, 
-                    numdiv-1, stop[numdiv-1],
-                    numdiv, start[numdiv]);
-#endif
-         }
-      }
-      
-      /* no match between string and delim, at non-zero depth, or in a word */
-      else
+      if (*num_spans + 1 == max_spans)
       {
-         update_depth (string[i], depth, &loc);
-         inword = (i < string_len) && (string[i] != ' ');
-         i++;
-         j = 0;
+         max_spans *= 2;
+         spans = (bt_span *) realloc (spans, max_spans * sizeof (bt_span));
       }
+      spans[*num_spans].offset = start;
+      spans[*num_spans].length = i - start;
+      (*num_spans)++;
+      i += delim_len + 1;               /* to the space after it ... */
+      start = i + 1;
+      i--;                              /* ... which is looked at next */
    }
 
    if (depth)
-	   name_warning (&loc, "unmatched '{' (ignoring)");
+      name_warning (&loc, "unmatched '{' (ignoring)");
 
-   stop[numdiv] = string_len;           /* last substring ends just past eos */
-   list->num_items = numdiv+1;
+   spans[*num_spans].offset = start;    /* the last substring */
+   spans[*num_spans].length = i - start;
+   (*num_spans)++;
 
+   for (j = 0; j < *num_spans; j++)
+   {
+      if (spans[j].length <= 0)         /* empty, e.g. "and and" */
+      {
+         spans[j].length = 0;
+         general_error (BTERR_CONTENT, filename, line,
+                        description, j+1, "empty %s", description);
+      }
+   }
+   return spans;
 
-   /* 
-    * OK, now we know how many divisions there are and where they are --
-    * so let's split that string up for real!
-    * 
-    * list->items will be an array of pointers into a duplicate of
-    * `string'; we duplicate `string' so we can safely scribble on it and
-    * free() it later (in bt_free_list()).
-    */
-       
-   list->items = (char **) malloc (list->num_items * sizeof (char *));
-   list->string = strdup (string);
+} /* bt_split_spans () */
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_split_list()
+@INPUT      : string - string to split up; whitespace must be collapsed
+                       eg. by bt_postprocess_string()
+              delim  - delimiter to use; must be lowercase and should be
+                       free of whitespace (code requires that delimiters
+                       in string be surrounded by whitespace)
+              filename - source of string (for warning messages)
+              line     - 1-based line number into file (for warning messages)
+              description - what substrings are (eg. "name") (for warning
+                            messages); if NULL will use "substring"
+@OUTPUT     : 
+@RETURNS    : newly-allocated list of substrings, or NULL if string is
+              NULL or empty
+@DESCRIPTION: Splits a string as bt_split_spans() does, and returns the
+              substrings as strings.
+
+              The list of substrings is returned as list->items, which
+              is an array of pointers into a duplicate of string (NULL
+              for empty substrings).  This duplicate copy has been
+              scribbled on such that there is a nul byte at the end of
+              every substring.  You should call bt_free_list() to free
+              both the duplicate copy of string and list->items itself.
+              Do *not* walk over the array free()'ing the substrings
+              yourself, as this is invalid -- they were not malloc()'d!
+@GLOBALS    : 
+@CALLS      : bt_split_spans()
+@CALLERS    : anyone (exported by library)
+@CREATED    : 1997/05/05, GPW
+@MODIFIED   : 2026/10/19: a wrapper around bt_split_spans()
+-------------------------------------------------------------------------- */
+bt_stringlist *
+bt_split_list (char *   string,
+               char *   delim,
+               char *   filename,
+               int      line,
+               char *   description)
+{
+   bt_span *  spans;
+   int        num_spans;
+   int        i;
+   bt_stringlist *
+              list;                     /* structure to return */
 
-   for (i = 0; i < list->num_items; i++)
+   spans = bt_split_spans (string, delim, filename, line, description,
+                           &num_spans);
+   if (spans == NULL)
+      return NULL;
+
+   list = (bt_stringlist *) malloc (sizeof (bt_stringlist));
+   list->num_items = num_spans;
+   list->items = (char **) malloc (num_spans * sizeof (char *));
+   list->string = strdup (string);
+   for (i = 0; i < num_spans; i++)
    {
-      /* 
-       * Possible cases:
-       *   - stop < start is for empty elements, e.g. "and and" seen in
-       *     input.  (`start' for empty element will be the 'a' of the
-       *     second 'and', and its stop will be the ' ' *before* the
-       *     second 'and'.)
-       *   - stop > start is for anything else between two and's (the usual)
-       *   - stop == start should never happen if the loop above is correct 
-       */
-
-      if (stop[i] > start[i])           /* the usual case */
+      if (spans[i].length > 0)
       {
-         list->string[stop[i]] = 0;
-         list->items[i] = list->string+start[i];
+         list->string[spans[i].offset + spans[i].length] = (char) 0;
+         list->items[i] = list->string + spans[i].offset;
       }
-      else if (stop[i] < start[i])      /* empty element */
+      else                              /* empty element */
       {
          list->items[i] = NULL;
-         general_error (BTERR_CONTENT, filename, line, 
-                        description, i+1, "empty %s", description);
-      }
-      else                              /* should not happen! */
-      {
-         internal_error ("stop == start for substring %d", i);
       }
    }
 
+   free (spans);
    return list;
-/*    return num_substrings; */
 
 } /* bt_split_list () */
 
@@ -809,6 +824,7 @@ bt_split_name (char *  name,
    DBG_ACTION (1, printf ("bt_split_name(): name=%p (%s)\n", name, name))
 
    split_name = (bt_name *) malloc (sizeof (bt_name));
+   split_name->refcount = 0;            /* not shared */
    if (name == NULL)
    {
       len = 0;
@@ -913,14 +929,21 @@ bt_split_name (char *  name,
 @DESCRIPTION: Frees up any memory allocated for a bt_name structure
               (namely, the `tokens' field [a bt_stringlist structure,
               this freed with bt_free_list()] and the structure itself.)
+              A name shared through the name cache is only freed when
+              its last holder (maybe the cache itself) lets go of it.
 @CALLS      : bt_free_list()
 @CALLERS    : anyone (exported)
 @CREATED    : 1997/11/14, GPW
-@MODIFIED   : 
+@MODIFIED   : 2026/10/19: shared names
 -------------------------------------------------------------------------- */
 void
 bt_free_name (bt_name * name)
 {
+   if (name->refcount > 1)              /* someone else still has it */
+   {
+      name->refcount--;
+      return;
+   }
 	if (name && name->tokens && name->parts[BTN_LAST])
    DBG_ACTION (2, printf ("bt_free_name(): freeing name %p "
                           "(%d tokens, string=%p (%s), last[0]=%s)\n",
@@ -933,3 +956,197 @@ bt_free_name (bt_name * name)
    free (name);
    DBG_ACTION (2, printf ("bt_free_name(): done, everything freed\n"));
 }
+
+
+/* ----------------------------------------------------------------------
+ * The name cache: split names kept by the exact bytes of the name, so
+ * that a name seen again (the same authors turn up all through a big
+ * bibliography) is split once.  The cache holds a fixed number of
+ * names, in a hash table; when it is full, a CLOCK sweep picks the name
+ * to drop: the hand passes over names that have been asked for since
+ * it last came round (clearing their marks), and stops at one that
+ * hasn't.  New names start unmarked, so a name seen only once goes
+ * first.
+ *
+ * Names are shared: the cache and everyone it has handed a name to
+ * hold a reference (counted in the name), and bt_free_name() lets go
+ * of one.  Names that caused warnings when they were split aren't
+ * kept, so that every occurrence is warned about.
+ */
+
+typedef struct
+{
+   char *        key;                   /* the name, as given */
+   unsigned long hash;
+   bt_name *     name;
+   boolean       marked;                /* asked for since the hand passed */
+} name_slot;
+
+static name_slot *    CacheSlots = NULL;
+static htable         CacheTable;       /* of slots, by name_hash() */
+static int            CacheSize = 0;    /* 0: no cache */
+static int            CacheUsed = 0;
+static int            CacheHand = 0;
+static unsigned long  CacheHits = 0;
+static unsigned long  CacheMisses = 0;
+
+
+static unsigned long
+name_hash (char * name)
+{
+   unsigned long  hash = 2166136261UL;
+
+   for ( ; *name; name++)
+      hash = ((hash ^ (unsigned char) *name) * 16777619UL) & 0xffffffffUL;
+   return hash;
+}
+
+
+/* Takes a slot's name out of the cache (leaving the slot empty) */
+static void
+drop_slot (int slot)
+{
+   name_slot * s = &CacheSlots[slot];
+   int         found;
+
+   found = -1;
+   while (htable_find (&CacheTable, s->hash, &found) != slot)
+      ;
+   htable_remove (&CacheTable, found);
+   free (s->key);
+   bt_free_name (s->name);
+   s->key = NULL;
+   s->name = NULL;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_set_name_cache()
+@INPUT      : size - the number of names to keep, or 0 for no cache
+@DESCRIPTION: Empties the name cache (names already handed out stay
+              good), sets its size and zeroes its counts.  There is no
+              cache until this is called.
+@GLOBALS    : the name cache
+@CALLERS    : anyone (exported), bt_cleanup()
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+void
+bt_set_name_cache (int size)
+{
+   int  i;
+
+   for (i = 0; i < CacheUsed; i++)
+   {
+      free (CacheSlots[i].key);
+      bt_free_name (CacheSlots[i].name);
+   }
+   if (CacheSlots) free (CacheSlots);
+   htable_free (&CacheTable);
+   CacheSlots = NULL;
+   CacheSize = CacheUsed = CacheHand = 0;
+   CacheHits = CacheMisses = 0;
+
+   if (size <= 0)
+      return;
+   CacheSize = size;
+   CacheSlots = (name_slot *) calloc (size, sizeof (name_slot));
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_split_name_cached()
+@INPUT      : name
+              filename
+              line
+              name_num
+@RETURNS    : the name, split as by bt_split_name()
+@DESCRIPTION: Looks a name up in the name cache, splitting it (and
+              keeping it) if it isn't there.  The bt_name returned may
+              be shared, so it mustn't be changed; it is freed with
+              bt_free_name(), as usual.  With no cache, this is just
+              bt_split_name().
+@GLOBALS    : the name cache
+@CALLS      : bt_split_name()
+@CALLERS    : anyone (exported)
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+bt_name *
+bt_split_name_cached (char *  name,
+                      char *  filename,
+                      int     line,
+                      int     name_num)
+{
+   unsigned long  hash;
+   bt_name *      split_name;
+   name_slot *    s;
+   int            found, slot, warnings;
+
+   if (CacheSize == 0 || name == NULL)
+      return bt_split_name (name, filename, line, name_num);
+
+   hash = name_hash (name);
+   found = -1;
+   while ((slot = htable_find (&CacheTable, hash, &found)) >= 0)
+   {
+      s = &CacheSlots[slot];
+      if (strcmp (s->key, name) == 0)
+      {
+         CacheHits++;
+         s->marked = TRUE;
+         s->name->refcount++;
+         return s->name;
+      }
+   }
+
+   CacheMisses++;
+   warnings = bt_get_error_count (BTERR_CONTENT);
+   split_name = bt_split_name (name, filename, line, name_num);
+   if (bt_get_error_count (BTERR_CONTENT) != warnings)
+      return split_name;
+
+   if (CacheUsed < CacheSize)
+   {
+      slot = CacheUsed++;
+   }
+   else                                 /* full: sweep for a name to drop */
+   {
+      while (CacheSlots[CacheHand].marked)
+      {
+         CacheSlots[CacheHand].marked = FALSE;
+         CacheHand = (CacheHand + 1) % CacheSize;
+      }
+      slot = CacheHand;
+      CacheHand = (CacheHand + 1) % CacheSize;
+      drop_slot (slot);
+   }
+
+   s = &CacheSlots[slot];
+   s->key = strdup (name);
+   s->hash = hash;
+   s->name = split_name;
+   s->marked = FALSE;
+   htable_add (&CacheTable, hash, slot);
+   split_name->refcount = 2;            /* the cache's, and the caller's */
+   return split_name;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_name_cache_stats()
+@OUTPUT     : hits   - names found in the cache
+              misses - names not found, and so split
+@DESCRIPTION: Counts the cache's hits and misses since it was last
+              set with bt_set_name_cache().
+@GLOBALS    : the name cache
+@CALLERS    : anyone (exported)
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+void
+bt_name_cache_stats (unsigned long * hits, unsigned long * misses)
+{
+   if (hits) *hits = CacheHits;
+   if (misses) *misses = CacheMisses;
+}
@@ -218,7 +218,7 @@ zzsyn(char *        text,
 
    if (!etok && !eset)
    {
-      syntax_error (msg);
+      syntax_error ("%s", msg);
       return;
    }
    else
@@ -264,7 +264,7 @@ zzsyn(char *        text,
    if (egroup && strlen (egroup) > 0) 
       snprintf (msg+len, MAX_ERROR - len - 1, " in %s", egroup);
 
-   syntax_error (msg);
+   syntax_error ("%s", msg);
 
 }
 #endif /* USER_ZZSYN */
@@ -28,15 +28,102 @@
 #define DEBUG 1
 
 
+/*
+ * Word-at-a-time ("SWAR") helpers for bt_postprocess_string() (bt_word
+ * and friends are in prototypes.h).  A bt_word is loaded from an
+ * arbitrary (possibly unaligned) position with memcpy(), which compilers
+ * turn into a single load.  byte_match() yields 0x80 in every byte of `w'
+ * equal to the byte replicated in `pattern', and zero everywhere else --
+ * the exact variant, without the false positives of the usual "has zero
+ * byte" trick, so that masks can be combined and shifted.
+ */
+#define WORD_SPACES   (WORD_ONES * ' ')
+#define WORD_CRS      (WORD_ONES * '\r')
+
+static bt_word
+byte_match (bt_word w, bt_word pattern)
+{
+   bt_word x = w ^ pattern;
+   return ~(((x & WORD_LOW7) + WORD_LOW7) | x | WORD_LOW7);
+}
+
+static bt_word
+load_word (const char * p)
+{
+   bt_word w;
+   memcpy (&w, p, WORD_SIZE);
+   return w;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : first_edit()
+@INPUT      : s        - string to scan
+              len      - its length
+              collapse - are we collapsing whitespace?
+@OUTPUT     : 
+@RETURNS    : offset of the first character that bt_postprocess_string()
+              must delete (a carriage return, a leading space, or the
+              second space of a run), or len if there is none
+@DESCRIPTION: Fast path for bt_postprocess_string(): most strings are
+              already clean, and for those we want to get away with a
+              read-only scan.  Carriage returns are located with memchr();
+              runs of spaces are detected a word at a time by and'ing the
+              space mask of each word with itself shifted by one byte, so
+              that we only drop to a byte-by-byte loop in the one word
+              that actually contains a double space.
+@CREATED    : 2026/10/19
+-------------------------------------------------------------------------- */
+static int
+first_edit (const char * s, int len, boolean collapse)
+{
+   const char * cr;
+   int   limit;
+   int   i;
+   bt_word mask;
+
+   cr = memchr (s, '\r', len);
+   limit = cr ? (int) (cr - s) : len;
+
+   if (!collapse || limit == 0)
+      return limit;
+   if (s[0] == ' ')
+      return 0;
+
+   /* 
+    * Word loop: a double space lies either inside a word (caught by the
+    * mask test) or straddles two words (caught by the explicit check of
+    * the first byte against the previous one).
+    */
+   for (i = 0; i + (int) WORD_SIZE <= limit; i += WORD_SIZE)
+   {
+      mask = byte_match (load_word (s + i), WORD_SPACES);
+      if ((mask & (mask >> 8)) || (i > 0 && s[i] == ' ' && s[i-1] == ' '))
+         break;
+   }
+
+   /* Byte loop: pin down the double space, or handle the tail */
+   if (i == 0) i = 1;
+   for (; i < limit; i++)
+   {
+      if (s[i] == ' ' && s[i-1] == ' ')
+         return i;
+   }
+   return limit;
+
+} /* first_edit() */
+
+
 /* ------------------------------------------------------------------------
 @NAME       : bt_postprocess_string ()
 @INPUT      : s
               options
 @OUTPUT     : s (modified in place according to the flags)
-@RETURNS    : (void)
+@RETURNS    : the length of the post-processed string (0 if s is NULL)
 @DESCRIPTION: Make a pass over string s (which is modified in-place) to
-              optionally collapse whitespace according to BibTeX rules
-              (if the BTO_COLLAPSE bit in options is true).
+              strip carriage returns and optionally collapse whitespace
+              according to BibTeX rules (if the BTO_COLLAPSE bit in options
+              is true).
 
               Rules for collapsing whitespace are:
                  * whitespace at beginning/end of string is deleted
@@ -45,20 +132,26 @@
 
               Note that part of the work is done by the lexer proper,
               namely conversion of tabs and newlines to spaces.
+
+              Strings that need no change are detected by first_edit()
+              without writing to them; otherwise we only start copying at
+              the first character to be dropped, and copy runs of ordinary
+              characters a word at a time.
 @GLOBALS    : 
-@CALLS      : 
+@CALLS      : first_edit()
 @CREATED    : originally in lex_auxiliary.c; moved here 1997/01/12
-@MODIFIED   : 
+@MODIFIED   : 2026/10/19: word-at-a-time scanning, returns the length
 @COMMENTS   : this only collapses whitespace now -- rename it???
 -------------------------------------------------------------------------- */
-void 
+int
 bt_postprocess_string (char * s, btshort options)
 {
    boolean collapse_whitespace;
-   char *i, *j;
-   int   len;
+   int     len;
+   int     i, j;
+   bt_word w;
 
-   if (s == NULL) return;               /* quit if no string supplied */
+   if (s == NULL) return 0;             /* quit if no string supplied */
 
 #if DEBUG > 1
    printf ("bt_postprocess_string: looking at >%s<\n", s);
@@ -67,51 +160,59 @@ bt_postprocess_string (char * s, btshort options)
    /* Extract any relevant options (just one currently) to local flags. */
    collapse_whitespace = options & BTO_COLLAPSE;
 
-   /*
-    * N.B. i and j will both point into s; j is always >= i, and
-    * we copy characters from j to i.  Whitespace is collapsed/deleted
-    * by advancing j without advancing i.
-    */
-   i = j = s;                           /* start both at beginning of string */
+   len = strlen (s);
+   j = first_edit (s, len, collapse_whitespace);
 
    /*
-    * If we're supposed to collapse whitespace, then advance j to the
-    * first non-space character.
+    * N.B. i and j are both offsets into s; j is always >= i, and we copy
+    * characters from j to i.  Carriage returns and redundant spaces are
+    * deleted by advancing j without advancing i.  Everything before the
+    * first edit stays where it is.
     */
-   if (collapse_whitespace)
+   i = j;
+   while (j < len)
    {
-      while (*j == ' ' && *j != (char) 0)
-         j++;
-   }
+      /* Copy whole words that contain neither spaces nor CRs */
+      while (j + (int) WORD_SIZE <= len)
+      {
+         w = load_word (s + j);
+         if (byte_match (w, WORD_SPACES) | byte_match (w, WORD_CRS))
+            break;
+         if (i != j)
+            memcpy (s + i, &w, WORD_SIZE);
+         i += WORD_SIZE;
+         j += WORD_SIZE;
+      }
+      if (j == len)
+         break;
 
-   while (*j != (char) 0)
-   {
+      /* Don't want Ctrl-Ms in strings in the output */
+      if (s[j] == '\r')
+      {
+         j++;
+         continue;
+      }
 
-       if (*j == '\r') j++; /* don't want Ctrl-Ms in strings in the output */
       /*
-       * If we're in a string of spaces (ie. current and previous char.
-       * are both space), and we're supposed to be collapsing whitespace,
-       * then skip until we hit a non-space character (or end of string).
+       * Drop a space if it would start the string or follow another space
+       * (in the output, so that "a \r b" also collapses properly).
        */
-      if (collapse_whitespace && *j == ' ' && *(j-1) == ' ') 
+      if (collapse_whitespace && s[j] == ' ' && (i == 0 || s[i-1] == ' '))
       {
-         while (*j == ' ') j++;         /* skip spaces */
-         if (*j == (char) 0)            /* reached end of string? */
-            break;
+         j++;
+         continue;
       }
 
-      /* Copy the current character from j down to i */
-      *(i++) = *(j++);
+      s[i++] = s[j++];
    }
-   *i = (char) 0;                       /* ensure string is terminated */
-
+   s[i] = (char) 0;                     /* ensure string is terminated */
+   len = i;
 
    /*
     * And mop up whitespace (if any) at end of string -- note that if there
     * was any whitespace there, it has already been collapsed to exactly
     * one space.
     */
-   len = strlen (s);
    if (len > 0 && collapse_whitespace && s[len-1] == ' ')
    {
       s[--len] = (char) 0;
@@ -121,6 +222,8 @@ bt_postprocess_string (char * s, btshort options)
    printf ("                transformed to >%s<\n", s);
 #endif
 
+   return len;
+
 } /* bt_postprocess_string */
 
 
@@ -179,6 +282,7 @@ bt_postprocess_value (AST * value, btshort options, boolean replace)
    boolean pasting;
    btshort  string_opts;                 /* what to do to individual strings */
    int     tot_len;                     /* total length of pasted string */
+   int     cur_len;                     /* length pasted so far */
    char *  new_string;                  /* in case of string pasting */
    char *  tmp_string;
    boolean free_tmp;                    /* should we free() tmp_string? */
@@ -206,6 +310,7 @@ bt_postprocess_value (AST * value, btshort options, boolean replace)
     */
 
    tot_len = 0;                         /* these are out here to keep */
+   cur_len = 0;
    new_string = NULL;                   /* gcc -Wall happy */
    tmp_string = NULL;
 
@@ -360,7 +465,13 @@ bt_postprocess_value (AST * value, btshort options, boolean replace)
       if (pasting)
       {
          if (tmp_string)
-            strcat (new_string, tmp_string);
+         {
+            int tmp_len = strlen (tmp_string);
+
+            assert (cur_len + tmp_len <= tot_len); /* hope we alloc'd enough! */
+            memcpy (new_string + cur_len, tmp_string, tmp_len);
+            cur_len += tmp_len;
+         }
          if (free_tmp)
             free (tmp_string);
       }
@@ -385,11 +496,7 @@ bt_postprocess_value (AST * value, btshort options, boolean replace)
 
    if (pasting)
    {
-      int    len;
-
-      len = strlen (new_string);
-      assert (len <= tot_len);          /* hope we alloc'd enough! */
-
+      new_string[cur_len] = (char) 0;
       bt_postprocess_string (new_string, options);
 
       /* 
@@ -29,8 +29,21 @@
 #include <stdio.h>
 #include "btparse.h"                    /* for types */
 
+/*
+ * Word-at-a-time ("SWAR") scanning: a bt_word holds WORD_SIZE bytes, and
+ * multiplying WORD_ONES by a byte value replicates it in every byte.
+ */
+typedef unsigned long bt_word;
+
+#define WORD_SIZE     (sizeof (bt_word))
+#define WORD_ONES     ((bt_word) -1 / 0xFF)
+#define WORD_LOW7     (WORD_ONES * 0x7F)
+#define WORD_HIGH     (WORD_ONES * 0x80)
+
 /* util.c */
 int get_uchar(char *string, int offset);
+int utf8_decode(const char *string, int *len);
+int ascii_span(const char *string, int len);
 int isulower(char *string);
 #if !HAVE_STRLWR
 char *strlwr (char *s);
@@ -40,10 +53,78 @@ char *strupr (char *s);
 #endif
 
 
+/* string_util.c */
+
+/*
+ * The TeX control sequences that btparse knows about, from tex_chars.dat
+ * (see gen_tex_chars.pl for the tables made of it).
+ */
+typedef enum
+{
+   TEX_NONE,                            /* an empty slot in the table */
+   TEX_LETTER,                          /* a foreign letter (\ss, ...) */
+   TEX_ACCENT,                          /* an accent (\", \v, ...) */
+   TEX_SYMBOL,                          /* any other character (\S, ...) */
+   TEX_COMMAND,                         /* dropped, keeping its argument */
+   TEX_SKIP                             /* dropped with its argument */
+} tex_kind;
+
+typedef struct
+{
+   char *    name;                      /* without the backslash */
+   tex_kind  kind;
+   char *    purified;                  /* forms of a foreign letter */
+   char *    upper;
+   char *    lower;
+   int       code;                      /* Unicode (combining, if accent) */
+   int       accent;                    /* accent: row of tex_composed[] */
+} tex_char;
+
+tex_char * tex_char_lookup (char * name, int len);
+
+/* tex_unicode.c */
+char * fold_text (char * string, boolean accents);
+
+/* input.c */
+boolean field_wanted (char * name);
+boolean entry_wanted (char * type, char * key);
+void save_stringopts (btshort * saved, btshort macro_options);
+void restore_stringopts (btshort * saved);
+
+/* hash_table.c */
+
+/*
+ * A hash table of ids (see hash_table.c); all zeros is an empty table.
+ */
+typedef struct
+{
+   unsigned long  hash;
+   int            id;                   /* -1 for a free slot */
+} hslot;
+
+typedef struct
+{
+   int      size;                       /* a power of two, or 0 */
+   int      count;
+   hslot *  slots;
+} htable;
+
+void hash_text (char * text, int length, unsigned long * hash);
+int  htable_find (htable * table, unsigned long hash, int * slot);
+void htable_add (htable * table, unsigned long hash, int id);
+void htable_remove (htable * table, int slot);
+void htable_free (htable * table);
+
 /* macros.c */
 void  init_macros (void);
 void  done_macros (void);
 
+/* write.c */
+void buf_reserve (bt_buffer * buf, int more);
+void buf_append (bt_buffer * buf, char * text, int len);
+void buf_append_str (bt_buffer * buf, char * text);
+void buf_append_char (bt_buffer * buf, char c);
+
 /* bibtex_ast.c */
 void dump_ast (char *msg, AST *root);
 
@@ -0,0 +1,892 @@
+/* ------------------------------------------------------------------------
+@NAME       : query.c
+@DESCRIPTION: Queries on the fields of entries, evaluated as a file is
+              parsed:
+                bt_query_new
+                bt_query_fields
+                bt_query_match
+                bt_query_file
+                bt_query_free
+
+              A query is compiled to a tree of predicates:
+
+                type = article and year >= 2015 and author ~ "Knuth"
+
+              Comparisons are joined by `and' (which can be left out),
+              `or' and `not', and grouped with parentheses.  A
+              comparison is a field name, an operator (= != < <= > >=
+              or ~) and a value (a word, or anything in double quotes);
+              a field name alone is true if the entry has that field.
+              `type' and `key' are the entry type and key.
+
+              Values are compared as they are indexed by index.c: the
+              field's value (with macros expanded) and the query's are
+              both folded by fold_text(), so TeX, case and accents make
+              no difference -- except that ~ with an accented value
+              looks for it with its accents.  A ~ value with no letters
+              or digits at all is an error, since it would be found in
+              anything.  If the query's value is a number, it is
+              compared as one (and is never equal to a word, nor more
+              or less than one).  For author and editor, = and !=
+              compare with the von and last parts of each name (true if
+              any name matches).  ~ looks for the query's value
+              anywhere in the field's.  A comparison on a field the
+              entry doesn't have is false.
+
+              Fields are only looked at when a comparison needs them,
+              and their values only folded (or their names split) once
+              per entry.  When a file is queried, entries are
+              parsed with only the fields the query needs (see
+              bt_set_projection()), and an entry whose type or key
+              already rules it out isn't parsed at all.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse library.  This library is
+              free software; you can redistribute it and/or modify it under
+              the terms of the GNU Library General Public License as
+              published by the Free Software Foundation; either version 2
+              of the License, or (at your option) any later version.
+-------------------------------------------------------------------------- */
+
+#include "bt_config.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "btparse.h"
+#include "prototypes.h"
+#include "error.h"
+#include "my_dmalloc.h"
+#include "bt_debug.h"
+
+
+/* Pseudo-fields: the entry type and key */
+#define FIELD_TYPE   (-1)
+#define FIELD_KEY    (-2)
+
+/* The fields whose values are lists of names */
+static char * name_fields[] = { "author", "editor", NULL };
+
+typedef enum { Q_AND, Q_OR, Q_NOT, Q_CMP } qnodetype;
+typedef enum { C_EXISTS, C_EQ, C_NE, C_LT, C_LE, C_GT, C_GE, C_MATCH } qcmp;
+
+/* Three-valued results, for entries whose fields aren't known yet */
+#define QV_FALSE     0
+#define QV_TRUE      1
+#define QV_UNKNOWN   2
+
+typedef struct qnode_s
+{
+   qnodetype         type;
+   struct qnode_s *  left;              /* Q_AND, Q_OR, Q_NOT */
+   struct qnode_s *  right;             /* Q_AND, Q_OR */
+   int               field;             /* Q_CMP: FIELD_TYPE, FIELD_KEY, */
+   qcmp              cmp;               /*   or an index into fields */
+   char *            value;             /* normalized */
+   boolean           accents;           /* ~: value keeps its accents */
+   boolean           numeric;
+   double            number;
+} qnode;
+
+struct bt_query_s
+{
+   char *    text;
+   qnode *   root;
+   char **   fields;                    /* the fields compared */
+   boolean * is_names;
+   int       num_fields;
+};
+
+/* What's known of the entry being matched */
+typedef struct
+{
+   AST *     entry;                     /* NULL: only type and key known */
+   char *    type;
+   char *    key;
+   AST **    found;                     /* for each of the query's fields */
+   char **   values;                    /* normalized, when needed */
+   char **   accented;                  /* the same, keeping accents */
+   char ***  names;                     /* von and last, when needed */
+   int *     num_names;
+} qentry;
+
+
+/* ------------------------------------------------------------------------
+ * Normalizing values
+ */
+
+/* Folds `text' (see fold_text()) into a new string */
+static char *
+normalize (char * text, boolean accents)
+{
+   return fold_text (text, accents);
+}
+
+
+static boolean
+is_number (char * text, double * number)
+{
+   char *  end;
+
+   if (*text == (char) 0)
+      return FALSE;
+   *number = strtod (text, &end);
+   return *end == (char) 0;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Compiling a query: a recursive-descent parser, on this grammar:
+
+     or      := and ("or" and)*
+     and     := not (["and"] not)*
+     not     := "not" not | primary
+     primary := "(" or ")" | name [op value]
+     op      := "=" | "!=" | "<" | "<=" | ">" | ">=" | "~"
+     value   := word | '"' anything but '"' '"'
+
+   where a name or word is anything up to a space, parenthesis, double
+   quote or operator character; and, or and not are in any case.
+ */
+
+typedef struct
+{
+   bt_query *  query;
+   char *      pos;
+   boolean     ok;
+} qparser;
+
+static qnode * parse_or (qparser * parser);
+
+
+static void
+skip_space (qparser * parser)
+{
+   while (isspace ((unsigned char) *parser->pos))
+      parser->pos++;
+}
+
+
+static void
+query_error (qparser * parser, char * message)
+{
+   if (parser->ok)
+      usage_warning ("query \"%s\", at character %d: %s",
+                     parser->query->text,
+                     (int) (parser->pos - parser->query->text) + 1, message);
+   parser->ok = FALSE;
+}
+
+
+static boolean
+word_char (char c)
+{
+   return c && !isspace ((unsigned char) c) && strchr ("()\"=!<>~", c) == NULL;
+}
+
+
+/* Is the next word `keyword' (in any case)?  If so, skips it. */
+static boolean
+next_keyword (qparser * parser, char * keyword)
+{
+   int  len = strlen (keyword);
+   int  i;
+
+   skip_space (parser);
+   for (i = 0; i < len; i++)
+      if (tolower ((unsigned char) parser->pos[i]) != keyword[i])
+         return FALSE;
+   if (word_char (parser->pos[len]))
+      return FALSE;
+   parser->pos += len;
+   return TRUE;
+}
+
+
+static qnode *
+new_node (qnodetype type, qnode * left, qnode * right)
+{
+   qnode *  node = (qnode *) calloc (1, sizeof (qnode));
+
+   node->type = type;
+   node->left = left;
+   node->right = right;
+   return node;
+}
+
+
+static void
+free_node (qnode * node)
+{
+   if (node == NULL)
+      return;
+   free_node (node->left);
+   free_node (node->right);
+   if (node->value) free (node->value);
+   free (node);
+}
+
+
+static char *
+copy_text (char * start, char * end)
+{
+   char *  text = (char *) malloc (end - start + 1);
+
+   memcpy (text, start, end - start);
+   text[end - start] = (char) 0;
+   return text;
+}
+
+
+/* The number of a field compared, adding it to the query's list */
+static int
+query_field (bt_query * query, char * name)
+{
+   int  i;
+
+   strlwr (name);
+   if (strcmp (name, "type") == 0)
+      return FIELD_TYPE;
+   if (strcmp (name, "key") == 0)
+      return FIELD_KEY;
+   for (i = 0; i < query->num_fields; i++)
+      if (strcmp (query->fields[i], name) == 0)
+         return i;
+
+   query->fields = (char **)
+      realloc (query->fields, (i + 1) * sizeof (char *));
+   query->is_names = (boolean *)
+      realloc (query->is_names, (i + 1) * sizeof (boolean));
+   query->fields[i] = strdup (name);
+   query->is_names[i] = FALSE;
+   for (i = 0; name_fields[i]; i++)
+      if (strcmp (name, name_fields[i]) == 0)
+         query->is_names[query->num_fields] = TRUE;
+   return query->num_fields++;
+}
+
+
+static qcmp
+parse_operator (qparser * parser)
+{
+   char *  p;
+
+   skip_space (parser);
+   p = parser->pos;
+   switch (*p)
+   {
+      case '=': parser->pos += 1; return C_EQ;
+      case '~': parser->pos += 1; return C_MATCH;
+      case '!':
+         if (p[1] == '=') { parser->pos += 2; return C_NE; }
+         break;
+      case '<':
+         if (p[1] == '=') { parser->pos += 2; return C_LE; }
+         parser->pos += 1; return C_LT;
+      case '>':
+         if (p[1] == '=') { parser->pos += 2; return C_GE; }
+         parser->pos += 1; return C_GT;
+   }
+   return C_EXISTS;
+}
+
+
+static qnode *
+parse_primary (qparser * parser)
+{
+   qnode *  node;
+   char *   start;
+   char *   name;
+   char *   value;
+   char *   accented;
+
+   skip_space (parser);
+   if (*parser->pos == '(')
+   {
+      parser->pos++;
+      node = parse_or (parser);
+      skip_space (parser);
+      if (*parser->pos != ')')
+         query_error (parser, "expected \")\"");
+      else
+         parser->pos++;
+      return node;
+   }
+
+   start = parser->pos;
+   while (word_char (*parser->pos))
+      parser->pos++;
+   if (parser->pos == start)
+   {
+      query_error (parser, "expected a field name");
+      return NULL;
+   }
+   name = copy_text (start, parser->pos);
+   node = new_node (Q_CMP, NULL, NULL);
+   node->field = query_field (parser->query, name);
+   free (name);
+
+   node->cmp = parse_operator (parser);
+   if (node->cmp == C_EXISTS)
+      return node;
+
+   skip_space (parser);
+   if (*parser->pos == '"')
+   {
+      start = ++parser->pos;
+      while (*parser->pos && *parser->pos != '"')
+         parser->pos++;
+      if (*parser->pos != '"')
+      {
+         query_error (parser, "unterminated string");
+         return node;
+      }
+      value = copy_text (start, parser->pos++);
+   }
+   else
+   {
+      start = parser->pos;
+      while (word_char (*parser->pos))
+         parser->pos++;
+      if (parser->pos == start)
+      {
+         query_error (parser, "expected a value");
+         return node;
+      }
+      value = copy_text (start, parser->pos);
+   }
+
+   /* types and keys aren't TeX: they're just compared without case */
+   if (node->field < 0)
+      node->value = strlwr (value);
+   else
+   {
+      node->value = normalize (value, FALSE);
+      if (node->cmp == C_MATCH)
+      {                                 /* look for accents if given them */
+         accented = normalize (value, TRUE);
+         node->accents = (strcmp (accented, node->value) != 0);
+         free (node->accents ? node->value : accented);
+         if (node->accents)
+            node->value = accented;
+      }
+      free (value);
+      if (node->cmp == C_MATCH && *node->value == (char) 0)
+      {                                 /* would be found in anything */
+         query_error (parser, "nothing to look for after \"~\"");
+         return node;
+      }
+   }
+   node->numeric = (node->cmp != C_MATCH &&
+                    is_number (node->value, &node->number));
+   return node;
+}
+
+
+static qnode *
+parse_not (qparser * parser)
+{
+   if (next_keyword (parser, "not"))
+      return new_node (Q_NOT, parse_not (parser), NULL);
+   return parse_primary (parser);
+}
+
+
+static qnode *
+parse_and (qparser * parser)
+{
+   qnode *  node;
+   char *   save;
+
+   node = parse_not (parser);
+   while (parser->ok)
+   {
+      skip_space (parser);
+      save = parser->pos;
+      if (*parser->pos == (char) 0 || *parser->pos == ')' ||
+          next_keyword (parser, "or"))
+      {
+         parser->pos = save;
+         break;
+      }
+      next_keyword (parser, "and");
+      node = new_node (Q_AND, node, parse_not (parser));
+   }
+   return node;
+}
+
+
+static qnode *
+parse_or (qparser * parser)
+{
+   qnode *  node;
+
+   node = parse_and (parser);
+   while (parser->ok && next_keyword (parser, "or"))
+      node = new_node (Q_OR, node, parse_and (parser));
+   return node;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_query_new()
+@INPUT      : text - a query (see the top of this file)
+@RETURNS    : the compiled query, or NULL if it has a syntax error (which
+              is reported, as a usage warning)
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+bt_query * bt_query_new (char * text)
+{
+   bt_query *  query;
+   qparser     parser;
+
+   query = (bt_query *) calloc (1, sizeof (bt_query));
+   query->text = strdup (text);
+   parser.query = query;
+   parser.pos = query->text;
+   parser.ok = TRUE;
+   query->root = parse_or (&parser);
+   skip_space (&parser);
+   if (parser.ok && *parser.pos != (char) 0)
+      query_error (&parser, "expected and, or or the end");
+
+   if (!parser.ok)
+   {
+      bt_query_free (query);
+      return NULL;
+   }
+   return query;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_query_fields()
+@INPUT      : query
+@OUTPUT     : num_fields - the number of fields
+@RETURNS    : the (lowercase) names of the fields the query looks at, not
+              counting the type and key; they belong to the query
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+char ** bt_query_fields (bt_query * query, int * num_fields)
+{
+   *num_fields = query->num_fields;
+   return query->fields;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_query_free()
+@INPUT      : query
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_query_free (bt_query * query)
+{
+   int  i;
+
+   free_node (query->root);
+   for (i = 0; i < query->num_fields; i++)
+      free (query->fields[i]);
+   if (query->fields) free (query->fields);
+   if (query->is_names) free (query->is_names);
+   free (query->text);
+   free (query);
+}
+
+
+/* ------------------------------------------------------------------------
+ * Evaluating a query
+ */
+
+static void
+start_entry (bt_query * query, qentry * qe, AST * entry)
+{
+   AST *   field;
+   char *  name;
+   int     i, n;
+
+   n = query->num_fields > 0 ? query->num_fields : 1;
+   qe->entry = entry;
+   qe->type = bt_entry_type (entry);
+   qe->key = bt_entry_key (entry);
+   qe->found = (AST **) calloc (n, sizeof (AST *));
+   qe->values = (char **) calloc (n, sizeof (char *));
+   qe->accented = (char **) calloc (n, sizeof (char *));
+   qe->names = (char ***) calloc (n, sizeof (char **));
+   qe->num_names = (int *) calloc (n, sizeof (int));
+
+   field = NULL;
+   while ((field = bt_next_field (entry, field, &name)))
+   {
+      for (i = 0; i < query->num_fields; i++)
+         if (strcmp (name, query->fields[i]) == 0 && qe->found[i] == NULL)
+            qe->found[i] = field;
+   }
+}
+
+
+static void
+finish_entry (bt_query * query, qentry * qe)
+{
+   int  i, j;
+
+   for (i = 0; i < query->num_fields; i++)
+   {
+      if (qe->values[i]) free (qe->values[i]);
+      if (qe->accented[i]) free (qe->accented[i]);
+      for (j = 0; j < qe->num_names[i]; j++)
+         free (qe->names[i][j]);
+      if (qe->names[i]) free (qe->names[i]);
+   }
+   free (qe->found);
+   free (qe->values);
+   free (qe->accented);
+   free (qe->names);
+   free (qe->num_names);
+}
+
+
+/*
+ * The normalized value of a field (keeping its accents, or not), or NULL
+ * if the entry hasn't got it
+ */
+static char *
+field_value (qentry * qe, int field, boolean accents)
+{
+   char ** values;
+   char *  text;
+
+   if (qe->found[field] == NULL)
+      return NULL;
+   values = accents ? qe->accented : qe->values;
+   if (values[field] == NULL)
+   {
+      text = bt_get_text (qe->found[field]);
+      values[field] = normalize (text ? text : "", accents);
+      if (text) free (text);
+   }
+   return values[field];
+}
+
+
+/* Splits a field's names, keeping the normalized von and last parts */
+static void
+split_names (qentry * qe, int field)
+{
+   bt_stringlist * list;
+   bt_name *       name;
+   bt_buffer       buf;
+   char *          text;
+   int             i, j;
+
+   text = bt_get_text (qe->found[field]);
+   if (text == NULL)
+      return;
+   list = bt_split_list (text, "and", qe->entry->filename, qe->entry->line,
+                         "name");
+   free (text);
+   if (list == NULL)
+      return;
+
+   qe->names[field] = (char **) malloc ((list->num_items + 1) * sizeof (char *));
+   memset (&buf, 0, sizeof (buf));
+   for (i = 0; i < list->num_items; i++)
+   {
+      if (list->items[i] == NULL)
+         continue;
+      name = bt_split_name_cached (list->items[i], qe->entry->filename,
+                                   qe->entry->line, i);
+      buf.length = 0;
+      buf_append_str (&buf, "");
+      for (j = 0; j < name->part_len[BTN_VON]; j++)
+      {
+         buf_append_str (&buf, name->parts[BTN_VON][j]);
+         buf_append_char (&buf, ' ');
+      }
+      for (j = 0; j < name->part_len[BTN_LAST]; j++)
+      {
+         buf_append_str (&buf, name->parts[BTN_LAST][j]);
+         buf_append_char (&buf, ' ');
+      }
+      qe->names[field][qe->num_names[field]++] = normalize (buf.text, FALSE);
+      bt_free_name (name);
+   }
+   bt_free_buffer (&buf);
+   bt_free_list (list);
+}
+
+
+static boolean
+compare (qnode * node, char * value)
+{
+   double  number;
+   int     diff;
+
+   if (node->cmp == C_MATCH)
+      return strstr (value, node->value) != NULL;
+
+   if (node->numeric)
+   {
+      if (!is_number (value, &number))  /* a number is never equal to, */
+         return node->cmp == C_NE;      /* or more or less than, a word */
+      diff = (number > node->number) - (number < node->number);
+   }
+   else
+      diff = strcmp (value, node->value);
+
+   switch (node->cmp)
+   {
+      case C_EQ: return diff == 0;
+      case C_NE: return diff != 0;
+      case C_LT: return diff < 0;
+      case C_LE: return diff <= 0;
+      case C_GT: return diff > 0;
+      case C_GE: return diff >= 0;
+      default:   return FALSE;
+   }
+}
+
+
+/* Is any of a field's names (von and last) equal to the node's value? */
+static boolean
+any_name (qentry * qe, qnode * node)
+{
+   int  i;
+
+   if (qe->names[node->field] == NULL)
+      split_names (qe, node->field);
+   for (i = 0; i < qe->num_names[node->field]; i++)
+      if (strcmp (qe->names[node->field][i], node->value) == 0)
+         return TRUE;
+   return FALSE;
+}
+
+
+static int
+evaluate_cmp (bt_query * query, qentry * qe, qnode * node)
+{
+   char *  value;
+   char *  lower;
+   boolean result;
+
+   if (node->field < 0)
+   {
+      value = (node->field == FIELD_TYPE) ? qe->type : qe->key;
+      if (value == NULL)
+         return QV_FALSE;
+      if (node->cmp == C_EXISTS)
+         return QV_TRUE;
+      lower = strlwr (strdup (value));
+      result = compare (node, lower);
+      free (lower);
+      return result ? QV_TRUE : QV_FALSE;
+   }
+
+   if (qe->entry == NULL)
+      return QV_UNKNOWN;
+   if (qe->found[node->field] == NULL)
+      return QV_FALSE;
+   if (node->cmp == C_EXISTS)
+      return QV_TRUE;
+   if (query->is_names[node->field] &&
+       (node->cmp == C_EQ || node->cmp == C_NE))
+   {
+      result = any_name (qe, node);
+      return (result == (node->cmp == C_EQ)) ? QV_TRUE : QV_FALSE;
+   }
+   return compare (node, field_value (qe, node->field, node->accents)) ? QV_TRUE : QV_FALSE;
+}
+
+
+static int
+evaluate (bt_query * query, qentry * qe, qnode * node)
+{
+   int  left, right;
+
+   switch (node->type)
+   {
+      case Q_CMP:
+         return evaluate_cmp (query, qe, node);
+      case Q_NOT:
+         left = evaluate (query, qe, node->left);
+         return (left == QV_UNKNOWN) ? left : !left;
+      case Q_AND:
+         left = evaluate (query, qe, node->left);
+         if (left == QV_FALSE)
+            return left;
+         right = evaluate (query, qe, node->right);
+         return (right == QV_TRUE) ? left : right;
+      case Q_OR:
+         left = evaluate (query, qe, node->left);
+         if (left == QV_TRUE)
+            return left;
+         right = evaluate (query, qe, node->right);
+         return (right == QV_FALSE) ? left : right;
+   }
+   return QV_FALSE;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_query_match()
+@INPUT      : query
+              entry - a regular entry
+@RETURNS    : TRUE if the entry matches the query
+@DESCRIPTION: Evaluates a query on an entry, as parsed (with any amount
+              of processing: values are compared fully processed).
+              Values are only looked at as the comparisons come to them.
+@CALLS      : bt_get_text(), bt_split_list(), bt_split_name_cached()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+boolean bt_query_match (bt_query * query, AST * entry)
+{
+   qentry   qe;
+   boolean  result;
+
+   if (bt_entry_metatype (entry) != BTE_REGULAR)
+      return FALSE;
+   start_entry (query, &qe, entry);
+   result = (evaluate (query, &qe, query->root) == QV_TRUE);
+   finish_entry (query, &qe);
+   return result;
+}
+
+
+/*
+ * Reads the type and key from an entry's raw text, for a first look at
+ * it; FALSE if they can't be.
+ */
+static boolean
+raw_type_key (bt_entry_text * text, char ** type, char ** key)
+{
+   char *  p;
+   char *  start;
+
+   for (p = text->text + 1; isspace ((unsigned char) *p); p++)
+      ;
+   for (start = p; *p && *p != '{' && *p != '(' &&
+           !isspace ((unsigned char) *p); p++)
+      ;
+   if (p == start)
+      return FALSE;
+   *type = strlwr (copy_text (start, p));
+
+   if ((p = strpbrk (p, "{(")) == NULL)
+   {
+      free (*type);
+      return FALSE;
+   }
+   for (p++; isspace ((unsigned char) *p); p++)
+      ;
+   for (start = p; *p && *p != ',' && *p != '}' && *p != ')' &&
+           !isspace ((unsigned char) *p); p++)
+      ;
+   if (p == start)
+   {
+      free (*type);
+      return FALSE;
+   }
+   *key = copy_text (start, p);
+   return TRUE;
+}
+
+
+/* Can an entry be ruled out on its type and key alone? */
+static boolean
+ruled_out (bt_query * query, bt_entry_text * text)
+{
+   qentry   qe;
+   boolean  result;
+
+   memset (&qe, 0, sizeof (qe));
+   if (!raw_type_key (text, &qe.type, &qe.key))
+      return FALSE;
+   result = (evaluate (query, &qe, query->root) == QV_FALSE);
+   free (qe.type);
+   free (qe.key);
+   return result;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_query_file()
+@INPUT      : query
+              infile   - a BibTeX file
+              filename - its name, for messages
+              output   - what to write for each entry matched:
+                           BTQ_KEYS    its key, on a line
+                           BTQ_RANGES  its byte offset and length, on a line
+                           BTQ_ENTRIES its text, and a blank line
+              outfile  - where to write it
+@RETURNS    : the number of entries matched
+@DESCRIPTION: Reads a file to the end, matching its regular entries to
+              the query and writing out the ones that match, as they
+              are found.  Entries are found with bt_read_entry_text(),
+              so their offsets are exact, and parsed with only the
+              fields the query needs; an entry whose type or key rules
+              it out isn't parsed at all.  @string entries are parsed,
+              and their macros defined, so that values have their
+              macros expanded.
+@GLOBALS    : StringOptions
+@CALLS      : bt_read_entry_text(), bt_parse_entry_s(), bt_query_match()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+int bt_query_file (bt_query * query, FILE * infile, char * filename,
+                   bt_query_output output, FILE * outfile)
+{
+   bt_reader *    reader;
+   bt_entry_text  text;
+   AST *          entry;
+   btshort        saved[NUM_METATYPES];
+   boolean        status;
+   int            count, parsed;
+
+   save_stringopts (saved, BTO_MACRO);
+   bt_set_projection (query->fields, query->num_fields);
+   reader = bt_open_reader (infile);
+
+   count = parsed = 0;
+   while (bt_read_entry_text (reader, &text))
+   {
+      if (text.metatype != BTE_REGULAR && text.metatype != BTE_MACRODEF)
+         continue;
+      if (text.metatype == BTE_REGULAR && ruled_out (query, &text))
+         continue;
+      entry = bt_parse_entry_s (text.text, filename, text.line, 0, &status);
+      parsed++;
+      if (entry == NULL)
+         continue;
+      if (bt_query_match (query, entry))
+      {
+         switch (output)
+         {
+            case BTQ_KEYS:
+               fprintf (outfile, "%s\n", bt_entry_key (entry));
+               break;
+            case BTQ_RANGES:
+               fprintf (outfile, "%ld %d\n", text.offset, text.length);
+               break;
+            case BTQ_ENTRIES:
+               fwrite (text.text, 1, text.length, outfile);
+               fputs ("\n\n", outfile);
+               break;
+         }
+         count++;
+      }
+      bt_free_ast (entry);
+   }
+
+   if (parsed)                          /* clean up after the parser */
+      bt_parse_entry_s (NULL, NULL, 0, 0, NULL);
+   bt_close_reader (reader);
+   bt_set_projection (NULL, 0);
+   restore_stringopts (saved);
+   return count;
+}
@@ -0,0 +1,378 @@
+/* ------------------------------------------------------------------------
+@NAME       : reader.c
+@DESCRIPTION: Reads the raw text of entries from a file, without parsing
+              them:
+
+                bt_open_reader
+                bt_set_reader_range
+                bt_read_entry_text
+                bt_close_reader
+
+              Entries are found by the same rules as the lexer uses: an
+              '@' between entries (outside %-comments), the entry type,
+              then a body delimited by braces (which must balance) or
+              parentheses (which end at the first ')' outside braces and
+              quotes).  Only one entry is held in memory at a time; its
+              text can be passed to bt_parse_entry_s(), copied out as it
+              is, or both.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse library.  This library is
+              free software; you can redistribute it and/or modify it under
+              the terms of the GNU Library General Public License as
+              published by the Free Software Foundation; either version 2
+              of the License, or (at your option) any later version.
+-------------------------------------------------------------------------- */
+
+#include "bt_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "btparse.h"
+#include "prototypes.h"
+#include "my_dmalloc.h"
+#include "bt_debug.h"
+
+
+#define READ_SIZE 8192
+
+struct bt_reader_s
+{
+   FILE *          infile;
+   unsigned char   buf[READ_SIZE];
+   int             pos, len;            /* next char, and end, of buf */
+   long            offset;              /* of buf[0] in the file */
+   long            end;                 /* no entries from here (or -1) */
+   int             line;                /* current line number */
+   char *          text;                /* the entry being read */
+   int             length;
+   int             size;
+};
+
+
+/* ------------------------------------------------------------------------
+ * Characters
+ */
+
+static int
+next_char (bt_reader * reader)
+{
+   int  c;
+
+   if (reader->pos == reader->len)
+   {
+      reader->offset += reader->len;
+      reader->len = fread (reader->buf, 1, READ_SIZE, reader->infile);
+      reader->pos = 0;
+      if (reader->len <= 0)
+      {
+         reader->len = 0;
+         return EOF;
+      }
+   }
+   c = reader->buf[reader->pos++];
+   if (c == '\n')
+      reader->line++;
+   return c;
+}
+
+
+/* only ever called right after next_char() returned `c' (not EOF) */
+static void
+unget_char (bt_reader * reader, int c)
+{
+   reader->pos--;
+   if (c == '\n')
+      reader->line--;
+}
+
+
+static void
+keep_char (bt_reader * reader, int c)
+{
+   if (reader->length + 1 >= reader->size)
+   {
+      reader->size = reader->size ? 2 * reader->size : 1024;
+      reader->text = (char *) realloc (reader->text, reader->size);
+   }
+   reader->text[reader->length++] = (char) c;
+}
+
+
+static bt_metatype
+type_metatype (char * type, int length)
+{
+   static struct { char * name; bt_metatype metatype; } special[] =
+   {
+      { "comment",  BTE_COMMENT },
+      { "preamble", BTE_PREAMBLE },
+      { "string",   BTE_MACRODEF }
+   };
+   int  i, j;
+
+   for (i = 0; i < (int) (sizeof (special) / sizeof (special[0])); i++)
+   {
+      if ((int) strlen (special[i].name) != length)
+         continue;
+      for (j = 0; j < length; j++)
+      {
+         if (tolower ((unsigned char) type[j]) != special[i].name[j])
+            break;
+      }
+      if (j == length)
+         return special[i].metatype;
+   }
+   return BTE_REGULAR;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_open_reader()
+@INPUT      : infile - file to read entries from (positioned at the
+                       start of the file, or anywhere between entries)
+@RETURNS    : a new reader
+@DESCRIPTION: Starts reading the raw text of entries from a file.  The
+              file is not closed by bt_close_reader().
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+bt_reader * bt_open_reader (FILE * infile)
+{
+   bt_reader *  reader;
+
+   reader = (bt_reader *) calloc (1, sizeof (bt_reader));
+   reader->infile = infile;
+   reader->offset = ftell (infile);
+   if (reader->offset < 0)
+      reader->offset = 0;
+   reader->end = -1;
+   reader->line = 1;
+   return reader;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_set_reader_range()
+@INPUT      : reader
+              start - byte offset of the first entry to read (or of
+                      anything between entries before it)
+              end   - and of the first entry not to read (-1: read to
+                      the end of the file)
+              line  - the line number at `start'
+@RETURNS    : FALSE if the file couldn't be positioned at `start'
+@DESCRIPTION: Restricts a reader to the entries that start (at their
+              '@') in a range of its file, seeking straight to the start
+              of the range; bt_read_entry_text() then returns FALSE at
+              the first entry from `end' on, without reading it.  This
+              is how a big file is read in shards, with the offsets and
+              lines of the entries that start them taken from an earlier
+              bt_read_entry_text() pass.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+boolean bt_set_reader_range (bt_reader * reader, long start, long end,
+                             int line)
+{
+   if (fseek (reader->infile, start, SEEK_SET) != 0)
+      return FALSE;
+   reader->pos = reader->len = 0;
+   reader->offset = start;
+   reader->end = end;
+   reader->line = line;
+   return TRUE;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : skip_comment()
+@INPUT      : reader
+@DESCRIPTION: Keeps the rest of a %-comment (whose '%' has just been
+              kept) up to and including the newline that ends it, so
+              that nothing in it is counted as a delimiter.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static void
+skip_comment (bt_reader * reader)
+{
+   int   c;
+
+   while ((c = next_char (reader)) != EOF)
+   {
+      keep_char (reader, c);
+      if (c == '\n')
+         break;
+   }
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_read_entry_text()
+@INPUT      : reader
+@OUTPUT     : *entry - the text of the next entry, where it starts (as a
+                       byte offset, and a line number), its metatype
+                       (from its type alone), its key (for a regular
+                       entry), and how much junk came before it
+@RETURNS    : TRUE if an entry was read, FALSE at end of file (or of the
+              reader's range)
+@DESCRIPTION: Reads the next entry, skipping anything between entries
+              (where a '%' that starts a token, as the lexer sees it,
+              comments out the rest of the line, '@' and all).  The
+              characters skipped, other than whitespace and comments,
+              are counted as junk, as the lexer counts them.
+              `entry->text' runs from the '@' to the closing delimiter
+              and is nul-terminated; it belongs to the reader, and is
+              only good until the next call.  An '@' that isn't followed
+              by a type and an opening delimiter is taken as junk; an
+              entry that runs off the end of the file is returned as far
+              as it goes (and the parser will complain about it).
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+boolean bt_read_entry_text (bt_reader * reader, bt_entry_text * entry)
+{
+   int      c, type_start, type_end, open, depth;
+   boolean  quoted, comments, at_token;
+   char *   key;
+
+   entry->junk = 0;
+   at_token = TRUE;
+   for (;;)
+   {
+      while ((c = next_char (reader)) != EOF && c != '@')
+      {
+         if (c == '%' && at_token)
+         {
+            while ((c = next_char (reader)) != EOF && c != '\n')
+               ;
+            if (c == EOF)
+               break;
+         }
+         at_token = (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+         if (!at_token)
+            entry->junk++;
+      }
+      if (c == EOF)
+         return FALSE;
+      if (reader->end >= 0 && reader->offset + reader->pos - 1 >= reader->end)
+      {
+         unget_char (reader, c);        /* for the next range, if any */
+         return FALSE;
+      }
+
+      entry->offset = reader->offset + reader->pos - 1;
+      entry->line = reader->line;
+      reader->length = 0;
+      keep_char (reader, c);
+
+      while ((c = next_char (reader)) != EOF && isspace (c))
+         keep_char (reader, c);
+      type_start = reader->length;
+      while (c != EOF && !isspace (c) && !strchr ("{}()\"#%'=,@", c))
+      {
+         keep_char (reader, c);
+         c = next_char (reader);
+      }
+      type_end = reader->length;
+      while (c != EOF && isspace (c))
+      {
+         keep_char (reader, c);
+         c = next_char (reader);
+      }
+
+      if (type_end > type_start && (c == '{' || c == '('))
+         break;
+      if (c == '@')                     /* start over at this '@' */
+         unget_char (reader, c);
+   }
+
+   entry->metatype = type_metatype (reader->text + type_start,
+                                    type_end - type_start);
+   open = reader->length;
+   keep_char (reader, c);
+
+   /*
+    * Braces balance everywhere in an entry, so the closing brace is the
+    * one that brings us back to depth 0.  A ')' closes the entry only
+    * outside of any braces or quoted string.  Between the tokens of the
+    * entry (but not in a comment entry, which is one big string) a '%'
+    * starts a comment that runs to end-of-line, and the lexer skips it
+    * -- so must we, or a brace in it would throw out our count.
+    */
+   comments = (entry->metatype != BTE_COMMENT);
+   quoted = FALSE;
+   if (c == '{')
+   {
+      depth = 1;
+      while (depth > 0 && (c = next_char (reader)) != EOF)
+      {
+         keep_char (reader, c);
+         if (c == '%' && comments && depth == 1 && !quoted)
+            skip_comment (reader);
+         else if (c == '{')
+            depth++;
+         else if (c == '}')
+            depth--;
+         else if (c == '"' && depth == 1)
+            quoted = !quoted;
+      }
+   }
+   else
+   {
+      depth = 0;
+      while ((c = next_char (reader)) != EOF)
+      {
+         keep_char (reader, c);
+         if (c == '%' && comments && depth == 0 && !quoted)
+            skip_comment (reader);
+         else if (c == '{')
+            depth++;
+         else if (c == '}' && depth > 0)
+            depth--;
+         else if (c == '"' && depth == 0)
+            quoted = !quoted;
+         else if (c == ')' && depth == 0 && !quoted)
+            break;
+      }
+   }
+
+   reader->text[reader->length] = (char) 0;
+   entry->text = reader->text;
+   entry->length = reader->length;
+
+   /* the key: up to the first comma, whitespace or closing delimiter */
+   entry->key = NULL;
+   entry->key_length = 0;
+   if (entry->metatype == BTE_REGULAR)
+   {
+      for (key = entry->text + open + 1; isspace ((unsigned char) *key); key++)
+         ;
+      while (key[entry->key_length] &&
+             !strchr (",})", key[entry->key_length]) &&
+             !isspace ((unsigned char) key[entry->key_length]))
+         entry->key_length++;
+      if (entry->key_length > 0)
+         entry->key = key;
+   }
+   return TRUE;
+
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_close_reader()
+@INPUT      : reader
+@DESCRIPTION: Frees a reader (but doesn't close its file).
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_close_reader (bt_reader * reader)
+{
+   if (reader == NULL)
+      return;
+   free (reader->text);
+   free (reader);
+}
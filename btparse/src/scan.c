@@ -23,6 +23,7 @@
 #include "my_dmalloc.h"
 
 extern char * InputFilename;            /* for zzcr_ast call in pccts/ast.c */
+extern boolean CheckOnly;               /* no value nodes wanted */
 #include "../pccts/antlr.h"
 #include "../pccts/ast.h"
 #include "tokens.h"
@@ -0,0 +1,1051 @@
+/* ------------------------------------------------------------------------
+@NAME       : scan_direct.c
+@DESCRIPTION: Hand-written, direct-coded replacement for the DLG-generated
+              lexical scanner in scan.c.  It implements the subset of the
+              DLG runtime interface (zzgettok(), zzmode(), zzskip(),
+              zzmore(), zzreplchar(), zzrdstream(), zzrdstr() and the
+              usual zz* globals) that the parser and lex_auxiliary.c rely
+              on, and recognizes exactly the same tokens in the same three
+              lexical modes, calling the same lexical actions.  The library
+              is built with either this file or scan.c (see the `lexer'
+              build option in inc/MyBuilder.pm).
+
+              Where DLG fetches and classifies one character at a time
+              through a table-driven automaton, and copies every character
+              into the token buffer with an overflow check, this scanner
+              works directly on an in-memory buffer: the string being
+              parsed, or a line-sized chunk of the input stream.  Runs of
+              characters of the same class (names, whitespace, and above
+              all the bodies of strings) are found with a tight table loop
+              and copied into the token buffer with one memcpy().
+
+              The token stream -- token numbers, text, line numbers and
+              offsets -- is the same as DLG's, including a few of its
+              quirks, which are noted where they are reproduced.  The only
+              intended difference is that the text of the end-of-input
+              token is empty, where DLG stores the EOF marker itself.
+
+              This scanner also implements entry filtering and field
+              projection (see bt_set_entry_filter() and bt_set_projection()
+              in input.c): it follows the header and field names of
+              regular entries, and skips over unwanted entries, and whole
+              unwanted fields, without making tokens of them.
+@GLOBALS    : the DLG scanner globals and zzerr (see pccts/dlgdef.h)
+@CALLS      : lexical actions in lex_auxiliary.c
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse library.  This library is
+              free software; you can redistribute it and/or modify it under
+              the terms of the GNU Library General Public License as
+              published by the Free Software Foundation; either version 2
+              of the License, or (at your option) any later version.
+-------------------------------------------------------------------------- */
+
+#include "bt_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include "lex_auxiliary.h"
+#include "stdpccts.h"
+#include "error.h"
+#include "prototypes.h"
+#include "my_dmalloc.h"
+
+
+/* ----------------------------------------------------------------------
+ * The DLG scanner globals (normally defined by pccts/dlgauto.h)
+ */
+
+LOOKAHEAD                               /* the current token: zztoken */
+
+zzchar_t * zzlextext;                   /* text of most recently matched token */
+zzchar_t * zzbegexpr;                   /* beginning of last reg expr recogn. */
+zzchar_t * zzendexpr;                   /* end of last reg expr recogn. */
+int        zzbufsize;                   /* number of characters in zzlextext */
+int        zzbegcol = 0;                /* offset of first character of token */
+int        zzendcol = 0;                /* offset of last character of token */
+int        zzline = 1;                  /* line current token is on */
+int        zzreal_line = 1;             /* line of 1st non-skipped portion */
+int        zzchar;                      /* (unused; kept for DLG compat.) */
+int        zzbufovf;                    /* never set: the buffer grows */
+int        zzcharfull = 0;              /* (unused; kept for DLG compat.) */
+
+void       (*zzerr)(const char *) = zzerrstd; /* error reporting function */
+
+static zzchar_t * zznextpos;            /* next free position in zzlextext */
+static zzchar_t * lastpos;              /* last usable position in zzlextext */
+static int        zzauto = START;       /* current lexical mode */
+static int        zzadd_erase;          /* 1 = skip, 2 = more, set by actions */
+
+extern char *     InputFilename;        /* from input.c */
+
+
+/*
+ * Token numbers for the lexemes that the grammar doesn't name (they are
+ * normally skipped, or continued with zzmore()).  These match the numbers
+ * assigned by DLG -- see zztokens[] in err.c -- since they can escape to
+ * the parser in a few error situations.
+ */
+#define T_NEWLINE       3
+#define T_WHITESPACE    5
+#define T_JUNK          6
+#define T_E_NEWLINE     7
+#define T_E_WHITESPACE  8
+#define T_QUOTE         18
+#define T_S_NEWLINE     19
+#define T_S_WHITESPACE  20
+#define T_S_LBRACE      21
+#define T_S_RBRACE      22
+#define T_S_LPAREN      23
+#define T_S_RPAREN      24
+#define T_S_TEXT        26
+
+
+/* ----------------------------------------------------------------------
+ * Character classes.  A character can belong to several of these, so
+ * each run-scanning loop just tests one bit.
+ */
+
+#define CC_WS        0x01               /* space, tab, CR */
+#define CC_JUNK      0x02               /* junk between entries */
+#define CC_DIGIT     0x04               /* 0-9 */
+#define CC_NAME      0x08               /* allowed in a NAME (incl. digits) */
+#define CC_STRTEXT   0x10               /* ordinary string text */
+#define CC_RUNAWAY   0x20               /* string text after a newline */
+#define CC_INVALID   0x40               /* not allowed inside an entry */
+
+static unsigned char CharClass[256];
+static boolean       CharClassReady = FALSE;
+
+static void
+init_char_classes (void)
+{
+   int    c;
+   const unsigned char * p;
+
+   /* every name character except digits and 8-bit characters */
+   static const unsigned char name_chars[] =
+      "!$&*+-./:;<>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[]^_`abcdefghijklmnopqrstuvwxyz|~";
+
+   for (c = 0; c < 256; c++)
+   {
+      unsigned char cl = 0;
+
+      if (c == ' ' || c == '\t' || c == '\r')
+         cl |= CC_WS;
+      else if (c != '@' && c != '\n')
+         cl |= CC_JUNK;
+
+      if (c >= '0' && c <= '9')
+         cl |= CC_DIGIT | CC_NAME;
+      if (c >= 128)
+         cl |= CC_NAME;
+
+      if (c == 0 || !strchr ("\n{}()\"", c))
+         cl |= CC_STRTEXT;
+      if ((cl & CC_STRTEXT) && c != '\\')
+         cl |= CC_RUNAWAY;
+
+      if ((c < 32 && c != '\t' && c != '\n' && c != '\r') ||
+          c == '\'' || c == '\\' || c == 127)
+         cl |= CC_INVALID;
+
+      CharClass[c] = cl;
+   }
+   for (p = name_chars; *p; p++)
+      CharClass[*p] |= CC_NAME;
+
+   CharClassReady = TRUE;
+}
+
+
+/* ----------------------------------------------------------------------
+ * Input buffering.
+ *
+ * When scanning a string (zzrdstr()), the buffer is simply the string
+ * itself.  When scanning a stream (zzrdstream()), we read it a line at a
+ * time with fgets() -- not with big fread()'s -- so that the stream is
+ * never far ahead of the scanner: callers such as Text::BibTeX::File test
+ * feof() between entries, and pipes should deliver entries as soon as
+ * they are complete.  fgets() sets the end-of-file flag as soon as it
+ * reads a final line without a newline; we clear it again so that feof()
+ * only becomes true when the scanner's lookahead really hits the end, as
+ * it did with DLG's getc().
+ *
+ * fgets() can't tell us where a line that contains NUL bytes ends.  The
+ * buffer is kept filled with newlines beyond the current line, so the
+ * terminating NUL is always the last one in the buffer; we only need to
+ * search for it if the line doesn't end in '\n'.
+ */
+
+#define IN_BUFSIZE 8192
+
+static FILE *                in_stream = NULL;
+static unsigned char *       in_buf = NULL;
+static const unsigned char * in_cur = NULL;     /* next unread character */
+static const unsigned char * in_end = NULL;     /* end of buffered input */
+static int                   in_len = 0;        /* length of line in in_buf */
+static boolean               in_dirty = FALSE;  /* line had embedded NULs */
+
+
+static boolean
+fill_input (void)
+{
+   int   len;
+
+   if (in_stream == NULL)               /* reading a string: no more */
+      return FALSE;
+
+   if (in_buf == NULL)
+   {
+      in_buf = (unsigned char *) malloc (IN_BUFSIZE);
+      memset (in_buf, '\n', IN_BUFSIZE);
+   }
+   else if (in_dirty)
+   {
+      memset (in_buf, '\n', in_len + 1);
+      in_dirty = FALSE;
+   }
+   else
+   {
+      in_buf[in_len] = '\n';            /* erase previous terminator */
+   }
+   in_len = 0;
+
+   if (fgets ((char *) in_buf, IN_BUFSIZE, in_stream) == NULL)
+   {
+      in_cur = in_end = in_buf;
+      return FALSE;
+   }
+
+   len = strlen ((char *) in_buf);
+   if (len == 0 || in_buf[len-1] != '\n')
+   {
+      int   nul = IN_BUFSIZE - 1;
+
+      while (in_buf[nul] != 0) nul--;
+      if (nul != len)
+         in_dirty = TRUE;
+      len = nul;
+      if (feof (in_stream))             /* see above */
+         clearerr (in_stream);
+   }
+
+   in_len = len;
+   in_cur = in_buf;
+   in_end = in_buf + len;
+   return TRUE;
+}
+
+
+/* Next input character (without consuming it), or EOF */
+#define PEEK() (in_cur < in_end ? *in_cur : peek_slow ())
+
+static int
+peek_slow (void)
+{
+   return fill_input () ? *in_cur : EOF;
+}
+
+
+/* ----------------------------------------------------------------------
+ * Token buffer handling
+ */
+
+static void
+copy_text (const unsigned char * text, int len)
+{
+   if (zznextpos + len > lastpos)
+      lexer_grow (len, &lastpos, &zznextpos);
+   memcpy (zznextpos, text, len);
+   zznextpos += len;
+   *zznextpos = '\0';                  /* the actions look at the text */
+   zzendexpr = zznextpos - 1;
+}
+
+
+/* Consume the next input character, copying it to the token buffer. */
+static void
+take_char (void)
+{
+   copy_text (in_cur, 1);
+   in_cur++;
+   zzendcol++;
+}
+
+
+/*
+ * Consume characters for as long as they are in class `cl', copying them
+ * to the token buffer.  Returns the number of characters taken.
+ */
+static int
+take_run (unsigned char cl)
+{
+   const unsigned char * p;
+   int   total = 0;
+
+   for (;;)
+   {
+      p = in_cur;
+      while (p < in_end && (CharClass[*p] & cl))
+         p++;
+      if (p > in_cur)
+      {
+         copy_text (in_cur, p - in_cur);
+         total += p - in_cur;
+         zzendcol += p - in_cur;
+         in_cur = p;
+      }
+      if (p < in_end || !fill_input ())
+         return total;
+   }
+}
+
+
+/*
+ * Consume the end-of-input pseudo-character.  DLG counts it like any other
+ * character (it ends up in the offsets of the EOF token), so we do too.
+ */
+static void
+take_eof (void)
+{
+   zzendcol++;
+}
+
+
+/* ----------------------------------------------------------------------
+ * Error action for input that matches no token -- same as DLG's
+ * zzerraction(), which also swallows the character after the bad lexeme.
+ */
+
+static void
+invalid_token (void)
+{
+   (*zzerr) ("invalid token");
+   if (PEEK () == EOF)
+      take_eof ();
+   else
+   {
+      in_cur++;
+      zzendcol++;
+   }
+   zzskip ();
+}
+
+
+/* ----------------------------------------------------------------------
+ * Entry filtering and field projection.  track_entry() sees every token
+ * scanned in LEX_ENTRY mode (and is told about '@' signs), and follows
+ * the header of each entry: once the key of a regular entry has been
+ * seen, the entry filter (see bt_set_entry_filter() in input.c) is asked
+ * whether the entry is wanted.  If not, and the key is followed by a
+ * comma as usual, the rest of the entry is skipped by skip_entry_body(),
+ * and the parser just sees "@type{key,}".
+ *
+ * track_entry() also looks at the name of each field (a NAME right after
+ * a comma), to see whether the field is wanted (see bt_set_projection()).
+ * If not, the name is dropped, and so is the '=' after it, and then
+ * skip_field_value() skips the value and the comma after it: the parser
+ * never sees the field at all, so it makes no tokens or AST nodes of it.
+ * Syntax errors in a dropped field (no '=', a missing value, unbalanced
+ * braces...) are reported here instead, so that an entry parses OK
+ * with a projection exactly when it does without one.
+ */
+
+GEN_PRIVATE_ERRFUNC (field_error, (char * fmt, ...),
+                     BTERR_SYNTAX, InputFilename, zzline, NULL, -1, fmt)
+
+#define MAX_FIELD_NAME 64
+
+typedef enum
+{
+   h_none,                              /* not in an entry header */
+   h_type,                              /* after '@' */
+   h_open,                              /* after '@type' */
+   h_key,                               /* after '@type{' */
+   h_reject,                            /* after the key of an unwanted entry */
+   h_skip                               /* after its comma: skip the rest */
+} header_state;
+
+static header_state Header = h_none;
+static char    EntryType[MAX_FIELD_NAME];  /* type of current entry */
+static int     EntryCloser;             /* '}' or ')' */
+static boolean AfterComma = FALSE;      /* next NAME is a field name? */
+static boolean SkipField = FALSE;       /* dropped an unwanted field name? */
+
+static void skip_field_value (void);
+
+static void
+track_entry (void)
+{
+   switch (NLA)
+   {
+      case T_E_WHITESPACE:
+      case T_E_NEWLINE:
+      case COMMENT:
+         return;
+   }
+
+   if (SkipField && NLA != EQUALS)      /* dropped a name, but no '=' */
+   {
+      if (NLA == zzEOF_TOKEN)
+         field_error ("at end of input, expected \"=\"");
+      else
+         field_error ("found \"%s\", expected \"=\"", zzbegexpr);
+      SkipField = FALSE;
+   }
+
+   switch (NLA)
+   {
+      case AT:
+         Header = h_type;
+         SkipField = FALSE;
+         return;
+      case ENTRY_OPEN:
+         if (Header == h_open && entry_metatype () == BTE_REGULAR)
+         {
+            Header = h_key;
+            EntryCloser = (zzbegexpr[0] == '(') ? ')' : '}';
+         }
+         else
+            Header = h_none;
+         break;
+      case NUMBER:
+      case NAME:
+         if (Header == h_type)
+         {
+            Header = h_none;
+            if (zznextpos - zzbegexpr < MAX_FIELD_NAME)
+            {
+               strcpy (EntryType, (char *) zzbegexpr);
+               strlwr (EntryType);
+               Header = h_open;
+            }
+         }
+         else if (Header == h_key)
+         {
+            Header = entry_wanted (EntryType, (char *) zzbegexpr)
+               ? h_none : h_reject;
+         }
+         else
+            Header = h_none;
+         break;
+      case COMMA:
+         Header = (Header == h_reject) ? h_skip : h_none;
+         AfterComma = TRUE;
+         SkipField = FALSE;
+         return;
+      case EQUALS:
+         Header = h_none;
+         if (SkipField)                 /* drop it, and the value */
+         {
+            SkipField = FALSE;
+            zzskip ();
+            skip_field_value ();
+         }
+         return;
+      default:
+         Header = h_none;
+         break;
+   }
+
+   /* a NAME right after a comma is a field name: drop it if unwanted */
+   SkipField = (NLA == NAME && AfterComma &&
+                entry_metatype () == BTE_REGULAR &&
+                !field_wanted ((char *) zzbegexpr));
+   if (SkipField)
+      zzskip ();
+   AfterComma = FALSE;
+}
+
+
+/*
+ * Skip the rest of an unwanted entry, up to (but not including) its
+ * closing '}' or ')', which is then scanned as usual.  Braces have to
+ * balance, and a ')' or '}' inside a quoted string or a %-comment (from
+ * '%' to the end of the line, outside braces and strings) doesn't count
+ * -- just as when the entry is scanned token by token.  Newlines are
+ * counted, but nothing else is looked at; errors in the entry go
+ * unreported.
+ */
+static void
+skip_entry_body (void)
+{
+   int   depth = 0;
+   boolean quoted = FALSE;
+   int   c;
+
+   while ((c = PEEK ()) != EOF)
+   {
+      if (c == '\n')
+         zzline++;
+      else if (c == '{')
+         depth++;
+      else if (c == '}' && depth > 0)
+         depth--;
+      else if (depth == 0)
+      {
+         if (c == '"')
+            quoted = !quoted;
+         else if (c == '%' && !quoted)
+         {
+            while ((c = PEEK ()) != '\n' && c != EOF)
+            {
+               in_cur++;
+               zzendcol++;
+            }
+            continue;
+         }
+         else if (c == EntryCloser && !quoted)
+            break;
+      }
+      in_cur++;
+      zzendcol++;
+   }
+   Header = h_none;
+}
+
+
+/* Skip the next input character (not EOF), counting newlines. */
+static void
+skip_char (void)
+{
+   if (*in_cur == '\n')
+      zzline++;
+   in_cur++;
+   zzendcol++;
+}
+
+
+/* Report a syntax error at `c' (the next character, or EOF) in a value. */
+static void
+value_error (int c, char * expected)
+{
+   if (c == EOF)
+      field_error ("at end of input, expected %s", expected);
+   else
+      field_error ("found \"%c\", expected %s", c, expected);
+}
+
+
+/*
+ * Skip a string in braces or quotes, from its opening '{' or '"'.  Braces
+ * inside it must balance, and a '"' only ends it outside them.  Returns
+ * FALSE, having reported the error, if the input ends first.
+ */
+static boolean
+skip_string (void)
+{
+   int   closer = (*in_cur == '{') ? '}' : '"';
+   int   depth = 0;
+   int   c;
+
+   skip_char ();
+   while ((c = PEEK ()) != EOF)
+   {
+      skip_char ();
+      if (c == '{')
+         depth++;
+      else if (c == '}' && depth > 0)
+         depth--;
+      else if (c == closer && depth == 0)
+         return TRUE;
+   }
+   value_error (c, "end of string");
+   return FALSE;
+}
+
+
+/*
+ * Skip the value of an unwanted field, after its '=': up to the next
+ * comma, which is skipped too (so a field name may come next), or up to
+ * (but not including) the closing '}' or ')' of the entry.  The value is
+ * checked on the way, as the parser would -- simple values (strings,
+ * numbers and macro names) joined by '#' -- and a syntax error in it is
+ * reported; the rest of it is then skipped as by skip_entry_body(), up
+ * to a comma or the end of the entry.
+ */
+static void
+skip_field_value (void)
+{
+   boolean need_value = TRUE;           /* after '=' or '#' */
+   int   depth = 0;
+   boolean quoted = FALSE;
+   int   c;
+
+   for (;;)
+   {
+      c = PEEK ();
+      if (c == '%')                     /* a comment, as in lex_entry() */
+      {
+         while ((c = PEEK ()) != '\n' && c != EOF)
+            skip_char ();
+         continue;
+      }
+      if (c != EOF && (c == '\n' || (CharClass[c] & CC_WS)))
+      {
+         skip_char ();
+         continue;
+      }
+
+      if (need_value)
+      {
+         if (c == '{' || c == '"')
+         {
+            if (!skip_string ())
+               return;
+         }
+         else if (c != EOF && (CharClass[c] & CC_NAME))
+         {
+            while ((c = PEEK ()) != EOF && (CharClass[c] & CC_NAME))
+               skip_char ();
+         }
+         else
+         {
+            value_error (c, "a value");
+            break;
+         }
+         need_value = FALSE;
+      }
+      else if (c == '#')
+      {
+         skip_char ();
+         need_value = TRUE;
+      }
+      else if (c == ',')
+      {
+         skip_char ();
+         AfterComma = TRUE;
+         return;
+      }
+      else if (c == EntryCloser)
+         return;
+      else
+      {
+         value_error (c, "\",\", \"#\" or end of entry");
+         break;
+      }
+   }
+
+   /* after an error: on to the next comma, or the end of the entry */
+   while ((c = PEEK ()) != EOF)
+   {
+      if (c == '{')
+         depth++;
+      else if (c == '}' && depth > 0)
+         depth--;
+      else if (depth == 0)
+      {
+         if (c == '"')
+            quoted = !quoted;
+         else if (c == '%' && !quoted)
+         {
+            while ((c = PEEK ()) != '\n' && c != EOF)
+               skip_char ();
+            continue;
+         }
+         else if (c == EntryCloser && !quoted)
+            break;
+         else if (c == ',' && !quoted)
+         {
+            skip_char ();
+            AfterComma = TRUE;
+            break;
+         }
+      }
+      skip_char ();
+   }
+}
+
+
+/* ----------------------------------------------------------------------
+ * The three lexical modes.  Each function recognizes one lexeme at the
+ * current input position, copies it to the token buffer, sets the token
+ * number, and calls the lexical action (if any) -- just like the DLG
+ * automaton and the act*() functions in scan.c.
+ */
+
+/*
+ * START: between entries.  Looks for '@', skips whitespace, newlines and
+ * %-comments, and counts junk.
+ */
+static void
+lex_toplevel (void)
+{
+   int   c = PEEK ();
+
+   if (c == EOF)
+   {
+      take_eof ();
+      NLA = zzEOF_TOKEN;
+   }
+   else if (c == '@')
+   {
+      take_char ();
+      NLA = AT;
+      at_sign ();
+   }
+   else if (c == '\n')
+   {
+      take_char ();
+      NLA = T_NEWLINE;
+      newline ();
+   }
+   else if (c == '%')
+   {
+      /*
+       * "%~[\n]*\n" is a comment, but "%" followed by junk characters up
+       * to end-of-input is junk.  If end-of-input comes after whitespace
+       * or '@', DLG gives up without backing up, and so do we.
+       */
+      boolean junk_only = TRUE;
+
+      take_char ();
+      for (;;)
+      {
+         take_run (CC_JUNK);
+         if ((c = PEEK ()) == '\n' || c == EOF)
+            break;
+         junk_only = FALSE;             /* whitespace or '@' */
+         take_char ();
+      }
+
+      if (c == '\n')
+      {
+         take_char ();
+         NLA = COMMENT;
+         comment ();
+      }
+      else if (junk_only)
+      {
+         NLA = T_JUNK;
+         toplevel_junk ();
+      }
+      else
+         invalid_token ();
+   }
+   else if (CharClass[c] & CC_WS)
+   {
+      take_run (CC_WS);
+      NLA = T_WHITESPACE;
+      zzskip ();
+   }
+   else
+   {
+      take_run (CC_JUNK);
+      NLA = T_JUNK;
+      toplevel_junk ();
+   }
+}
+
+
+/*
+ * LEX_ENTRY: inside an entry, outside of strings.
+ */
+static void
+lex_entry (void)
+{
+   int   c = PEEK ();
+
+   if (c == EOF)
+   {
+      take_eof ();
+      NLA = zzEOF_TOKEN;
+      return;
+   }
+
+   switch (c)
+   {
+      case '\n':
+         take_char ();
+         NLA = T_E_NEWLINE;
+         newline ();
+         return;
+      case '%':                         /* comment must end with newline */
+         take_char ();
+         while ((c = PEEK ()) != '\n' && c != EOF)
+         {
+            const unsigned char * p = memchr (in_cur, '\n', in_end - in_cur);
+
+            if (p == NULL) p = in_end;
+            copy_text (in_cur, p - in_cur);
+            zzendcol += p - in_cur;
+            in_cur = p;
+         }
+         if (c == EOF)
+         {
+            invalid_token ();
+            return;
+         }
+         take_char ();
+         NLA = COMMENT;
+         comment ();
+         return;
+      case '{':
+         take_char ();
+         NLA = LBRACE;
+         lbrace ();
+         return;
+      case '}':
+         take_char ();
+         NLA = RBRACE;
+         rbrace ();
+         return;
+      case '(':
+         take_char ();
+         NLA = ENTRY_OPEN;
+         lparen ();
+         return;
+      case ')':
+         take_char ();
+         NLA = ENTRY_CLOSE;
+         rparen ();
+         return;
+      case '=':
+         take_char ();
+         NLA = EQUALS;
+         return;
+      case '#':
+         take_char ();
+         NLA = HASH;
+         return;
+      case ',':
+         take_char ();
+         NLA = COMMA;
+         return;
+      case '"':
+         take_char ();
+         NLA = T_QUOTE;
+         start_string ('"');
+         return;
+   }
+
+   if (CharClass[c] & CC_WS)
+   {
+      take_run (CC_WS);
+      NLA = T_E_WHITESPACE;
+      zzskip ();
+   }
+   else if (CharClass[c] & CC_NAME)
+   {
+      /* a digit string is a NUMBER, unless more name chars follow it */
+      take_run (CC_DIGIT);
+      if ((c = PEEK ()) != EOF && (CharClass[c] & CC_NAME))
+      {
+         take_run (CC_NAME);
+         NLA = NAME;
+         name ();
+      }
+      else
+         NLA = NUMBER;
+   }
+   else                                 /* CC_INVALID */
+   {
+      take_char ();
+      invalid_token ();
+   }
+}
+
+
+/*
+ * LEX_STRING: inside a quoted or braced string.  Everything is appended to
+ * the current token (via zzmore() in the actions) until end_string().
+ */
+static void
+lex_string (void)
+{
+   int   c = PEEK ();
+
+   switch (c)
+   {
+      case EOF:
+         take_eof ();
+         NLA = zzEOF_TOKEN;
+         return;
+      case '\n':
+         /* newline, plus anything that can be on the same line */
+         take_char ();
+         take_run (CC_RUNAWAY);
+         NLA = T_S_NEWLINE;
+         check_runaway_string ();
+         return;
+      case '{':
+         take_char ();
+         NLA = T_S_LBRACE;
+         open_brace ();
+         return;
+      case '}':
+         take_char ();
+         NLA = T_S_RBRACE;
+         close_brace ();
+         return;
+      case '(':
+         take_char ();
+         NLA = T_S_LPAREN;
+         lparen_in_string ();
+         return;
+      case ')':
+         take_char ();
+         NLA = T_S_RPAREN;
+         rparen_in_string ();
+         return;
+      case '"':
+         take_char ();
+         NLA = STRING;
+         quote_in_string ();
+         return;
+   }
+
+   /*
+    * A lone tab or CR becomes a space; but as DLG matches the longest
+    * lexeme, one that is followed by more ordinary text is just part of
+    * that text, and is left alone.
+    */
+   if (c == '\t' || c == '\r')
+   {
+      take_char ();
+      if ((c = PEEK ()) == EOF || !(CharClass[c] & CC_STRTEXT))
+      {
+         NLA = T_S_WHITESPACE;
+         zzreplchar (' ');
+         zzmore ();
+         return;
+      }
+   }
+
+   take_run (CC_STRTEXT);
+   NLA = T_S_TEXT;
+   zzmore ();
+}
+
+
+/* ----------------------------------------------------------------------
+ * The DLG runtime interface
+ */
+
+void
+zzrdstream (FILE * f)
+{
+   if (f)
+   {
+      zzline = 1;
+      in_stream = f;
+      if (in_buf != NULL && in_dirty)
+         memset (in_buf, '\n', in_len + 1);
+      else if (in_buf != NULL)
+         in_buf[in_len] = '\n';
+      in_len = 0;
+      in_dirty = FALSE;
+      in_cur = in_end = in_buf;
+   }
+}
+
+
+void
+zzrdstr (zzchar_t * s)
+{
+   if (s)
+   {
+      zzline = 1;
+      in_stream = NULL;
+      in_cur = s;
+      in_end = s + strlen ((char *) s);
+   }
+}
+
+
+void
+zzerrstd (const char * s)
+{
+   fprintf (stderr, "%s near line %d (text was '%s')\n",
+            ((s == NULL) ? "Lexical error" : s), zzline, zzlextext);
+}
+
+
+void
+zzmode (int m)
+{
+   char  buf[70];
+
+   if (m >= 0 && m <= LEX_STRING)
+   {
+      zzauto = m;
+   }
+   else
+   {
+      snprintf (buf, sizeof (buf), "Invalid automaton mode = %d ", m);
+      (*zzerr) (buf);
+   }
+}
+
+
+void
+zzskip (void)
+{
+   zzadd_erase = 1;
+}
+
+
+void
+zzmore (void)
+{
+   zzadd_erase = 2;
+}
+
+
+/* substitute c for the lexeme last matched (and already in the buffer) */
+void
+zzreplchar (zzchar_t c)
+{
+   *zzbegexpr = c;
+   *(zzbegexpr+1) = '\0';
+   zzendexpr = zzbegexpr;
+   zznextpos = zzbegexpr + 1;
+}
+
+
+void
+zzgettok (void)
+{
+   if (!CharClassReady)
+      init_char_classes ();
+
+skip:
+   zzreal_line = zzline;
+   zzbufovf = 0;
+   lastpos = &zzlextext[zzbufsize-1];
+   zznextpos = zzlextext;
+   zzbegcol = zzendcol + 1;
+more:
+   zzbegexpr = zznextpos;
+   zzadd_erase = 0;
+
+   switch (zzauto)
+   {
+      case START:
+         lex_toplevel ();
+         if (NLA == AT)
+            track_entry ();
+         break;
+      case LEX_ENTRY:
+         if (Header == h_skip)
+            skip_entry_body ();
+         lex_entry ();
+         track_entry ();
+         break;
+      case LEX_STRING: lex_string (); break;
+   }
+
+   *zznextpos = '\0';
+   zzendexpr = zznextpos - 1;
+
+   switch (zzadd_erase)
+   {
+      case 1: goto skip;
+      case 2: goto more;
+   }
+
+   /* Read the lookahead, so that feof() is set just as it was by DLG */
+   if (in_cur == in_end)
+      (void) PEEK ();
+}
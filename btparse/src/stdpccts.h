@@ -22,6 +22,7 @@
 #include "my_dmalloc.h"
 
 extern char * InputFilename;            /* for zzcr_ast call in pccts/ast.c */
+extern boolean CheckOnly;               /* no value nodes wanted */
 #define GENAST
 #define zzSET_SIZE 4
 #include "../pccts/antlr.h"
@@ -5,14 +5,19 @@
                 bt_change_case()
 
               and their helpers:
+                tex_char_hash()
+                tex_char_lookup()
                 foreign_letter()
                 purify_special_char()
+                convert_special_char()
 @GLOBALS    : 
 @CALLS      : 
 @CALLERS    : 
 @CREATED    : 1997/10/19, Greg Ward
 @MODIFIED   : 1997/11/25, GPW: renamed to from purify.c to string_util.c
                                added bt_change_case() and friends
+              2026/10/19: control sequences from the generated
+                          tex_chars.h
 @VERSION    : $Id$
 -------------------------------------------------------------------------- */
 
@@ -22,72 +27,75 @@
 #include <assert.h>
 #include "error.h"
 #include "btparse.h"
+#include "prototypes.h"
 #include "bt_debug.h"
 
 
-/* 
- * These definitions should be fixed to be consistent with HTML 
- * entities, just for fun.  And perhaps I should add entries for
- * accented letters (at least those supported by TeX and HTML).
+/*
+ * The control sequences we know about -- foreign letters, accents and
+ * so on -- are in tex_chars.h, a perfect hash table generated from
+ * tex_chars.dat by gen_tex_chars.pl.  Add to tex_chars.dat, not to the
+ * code.
  */
-typedef enum
-{
-   L_OTHER,                             /* not a "foreign" letter */
-   L_OSLASH_L,                          /* Eastern European {\o} */
-   L_OSLASH_U,
-   L_LSLASH_L,                          /* {\l} */
-   L_LSLASH_U,
-   L_OELIG_L,                           /* Latin {\oe} ligature */
-   L_OELIG_U,
-   L_AELIG_L,                           /* {\ae} ligature */
-   L_AELIG_U,
-   L_SSHARP_L,                          /* German "sharp s" {\ss} */
-   L_SSHARP_U,
-   L_ACIRCLE_L,                         /* Nordic {\aa} */
-   L_ACIRCLE_U,
-   L_INODOT_L,                          /* undotted i: {\i} */
-   L_JNODOT_L                           /* {\j} */
-} bt_letter;
-
-
-static char * uc_version[] = 
+#include "tex_chars.h"
+
+
+/* ------------------------------------------------------------------------
+@NAME       : tex_char_hash()
+@INPUT      : name - start of a control sequence (after the backslash)
+              len  - its length
+              seed
+@RETURNS    : a hash of the control sequence
+@DESCRIPTION: The hash function of the tex_chars[] table.  It must hash
+              exactly as hash() in gen_tex_chars.pl does, since that
+              chose the seeds that give every control sequence a slot
+              of its own.
+@CALLERS    : tex_char_lookup()
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+static unsigned long
+tex_char_hash (char * name, int len, unsigned long seed)
 {
-   NULL,                                /* L_OTHER */
-   "\\O",                               /* L_OSLASH_L */
-   "\\O",                               /* L_OSLASH_U */
-   "\\L",                               /* L_LSLASH_L */
-   "\\L",                               /* L_LSLASH_U */
-   "\\OE",                              /* L_OELIG_L */
-   "\\OE",                              /* L_OELIG_U */
-   "\\AE",                              /* L_AELIG_L */
-   "\\AE",                              /* L_AELIG_U */
-   "SS",                                /* L_SSHARP_L -- for LaTeX 2.09 */
-   "\\SS",                              /* L_SSHARP_U */
-   "\\AA",                              /* L_ACIRCLE_L */
-   "\\AA",                              /* L_ACIRCLE_U */
-   "I",                                 /* L_INODOT_L */
-   "J"                                  /* L_JNODOT_L */
-};
-
-static char * lc_version[] = 
+   unsigned long  h;
+
+   h = seed;
+   while (len-- > 0)
+      h = ((h * 33) ^ (unsigned char) *name++) & 0xFFFFFFFFUL;
+   return h ^ (h >> 15);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : tex_char_lookup()
+@INPUT      : name - start of a control sequence (after the backslash)
+              len  - its length
+@RETURNS    : its entry in tex_chars[], or NULL if it isn't one we know
+@DESCRIPTION: Hashes the control sequence once to find its bucket, and
+              again with the bucket's seed to find its slot; the slot
+              holds it, if anything does.
+@CALLS      : tex_char_hash()
+@CALLERS    : foreign_letter(), bt_tex_to_unicode() (tex_unicode.c)
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+tex_char *
+tex_char_lookup (char * name, int len)
 {
-   NULL,                                /* L_OTHER */
-   "\\o",                               /* L_OSLASH_L */
-   "\\o",                               /* L_OSLASH_U */
-   "\\l",                               /* L_LSLASH_L */
-   "\\l",                               /* L_LSLASH_U */
-   "\\oe",                              /* L_OELIG_L */
-   "\\oe",                              /* L_OELIG_U */
-   "\\ae",                              /* L_AELIG_L */
-   "\\ae",                              /* L_AELIG_U */
-   "\\ss",                              /* L_SSHARP_L */
-   "\\ss",                              /* L_SSHARP_U */
-   "\\aa",                              /* L_ACIRCLE_L */
-   "\\aa",                              /* L_ACIRCLE_U */
-   "\\i",                               /* L_INODOT_L */
-   "\\j"                                /* L_JNODOT_L */
-};      
+   unsigned long  bucket;
+   tex_char *     tc;
+
+   if (len < 1 || len > TEX_CHARS_MAXLEN)
+      return NULL;
 
+   bucket = tex_char_hash (name, len, TEX_CHARS_BUCKETS) % TEX_CHARS_BUCKETS;
+   tc = &tex_chars[tex_char_hash (name, len, tex_chars_seeds[bucket])
+                   % TEX_CHARS_SIZE];
+   if (tc->kind == TEX_NONE ||
+       strncmp (tc->name, name, len) != 0 || tc->name[len] != 0)
+      return NULL;
+   return tc;
+}
 
 
 /* ------------------------------------------------------------------------
@@ -95,109 +103,27 @@ static char * lc_version[] =
 @INPUT      : str
               start
               stop
-@OUTPUT     : letter
-@RETURNS    : TRUE if the string delimited by start and stop is a foreign
-              letter control sequence
+@OUTPUT     : 
+@RETURNS    : the entry in tex_chars[] for the foreign letter delimited by
+              start and stop, or NULL if it isn't a foreign letter
+              control sequence
 @DESCRIPTION: Determines if a character sequence is one of (La)TeX's
-              "foreign letter" control sequences (l, o, ae, oe, aa, ss, plus
-              uppercase versions).  If `letter' is non-NULL, returns which
-              letter was found in it (as a bt_letter value).
-@CALLS      : 
-@CALLERS    : purify_special_char()
+              "foreign letter" control sequences (l, o, ae, oe, aa, ss,
+              and so on, plus uppercase versions -- whatever
+              tex_chars.dat lists), by looking it up in tex_chars[].
+@CALLS      : tex_char_lookup()
+@CALLERS    : purify_special_char(), convert_special_char()
 @CREATED    : 1997/10/19, GPW
-@MODIFIED   : 
+@MODIFIED   : 2026/10/19: looks in the generated table instead of a
+                          hand-written switch
 -------------------------------------------------------------------------- */
-static boolean
-foreign_letter (char *str, int start, int stop, bt_letter * letter)
+static tex_char *
+foreign_letter (char *str, int start, int stop)
 {
-   char      c1, c2;
-   bt_letter dummy;
-
+   tex_char * tc;
 
-   /* 
-    * This is written for speed, not flexibility -- adding new foreign
-    * letters would be trying and vexatious.
-    * 
-    * N.B. my gold standard list of foreign letters is Kopka and Daly's
-    * *A Guide to LaTeX 2e*, section 2.5.6.
-    */
-
-   if (letter == NULL)                  /* so we can assign to *letter */
-      letter = &dummy;                  /* without compunctions */
-   *letter = L_OTHER;                   /* assume not a "foreign" letter */
-
-   c1 = str[start+0];                   /* only two characters that we're */
-   c2 = str[start+1];                   /* interested in */
-
-   switch (stop - start)
-   {
-      case 1:                           /* one-character control sequences */
-         switch (c1)                    /* (\o and \l) */
-         {
-            case 'o':
-               *letter = L_OSLASH_L; return TRUE;
-            case 'O':
-               *letter = L_OSLASH_U; return TRUE;
-            case 'l':
-               *letter = L_LSLASH_L; return TRUE;
-            case 'L': 
-               *letter = L_LSLASH_L; return TRUE;
-            case 'i':
-               *letter = L_INODOT_L; return TRUE;
-            case 'j':
-               *letter = L_JNODOT_L; return TRUE;
-            default:
-               return FALSE;
-         }
-         break;
-      case 2:                           /* two character control sequences */
-         switch (c1)                    /* (\oe, \ae, \aa, and \ss) */
-         {
-            case 'o':
-               if (c2 == 'e') { *letter = L_OELIG_L; return TRUE; }
-            case 'O':
-               if (c2 == 'E') { *letter = L_OELIG_U; return TRUE; }
-
-            /* BibTeX 0.99 does not handle \aa and \AA -- but I do!*/
-            case 'a':
-               if (c2 == 'e')
-                  { *letter = L_AELIG_L; return TRUE; }
-               else if (c2 == 'a')
-                  { *letter = L_ACIRCLE_L; return TRUE; }
-               else
-                  return FALSE;
-            case 'A':
-               if (c2 == 'E')
-                  { *letter = L_AELIG_U; return TRUE; }
-               else if (c2 == 'A')
-                  { *letter = L_ACIRCLE_U; return TRUE; }
-               else
-                  return FALSE;
-
-            /* uppercase sharp-s -- new with LaTeX 2e (so far all I do
-             * is recognize it as a "foreign" letter)
-             */
-            case 's':
-               if (c2 == 's')
-                  { *letter = L_SSHARP_L; return TRUE; }
-               else 
-                  return FALSE;
-            case 'S':
-               if (c2 == 'S')
-                  { *letter = L_SSHARP_U; return TRUE; }
-               else 
-                  return FALSE;
-
-            default:
-               return FALSE;
-         }
-         break;
-      default:
-         return FALSE;
-   } /* switch on length of control sequence */
-
-   internal_error ("foreign_letter(): should never reach end of function");
-   return FALSE;                        /* to keep gcc -Wall happy */
+   tc = tex_char_lookup (str + start, stop - start);
+   return (tc != NULL && tc->kind == TEX_LETTER) ? tc : NULL;
 
 } /* foreign_letter */
 
@@ -218,21 +144,24 @@ foreign_letter (char *str, int start, int stop, bt_letter * letter)
               (purified) string.  purify_special_char() will skip over the
               opening brace and backslash; if the control sequence is one
               of LaTeX's foreign letter sequences (as determined by
-              foreign_letter()), then it is simply copied to *dst.
-              Otherwise the control sequence is skipped.  In either case,
+              foreign_letter()), then its purified form (from
+              tex_chars.dat) is copied to *dst.  Otherwise the control
+              sequence is skipped.  In either case,
               text after the control sequence is either copied (alphabetic
               characters) or skipped (anything else, including hyphens,
               ties, and digits).
 @CALLS      : foreign_letter()
 @CALLERS    : bt_purify_string()
 @CREATED    : 1997/10/19, GPW
-@MODIFIED   : 
+@MODIFIED   : 2026/10/19: purified forms come from tex_chars[]
 -------------------------------------------------------------------------- */
 static void
 purify_special_char (char *str, int * src, int * dst)
 {
-   int    depth;
-   int    peek;
+   int        depth;
+   int        peek;
+   tex_char * letter;
+   int        len;
 
    assert (str[*src] == '{' && str[*src + 1] == '\\');
    depth = 1;
@@ -244,17 +173,15 @@ purify_special_char (char *str, int * src, int * dst)
    if (peek == *src)                    /* in case of single-char, non-alpha */
       peek++;                           /* control sequence (eg. {\'e}) */
 
-   if (foreign_letter (str, *src, peek, NULL))
+   letter = foreign_letter (str, *src, peek);
+   if (letter != NULL)                  /* copy its purified form */
    {
-      assert (peek - *src == 1 || peek - *src == 2);
-      str[(*dst)++] = str[(*src)++];    /* copy first char */
-      if (*src < peek)                  /* copy second char, downcasing */
-         str[(*dst)++] = tolower (str[(*src)++]);
-   }
-   else                                 /* not a foreign letter -- skip */
-   {                                    /* the control sequence entirely */
-      *src = peek;
+      len = strlen (letter->purified);
+      assert (len <= peek - *src + 2);
+      memmove (str + *dst, letter->purified, len);
+      *dst += len;
    }
+   *src = peek;                         /* and skip the control sequence */
 
    while (str[*src])
    {
@@ -416,7 +343,7 @@ convert_special_char (char transform,
    boolean   done_special;
    int       cs_end;
    int       cs_len;                    /* counting the backslash */
-   bt_letter letter;
+   tex_char *letter;
    char *    repl;
    int       repl_len;
 
@@ -456,28 +383,26 @@ convert_special_char (char transform,
 
             cs_len = cs_end - *src;     /* length of cs, counting backslash */
 
-            if (foreign_letter (string, *src+1, cs_end, &letter))
+            letter = foreign_letter (string, *src+1, cs_end);
+            if (letter != NULL)
             {
-               if (letter == L_OTHER)
-                  internal_error ("impossible foreign letter");
-
                switch (transform)
                {
                   case 'u':
-                     repl = uc_version[(int) letter];
+                     repl = letter->upper;
                      break;
                   case 'l':
-                     repl = lc_version[(int) letter];
+                     repl = letter->lower;
                      break;
                   case 't':
                      if (*start_sentence || *after_colon)
                      {
-                        repl = uc_version[(int) letter];
+                        repl = letter->upper;
                         *start_sentence = *after_colon = FALSE;
                      }
                      else
                      {
-                        repl = lc_version[(int) letter];
+                        repl = letter->lower;
                      }
                      break;
                   default:
@@ -490,7 +415,7 @@ convert_special_char (char transform,
                   internal_error
                      ("replacement text longer than original cs");
 
-               strncpy (string + *dst, repl, repl_len);
+               memcpy (string + *dst, repl, repl_len);
                *src = cs_end;
                *dst += repl_len;
             } /* control sequence is a foreign letter */
@@ -598,7 +523,7 @@ bt_change_case (char   transform,
              *   - control sequences are left alone, unless they are
              *     one of the "foreign letter" control sequences, in
              *     which case they're converted to the appropriate string
-             *     according to the uc_version or lc_version tables.
+             *     according to its upper or lower form in tex_chars[].
              */
             if (depth == 0 && string[src+1] == '\\')
             {
@@ -695,4 +620,6 @@ bt_change_case (char   transform,
                                   
    } /* while not at end of string */
 
+   string[dst] = (char) 0;              /* foreign letters can shrink */
+
 } /* bt_change_case */
@@ -3,6 +3,12 @@
 @DESCRIPTION: Functions for dealing with strings of TeX code: converting
               them to tree representation, traversing the trees to glean
               useful information, and converting back to string form.
+
+              A tree is built in one pass into a single block of memory
+              (the "arena"), with its nodes in document order; so it is
+              freed with one free(), can be rebuilt for another string
+              without any allocation, and is traversed with simple loops
+              (using each node's depth) rather than recursion.
 @GLOBALS    : 
 @CALLS      : 
 @CALLERS    : 
@@ -20,6 +26,7 @@
 
 #include "bt_config.h"
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include "error.h"
@@ -29,84 +36,23 @@
 /* blech! temp hack until I make error.c perfect and magical */
 #define string_warning(w) fprintf (stderr, w);
 
-typedef struct treestack_s
-{
-   bt_tex_tree * node;
-   struct treestack_s
-               * prev,
-               * next;
-} treestack;
-
-
-/* ----------------------------------------------------------------------
- * Stack manipulation functions
+/* 
+ * The nodes of a tree live in an array, preceded by this header and
+ * followed by a sentinel node with depth -1 (which stops every
+ * traversal) and by the stack of open groups used while building.
+ * The root of the tree is nodes[0], so we can always get from it back to
+ * the arena.
  */
-
-/* ------------------------------------------------------------------------
-@NAME       : push_treestack()
-@INPUT      : *stack
-              node
-@OUTPUT     : *stack
-@RETURNS    : 
-@DESCRIPTION: Creates and initializes new node in a stack, and pushes it
-              onto the stack.
-@GLOBALS    : 
-@CALLS      : 
-@CALLERS    : 
-@CREATED    : 1997/05/29, GPW
-@MODIFIED   : 
--------------------------------------------------------------------------- */
-static void
-push_treestack (treestack **stack, bt_tex_tree *node)
-{
-   treestack  *newtop;
-
-   newtop = (treestack *) malloc (sizeof (treestack));
-   newtop->node = node;
-   newtop->next = NULL;
-   newtop->prev = *stack;
-
-   if (*stack != NULL)                  /* stack already has some entries */
-   {
-      (*stack)->next = newtop;
-      *stack = newtop;
-   }
-
-   *stack = newtop;
-
-} /* push_treestack() */
-
-
-/* ------------------------------------------------------------------------
-@NAME       : pop_treestack
-@INPUT      : *stack
-@OUTPUT     : *stack
-@RETURNS    : 
-@DESCRIPTION: Pops an entry off of a stack of tex_tree nodes, frees up
-              the wrapper treestack node, and returns the popped tree node.
-@GLOBALS    : 
-@CALLS      : 
-@CALLERS    : 
-@CREATED    : 1997/05/29, GPW
-@MODIFIED   : 
--------------------------------------------------------------------------- */
-static bt_tex_tree *
-pop_treestack (treestack **stack)
+typedef struct
 {
-   treestack *   oldtop;
-   bt_tex_tree * node;
+   int            size;                 /* nodes allocated, with sentinel */
+   int            num_nodes;            /* nodes in use, without it */
+   bt_tex_tree ** stack;
+   bt_tex_tree    nodes[1];
+} tex_arena;
 
-   if (*stack == NULL)
-      internal_error ("attempt to pop off empty stack");
-   oldtop = (*stack)->prev;
-   node = (*stack)->node;
-   free (*stack);
-   if (oldtop != NULL)
-      oldtop->next = NULL;
-   *stack = oldtop;
-   return node;
-
-} /* pop_treestack() */
+#define ARENA_OF(top) \
+   ((tex_arena *) ((char *) (top) - offsetof (tex_arena, nodes)))
 
 
 /* ----------------------------------------------------------------------
@@ -115,62 +61,64 @@ pop_treestack (treestack **stack)
 
 /* ------------------------------------------------------------------------
 @NAME       : new_tex_tree
-@INPUT      : start
+@INPUT      : arena
+              start
+              depth
 @OUTPUT     : 
 @RETURNS    : pointer to newly-allocated node
-@DESCRIPTION: Allocates and initializes a bt_tex_tree node.
+@DESCRIPTION: Takes the next node from the arena and initializes it.
 @GLOBALS    : 
 @CALLS      : 
-@CALLERS    : 
+@CALLERS    : build_tree
 @CREATED    : 1997/05/29, GPW
-@MODIFIED   : 
+@MODIFIED   : 2026/10/19 (allocate from the arena)
 -------------------------------------------------------------------------- */
 static bt_tex_tree *
-new_tex_tree (char *start)
+new_tex_tree (tex_arena *arena, char *start, int depth)
 {
    bt_tex_tree * node;
 
-   node = (bt_tex_tree *) malloc (sizeof (bt_tex_tree));
+   node = &arena->nodes[arena->num_nodes++];
    node->start = start;
    node->len = 0;
+   node->depth = depth;
    node->child = node->next = NULL;
    return node;
 }
 
 
 /* ------------------------------------------------------------------------
-@NAME       : bt_build_tex_tree
-@INPUT      : string
+@NAME       : build_tree
+@INPUT      : arena  - big enough for the string (see bt_rebuild_tex_tree)
+              string
+              len    - length of string
 @OUTPUT     : 
-@RETURNS    : pointer to a complete tree; call bt_free_tex_tree() to free
-              the entire tree
+@RETURNS    : root of the tree, or NULL if the braces in string are
+              unbalanced
 @DESCRIPTION: Traverses a string looking for TeX groups ({...}), and builds
               a tree containing pointers into the string and describing
               its brace-structure.
 @GLOBALS    : 
 @CALLS      : 
-@CALLERS    : 
-@CREATED    : 1997/05/29, GPW
-@MODIFIED   : 
+@CALLERS    : bt_rebuild_tex_tree
+@CREATED    : 1997/05/29, GPW (as bt_build_tex_tree)
+@MODIFIED   : 2026/10/19 (build in the arena; the stack is an array)
 -------------------------------------------------------------------------- */
-bt_tex_tree *
-bt_build_tex_tree (char * string)
+static bt_tex_tree *
+build_tree (tex_arena *arena, char * string, int len)
 {
    int     i;
    int     depth;
-   int     len;
    bt_tex_tree
          * top,
          * cur,
-         * new;
-   treestack
-         * stack;
+         * new,
+         * sentinel;
 
    i = 0;
    depth = 0;
-   len = strlen (string);
-   top = new_tex_tree (string);
-   stack = NULL;
+   arena->num_nodes = 0;
+   top = new_tex_tree (arena, string, 0);
 
    cur = top;
    
@@ -183,27 +131,25 @@ bt_build_tex_tree (char * string)
             if (i == len-1)             /* open brace in last character? */
             {
                string_warning ("unbalanced braces: { at end of string");
-               goto error;
+               return NULL;
             }
 
-            new = new_tex_tree (string+i+1);
+            new = new_tex_tree (arena, string+i+1, depth+1);
             cur->child = new;
-            push_treestack (&stack, cur);
+            arena->stack[depth++] = cur;
             cur = new;
-            depth++;
             break;
          }
          case '}':                      /* pop level(s) off */
          {
             while (i < len && string[i] == '}')
             {
-               if (stack == NULL)
+               if (depth == 0)
                {
                   string_warning ("unbalanced braces: extra }");
-                  goto error;
+                  return NULL;
                }
-               cur = pop_treestack (&stack);
-               depth--;
+               cur = arena->stack[--depth];
                i++;
             }
             i--;
@@ -213,27 +159,24 @@ bt_build_tex_tree (char * string)
                if (depth > 0)           /* but not at depth 0 */
                {
                   string_warning ("unbalanced braces: not enough }'s");
-                  goto error;
+                  return NULL;
                }
-
-               /* 
-                * if we get here, do nothing -- we've reached the end of 
-                * the string and are at depth 0, so will just fall out
-                * of the while loop at the end of this iteration
-                */
             }
             else                        /* still have characters left */
             {                           /* to worry about */
-               new = new_tex_tree (string+i+1);
+               new = new_tex_tree (arena, string+i+1, depth);
                cur->next = new;
                cur = new;
             }
 
             break;
          }
-         default:
+         default:                       /* take the whole run of text */
          {
-            cur->len++;
+            int   run = strcspn (string+i, "{}");
+
+            cur->len += run;
+            i += run - 1;
          }
 
       } /* switch */
@@ -245,16 +188,93 @@ bt_build_tex_tree (char * string)
    if (depth > 0)
    {
       string_warning ("unbalanced braces (not enough }'s)");
-      goto error;
+      return NULL;
    }
 
+   sentinel = &arena->nodes[arena->num_nodes];
+   sentinel->start = string + len;
+   sentinel->len = 0;
+   sentinel->depth = -1;
+   sentinel->child = sentinel->next = NULL;
    return top;
 
-error:
-   bt_free_tex_tree (&top);
-   return NULL;
+} /* build_tree() */
 
-} /* bt_build_tex_tree() */
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_rebuild_tex_tree
+@INPUT      : top    - a tree from an earlier bt_build_tex_tree() or
+                       bt_rebuild_tex_tree(), or NULL
+              string
+@OUTPUT     : 
+@RETURNS    : pointer to a complete tree for string (top itself, if it
+              was big enough); NULL if the braces in string are
+              unbalanced, in which case top has been freed
+@DESCRIPTION: Builds the tree for string in the memory of an existing
+              tree, growing it if necessary.  Lets a caller that works
+              through many strings use a single tree for all of them.
+@GLOBALS    : 
+@CALLS      : build_tree
+@CALLERS    : bt_build_tex_tree
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+bt_tex_tree *
+bt_rebuild_tex_tree (bt_tex_tree *top, char * string)
+{
+   tex_arena * arena;
+   int         len;
+   int         braces;
+   int         needed;
+
+   /* 
+    * Each { starts one node, and each run of }'s at most one more; add
+    * the root and the sentinel, and that's all we'll need.
+    */
+   braces = 0;
+   for (len = 0; string[len]; len++)
+      if (string[len] == '{' || string[len] == '}') braces++;
+   needed = braces + 2;
+
+   arena = top ? ARENA_OF (top) : NULL;
+   if (arena == NULL || arena->size < needed)
+   {
+      arena = (tex_arena *)
+         realloc (arena, offsetof (tex_arena, nodes) +
+                         needed * (sizeof (bt_tex_tree) +
+                                   sizeof (bt_tex_tree *)));
+      arena->size = needed;
+      arena->stack = (bt_tex_tree **) (arena->nodes + needed);
+   }
+
+   top = build_tree (arena, string, len);
+   if (top == NULL)
+      free (arena);
+   return top;
+
+} /* bt_rebuild_tex_tree() */
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_build_tex_tree
+@INPUT      : string
+@OUTPUT     : 
+@RETURNS    : pointer to a complete tree; call bt_free_tex_tree() to free
+              the entire tree
+@DESCRIPTION: Traverses a string looking for TeX groups ({...}), and builds
+              a tree containing pointers into the string and describing
+              its brace-structure.
+@GLOBALS    : 
+@CALLS      : bt_rebuild_tex_tree
+@CALLERS    : 
+@CREATED    : 1997/05/29, GPW
+@MODIFIED   : 2026/10/19 (all the work is in build_tree())
+-------------------------------------------------------------------------- */
+bt_tex_tree *
+bt_build_tex_tree (char * string)
+{
+   return bt_rebuild_tex_tree (NULL, string);
+}
 
 
 /* ------------------------------------------------------------------------
@@ -264,17 +284,16 @@ error:
 @RETURNS    : 
 @DESCRIPTION: Frees up an entire tree created by bt_build_tex_tree().
 @GLOBALS    : 
-@CALLS      : itself, free()
+@CALLS      : free()
 @CALLERS    : 
 @CREATED    : 1997/05/29, GPW
-@MODIFIED   : 
+@MODIFIED   : 2026/10/19 (one free() for the whole arena)
 -------------------------------------------------------------------------- */
 void
 bt_free_tex_tree (bt_tex_tree **top)
 {
-   if ((*top)->child) bt_free_tex_tree (&(*top)->child);
-   if ((*top)->next) bt_free_tex_tree (&(*top)->next);
-   free (*top);
+   if (*top)
+      free (ARENA_OF (*top));
    *top = NULL;
 }
 
@@ -282,6 +301,10 @@ bt_free_tex_tree (bt_tex_tree **top)
 
 /* ----------------------------------------------------------------------
  * Tree traversal functions
+ *
+ * A node's child and following siblings, with all their descendants, are
+ * exactly the nodes after it in the arena up to the first one that is
+ * less deep (possibly the sentinel); so all of these are loops.
  */
 
 /* ------------------------------------------------------------------------
@@ -294,29 +317,29 @@ bt_free_tex_tree (bt_tex_tree **top)
 @DESCRIPTION: Dumps a TeX tree: one node per line, depth indented according
               to depth.
 @GLOBALS    : 
-@CALLS      : itself
+@CALLS      : 
 @CALLERS    : 
 @CREATED    : 1997/05/29, GPW
-@MODIFIED   : 
+@MODIFIED   : 2026/10/19 (iterative)
 -------------------------------------------------------------------------- */
 void
 bt_dump_tex_tree (bt_tex_tree *node, int depth, FILE *stream)
 {
    char  buf[256];
+   int   base;
 
    if (node == NULL)
       return;
 
-   if (node->len > 255)
-      internal_error ("augughgh! buf too small");
-   strncpy (buf, node->start, node->len);
-   buf[node->len] = (char) 0;
-
-   fprintf (stream, "%*s[%s]\n", depth*2, "", buf);
+   for (base = node->depth; node->depth >= base; node++)
+   {
+      if (node->len > 255)
+         internal_error ("augughgh! buf too small");
+      strncpy (buf, node->start, node->len);
+      buf[node->len] = (char) 0;
 
-   bt_dump_tex_tree (node->child, depth+1, stream);
-   bt_dump_tex_tree (node->next, depth, stream);
-   
+      fprintf (stream, "%*s[%s]\n", (depth + node->depth - base)*2, "", buf);
+   }
 }
 
 
@@ -330,20 +353,22 @@ bt_dump_tex_tree (bt_tex_tree *node, int depth, FILE *stream)
               of string in each node, plus two [{ and }] for each down 
               edge.)
 @GLOBALS    : 
-@CALLS      : itself
+@CALLS      : 
 @CALLERS    : bt_flatten_tex_tree
 @CREATED    : 1997/05/29, GPW
-@MODIFIED   : 
+@MODIFIED   : 2026/10/19 (iterative)
 -------------------------------------------------------------------------- */
 static int
 count_length (bt_tex_tree *node)
 {
+   int   base;
+   int   len;
+
    if (node == NULL) return 0;
-   return
-      node->len + 
-      (node->child ? 2 : 0) +
-      count_length (node->child) +
-      count_length (node->next);
+   len = 0;
+   for (base = node->depth; node->depth >= base; node++)
+      len += node->len + (node->child ? 2 : 0);
+   return len;
 }
 
 
@@ -356,30 +381,38 @@ count_length (bt_tex_tree *node)
 @RETURNS    : 
 @DESCRIPTION: Dumps a reconstructed string ("flat" representation of the 
               tree) into a pre-allocated buffer, starting at a specified
-              offset.
+              offset.  Closing braces are written whenever the depth
+              drops from one node to the next.
 @GLOBALS    : 
-@CALLS      : itself
+@CALLS      : 
 @CALLERS    : bt_flatten_tex_tree
 @CREATED    : 1997/05/29, GPW
-@MODIFIED   : 
+@MODIFIED   : 2026/10/19 (iterative)
 -------------------------------------------------------------------------- */
 static void
 flatten_tree (bt_tex_tree *node, char *buf, int *offset)
 {
-   strncpy (buf + *offset, node->start, node->len);
-   *offset += node->len;
+   int   base;
+   int   depth;
 
-   if (node->child)
+   base = depth = node->depth;
+   for (; node->depth >= base; node++)
    {
-      buf[(*offset)++] = '{';
-      flatten_tree (node->child, buf, offset);
-      buf[(*offset)++] = '}';
-   }
+      for (; depth > node->depth; depth--)
+         buf[(*offset)++] = '}';
 
-   if (node->next)
-   {
-      flatten_tree (node->next, buf, offset);
+      memcpy (buf + *offset, node->start, node->len);
+      *offset += node->len;
+
+      if (node->child)
+      {
+         buf[(*offset)++] = '{';
+         depth++;
+      }
    }
+
+   for (; depth > base; depth--)
+      buf[(*offset)++] = '}';
 }
 
 
@@ -410,5 +443,137 @@ bt_flatten_tex_tree (bt_tex_tree *top)
    buf = (char *) malloc (sizeof (char) * (len+1));
    offset = 0;
    flatten_tree (top, buf, &offset);
+   buf[offset] = (char) 0;
    return buf;
 }
+
+
+
+/* ----------------------------------------------------------------------
+ * Queries about positions in the string a tree was built from
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : find_node
+@INPUT      : arena
+              pos    - pointer into the tree's string
+@OUTPUT     : 
+@RETURNS    : the last node starting at or before pos
+@DESCRIPTION: Binary search over the arena, whose nodes are in the
+              order of the text they point to.  pos is either in the
+              text of the returned node, or in the braces just after it.
+@GLOBALS    : 
+@CALLS      : 
+@CALLERS    : bt_tex_depth, bt_tex_span
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+static bt_tex_tree *
+find_node (tex_arena *arena, char *pos)
+{
+   int   lo, hi, mid;
+
+   lo = 0;
+   hi = arena->num_nodes - 1;
+   while (lo < hi)
+   {
+      mid = (lo + hi + 1) / 2;
+      if (arena->nodes[mid].start <= pos)
+         lo = mid;
+      else
+         hi = mid - 1;
+   }
+   return &arena->nodes[lo];
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_tex_depth
+@INPUT      : top    - root of a tree
+              offset - position in the string the tree was built from
+@OUTPUT     : 
+@RETURNS    : number of groups enclosing the character at offset (0 if
+              offset is outside the string)
+@DESCRIPTION: Finds the brace depth of any character, the way BibTeX
+              counts it: the braces delimiting a group are outside it.
+              A character in the text of a node has the node's depth; a
+              { following a node opens the node's child, and so has the
+              node's depth too; and the n'th } of a run following a node
+              closes one group more than the (n-1)'th.
+@GLOBALS    : 
+@CALLS      : find_node
+@CALLERS    : bt_tex_protected
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+int
+bt_tex_depth (bt_tex_tree *top, int offset)
+{
+   tex_arena *   arena;
+   bt_tex_tree * node;
+   char *        pos;
+
+   arena = ARENA_OF (top);
+   pos = top->start + offset;
+   if (offset < 0 || pos >= arena->nodes[arena->num_nodes].start)
+      return 0;
+
+   node = find_node (arena, pos);
+   if (pos < node->start + node->len || node->child)
+      return node->depth;
+   return node->depth - 1 - (pos - (node->start + node->len));
+
+} /* bt_tex_depth() */
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_tex_protected
+@INPUT      : top    - root of a tree
+              offset - position in the string the tree was built from
+@OUTPUT     : 
+@RETURNS    : TRUE if the character at offset is inside braces
+@DESCRIPTION: 
+@GLOBALS    : 
+@CALLS      : bt_tex_depth
+@CALLERS    : 
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+boolean
+bt_tex_protected (bt_tex_tree *top, int offset)
+{
+   return bt_tex_depth (top, offset) > 0;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_tex_span
+@INPUT      : top    - root of a tree
+              offset - position in the string the tree was built from
+@OUTPUT     : 
+@RETURNS    : the node whose text contains the character at offset, or
+              NULL if that character is a brace (or outside the string)
+@DESCRIPTION: Span lookup: the node gives the extent of the run of
+              text around offset (start and len) and its depth.
+@GLOBALS    : 
+@CALLS      : find_node
+@CALLERS    : 
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+bt_tex_tree *
+bt_tex_span (bt_tex_tree *top, int offset)
+{
+   tex_arena *   arena;
+   bt_tex_tree * node;
+   char *        pos;
+
+   arena = ARENA_OF (top);
+   pos = top->start + offset;
+   if (offset < 0 || pos >= arena->nodes[arena->num_nodes].start)
+      return NULL;
+
+   node = find_node (arena, pos);
+   return (pos < node->start + node->len) ? node : NULL;
+
+} /* bt_tex_span() */
@@ -0,0 +1,451 @@
+/* ------------------------------------------------------------------------
+@NAME       : tex_unicode.c
+@DESCRIPTION: Converts the TeX in a BibTeX string to plain UTF-8 text:
+
+                bt_tex_to_unicode
+                fold_text (private to the library)
+
+              Accented letters ({\'e}, \"{o}, \v c, ...), the foreign
+              letters (\ss, \ae, \o, ...), other text symbols
+              (\textendash, \S, ...), escaped special characters,
+              ligatures (--, ---, ``, '', ?`, !`) and ties become the
+              characters they stand for, in NFC; braces go, and so do
+              font commands (\emph, \textbf, ...), leaving their
+              arguments.  Math ($...$) is left alone, and so is any
+              control sequence that isn't known.  The control sequences
+              are those of tex_chars.dat.
+
+              fold_text() goes on to fold the result for comparing, as
+              bt_purify_string() does TeX: letters lose their case and
+              accents, whichever way they were written.
+@GLOBALS    :
+@CALLS      : tex_char_lookup()
+@CREATED    : 2026/10/19
+@MODIFIED   : 2026/10/19: table-driven, from tex_chars.dat
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse library.  This library is
+              free software; you can redistribute it and/or modify it under
+              the terms of the GNU Library General Public License as
+              published by the Free Software Foundation; either version 2
+              of the License, or (at your option) any later version.
+-------------------------------------------------------------------------- */
+
+#include "bt_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "btparse.h"
+#include "prototypes.h"
+#include "my_dmalloc.h"
+#include "bt_debug.h"
+
+
+/*
+ * The control sequences (accents, foreign letters, other symbols, and
+ * commands that are dropped) are looked up with tex_char_lookup(), in
+ * the perfect hash table that string_util.c has of tex_chars.dat; and
+ * the precomposed letter for an accent and a letter is found by
+ * indexing tex_composed[], also generated from tex_chars.dat.  So each
+ * control sequence costs the same, however many there are.
+ */
+#include "tex_composed.h"
+
+/*
+ * What fold_text() makes of the non-ASCII characters, in ranges (see
+ * gen_tex_chars.pl), found by binary search.
+ */
+typedef struct
+{
+   int     first;
+   int     last;
+   char *  fold;                        /* without accents; NULL: keep */
+   char *  lower;                       /* with them; NULL: keep */
+} fold_range;
+
+#include "tex_fold.h"
+
+#define IS_LETTER(c) (((c) >= 'A' && (c) <= 'Z') || ((c) >= 'a' && (c) <= 'z'))
+
+
+static void
+append_utf8 (bt_buffer * buf, int code)
+{
+   char  bytes[4];
+   int   len;
+
+   if (code < 0x80)
+   {
+      bytes[0] = (char) code;
+      len = 1;
+   }
+   else if (code < 0x800)
+   {
+      bytes[0] = (char) (0xC0 | (code >> 6));
+      bytes[1] = (char) (0x80 | (code & 0x3F));
+      len = 2;
+   }
+   else if (code < 0x10000)
+   {
+      bytes[0] = (char) (0xE0 | (code >> 12));
+      bytes[1] = (char) (0x80 | ((code >> 6) & 0x3F));
+      bytes[2] = (char) (0x80 | (code & 0x3F));
+      len = 3;
+   }
+   else
+   {
+      bytes[0] = (char) (0xF0 | (code >> 18));
+      bytes[1] = (char) (0x80 | ((code >> 12) & 0x3F));
+      bytes[2] = (char) (0x80 | ((code >> 6) & 0x3F));
+      bytes[3] = (char) (0x80 | (code & 0x3F));
+      len = 4;
+   }
+   buf_append (buf, bytes, len);
+}
+
+
+/*
+ * The argument of an accent, at *p: a letter, a letter in braces, or a
+ * dotless i or j (\i, {\i}, which eat the spaces after them, as control
+ * words do); *p is left after it.  Returns the letter ('i' or 'j' for the
+ * dotless ones), or 0 if there isn't one.
+ */
+static int
+accent_arg (char ** p)
+{
+   char *  s;
+   boolean braced;
+   int     letter;
+
+   s = *p;
+   while (*s == ' ')
+      s++;
+   braced = (*s == '{');
+   if (braced)
+      s++;
+
+   if (s[0] == '\\' && (s[1] == 'i' || s[1] == 'j') && !IS_LETTER (s[2]))
+   {
+      letter = s[1];
+      s += 2;
+      while (*s == ' ')
+         s++;
+   }
+   else if (IS_LETTER (*s))
+   {
+      letter = *s++;
+   }
+   else
+   {
+      return 0;
+   }
+
+   if (braced)
+   {
+      if (*s != '}')
+         return 0;
+      s++;
+   }
+   *p = s;
+   return letter;
+}
+
+
+/* Skips the group starting at p (a '{'), returning what's after it */
+static char *
+skip_group (char * p)
+{
+   int  depth = 0;
+
+   do
+   {
+      if (*p == '{') depth++;
+      else if (*p == '}') depth--;
+      p++;
+   } while (*p && depth > 0);
+   return p;
+}
+
+
+/*
+ * Puts an accent on the letter at *p (see accent_arg()), in NFC: as the
+ * precomposed letter if Unicode has one, and otherwise as the letter
+ * and the accent's combining character.  Returns FALSE (leaving *p
+ * alone) if there isn't a letter.
+ */
+static boolean
+convert_accent (bt_buffer * buf, tex_char * accent, char ** p)
+{
+   int   letter, code;
+
+   if ((letter = accent_arg (p)) == 0)
+      return FALSE;
+
+   if (letter <= 'Z')
+      code = tex_composed[accent->accent][letter - 'A'];
+   else
+      code = tex_composed[accent->accent][letter - 'a' + 26];
+   if (code != 0)
+   {
+      append_utf8 (buf, code);
+   }
+   else
+   {
+      buf_append_char (buf, (char) letter);
+      append_utf8 (buf, accent->code);
+   }
+   return TRUE;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_tex_to_unicode()
+@INPUT      : string - text of a field, in UTF-8 (or ASCII)
+@RETURNS    : the same text with its TeX converted (newly allocated)
+@DESCRIPTION: See above.  The string is converted in one pass, each
+              control sequence with one lookup.  An accent whose letter
+              has no precomposed form is written as the letter and a
+              combining character, which is what NFC makes of it.
+              Control words eat the spaces after them, as in TeX; an
+              unknown control sequence keeps its braced arguments
+              untouched.
+@CREATED    : 2026/10/19
+@MODIFIED   : 2026/10/19: looks control sequences up in tex_chars[]
+-------------------------------------------------------------------------- */
+char * bt_tex_to_unicode (char * string)
+{
+   bt_buffer  buf;
+   char *     p;
+   char *     start;
+   char *     name;
+   tex_char * tc;
+
+   memset (&buf, 0, sizeof (buf));
+   buf_reserve (&buf, strlen (string));
+   buf.text[0] = (char) 0;
+
+   p = string;
+   while (*p)
+   {
+      switch (*p)
+      {
+         case '{':
+         case '}':
+            p++;
+            break;
+
+         case '~':
+            append_utf8 (&buf, 0xA0);
+            p++;
+            break;
+
+         case '-':
+            if (p[1] == '-' && p[2] == '-')
+            {
+               append_utf8 (&buf, 0x2014);
+               p += 3;
+            }
+            else if (p[1] == '-')
+            {
+               append_utf8 (&buf, 0x2013);
+               p += 2;
+            }
+            else
+               buf_append_char (&buf, *p++);
+            break;
+
+         case '`':
+         case '\'':
+            if (p[1] == p[0])
+            {
+               append_utf8 (&buf, p[0] == '`' ? 0x201C : 0x201D);
+               p += 2;
+            }
+            else
+               buf_append_char (&buf, *p++);
+            break;
+
+         case '?':                      /* Spanish ?` and !` */
+         case '!':
+            if (p[1] == '`')
+            {
+               append_utf8 (&buf, p[0] == '?' ? 0xBF : 0xA1);
+               p += 2;
+            }
+            else
+               buf_append_char (&buf, *p++);
+            break;
+
+         case '$':                      /* math: leave it all alone */
+            start = p;
+            for (p++; *p && *p != '$'; p++)
+            {
+               if (*p == '\\' && p[1])
+                  p++;
+            }
+            if (*p == '$')
+               p++;
+            buf_append (&buf, start, p - start);
+            break;
+
+         case '\\':
+            start = p++;
+            if (*p == 0)
+            {
+               buf_append_char (&buf, '\\');
+               break;
+            }
+            name = p;
+            if (IS_LETTER (*p))         /* control word */
+            {
+               while (IS_LETTER (*p))
+                  p++;
+            }
+            else                        /* control symbol */
+            {
+               if (strchr ("&%$#_{} ", *p))
+               {
+                  buf_append_char (&buf, *p++);
+                  break;
+               }
+               p++;
+            }
+
+            tc = tex_char_lookup (name, p - name);
+            if (tc != NULL && tc->kind == TEX_ACCENT &&
+                convert_accent (&buf, tc, &p))
+               break;
+            if (tc == NULL || tc->kind == TEX_ACCENT)
+            {                           /* unknown (or an accent with no */
+               while (*p == '{')        /* letter): keep it, and its */
+                  p = skip_group (p);   /* arguments, as they are */
+               buf_append (&buf, start, p - start);
+               break;
+            }
+
+            if (IS_LETTER (*name))      /* control words eat spaces */
+            {
+               while (*p == ' ')
+                  p++;
+            }
+            if (tc->kind == TEX_LETTER || tc->kind == TEX_SYMBOL)
+               append_utf8 (&buf, tc->code);
+            else if (tc->kind == TEX_SKIP && *p == '{')
+               p = skip_group (p);      /* drop the argument too */
+            break;
+
+         default:
+            buf_append_char (&buf, *p++);
+            break;
+      }
+   }
+
+   return buf.text;
+}
+
+
+/* The range of tex_fold[] that a (non-ASCII) character is in */
+static fold_range *
+fold_lookup (int code)
+{
+   int  lo, hi, mid;
+
+   lo = 0;
+   hi = TEX_FOLD_SIZE - 1;
+   while (lo <= hi)
+   {
+      mid = (lo + hi) / 2;
+      if (code < tex_fold[mid].first)
+         hi = mid - 1;
+      else if (code > tex_fold[mid].last)
+         lo = mid + 1;
+      else
+         return &tex_fold[mid];
+   }
+   return NULL;                         /* beyond U+FFFF */
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : fold_text()
+@INPUT      : string  - text of a field, in UTF-8 (or, failing that,
+                        Latin-1)
+              accents - keep accents (and foreign letters) as they are
+@RETURNS    : the text folded for comparing (newly allocated)
+@DESCRIPTION: Converts the TeX in `string' with bt_tex_to_unicode(), and
+              then folds it much as bt_purify_string() and
+              bt_change_case() would fold the TeX: letters and digits
+              are kept, lowercased and without their accents, and the
+              foreign letters are spelled as purify spells them -- so
+              `{\"U}ber', `Uber' and `Uber' with a U+00DC are all
+              `uber', and `{\o}' and U+00F8 are both `o'.  Whitespace,
+              hyphens, dashes and ties separate words, which are joined
+              by single spaces (with none at either end); anything else
+              is dropped.  Unicode text folds just like the TeX for it.
+
+              With `accents', letters are only lowercased: `{\"U}ber'
+              is then `uber' with a U+00FC, and not the same as `Uber'.
+@CALLS      : bt_tex_to_unicode(), utf8_decode()
+@CALLERS    : normalize() (query.c), split_words() (index.c)
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+char * fold_text (char * string, boolean accents)
+{
+   bt_buffer    buf;
+   char *       unicode;
+   char *       p;
+   char *       f;
+   fold_range * range;
+   boolean      space;
+   int          code, len;
+
+   unicode = bt_tex_to_unicode (string);
+   memset (&buf, 0, sizeof (buf));
+   buf_reserve (&buf, strlen (unicode));
+   buf.text[0] = (char) 0;
+
+   space = FALSE;
+   for (p = unicode; *p; p += len)
+   {
+      code = utf8_decode (p, &len);
+      if (code < 0x80)
+      {
+         if (isalnum (code))
+         {
+            if (space && buf.length > 0)
+               buf_append_char (&buf, ' ');
+            buf_append_char (&buf, (char) tolower (code));
+            space = FALSE;
+         }
+         else if (isspace (code) || code == '-')
+            space = TRUE;
+         continue;
+      }
+
+      range = fold_lookup (code);
+      f = (range == NULL) ? NULL : accents ? range->lower : range->fold;
+      if (f == NULL)
+      {
+         if (space && buf.length > 0)
+            buf_append_char (&buf, ' ');
+         append_utf8 (&buf, code);
+         space = FALSE;
+         continue;
+      }
+      for ( ; *f; f++)
+      {
+         if (*f == ' ')
+         {
+            space = TRUE;
+            continue;
+         }
+         if (space && buf.length > 0)
+            buf_append_char (&buf, ' ');
+         buf_append_char (&buf, *f);
+         space = FALSE;
+      }
+   }
+
+   free (unicode);
+   return buf.text;
+}
@@ -2,7 +2,7 @@
  * ------------------------------------------------------------------------
  * @NAME       : util.c @INPUT      : @OUTPUT     : @RETURNS    :
  * @DESCRIPTION: Miscellaneous utility functions.  So far, just: strlwr
- * strupr @CREATED    : Summer 1996, Greg Ward @MODIFIED   : @VERSION    :
+ * strupr, and UTF-8 helpers: get_uchar utf8_decode ascii_span isulower @CREATED    : Summer 1996, Greg Ward @MODIFIED   : @VERSION    :
  * $Id$ @COPYRIGHT  : Copyright (c) 1996-99 by Gregory P. Ward.  All rights
  * reserved.
  * 
@@ -67,113 +67,187 @@ strupr(char *s)
 }
 #endif
 
+/*
+ * UTF-8 decoding tables.  Utf8Class gives the class of every byte that can
+ * start a character; Utf8Seq gives, for each class, the length of the
+ * sequence and the valid range of its second byte (the ranges exclude
+ * overlong forms, surrogates, and code points beyond U+10FFFF).  Further
+ * bytes must all be in 80..BF.  Class 0 is a single byte: ASCII, and
+ * also stray bytes that can't start a sequence, which are taken as
+ * characters of their own (as are the lead bytes of malformed sequences).
+ */
+static const unsigned char Utf8Class[256] =
+{
+    /* 00..7F: ASCII */
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 80..BF: continuation bytes */
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* C0..DF: two bytes (C0 and C1 would be overlong) */
+    0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    /* E0..EF: three bytes */
+    3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 4, 2, 2,
+    /* F0..FF: four bytes (F5 and up would be beyond U+10FFFF) */
+    6, 5, 5, 5, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const struct
+{
+    unsigned char   length;
+    unsigned char   lo;         /* range of the second byte */
+    unsigned char   hi;
+}               Utf8Seq[8] =
+{
+    {1, 0x00, 0xFF},            /* 0: single byte */
+    {2, 0x80, 0xBF},            /* 1: C2..DF */
+    {3, 0x80, 0xBF},            /* 2: E1..EC, EE, EF */
+    {3, 0xA0, 0xBF},            /* 3: E0 (no overlongs) */
+    {3, 0x80, 0x9F},            /* 4: ED (no surrogates) */
+    {4, 0x80, 0xBF},            /* 5: F1..F3 */
+    {4, 0x90, 0xBF},            /* 6: F0 (no overlongs) */
+    {4, 0x80, 0x8F}             /* 7: F4 (up to U+10FFFF) */
+};
+
+
+/*
+ * ------------------------------------------------------------------------
+ * @NAME       : utf8_char_length() @INPUT      : bytes - start of a
+ * character @OUTPUT     : @RETURNS    : number of bytes in the UTF-8
+ * sequence starting at bytes (1 if it isn't a valid sequence)
+ * @DESCRIPTION: Table-driven decoding of the length of one character,
+ * without combining marks. @CALLS      : @CALLERS    : get_uchar()
+ * @CREATED    : 2026/10/19 @MODIFIED   :
+ * --------------------------------------------------------------------------
+ */
+static int
+utf8_char_length(const unsigned char *bytes)
+{
+    int        cl = Utf8Class[bytes[0]];
+    int        len = Utf8Seq[cl].length;
+    int        i;
+
+    if (len == 1)
+        return 1;
+    if (bytes[1] < Utf8Seq[cl].lo || bytes[1] > Utf8Seq[cl].hi)
+        return 1;
+    for (i = 2; i < len; i++)
+        if ((bytes[i] & 0xC0) != 0x80)
+            return 1;
+    return len;
+}
+
+
 /*
  * ------------------------------------------------------------------------
  * @NAME       : get_uchar() @INPUT      : string offset in string @OUTPUT
  * : number of bytes required to gobble the next unicode character, including
  * any combining marks @RETURNS    : @DESCRIPTION: In order to deal with
  * unicode chars when calculating abbreviations, we need to know how many
- * bytes the next character is. @CALLS      : @CALLERS    :
- * count_virtual_char() @CREATED    : 2010/03/14, PK @MODIFIED   :
+ * bytes the next character is. @CALLS      : utf8_char_length()
+ * @CALLERS    : count_virtual_char() @CREATED    : 2010/03/14, PK
+ * @MODIFIED   : 2026/10/19: table-driven, with a fast path for ASCII
  * --------------------------------------------------------------------------
  */
 int
 get_uchar(char *string, int offset)
 {
-    unsigned char  *bytes = (unsigned char *)string;
-    int        init;
-    unsigned int    c = 0;
-    //Without unsigned, for some reason Solaris coredumps
+    unsigned char  *bytes;
+    int        len;
 
-    if              (!string)
-                return    0;
+    if (!string)
+        return 0;
 
-    if ((//ASCII
-         bytes[offset] == 0x09 ||
-         bytes[offset] == 0x0A ||
-         bytes[offset] == 0x0D ||
-         (0x20 <= bytes[offset] && bytes[offset] <= 0x7E)
-         )
-        ) {
-        init = 1;
-    }
-    if ((//non - overlong 2 - byte
-         (0xC2 <= bytes[offset] && bytes[offset] <= 0xDF) &&
-         (0x80 <= bytes[offset + 1] && bytes[offset + 1] <= 0xBF)
-         )
-        ) {
-        init = 2;
-    }
-    if ((//excluding overlongs
-         bytes[offset] == 0xE0 &&
-         (0xA0 <= bytes[offset + 1] && bytes[offset + 1] <= 0xBF) &&
-         (0x80 <= bytes[offset + 2] && bytes[offset + 2] <= 0xBF)
-         ) ||
-        (//straight 3 - byte
-         ((0xE1 <= bytes[offset] && bytes[offset] <= 0xEC) ||
-          bytes[offset] == 0xEE ||
-          bytes[offset] == 0xEF) &&
-         (0x80 <= bytes[offset + 1] && bytes[offset + 1] <= 0xBF) &&
-         (0x80 <= bytes[offset + 2] && bytes[offset + 2] <= 0xBF)
-         ) ||
-        (//excluding surrogates
-         bytes[offset] == 0xED &&
-         (0x80 <= bytes[offset + 1] && bytes[offset + 1] <= 0x9F) &&
-         (0x80 <= bytes[offset + 2] && bytes[offset + 2] <= 0xBF)
-         )
-        ) {
-        init = 3;
+    bytes = (unsigned char *) string + offset;
+    len = (bytes[0] < 0x80) ? 1 : utf8_char_length(bytes);
+
+    /*
+     * Now check for combining marks which are separate even in NFC; they
+     * all start with CC, E1 or EF, so anything below CC ends the character
+     * at once.
+     */
+    while (bytes[len] >= 0xCC) {
+        /* 0300-036F - Combining Diacritical Marks */
+        if (bytes[len] == 0xCC &&
+            0x80 <= bytes[len + 1] && bytes[len + 1] <= 0xAF)
+            len += 2;
+        /* 1DC0-1DFF - Combining Diacritical Marks Supplement */
+        else if (bytes[len] == 0xE1 && bytes[len + 1] == 0xB7 &&
+                 0x80 <= bytes[len + 2] && bytes[len + 2] <= 0xBF)
+            len += 3;
+        /* FE20-FE2F - Combining Half Marks */
+        else if (bytes[len] == 0xEF && bytes[len + 1] == 0xB8 &&
+                 0xA0 <= bytes[len + 2] && bytes[len + 2] <= 0xAF)
+            len += 3;
+        else
+            break;
     }
-    if ((//planes 1 - 3
-         bytes[offset] == 0xF0 &&
-         (0x90 <= bytes[offset + 1] && bytes[offset + 1] <= 0xBF) &&
-         (0x80 <= bytes[offset + 2] && bytes[offset + 2] <= 0xBF) &&
-         (0x80 <= bytes[offset + 3] && bytes[offset + 3] <= 0xBF)
-         ) ||
-        (//planes 4 - 15
-         (0xF1 <= bytes[offset] && bytes[offset] <= 0xF3) &&
-         (0x80 <= bytes[offset + 1] && bytes[offset + 1] <= 0xBF) &&
-         (0x80 <= bytes[offset + 2] && bytes[offset + 2] <= 0xBF) &&
-         (0x80 <= bytes[offset + 3] && bytes[offset + 3] <= 0xBF)
-         ) ||
-        (//plane 16
-         bytes[offset] == 0xF4 &&
-         (0x80 <= bytes[offset + 1] && bytes[offset + 1] <= 0x8F) &&
-         (0x80 <= bytes[offset + 2] && bytes[offset + 2] <= 0xBF) &&
-         (0x80 <= bytes[offset + 3] && bytes[offset + 3] <= 0xBF)
-         )
-        ) {
-        init = 4;
+    return len;
+}
+
+
+/*
+ * ------------------------------------------------------------------------
+ * @NAME       : utf8_decode() @INPUT      : string @OUTPUT     : *len -
+ * number of bytes used @RETURNS    : the character at the start of string
+ * @DESCRIPTION: Decodes one UTF-8 character.  A byte that doesn't start a
+ * valid sequence is taken to be a Latin-1 character on its own, which is
+ * what a .bib file that isn't UTF-8 most often is. @CALLS      :
+ * utf8_char_length() @CALLERS    : fold_text() (in tex_unicode.c)
+ * @CREATED    : 2026/10/19 @MODIFIED   :
+ * --------------------------------------------------------------------------
+ */
+int
+utf8_decode(const char *string, int *len)
+{
+    const unsigned char *bytes = (const unsigned char *) string;
+    int        code, i;
+
+    if (bytes[0] < 0x80 || (*len = utf8_char_length(bytes)) == 1) {
+        *len = 1;
+        return bytes[0];
     }
-    /* Now check for combining marks which are separate even in NFC */
-    while (bytes[offset + init + c]) {
-        /* 0300–036F - Combining Diacritical Marks */
-        if (bytes[offset + init + c] == 0xCC &&
-            (0x80 <= bytes[offset + init + 1 + c] && bytes[offset + init + 1 + c] <= 0xAF)
-            ) {
-            c = c + 2;    /* Skip to next possible combining
-                     * mark */
-        }
-        /* 1DC0–1DFF - Combining Diacritical Marks Supplement */
-        else if (bytes[offset + init + c] == 0xE1 &&
-             bytes[offset + init + 1 + c] == 0xB7 &&
-             (0x80 <= bytes[offset + init + 2 + c] && bytes[offset + init + 2 + c] <= 0xBF)
-            ) {
-            c = c + 3;    /* Skip to next possible combining
-                     * mark */
-        }
-        /* FE20–FE2F - Combining Half Marks */
-        else if (bytes[offset + init + c] == 0xEF &&
-             bytes[offset + init + 1 + c] == 0xB8 &&
-             (0xA0 <= bytes[offset + init + 2 + c] && bytes[offset + init + 2 + c] <= 0xAF)
-            ) {
-            c = c + 3;    /* Skip to next possible combining
-                     * mark */
-        } else {
+    code = bytes[0] & (0x7F >> *len);
+    for (i = 1; i < *len; i++)
+        code = (code << 6) | (bytes[i] & 0x3F);
+    return code;
+}
+
+
+/*
+ * ------------------------------------------------------------------------
+ * @NAME       : ascii_span() @INPUT      : string len @OUTPUT     :
+ * @RETURNS    : number of leading bytes of string (of length len) that
+ * are 7-bit ASCII @DESCRIPTION: Lets callers that count characters skip
+ * UTF-8 decoding altogether for plain ASCII text, which is checked a
+ * word at a time. @CALLS      : @CALLERS    : string_length() (in
+ * format_name.c) @CREATED    : 2026/10/19 @MODIFIED   :
+ * --------------------------------------------------------------------------
+ */
+int
+ascii_span(const char *string, int len)
+{
+    bt_word    w;
+    int        i = 0;
+
+    while (i + (int) WORD_SIZE <= len) {
+        memcpy(&w, string + i, WORD_SIZE);
+        if (w & WORD_HIGH)
             break;
-        }
+        i += WORD_SIZE;
     }
-    return init + c;
+    while (i < len && !(string[i] & 0x80))
+        i++;
+    return i;
 }
 
 /*
@@ -194,11 +268,9 @@ isulower(char *string)
     if (!string)
         return 0;
 
-    if (
-        (0x61 <= bytes[0] && bytes[0] <= 0x7A)
-        ) {
-        return 1;
-    }
+    if (bytes[0] < 0x80)        /* ASCII: no need for the big search */
+        return (0x61 <= bytes[0] && bytes[0] <= 0x7A);
+
     if (
         (
          bytes[0] == 0xC2 &&
@@ -0,0 +1,451 @@
+/* ------------------------------------------------------------------------
+@NAME       : write.c
+@DESCRIPTION: Writing entries back out, as BibTeX or in bibparse's flat
+              line-based form:
+                bt_write_entry
+                bt_write_entry_s
+                bt_write_head
+                bt_write_field
+                bt_write_tail
+                bt_free_buffer
+
+              Everything is written to a growable buffer (a bt_buffer);
+              bt_write_entry() writes an entry to a buffer of its own
+              and then to a stream in one go.  The head/field/tail
+              functions are there for entries that aren't held as ASTs
+              (such as Text::BibTeX's Entry objects), so that they are
+              written in exactly the same way.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : 2026/10/19
+@MODIFIED   :
+@VERSION    : $Id$
+@COPYRIGHT  : This file is part of the btparse library.  This library is
+              free software; you can redistribute it and/or modify it under
+              the terms of the GNU Library General Public License as
+              published by the Free Software Foundation; either version 2
+              of the License, or (at your option) any later version.
+-------------------------------------------------------------------------- */
+
+#include "bt_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include "btparse.h"
+#include "prototypes.h"
+#include "error.h"
+#include "my_dmalloc.h"
+#include "bt_debug.h"
+
+
+#define MAX_VALUES   16                 /* simple values handled without */
+                                        /* malloc() (per field) */
+
+static bt_write_options default_options =
+{
+   FALSE,                               /* flat */
+   BTW_BRACES,                          /* quote */
+   "  ",                                /* indent */
+   0,                                   /* align */
+   NULL,                                /* field_order */
+   0                                    /* num_ordered */
+};
+
+
+/* ------------------------------------------------------------------------
+ * The buffer (these are shared with the other writers in the library)
+ */
+
+void
+buf_reserve (bt_buffer * buf, int more)
+{
+   if (buf->length + more + 1 > buf->size)
+   {
+      buf->size = 2 * buf->size > buf->length + more + 1
+         ? 2 * buf->size : buf->length + more + 1 + 256;
+      buf->text = (char *) realloc (buf->text, buf->size);
+   }
+}
+
+
+void
+buf_append (bt_buffer * buf, char * text, int len)
+{
+   buf_reserve (buf, len);
+   memcpy (buf->text + buf->length, text, len);
+   buf->length += len;
+   buf->text[buf->length] = (char) 0;
+}
+
+
+void
+buf_append_str (bt_buffer * buf, char * text)
+{
+   buf_append (buf, text, strlen (text));
+}
+
+
+void
+buf_append_char (bt_buffer * buf, char c)
+{
+   buf_reserve (buf, 1);
+   buf->text[buf->length++] = c;
+   buf->text[buf->length] = (char) 0;
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_free_buffer()
+@INOUT      : buf
+@DESCRIPTION: Frees the text of a buffer, leaving it empty (and ready
+              for re-use).
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_free_buffer (bt_buffer * buf)
+{
+   if (buf->text)
+      free (buf->text);
+   buf->text = NULL;
+   buf->length = buf->size = 0;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Writing the pieces of an entry
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : needs_braces()
+@INPUT      : text
+@RETURNS    : true if `text' has a double quote at brace depth zero, so
+              that it can't be written between double quotes
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static boolean
+needs_braces (char * text)
+{
+   int  depth = 0;
+
+   for ( ; *text; text++)
+   {
+      if (*text == '{') depth++;
+      else if (*text == '}') depth--;
+      else if (*text == '"' && depth <= 0) return TRUE;
+   }
+   return FALSE;
+}
+
+
+static void
+write_value (bt_buffer *        buf,
+             int                num_values,
+             bt_nodetype *      types,
+             char **            texts,
+             bt_write_options * options)
+{
+   int     i;
+   char *  text;
+
+   for (i = 0; i < num_values; i++)
+   {
+      if (i > 0)
+         buf_append_str (buf, options->flat ? "#" : " # ");
+      text = texts[i] ? texts[i] : "";
+      if (types[i] != BTAST_STRING || options->quote == BTW_BARE)
+      {
+         buf_append_str (buf, text);
+      }
+      else if (options->quote == BTW_QUOTES && !needs_braces (text))
+      {
+         buf_append_char (buf, '"');
+         buf_append_str (buf, text);
+         buf_append_char (buf, '"');
+      }
+      else
+      {
+         buf_append_char (buf, '{');
+         buf_append_str (buf, text);
+         buf_append_char (buf, '}');
+      }
+   }
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_write_head()
+@INOUT      : buf
+@INPUT      : metatype - of the entry
+              type     - entry type, as it is to be written
+              key      - entry key (regular entries only; may be NULL)
+              options  - may be NULL, for the defaults
+@DESCRIPTION: Writes the start of an entry: everything up to its first
+              field (or up to its value, for comments and preambles).
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_write_head (bt_buffer *        buf,
+                    bt_metatype        metatype,
+                    char *             type,
+                    char *             key,
+                    bt_write_options * options)
+{
+   if (options == NULL) options = &default_options;
+
+   buf_append_char (buf, '@');
+   buf_append_str (buf, type ? type : "");
+   if (options->flat)
+   {
+      if (key && metatype == BTE_REGULAR)
+      {
+         buf_append_char (buf, ' ');
+         buf_append_str (buf, key);
+      }
+      buf_append_char (buf, '\n');
+   }
+   else
+   {
+      buf_append_char (buf, '{');
+      if (metatype == BTE_REGULAR)
+      {
+         buf_append_str (buf, key ? key : "");
+         buf_append_str (buf, ",\n");
+      }
+      else if (metatype == BTE_MACRODEF)
+      {
+         buf_append_char (buf, '\n');
+      }
+   }
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_write_field()
+@INOUT      : buf
+@INPUT      : name       - field name, or NULL for the value of a comment
+                           or preamble entry
+              num_values - number of simple values in the field's value
+              types      - their node types (BTAST_STRING, BTAST_NUMBER or
+                           BTAST_MACRO)
+              texts      - their text (NULL is taken as empty)
+              options    - may be NULL, for the defaults
+@DESCRIPTION: Writes one field of an entry (or the value of a comment or
+              preamble): strings are quoted as options->quote says, and
+              numbers and macros are written as they are; simple values
+              are joined with '#'.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_write_field (bt_buffer *        buf,
+                     char *             name,
+                     int                num_values,
+                     bt_nodetype *      types,
+                     char **            texts,
+                     bt_write_options * options)
+{
+   int  len;
+
+   if (options == NULL) options = &default_options;
+
+   if (name == NULL)                    /* comment or preamble */
+   {
+      if (options->flat)                /* one simple value per line, */
+      {                                 /* never quoted */
+         int  i;
+
+         for (i = 0; i < num_values; i++)
+         {
+            if (texts[i] == NULL) continue;
+            buf_append_str (buf, texts[i]);
+            buf_append_char (buf, '\n');
+         }
+      }
+      else
+      {
+         write_value (buf, num_values, types, texts, options);
+      }
+      return;
+   }
+
+   if (options->flat)
+   {
+      buf_append_str (buf, name);
+      buf_append_char (buf, '=');
+      write_value (buf, num_values, types, texts, options);
+      buf_append_char (buf, '\n');
+      return;
+   }
+
+   len = strlen (name);
+   buf_append_str (buf, options->indent ? options->indent : "");
+   buf_append (buf, name, len);
+   for ( ; len < options->align; len++)
+      buf_append_char (buf, ' ');
+   buf_append_str (buf, " = ");
+   write_value (buf, num_values, types, texts, options);
+   buf_append_str (buf, ",\n");
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_write_tail()
+@INOUT      : buf
+@INPUT      : options  - may be NULL, for the defaults
+@DESCRIPTION: Writes the end of an entry (of any metatype), and the
+              blank line after it.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_write_tail (bt_buffer * buf, bt_write_options * options)
+{
+   if (options == NULL) options = &default_options;
+
+   buf_append_str (buf, options->flat ? "\n" : "}\n\n");
+}
+
+
+/* ------------------------------------------------------------------------
+ * Writing whole entries, from their ASTs
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : write_ast_value()
+@INOUT      : buf
+@INPUT      : name    - field name (NULL for a comment or preamble)
+              value   - the field (or entry) whose simple values are
+                        written
+              options
+@DESCRIPTION: Collects the simple values of a field and writes it.
+@CALLS      : bt_write_field()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static void
+write_ast_value (bt_buffer * buf, char * name, AST * value,
+                 bt_write_options * options)
+{
+   bt_nodetype   types_buf[MAX_VALUES], * types;
+   char *        texts_buf[MAX_VALUES], ** texts;
+   int           num, max;
+   AST *         simple;
+   bt_nodetype   nodetype;
+   char *        text;
+
+   types = types_buf;
+   texts = texts_buf;
+   max = MAX_VALUES;
+   num = 0;
+   simple = NULL;
+   while ((simple = bt_next_value (value, simple, &nodetype, &text)))
+   {
+      if (num == max)
+      {
+         max *= 2;
+         if (types == types_buf)
+         {
+            types = (bt_nodetype *) malloc (max * sizeof (bt_nodetype));
+            texts = (char **) malloc (max * sizeof (char *));
+            memcpy (types, types_buf, num * sizeof (bt_nodetype));
+            memcpy (texts, texts_buf, num * sizeof (char *));
+         }
+         else
+         {
+            types = (bt_nodetype *) realloc (types, max * sizeof (bt_nodetype));
+            texts = (char **) realloc (texts, max * sizeof (char *));
+         }
+      }
+      types[num] = nodetype;
+      texts[num] = text;
+      num++;
+   }
+
+   bt_write_field (buf, name, num, types, texts, options);
+   if (types != types_buf)
+   {
+      free (types);
+      free (texts);
+   }
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_write_entry_s()
+@INOUT      : buf
+@INPUT      : entry   - an entry, as returned by bt_parse_entry() and
+                        friends
+              options - may be NULL, for the defaults
+@DESCRIPTION: Appends an entry to `buf'.  The fields named in
+              options->field_order come first, in that order; the rest
+              follow in their original order.
+@CALLS      : bt_write_head(), bt_write_field(), bt_write_tail()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+void bt_write_entry_s (bt_buffer * buf, AST * entry, bt_write_options * options)
+{
+   bt_metatype  metatype;
+   AST *        field;
+   char *       name;
+   int          i;
+
+   if (options == NULL) options = &default_options;
+
+   metatype = bt_entry_metatype (entry);
+   bt_write_head (buf, metatype, bt_entry_type (entry),
+                  bt_entry_key (entry), options);
+
+   if (metatype == BTE_COMMENT || metatype == BTE_PREAMBLE)
+   {
+      write_ast_value (buf, NULL, entry, options);
+   }
+   else
+   {
+      for (i = 0; i < options->num_ordered; i++)
+      {
+         field = NULL;
+         while ((field = bt_next_field (entry, field, &name)))
+         {
+            if (strcmp (name, options->field_order[i]) == 0)
+               write_ast_value (buf, name, field, options);
+         }
+      }
+
+      field = NULL;
+      while ((field = bt_next_field (entry, field, &name)))
+      {
+         for (i = 0; i < options->num_ordered; i++)
+         {
+            if (strcmp (name, options->field_order[i]) == 0)
+               break;
+         }
+         if (i == options->num_ordered)
+            write_ast_value (buf, name, field, options);
+      }
+   }
+
+   bt_write_tail (buf, options);
+} /* bt_write_entry_s() */
+
+
+/* ------------------------------------------------------------------------
+@NAME       : bt_write_entry()
+@INPUT      : stream
+              entry
+              options - may be NULL, for the defaults
+@DESCRIPTION: Writes an entry to `stream', as bt_write_entry_s() would
+              to a buffer.
+@GLOBALS    : Buffer
+@CALLS      : bt_write_entry_s()
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+static bt_buffer Buffer;
+
+void bt_write_entry (FILE * stream, AST * entry, bt_write_options * options)
+{
+   Buffer.length = 0;
+   bt_write_entry_s (&Buffer, entry, options);
+   fwrite (Buffer.text, 1, Buffer.length, stream);
+   if (Buffer.size > 65536)             /* don't hang on to huge ones */
+      bt_free_buffer (&Buffer);
+}
@@ -6,16 +6,29 @@
 
 void postprocess (char *);
 
+int errors = 0;
+
 void postprocess (char * string)
 {
    char * buf;
+   int    len;
 
    buf = (char *) malloc (strlen(string) + 1);
    strcpy (buf, string);
-   bt_postprocess_string (buf, 0);
+   len = bt_postprocess_string (buf, 0);
    printf ("[%s] -> [%s] (no collapse)\n", string, buf);
-   bt_postprocess_string (buf, BTO_COLLAPSE);
+   if (len != (int) strlen (buf))
+   {
+      printf ("  wrong length returned: %d\n", len);
+      errors++;
+   }
+   len = bt_postprocess_string (buf, BTO_COLLAPSE);
    printf ("[%s] -> [%s] (collapse)\n", string, buf);
+   if (len != (int) strlen (buf))
+   {
+      printf ("  wrong length returned: %d\n", len);
+      errors++;
+   }
    free (buf);
 }
 
@@ -34,7 +47,12 @@ int main (void)
    postprocess ("   leading   and internal");   
    postprocess ("internal    and trailing   ");   
    postprocess ("    everything   at   once   ");
+   postprocess ("carriage\r\nreturn\r");
+   postprocess ("spaces \r around \r\r returns");
+   postprocess ("a rather long string without any double spaces in it");
+   postprocess ("a rather long string with a double space right  here");
+   postprocess ("abcdefg  hijklmn        opqrstuvwxyz                  ");
 
-   return 0;
+   return errors ? 1 : 0;
 }
    
@@ -13,8 +13,11 @@ int main (void)
    bt_tex_tree *
           tree;
    char * str;
+   int    i;
+   int    depth;
 
    line_num = 0;
+   tree = NULL;
    while (! feof (stdin))
    {
       if (fgets (line, 1024, stdin))
@@ -23,7 +26,7 @@ int main (void)
          if (line[len-1] == '\n') line[len-1] = '\0';
          line_num++;
 
-         tree = bt_build_tex_tree (line);
+         tree = bt_rebuild_tex_tree (tree, line);
 
          if (tree)
          {
@@ -35,8 +38,21 @@ int main (void)
             if (strcmp (line, str) != 0)
                printf ("uh-oh! line and str don't match!\n");
             free (str);
+
+            /* check the depth queries against simply counting braces */
+            depth = 0;
+            for (i = 0; line[i]; i++)
+            {
+               if (line[i] == '}') depth--;
+               if (bt_tex_depth (tree, i) != depth ||
+                   (bt_tex_span (tree, i) != NULL) !=
+                   (line[i] != '{' && line[i] != '}'))
+                  printf ("uh-oh! wrong depth or span at offset %d\n", i);
+               if (line[i] == '{') depth++;
+            }
          }
       }
    }
+   bt_free_tex_tree (&tree);
    return 0;
 }
@@ -18,7 +18,8 @@ use File::Path qw.mkpath.;
 use Cwd 'abs_path';
 
 my @EXTRA_FLAGS = ();
-my @BINARIES = qw(biblex bibparse dumpnames);
+my @BINARIES = qw(biblex bibparse btextract btindex btjson btmerge btquery
+                  dumpnames);
 
 ## debug
 ## @EXTRA_FLAGS = ('-g', "-DDEBUG=2");
@@ -82,9 +83,6 @@ sub ACTION_code {
     my $alloca_h = 'undef HAVE_ALLOCA_H';
     $alloca_h = 'define HAVE_ALLOCA_H 1' if Config::AutoConf->check_header("alloca.h");
 
-    my $vsnprintf = 'undef HAVE_VSNPRINTF';
-    $vsnprintf = 'define HAVE_VSNPRINTF 1' if Config::AutoConf->check_func('vsnprintf');
-
     my $strlcat = 'undef HAVE_STRLCAT';
     $strlcat = 'define HAVE_STRLCAT 1' if Config::AutoConf->check_func('strlcat');
 
@@ -94,10 +92,20 @@ sub ACTION_code {
                  FPACKAGE => "\"libbtparse $version\"",
                  VERSION  => "\"$version\"",
                  ALLOCA_H => $alloca_h,
-		 VSNPRINTF => $vsnprintf,
 		 STRLCAT => $strlcat
                 );
 
+    # the tables of TeX control sequences, for string_util.c and tex_unicode.c
+    my @tex_chars = map { "btparse/src/$_" } qw(gen_tex_chars.pl tex_chars.dat);
+    my @tex_headers = map { "btparse/src/$_" }
+                        qw(tex_chars.h tex_composed.h tex_fold.h);
+    unless ($self->up_to_date(\@tex_chars, \@tex_headers)) {
+        print "Creating new '@tex_headers' from '$tex_chars[1]'.\n";
+        $self->do_system($^X, @tex_chars, @tex_headers)
+          or die "Cannot create '@tex_headers'.\n";
+        unlink map { "btparse/src/$_.o" } qw(string_util tex_unicode);
+    }
+
 
     $self->dispatch("create_manpages");
     $self->dispatch("create_objects");
@@ -338,10 +346,20 @@ sub ACTION_create_library {
 
     print STDERR "\n** Creating libbtparse$LIBEXT\n";
 
-    my @modules = qw:init input bibtex err scan error
-                     lex_auxiliary parse_auxiliary bibtex_ast sym
-                     util postprocess macros traversal modify
-                     names tex_tree string_util format_name:;
+    # Lexical scanner: the hand-written one (scan_direct.c) by default,
+    # or the DLG-generated one (scan.c) with "perl Build.PL --lexer dlg"
+    my $lexer = $self->args('lexer') || 'direct';
+    die "Unknown lexer '$lexer' (use 'direct' or 'dlg')\n"
+      unless $lexer =~ /^(direct|dlg)$/;
+    my $scanner = $lexer eq 'dlg' ? 'scan' : 'scan_direct';
+    print STDERR "   (using the $lexer lexical scanner)\n";
+
+    my @modules = (qw:init input bibtex err:, $scanner,
+                   qw:error lex_auxiliary parse_auxiliary bibtex_ast sym
+                      util postprocess macros traversal modify
+                      names tex_tree string_util format_name dedup
+                      write crossref reader merge extract json hash_table
+                      tex_unicode index query:);
 
     my @objects = map { "btparse/src/$_.o" } @modules;
 
@@ -372,9 +390,90 @@ sub ACTION_create_library {
                              flatten => 1 );
 }
 
+sub ACTION_bench_programs {
+    my $self = shift;
+
+    $self->depends_on('code');
+
+    my $cbuilder   = $self->cbuilder;
+    my $libbuilder = $self->notes('libbuilder');
+    my $EXEEXT     = $libbuilder->{exeext};
+
+    print STDERR "\n** Creating benchmark binaries\n";
+    for my $prog (qw.gen_corpus bench.) {
+        my $source   = catfile("btparse","bench","$prog.c");
+        my $object   = catfile("btparse","bench","$prog.o");
+        my $exe_file = catfile("btparse","bench","$prog$EXEEXT");
+
+        if (!$self->up_to_date($source, $object)) {
+            $cbuilder->compile(object_file  => $object,
+                               extra_compiler_flags => [@EXTRA_FLAGS],
+                               source       => $source,
+                               include_dirs => ["btparse/src"]);
+        }
+        if (!$self->up_to_date($object, $exe_file)) {
+            $libbuilder->link_executable(exe_file => $exe_file,
+                                         extra_linker_flags => '-Lbtparse/src -lbtparse ',
+                                         objects => [$object]);
+        }
+    }
+}
+
+# Benchmarks of the Perl layers (bench/bench.pl), on a corpus made by
+# gen_corpus; options for bench.pl can be given with --args
+sub ACTION_perlbench {
+    my $self = shift;
+
+    $self->depends_on('bench_programs');
+
+    $self->_set_library_path;
+    my @args = split ' ', ($self->args('args') || '');
+    system($^X, (map { "-I" . catdir($self->blib, $_) } qw.lib arch.),
+           catfile("bench","bench.pl"), @args) == 0
+      or die "Benchmarks failed\n";
+}
+
+sub ACTION_bench {
+    my $self = shift;
+
+    $self->depends_on('bench_programs');
+
+    my $EXEEXT = $self->notes('libbuilder')->{exeext};
+
+    # The corpus is deterministic: it only needs making again if asked
+    # for a different size or seed (--entries, --seed).
+    my $corpus = catfile("btparse","bench","corpus.bib");
+    my $gen    = catfile("btparse","bench","gen_corpus$EXEEXT");
+    if (!$self->up_to_date($gen, $corpus)
+        || defined $self->args('entries') || defined $self->args('seed')) {
+        print STDERR "\n** Generating $corpus\n";
+        my @gen_args = ('-n', $self->args('entries') || 10000,
+                        '-s', $self->args('seed') || 1);
+        system($gen, @gen_args, $corpus) == 0
+          or die "Couldn't generate the benchmark corpus\n";
+    }
+
+    # Results go to stdout, one line of JSON per benchmark (--runs n,
+    # --only name,name... choose how often and which)
+    print STDERR "\n** Running benchmarks\n";
+    my @args = ('-r', $self->args('runs') || 3);
+    push @args, '-b', $self->args('only') if $self->args('only');
+    $self->_set_library_path;
+    system(catfile("btparse","bench","bench$EXEEXT"), @args, $corpus) == 0
+      or die "Benchmarks failed\n";
+}
+
 sub ACTION_test {
     my $self = shift;
 
+    $self->_set_library_path;
+    $self->SUPER::ACTION_test
+}
+
+# Lets the test and benchmark programs find the freshly built libbtparse
+sub _set_library_path {
+    my $self = shift;
+
     if ($^O =~ /darwin/i) {
         $ENV{DYLD_LIBRARY_PATH} = catdir($self->blib, "usrlib");
     }
@@ -398,7 +497,6 @@ sub ACTION_test {
         my $oldpath = $ENV{PATH};
         $ENV{PATH} = catdir($self->blib, "usrlib").";$oldpath";
     }
-    $self->SUPER::ACTION_test
 }
 
 
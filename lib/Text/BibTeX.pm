@@ -34,8 +34,12 @@ our $VERSION = '0.91';
                 nameparts => [qw(BTN_FIRST BTN_VON BTN_LAST BTN_JR BTN_NONE)],
                 joinmethods => [qw(BTJ_MAYTIE BTJ_SPACE 
                                    BTJ_FORCETIE BTJ_NOTHING)],
+                errclasses => [qw(BTERR_NOTIFY BTERR_CONTENT BTERR_LEXWARN
+                                  BTERR_USAGEWARN BTERR_LEXERR BTERR_SYNTAX
+                                  BTERR_USAGEERR BTERR_INTERNAL)],
                 subs      => [qw(bibloop split_list
-                                 purify_string change_case)],
+                                 purify_string change_case
+                                 tex_to_unicode)],
                 macrosubs => [qw(add_macro_text
                                  delete_macro
                                  delete_all_macros
@@ -46,36 +50,38 @@ our $VERSION = '0.91';
               @{$EXPORT_TAGS{'nodetypes'}},
               @{$EXPORT_TAGS{'nameparts'}},
               @{$EXPORT_TAGS{'joinmethods'}},
+              @{$EXPORT_TAGS{'errclasses'}},
               'check_class', 'display_list' );
 @EXPORT = @{$EXPORT_TAGS{'metatypes'}};
 
-use Encode 'encode', 'decode';
+use Encode 'decode';
 use Unicode::Normalize;
 
 
+# Decoding and normalization of UTF-8 results is done in one pass by
+# _decode_utf8 (in BibTeX.xs), which also tells us whether the string
+# could possibly change under normalization; most strings can't, and skip
+# Unicode::Normalize altogether.  Malformed input is left to Encode.
 sub _process_result {
   no strict 'refs';
   my ( $self, $result, $encoding, $norm ) = @_;
 
+  return $result unless $encoding eq "utf-8";
   $norm ||= "NFC"; # best to force it here.
-  my $normsub = \&{"$norm"}; # symbolic ref
-    if ( $encoding eq "utf-8" ) {
-        if ( utf8::is_utf8($result) ) {
-            return $normsub->($result);
-        }
-        else {
-            return $normsub->( decode( $encoding, $result ) );
-        }
-    }
-    else { return $result; }
-
+  my ( $string, $unnormal ) = _decode_utf8( $result, $norm );
+  if ( !defined $string ) {
+      $string = utf8::is_utf8($result) ? $result : decode( $encoding, $result );
+      $unnormal = 1;
+  }
+  return $unnormal ? &{"$norm"}($string) : $string; # symbolic ref
 }
 
 sub _process_argument {
     my ( $self, $value, $encoding ) = @_;
 
      if ( $encoding eq "utf-8" && utf8::is_utf8($value)) {
-         return encode( $encoding, $value );
+         utf8::encode( my $bytes = $value );
+         return $bytes;
      }
      else {
         return $value;
@@ -233,6 +239,16 @@ as defined by BibTeX itself: parses individual author names into
 Also specific to bibliographic data: puts split-up names (as parsed by
 the C<Name> class) back together in a custom way.
 
+=item C<Text::BibTeX::Dedup>
+
+Finds duplicate entries, within or across files, by their titles,
+authors and years.
+
+=item C<Text::BibTeX::Crossref>
+
+Resolves cross-references: entries inherit the fields of the entries
+named by their C<crossref> fields, as they are read.
+
 =back
 
 For a first time through the library, you'll probably want to confine
@@ -311,8 +327,9 @@ export tag C<metatypes>).  Thus, the following two lines are equivalent:
    use Text::BibTeX qw(:metatypes);
 
 Some of the various subroutines provided by the module are also
-exportable.  C<bibloop>, C<split_list>, C<purify_string>, and
-C<change_case> are all useful in everyday processing of BibTeX data, but
+exportable.  C<bibloop>, C<split_list>, C<purify_string>,
+C<change_case> and C<tex_to_unicode> are all useful in everyday
+processing of BibTeX data, but
 don't really fit anywhere in the class hierarchy.  They may be imported
 from C<Text::BibTeX> using the C<subs> export tag.  C<check_class> and
 C<display_list> are also exportable, but only by name; they are not
@@ -374,6 +391,15 @@ tell the C<NameFormat> class how to join adjacent tokens together; see
 L<Text::BibTeX::NameFormat> and L<bt_format_names>.  Export tag:
 C<joinmethods>.
 
+=item Error classes
+
+C<BTERR_NOTIFY>, C<BTERR_CONTENT>, C<BTERR_LEXWARN>, C<BTERR_USAGEWARN>,
+C<BTERR_LEXERR>, C<BTERR_SYNTAX>, C<BTERR_USAGEERR>, C<BTERR_INTERNAL>,
+in increasing order of severity: the first four are warnings, the rest
+errors.  The C<class> of each error returned by the C<Entry> class'
+C<errors> method is one of these values.  See also L<bt_errors>.
+Export tag: C<errclasses>.
+
 =back
 
 =head1 UTILITY FUNCTIONS
@@ -388,7 +414,7 @@ circumstances.
 
 =over 4
 
-=item bibloop (ACTION, FILES [, DEST])
+=item bibloop (ACTION, FILES [, DEST [, JOBS]])
 
 Loops over all entries in a set of BibTeX files, performing some
 caller-supplied action on each entry.  FILES should be a reference to
@@ -430,6 +456,13 @@ C<bibloop>:
 If the ACTION subroutine returns a true value and DEST was given, then
 the processed entry will be written to DEST.
 
+If JOBS is greater than 1, the files (and big files, in shards of
+consecutive entries) are processed by that many worker processes at
+once, using L<Text::BibTeX::Parallel>.  Whatever is written to DEST or
+printed by ACTION comes out in the same order as without JOBS; but
+ACTION runs in the worker processes, so it can't leave results behind in
+variables of the calling program.
+
 =cut
 
 # ----------------------------------------------------------------------
@@ -437,6 +470,7 @@ the processed entry will be written to DEST.
 # INPUT      : $action
 #              $files
 #              $dest
+#              $jobs
 # OUTPUT     : 
 # RETURNS    : 
 # DESCRIPTION: Loops over all entries in a set of files, calling
@@ -444,25 +478,51 @@ the processed entry will be written to DEST.
 # CREATED    : summer 1996 (in original Bibtex.pm module)
 # MODIFIED   : May 1997 (added to Text::BibTeX with revisions)
 #              Feb 1998 (simplified and documented)
+#              Oct 2026 (parallel processing with $jobs)
 # ----------------------------------------------------------------------
-sub bibloop (&$;$)
+sub bibloop (&$;$$)
 {
-   my ($action, $files, $dest) = @_;
+   my ($action, $files, $dest, $jobs) = @_;
+
+   if ($jobs && $jobs > 1)
+   {
+      require Text::BibTeX::Parallel;
+      my $output = $dest ? $dest->{'handle'} : \*STDOUT;
+      Text::BibTeX::Parallel::run
+         (files  => [splice (@$files)],
+          jobs   => $jobs,
+          output => $output,
+          work   => sub {
+             my ($file, $options) = @_;
+             $dest->{'handle'} = \*STDOUT if $dest;   # in the worker only
+             _loop_file ($action, Text::BibTeX::File->new ($file, $options),
+                         $dest);
+             return 0;
+          });
+      return;
+   }
 
    my $file;
    while ($file = shift @$files)
    {
-      my $bib = Text::BibTeX::File->new($file);
-      
-      while (! $bib->eof())
-      {
-         my $entry = Text::BibTeX::Entry->new($bib);
-         next unless $entry->parse_ok;
+      _loop_file ($action, Text::BibTeX::File->new($file), $dest);
+   }
+}
 
-         my $result = &$action ($entry);
-         $entry->write ($dest, 1)
-            if ($result && $dest)
-      }
+sub _loop_file
+{
+   my ($action, $bib, $dest) = @_;
+   my $entry;
+
+   # btparse reads the file itself, so $bib->eof() never becomes true:
+   # the end comes when there is no entry left to read
+   while ($entry = Text::BibTeX::Entry->new($bib))
+   {
+      next unless $entry->parse_ok;
+
+      my $result = &$action ($entry);
+      $entry->write ($dest, 1)
+         if ($result && $dest)
    }
 }
 
@@ -675,6 +735,27 @@ details; again, C<change_case> differs from the C interface in that
 STRING is not modified in-place---the input string is copied, and the
 transformed copy is returned.
 
+=item tex_to_unicode (STRING)
+
+Returns STRING with its TeX converted to plain Unicode text, in NFC:
+accented letters (C<{\"o}>, C<\'{e}>, C<\v c>), foreign letters
+(C<{\ss}>, C<\o>), other text symbols (C<\textendash>, C<\S>),
+escaped special characters, ligatures (C<-->, C<``>) and ties become the
+characters they stand for, braces are dropped, and so are font commands
+such as C<\emph> (but not their arguments).  Math (C<$...$>) and
+control sequences it doesn't know are left as they are.  A string of
+bytes is taken to be UTF-8 (as values are when read with the default
+C<binmode>); the result is a character string.  This is done in C, in
+one pass: see bt_tex_to_unicode() in L<bt_json>.
+
+=item fingerprint (TITLE, NAMES, YEAR)
+
+Returns the fingerprint of an entry with the given title, list of names
+and year (any of which may be C<undef>), for finding duplicate entries.
+See L<bt_dedup> for details, L<Text::BibTeX::Entry/fingerprint> for
+the easy way to get an entry's fingerprint, and
+L<Text::BibTeX::Dedup> for finding duplicates.
+
 =back
 
 =head2 Entry-parsing functions
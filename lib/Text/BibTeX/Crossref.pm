@@ -0,0 +1,181 @@
+# ----------------------------------------------------------------------
+# NAME       : BibTeX/Crossref.pm
+# CLASSES    : Text::BibTeX::Crossref
+# RELATIONS  :
+# DESCRIPTION: Resolves cross-references between entries, within or
+#              across files (the work is done by the bt_xref functions
+#              of the btparse library).
+# CREATED    : 2026/10/19
+# MODIFIED   :
+# VERSION    : $Id$
+# COPYRIGHT  : This file is part of the Text::BibTeX library.  This
+#              library is free software; you may redistribute it and/or
+#              modify it under the same terms as Perl itself.
+# ----------------------------------------------------------------------
+
+package Text::BibTeX::Crossref;
+
+use strict;
+use Carp;
+use IO::File;
+use vars qw($VERSION);
+$VERSION = '0.92';
+
+use Text::BibTeX;
+
+=head1 NAME
+
+Text::BibTeX::Crossref - resolve cross-references between BibTeX entries
+
+=head1 SYNOPSIS
+
+   use Text::BibTeX;
+   use Text::BibTeX::Crossref;
+
+   $xref = Text::BibTeX::Crossref->new (min_crossrefs => 2);
+   $xref->add_rule ('inproceedings', 'proceedings', 'title', 'booktitle');
+   $xref->index (@filenames);
+
+   $bibfile = Text::BibTeX::File->new ($filename, { crossrefs => $xref });
+   while ($entry = Text::BibTeX::Entry->new ($bibfile))
+   {
+      # $entry has inherited the fields of its crossref'd entry
+      ...
+   }
+
+   $count = $xref->children ($key);
+
+=head1 DESCRIPTION
+
+C<Text::BibTeX::Crossref> resolves C<crossref> fields: an entry with
+C<crossref = {key}> inherits every field it doesn't have from the entry
+with that key (and from that entry's own parent, if it has one).  It
+takes two passes over the files.  The first, C<index>, is done in C,
+without making any entry objects; it notes every entry's key and
+parent, and keeps the fields of the entries that are cross-referenced.
+The second is reading the files as usual, with the C<crossrefs> option
+of C<Text::BibTeX::File>: each entry is resolved as it is read.  So
+only the parents are ever held in memory, and the files can be as big
+as you like.  See L<bt_xref> for the details.
+
+Keys are matched without regard to case, as BibTeX does.  Entries that
+cross-reference an entry that doesn't exist, or whose cross-references
+go round in a circle, are left alone, with a warning.
+
+=head1 METHODS
+
+=over 4
+
+=item new ([OPTION =E<gt> VALUE, ...])
+
+Creates an empty index.  The options are C<min_crossrefs>, as BibTeX's
+C<-min-crossrefs> (default 2): entries whose parent has fewer children
+than that lose their C<crossref> field once they have inherited from
+it, since BibTeX wouldn't list the parent on its own; and C<rules>, a
+reference to a list of rules for C<add_rule> (each a reference to a
+list of its four arguments).
+
+=cut
+
+sub new
+{
+   my ($class, %options) = @_;
+
+   $class = ref ($class) || $class;
+   my $self = bless {}, $class;
+   $self->{_cstruct} = create ($options{min_crossrefs} || 0);
+   $self->add_rule (@$_) for @{ $options{rules} || [] };
+   $self;
+}
+
+
+sub DESTROY
+{
+   my $self = shift;
+   free ($self->{'_cstruct'})
+      if defined $self->{'_cstruct'};
+}
+
+
+=item add_rule (CHILD_TYPE, PARENT_TYPE, PARENT_FIELD, CHILD_FIELD)
+
+Adds a rule for inheriting fields: a parent of type PARENT_TYPE passes
+its field PARENT_FIELD to a child of type CHILD_TYPE as CHILD_FIELD (or
+not at all, if CHILD_FIELD is C<undef>).  Any of the first three may be
+C<'*'>, to match anything; a CHILD_FIELD of C<'*'> keeps the field's
+name.  The first rule that matches a field decides; fields no rule
+matches are inherited under their own names.  For example,
+
+   $xref->add_rule ('*', '*', 'title', undef);
+   $xref->add_rule ('*', '*', '*', undef);
+
+stop the title from being inherited, and then anything at all.
+
+=cut
+
+sub add_rule
+{
+   my ($self, @rule) = @_;
+
+   croak "add_rule: need four arguments" unless @rule == 4;
+   _add_rule ($self->{'_cstruct'}, @rule);
+}
+
+
+=item index (FILENAME, ...)
+
+The first pass: reads the given files, and notes their entries'
+cross-references, and copies the fields of the parents -- reading
+again any that came before their children -- so the second pass can
+use C<select_types>, C<projection> and the like without losing them.
+Files that cross-reference each other must all be indexed before any of
+them is read.  Returns the number of entries read; croaks if a file
+can't be opened.
+
+=cut
+
+sub index
+{
+   my ($self, @filenames) = @_;
+   my $count = 0;
+
+   for my $filename (@filenames)
+   {
+      my $fh = IO::File->new ($filename, '<')
+         or croak "couldn't open $filename: $!";
+      $count += _index_file ($self->{'_cstruct'}, $fh, $filename);
+      $fh->close;
+   }
+   $count;
+}
+
+
+=item children (KEY)
+
+Returns the number of entries that cross-reference KEY.
+
+=cut
+
+sub children
+{
+   my ($self, $key) = @_;
+
+   utf8::encode ($key) if utf8::is_utf8 ($key);
+   _children ($self->{'_cstruct'}, $key);
+}
+
+1;
+
+=back
+
+=head1 SEE ALSO
+
+L<bt_xref>, L<Text::BibTeX::File>, L<Text::BibTeX::Entry>
+
+=head1 COPYRIGHT
+
+This file is part of the Text::BibTeX library.  This library is free
+software; you may redistribute it and/or modify it under the same terms
+as Perl itself.
+
+=cut
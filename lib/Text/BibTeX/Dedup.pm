@@ -0,0 +1,196 @@
+# ----------------------------------------------------------------------
+# NAME       : BibTeX/Dedup.pm
+# CLASSES    : Text::BibTeX::Dedup
+# RELATIONS  :
+# DESCRIPTION: Finds duplicate entries, within or across files, by
+#              clustering their fingerprints (the work is done by the
+#              bt_dedup functions of the btparse library).
+# CREATED    : 2026/10/19
+# MODIFIED   :
+# VERSION    : $Id$
+# COPYRIGHT  : This file is part of the Text::BibTeX library.  This
+#              library is free software; you may redistribute it and/or
+#              modify it under the same terms as Perl itself.
+# ----------------------------------------------------------------------
+
+package Text::BibTeX::Dedup;
+
+use strict;
+use Carp;
+use vars qw($VERSION);
+$VERSION = '0.92';
+
+use Text::BibTeX;
+
+=head1 NAME
+
+Text::BibTeX::Dedup - find duplicate BibTeX entries
+
+=head1 SYNOPSIS
+
+   use Text::BibTeX;
+   use Text::BibTeX::Dedup;
+
+   $dedup = Text::BibTeX::Dedup->new (threshold => 0.8);
+
+   while ($entry = Text::BibTeX::Entry->new ($bibfile))
+   {
+      next unless $entry->parse_ok && $entry->metatype == BTE_REGULAR;
+      $id = $dedup->add ($entry);       # or: $dedup->add ($fingerprint)
+      $location[$id] = [$entry->key, $entry->line];
+   }
+
+   for $cluster ($dedup->clusters)
+   {
+      # @$cluster is a list of entry ids, first one first
+      ...
+   }
+
+   $similarity = $dedup->similarity ($id1, $id2);
+
+=head1 DESCRIPTION
+
+C<Text::BibTeX::Dedup> finds entries that describe the same work: those
+whose I<fingerprints> (made from their titles, the last names of their
+authors, and their years; see L<Text::BibTeX::Entry/fingerprint>) are
+the same, or similar enough.  Entries are added one at a time, and get
+numbered from 0 in the order they are added; every entry goes in a
+I<cluster> with all its duplicates.  Only about 550 to 900 bytes are
+kept per entry, so millions of entries, from any number of files, can be
+compared at once.  See L<bt_dedup> for how similarity is estimated, and
+what the parameters mean.
+
+=head1 METHODS
+
+=over 4
+
+=item new ([OPTION =E<gt> VALUE, ...])
+
+Creates an empty index.  The options are C<threshold>, the least
+similarity (from 0 to 1) for two entries to count as duplicates
+(default 0.7); and C<bands> and C<rows>, which tune how the candidate
+duplicates are found (defaults 10 and 4).
+
+=cut
+
+sub new
+{
+   my ($class, %options) = @_;
+
+   $class = ref ($class) || $class;
+   my $self = bless {}, $class;
+   $self->{_cstruct} = create ($options{bands} || 0, $options{rows} || 0,
+                               $options{threshold} || 0);
+   $self;
+}
+
+
+sub DESTROY
+{
+   my $self = shift;
+   free ($self->{'_cstruct'})
+      if defined $self->{'_cstruct'};
+}
+
+
+=item add (ENTRY)
+
+=item add (FINGERPRINT)
+
+Adds an entry to the index -- either a C<Text::BibTeX::Entry> object, or
+just its fingerprint -- and returns its id.
+
+=cut
+
+sub add
+{
+   my ($self, $entry) = @_;
+
+   $entry = $entry->fingerprint if ref $entry;
+   _add ($self->{'_cstruct'}, $entry);
+}
+
+
+=item count ()
+
+Returns the number of entries added.
+
+=cut
+
+sub count
+{
+   _count ($_[0]->{'_cstruct'});
+}
+
+
+=item cluster (ID)
+
+Returns the id of the first entry in the cluster of entry ID (which is
+ID itself, if the entry has no duplicates), or C<undef> if there is no
+such entry.  A later entry can still join two clusters into one.
+
+=cut
+
+sub cluster
+{
+   my ($self, $id) = @_;
+   my $first = _cluster ($self->{'_cstruct'}, $id);
+   return $first >= 0 ? $first : undef;
+}
+
+
+=item clusters ()
+
+Returns the clusters of more than one entry, as a list of references to
+lists of ids, in the order of their first entries.
+
+=cut
+
+sub clusters
+{
+   my $self = shift;
+   my ($index, $count, %members, @first);
+
+   $index = $self->{'_cstruct'};
+   $count = _count ($index);
+   for my $id (0 .. $count-1)
+   {
+      my $first = _cluster ($index, $id);
+      next if $first == $id;
+      push (@first, $first) unless $members{$first};
+      push (@{ $members{$first} ||= [$first] }, $id);
+   }
+   return map { $members{$_} } sort { $a <=> $b } @first;
+}
+
+
+=item similarity (ID1, ID2)
+
+Returns the estimated similarity of two entries' fingerprints: 1 if they
+are the same, and from 0 to just under 1 otherwise; or C<undef> if there
+is no such entry.
+
+=cut
+
+sub similarity
+{
+   my ($self, $id1, $id2) = @_;
+   my $similarity = _similarity ($self->{'_cstruct'}, $id1, $id2);
+   return $similarity >= 0 ? $similarity : undef;
+}
+
+1;
+
+=back
+
+=head1 SEE ALSO
+
+L<btdedup>, L<bt_dedup>, L<Text::BibTeX::Entry>
+
+=head1 COPYRIGHT
+
+This file is part of the Text::BibTeX library.  This library is free
+software; you may redistribute it and/or modify it under the same terms
+as Perl itself.
+
+=cut
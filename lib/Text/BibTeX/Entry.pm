@@ -197,6 +197,31 @@ Text::BibTeX::Entry->new(
 
 UTF-8 strings and you can customise the normalization with the NORMALIZATION option.
 
+=item QUIET
+
+If true, errors and warnings found while parsing the entry are not
+printed to C<stderr>; they are only available through the C<errors>
+method.
+
+=item CHECK_ONLY
+
+If true, the entry is only checked for lexical and syntax errors: its
+type, key and field names are available as usual, but field values are
+never built (they are all C<undef>), and macros are neither expanded nor
+defined.  This is a good deal faster than a full parse, and is meant for
+validating files (as B<btcheck> does with its C<-s> option).
+
+=item PROJECTION
+
+A reference to a list of field names.  If given, only these fields are
+kept from regular entries (C<@string> and other special entries are not
+affected); the values of other fields are skipped over by the lexer
+without being copied, which makes a big difference when large fields
+such as C<abstract> are not needed.
+
+   Text::BibTeX::Entry->new(
+      { projection => [qw(author title year)] }, $file);
+
 =back
 
 
@@ -223,6 +248,9 @@ sub new
    $self->{binmode} = 'utf-8'
           if exists $opts->{binmode} && $opts->{binmode} =~ /utf-?8/i;
    $self->{normalization} = $opts->{normalization} if exists $opts->{normalization};
+   $self->{quiet} = $opts->{quiet} if exists $opts->{quiet};
+   $self->{check_only} = $opts->{check_only} if exists $opts->{check_only};
+   $self->{projection} = $opts->{projection} if exists $opts->{projection};
 
    if (@source)
    {
@@ -313,7 +341,8 @@ sub read
    my $fh = $source->{'handle'};
    $self->{'file'} = $source;        # store File object for later use
    ## Propagate flags
-   for my $f (qw.binmode normalization.) {
+   for my $f (qw.binmode normalization quiet check_only projection
+                 select_types select_keys shard crossrefs query.) {
       $self->{$f} = $source->{$f} unless exists $self->{$f};
    }
    return $self->parse ($fn, $fh, $preserve);
@@ -340,10 +369,9 @@ errors, you'll usually get something resembling your input, but it's
 usually not wise to try to do anything with it.  Just call C<parse_ok>,
 and if it returns false then silently skip to the next entry.  (The
 error messages printed out by the parser should be quite adequate for
-the user to figure out what's wrong.  And no, there's currently no way
-for you to capture or redirect those error messages -- they're always
-printed to C<stderr> by the underlying C code.  That should change in
-future releases.)
+the user to figure out what's wrong.  They are printed to C<stderr> by
+the underlying C code, unless the C<quiet> option was given; either
+way, they are also available as data through the C<errors> method.)
 
 If no '@' signs are seen on the input before reaching end-of-file, then
 we've exhausted all the entries in the file, and C<parse> returns a
@@ -389,7 +417,12 @@ sub parse
 
    $preserve = $self->_preserve ($preserve);
    if (defined $filehandle) {
-      _parse ($self, $filename, $filehandle, $preserve);
+      _parse ($self, $filename, $filehandle, $preserve,
+              $self->{quiet} ? 1 : 0, $self->{check_only} ? 1 : 0,
+              $self->{projection},
+              $self->{select_types}, $self->{select_keys}, $self->{shard},
+              $self->{crossrefs} ? $self->{crossrefs}{_cstruct} : undef,
+              $self->{query} ? $self->{query}{_cstruct} : undef);
    } else {
       _reset_parse ();
    }
@@ -402,7 +435,9 @@ sub parse_s
 
    $preserve = $self->_preserve ($preserve);
    if (defined $text) {
-      _parse_s ($self, $text, $preserve);
+      _parse_s ($self, $text, $preserve,
+                $self->{quiet} ? 1 : 0, $self->{check_only} ? 1 : 0,
+                $self->{projection});
    } else {
       _reset_parse_s ();
    }
@@ -416,10 +451,26 @@ sub parse_s
 =item parse_ok ()
 
 Returns false if there were any serious errors encountered while parsing
-the entry.  (A "serious" error is a lexical or syntax error; currently,
-warnings such as "undefined macro" result in an error message being
-printed to C<stderr> for the user's edification, but no notice is
-available to the calling code.)
+the entry.  (A "serious" error is a lexical or syntax error; warnings
+such as "undefined macro" don't affect C<parse_ok>, but they can be
+found with C<errors>.)
+
+=item errors ()
+
+Returns the list of errors and warnings reported while parsing the
+entry, in order.  Each one is a hash reference with the following keys:
+C<class>, the error class (one of the C<BTERR_*> constants, exported
+with the C<errclasses> tag -- see L<Text::BibTeX>); C<message>, the
+text of the message; and, when they are known, C<filename>, C<line>,
+C<item_desc> and C<item> (eg. "name" and 2 for a warning about the
+second name in a list).  For example,
+
+   my $entry = Text::BibTeX::Entry->new ({ quiet => 1 }, $file);
+   for my $err ($entry->errors)
+   {
+      printf "%s:%d: %s\n", $err->{filename}, $err->{line}, $err->{message}
+         if $err->{class} >= BTERR_LEXERR;
+   }
 
 =item type ()
 
@@ -460,6 +511,8 @@ reference to the object's own list of fields.
 
 sub parse_ok   { shift->{'status'}; }
 
+sub errors     { @{ shift->{'errors'} || [] }; }
+
 sub metatype   {
     my $self = shift;
     Text::BibTeX->_process_result( $self->{'metatype'}, $self->{binmode}, $self->{normalization} );
@@ -704,6 +757,39 @@ sub names
    @names;
 }
 
+=item fingerprint ()
+
+Returns the entry's fingerprint, a normalized summary of its title, the
+last names of its authors (or editors), and its year, which is used to
+find duplicate entries.  For instance, an entry with
+
+   title  = {The {A}rt of {C}omputer {P}rogramming},
+   author = {Knuth, Donald E.},
+   year   = 1968
+
+has the fingerprint C<"the art of computer programming|knuth|1968">.  If there is no
+C<year>, the year is taken from the C<date> field (as in biblatex).  See
+L<bt_dedup> for the details, and L<Text::BibTeX::Dedup> for finding the
+duplicates.
+
+=cut
+
+sub fingerprint
+{
+   my $self = shift;
+   my ($value, @fields);
+
+   # the first field of each pair that's there (with preserved values,
+   # the text of their pieces, with macros unexpanded)
+   for my $pair (['title'], ['author', 'editor'], ['year', 'date'])
+   {
+      ($value) = grep { defined } @{$self->{'values'}}{@$pair};
+      $value = join ('', map { $_->text } $value->values) if ref $value;
+      push (@fields, $value);
+   }
+   Text::BibTeX::fingerprint (@fields);
+}
+
 =back
 
 =head2 Entry modification methods
@@ -845,114 +931,87 @@ sub set_fieldlist
 
 =over 4
 
-=item write (BIBFILE)
+=item write (BIBFILE [, OPTIONS])
 
 Prints a BibTeX entry on the filehandle associated with BIBFILE (which
-should be a C<Text::BibTeX::File> object, opened for output).  Currently
-the printout is not particularly human-friendly; a highly configurable
-pretty-printer will be developed eventually.
+should be a C<Text::BibTeX::File> object, opened for output).  OPTIONS
+is as for C<print_s>.
+
+=item print ([FILEHANDLE [, OPTIONS]])
+
+Prints a BibTeX entry on FILEHANDLE (default C<STDOUT>).  OPTIONS is as
+for C<print_s>.
+
+=item print_s ([OPTIONS])
+
+Prints a BibTeX entry to a string, which is the return value.  By
+default, fields are indented by two spaces, and strings are put in
+braces; OPTIONS, a hash reference, changes that:
+
+=over 4
 
-=item print (FILEHANDLE)
+=item quote
 
-Prints a BibTeX entry on FILEHANDLE.
+C<braces> (the default), C<quotes> (double quotes, except for strings
+with a double quote of their own, which are still braced), or C<bare>
+(no quoting at all, which is no longer BibTeX, but can be handy for
+printing values).  Numbers and macros are never quoted.
 
-=item print_s ()
+=item indent
 
-Prints a BibTeX entry to a string, which is the return value.
+The string to put before each field name (default two spaces).
+
+=item align
+
+Field names shorter than this are padded with spaces, so that the
+C<=> signs line up.
+
+=item order
+
+A reference to a list of field names: the fields to print first, in
+that order.  The rest follow in their usual order.
+
+=back
+
+The work is done by the C<bt_write> functions of the btparse library
+(see L<bt_write>), which are also used by the B<bibparse> program.
 
 =cut
 
 sub write
 {
-   my ($self, $bibfile) = @_;
+   my ($self, $bibfile, $options) = @_;
 
    my $fh = $bibfile->{'handle'};
-   $self->print ($fh);
+   $self->print ($fh, $options);
 }
 
 sub print
 {
-   my ($self, $handle) = @_;
+   my ($self, $handle, $options) = @_;
 
    $handle ||= \*STDOUT;
-   print $handle $self->print_s;
+   print $handle $self->print_s ($options);
 }
 
 sub print_s
 {
-   my $self = shift;
-   my ($field, $output);
-
-   sub value_to_string
-   {
-      my $value = shift;
-
-      if (! ref $value)                 # just a string
-      {
-         return "{$value}";
-      }
-      else                              # a Text::BibTeX::Value object
-      {
-         confess "value is a reference, but not to Text::BibTeX::Value object"
-            unless $value->isa ('Text::BibTeX::Value');
-         my @values = $value->values;
-         foreach (@values)
-         {
-            $_ = $_->type == &BTAST_STRING ? '{' . $_->text . '}' : $_->text;
-         }
-         return join (' # ', @values);
-     }
-   }
+   my ($self, $options) = @_;
 
    carp "entry type undefined" unless defined $self->{'type'};
    carp "entry metatype undefined" unless defined $self->{'metatype'};
-
-   # Regular and macro-def entries have to be treated differently when
-   # printing the first line, because the former have keys and the latter
-   # do not.
-   if ($self->{'metatype'} == &BTE_REGULAR)
+   if (defined $self->{'metatype'} && $self->{'metatype'} == &BTE_REGULAR)
    {
       carp "entry key undefined" unless defined $self->{'key'};
-      $output = sprintf ("@%s{%s,\n",
-                         $self->{'type'} || '',
-                         $self->{'key'}  || '');
-   }
-   elsif ($self->{'metatype'} == &BTE_MACRODEF)
-   {
-      $output = sprintf ("@%s{\n",
-                         $self->{'type'} || '');
-   }
-
-   # Comment and preamble entries are treated the same -- we print out
-   # the entire entry, on one line, right here.
-   else                                 # comment or preamble
-   {
-      return sprintf ("@%s{%s}\n\n",
-                      $self->{'type'},
-                      value_to_string ($self->{'value'}));
    }
-
-   # Here we print out all the fields/values of a regular or macro-def entry
-   my @fields = @{$self->{'fields'}};
-   while ($field = shift @fields)
+   if ($self->{'fields'})
    {
-      my $value = $self->{'values'}{$field};
-      if (! defined $value)
-      {
-         carp "field \"$field\" has undefined value\n";
-         $value = '';
-      }
-
-      $output .= "  $field = ";
-      $output .= value_to_string ($value);
-
-      $output .= ",\n";
+      carp "field \"$_\" has undefined value\n"
+         foreach grep { ! defined $self->{'values'}{$_} } @{$self->{'fields'}};
    }
 
-   # Tack on the last line, and we're done!
-   $output .= "}\n\n";
-   
-   Text::BibTeX->_process_result($output, $self->{binmode}, $self->{normalization});
+   Text::BibTeX->_process_result(_write ($self, $options),
+                                 $self->{binmode}, $self->{normalization});
 }
 
 =back
@@ -111,6 +111,82 @@ of macros being redefined.
 This option can be used to force Text::BibTeX to clean up all macros definitions
 (except for the month macros).
 
+=item QUIET
+
+If true, errors and warnings found while parsing entries from the file
+are not printed to C<stderr>.  They are still available from each
+entry's C<errors> method (see L<Text::BibTeX::Entry>).
+
+=item CHECK_ONLY
+
+If true, entries read from the file are only checked for errors, and
+their values are not built; see the C<CHECK_ONLY> option of
+L<Text::BibTeX::Entry>.
+
+=item PROJECTION
+
+A reference to a list of the field names wanted from the regular entries
+in the file; other fields are skipped without being copied or processed.
+See the C<PROJECTION> option of L<Text::BibTeX::Entry>.
+
+=item SELECT_TYPES
+
+=item SELECT_KEYS
+
+References to lists of entry types (in any case) and keys.  If given,
+only the regular entries with one of these types, and/or one of these
+keys, are read from the file: as soon as the type and key of an entry
+have been seen, the rest of an unwanted entry is skipped by the lexer,
+and no C<Text::BibTeX::Entry> object is ever made for it.  Other entries
+(C<@string>, C<@preamble> and C<@comment>) are always read.
+
+   my $articles = Text::BibTeX::File->new ($filename,
+                      { select_types => ['article'] });
+
+=item SHARD
+
+A reference to a list C<[START, END, LINE, STRINGS]>: only the entries
+that start at byte offset START of the file or later, and before END,
+are read (if END is undefined, up to the end of the file).  START must
+be where an entry starts, and LINE (by default 1) is the line it starts
+on, so that line numbers in messages are those of the whole file.
+STRINGS is a reference to a list of the texts of the C<@string> entries
+before START, if any: they are parsed (quietly) when the file is
+opened, so that macros are defined as they would be when reading the
+whole file.  Nothing outside the shard is read at all.  This is how
+L<Text::BibTeX::Parallel> has several processes work through one big
+file.
+
+=item CROSSREFS
+
+A C<Text::BibTeX::Crossref> object that has indexed this file (and any
+others it cross-references): entries read from the file inherit the
+fields of the entries they cross-reference.  See
+L<Text::BibTeX::Crossref>.
+
+=item QUERY
+
+A query on the fields of the regular entries: only the ones that match
+it are read from the file.
+
+   my $recent = Text::BibTeX::File->new ($filename,
+       { query => 'type=article and year>=2015 and author~"Knuth"' });
+
+Comparisons (C<=>, C<!=>, C<E<lt>>, C<E<lt>=>, C<E<gt>>, C<E<gt>=>, and
+C<~> for "contains") of a field (or C<type> or C<key>) with a word or a
+quoted string are joined by C<and>, C<or> and C<not>, and grouped with
+parentheses; a field name alone asks whether an entry has the field.
+Values are compared without TeX or case, and as numbers if the query's
+value is a number; C<author=knuth> matches an entry with Knuth (or
+"von" and last names C<knuth>) among its authors.  See L<bt_query> for
+the details.
+
+Entries are matched in C, after inheriting any crossref'ed fields (see
+C<CROSSREFS>); the ones that don't match never become
+C<Text::BibTeX::Entry> objects, and their messages are suppressed.
+With C<PROJECTION>, the fields the query looks at are read too.  A query
+with a syntax error is warned about, and makes C<open> croak.
+
 =back 
 
 =item close ()
@@ -152,12 +228,46 @@ sub open {
         $self->{binmode} = 'utf-8'
             if exists $opts->{binmode} && $opts->{binmode} =~ /utf-?8/i;
         $self->{normalization} = $opts->{normalization} if exists $opts->{normalization};
+        $self->{quiet} = $opts->{quiet} if exists $opts->{quiet};
+        $self->{check_only} = $opts->{check_only} if exists $opts->{check_only};
+        $self->{projection} = $opts->{projection} if exists $opts->{projection};
+        $self->{crossrefs} = $opts->{crossrefs} if exists $opts->{crossrefs};
+        if (exists $opts->{query}) {
+            # the C code sees queries as bytes, as it does keys
+            my $text = $opts->{query};
+            utf8::encode ($text) if utf8::is_utf8 ($text);
+            my $query = _query_new ($text);
+            croak "Text::BibTeX::File::open: bad query \"$opts->{query}\""
+                unless defined $query;
+            $self->{query} = bless { _cstruct => $query },
+                                   'Text::BibTeX::File::Query';
+        }
+        $self->{select_types} = { map { lc $_ => 1 } @{ $opts->{select_types} } }
+            if exists $opts->{select_types};
+        if (exists $opts->{select_keys}) {
+            # the C code sees keys as bytes
+            $self->{select_keys} = {
+                map { my $k = $_; utf8::encode ($k) if utf8::is_utf8 ($k); ($k => 1) }
+                @{ $opts->{select_keys} } };
+        }
+
+        if (exists $opts->{shard}) {
+            my ($start, $end, $line) = @{ $opts->{shard} };
+            $self->{shard} = [ $start || 0, defined $end ? $end : -1,
+                               $line || 1 ];
+        }
 
         if (exists $opts->{reset_macros} && $opts->{reset_macros}) {
           Text::BibTeX::delete_all_macros();
           Text::BibTeX::_define_months();
         }
 
+        # the macros defined before the shard
+        if ($self->{shard} && $opts->{shard}[3]) {
+            Text::BibTeX::Entry->new ({ quiet => 1 }, $_)
+                for @{ $opts->{shard}[3] };
+        }
+
         if ( exists $opts->{mode} ) {
             push @args, $opts->{mode};
             push @args, $opts->{perms} if exists $opts->{perms};
@@ -176,6 +286,7 @@ sub close
 {
    my $self = shift;
    if ( $self->{handle} ) {
+      _close_shard ($self->{shard}) if $self->{shard};
       Text::BibTeX::Entry->new ($self->{filename}, undef);   # resets parser
       $self->{handle}->close;
    }
@@ -248,6 +359,77 @@ sub preserve_values
 }
 
 
+=head2 Exporting
+
+=over 4
+
+=item to_json (FILEHANDLE [, OPTS])
+
+Reads the rest of the file, writing its entries to FILEHANDLE as JSON.
+They are converted in C as they are parsed, without becoming
+C<Text::BibTeX::Entry> objects, so a whole file is never held in
+memory.  OPTS is a hash reference:
+
+=over 4
+
+=item CSL
+
+If true, the regular entries are written as a CSL-JSON array, with
+their types and fields mapped to CSL's and their names split into
+family and given names (see L<bt_json>).  Otherwise, every entry is
+written as an object on a line of its own (JSON Lines), with all its
+fields.
+
+=item UNICODE
+
+If true, the TeX in strings (accents, special letters, dashes, and
+so on) is converted to Unicode.
+
+=back
+
+The C<CROSSREFS> option of the file is honoured.  Returns the number of
+entries written.
+
+=back
+
+=cut
+
+sub to_json
+{
+   my ($self, $out, $opts) = @_;
+   my (%opts, $json, $count);
+
+   $opts ||= {};
+   %opts = map { (lc $_ => $opts->{$_}) } keys %$opts;
+   $count = 0;
+   while (defined ($json = _json ($self->{filename}, $self->{handle},
+                                  $opts{csl} ? 1 : 0, $opts{unicode} ? 1 : 0,
+                                  $self->{crossrefs}
+                                     ? $self->{crossrefs}{_cstruct} : undef)))
+   {
+      $json = Text::BibTeX->_process_result ($json, $self->{binmode},
+                                             $self->{normalization});
+      print $out ($opts{csl} ? ($count ? ",\n" : "[\n") : ""), $json,
+                 ($opts{csl} ? "" : "\n");
+      $count++;
+   }
+   print $out ($count ? "\n]\n" : "[]\n") if $opts{csl};
+   $count;
+}
+
+
+# A compiled query (see the QUERY option), freed with the last file or
+# entry that holds it
+package Text::BibTeX::File::Query;
+
+sub DESTROY
+{
+   my $self = shift;
+   Text::BibTeX::File::_query_free ($self->{_cstruct})
+      if defined $self->{_cstruct};
+}
+
+
 1;
 
 =head1 SEE ALSO
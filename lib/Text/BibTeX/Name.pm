@@ -407,6 +407,48 @@ sub format
    $format->apply ($self);
 }
 
+=back
+
+=head2 The name cache
+
+The same names turn up again and again in a big bibliography, so split
+names are kept in a cache, by the exact bytes of the name (the C<BINMODE>
+and C<NORMALIZATION> of a name object only matter when its parts are
+returned, so objects with different options share the cache).  A name
+found there isn't split again, and its C<Text::BibTeX::Name> objects
+share its split form.  The cache holds a fixed number of names (4096 to
+start with); when it is full, names that haven't been asked for again
+lately are dropped.  Names that cause warnings aren't kept, so every
+occurrence is warned about.  See L<bt_split_names>.
+
+=over 4
+
+=item set_cache (SIZE)
+
+Class method: empties the cache, and sets the number of names it holds;
+0 turns it off.
+
+   Text::BibTeX::Name->set_cache (100_000);
+
+=item cache_stats ()
+
+Class method: returns the number of names found in the cache, and the
+number not found (and so split), since it was last set.
+
+=cut
+
+sub set_cache
+{
+   my ($class, $size) = @_;
+
+   _set_cache ($size || 0);
+}
+
+sub cache_stats
+{
+   _cache_stats ();
+}
+
 1;
 
 =back
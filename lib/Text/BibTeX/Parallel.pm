@@ -0,0 +1,301 @@
+# ----------------------------------------------------------------------
+# NAME       : Text::BibTeX::Parallel
+# CLASSES    :
+# RELATIONS  :
+# DESCRIPTION: Runs the processing of a set of BibTeX files in several
+#              worker processes -- one file, or one shard of a big file,
+#              per worker -- and merges their output in source order.
+# CREATED    : 2026/10/19
+# MODIFIED   :
+# VERSION    : $Id$
+# COPYRIGHT  : This file is part of the Text::BibTeX library.  This
+#              library is free software; you may redistribute it and/or
+#              modify it under the same terms as Perl itself.
+# ----------------------------------------------------------------------
+
+package Text::BibTeX::Parallel;
+
+use strict;
+use Carp;
+use IO::Handle;
+use File::Temp ();
+use POSIX ();
+
+use vars qw($VERSION);
+$VERSION = '0.92';
+
+=head1 NAME
+
+Text::BibTeX::Parallel - process BibTeX files in parallel
+
+=head1 SYNOPSIS
+
+   use Text::BibTeX;
+   use Text::BibTeX::Parallel;
+
+   $status = Text::BibTeX::Parallel::run
+      (files => \@filenames,
+       jobs  => 4,
+       work  => sub {
+          my ($filename, $options) = @_;
+          my $bib = Text::BibTeX::File->new ($filename, $options);
+          while (my $entry = Text::BibTeX::Entry->new ($bib)) {
+             # ... print to STDOUT, warn to STDERR ...
+          }
+          return 0;                     # exit status
+       });
+
+=head1 DESCRIPTION
+
+C<Text::BibTeX::Parallel> spreads work on a list of BibTeX files over a
+number of worker processes.  Each file is a separate I<task>; and a big
+file is split into several tasks, each of which reads one I<shard> of
+it: a run of consecutive entries, between two byte offsets (see the
+C<SHARD> option of L<Text::BibTeX::File>).  Where the shards start is
+found by a single quick pass over the file, which parses nothing; each
+worker then seeks straight to its shard, and reads nothing else but the
+C<@string> entries before it, which are handed to it so that macros are
+defined just as they would be when reading the whole file.  Line
+numbers in messages are those of the whole file.
+
+Everything a task prints, to C<STDOUT> and to C<STDERR> (including the
+messages of the B<btparse> library), is held until all the tasks before
+it have finished, so that the output comes out in exactly the order it
+would have without parallelism.
+
+Since each task runs in a process of its own, anything it changes in
+memory is lost when it ends: the results of a task must be printed.
+
+=head1 FUNCTIONS
+
+=over 4
+
+=item run (OPTIONS)
+
+Runs a task for each file (or shard), and returns the highest exit
+status of any of them.  OPTIONS are given as a list of key/value pairs:
+
+=over 4
+
+=item files
+
+Reference to the list of files to process.
+
+=item work
+
+Reference to the subroutine to run for each task.  It is called with
+the filename and a reference to a hash of options to pass to
+C<Text::BibTeX::File::new> (possibly along with options of its own):
+these select the shard of the task, if any, and provide a list
+C<preceding_keys> holding the keys of the regular entries before the
+shard (which C<Text::BibTeX::File> ignores).  Its return value is the exit status of
+the task; it is 255 if the subroutine dies.
+
+=item jobs
+
+The number of worker processes to run at once (default 1).
+
+=item output
+
+The filehandle where the standard output of the tasks goes; by default,
+C<STDOUT>.
+
+=item collect
+
+Reference to a subroutine that reads the standard output of the tasks,
+instead of having it copied to C<output>: it is called with a
+filehandle open on the output of each task in turn, in order, as soon as
+the task and all the ones before it have finished.  This is the way to
+gather the results of the tasks in the main process while the later
+ones are still running.
+
+=item min_shard
+
+Files are only split into shards of at least this many bytes (default
+1 MB); smaller files are one task each.
+
+=back
+
+=back
+
+=cut
+
+# ----------------------------------------------------------------------
+# NAME       : plan_tasks
+# INPUT      : $files     - ref to list of filenames
+#              $jobs      - number of worker processes
+#              $min_shard - minimum size of a shard, in bytes
+# RETURNS    : list of tasks, as hash refs with a filename and a hash
+#              of File options
+# DESCRIPTION: Splits the files big enough to keep several workers busy
+#              into shards of roughly equal sizes.
+# CREATED    : 2026/10/19
+# ----------------------------------------------------------------------
+sub plan_tasks
+{
+   my ($files, $jobs, $min_shard) = @_;
+   my @tasks;
+
+   for my $file (@$files)
+   {
+      my $size = -s $file || 0;
+      my $shards = int ($size / $min_shard);
+      $shards = $jobs if $shards > $jobs;
+
+      if ($shards < 2)
+      {
+         push (@tasks, { file => $file, options => {} });
+         next;
+      }
+
+      # each cut is [offset, line, strings, keys], with the @string
+      # entries and the keys since the cut before
+      my @cuts = @{ Text::BibTeX::File::_plan_shards ($file, $size, $shards) };
+      unless (@cuts)
+      {
+         push (@tasks, { file => $file, options => {} });
+         next;
+      }
+
+      my ($start, $line, @strings, @keys) = (0, 1);
+      for my $cut (@cuts, undef)
+      {
+         my $end = $cut ? $cut->[0] : undef;
+         push (@tasks, { file => $file,
+                         options => { shard => [$start, $end, $line,
+                                                [@strings]],
+                                      preceding_keys => [@keys] } });
+         last unless $cut;
+         ($start, $line) = @$cut;
+         push (@strings, @{ $cut->[2] });
+         push (@keys, @{ $cut->[3] });
+      }
+   }
+   return @tasks;
+}
+
+
+# ----------------------------------------------------------------------
+# NAME       : start_task
+# INPUT      : $task
+#              $work - the caller's subroutine
+# RETURNS    : process id of the worker
+# DESCRIPTION: Forks a worker with its standard output and error going
+#              to temporary files, and runs the task in it.
+# CREATED    : 2026/10/19
+# ----------------------------------------------------------------------
+sub start_task
+{
+   my ($task, $work) = @_;
+
+   $task->{stdout} = File::Temp->new;
+   $task->{stderr} = File::Temp->new;
+   STDOUT->flush;
+   STDERR->flush;
+
+   my $pid = fork;
+   croak "Text::BibTeX::Parallel: can't fork: $!" unless defined $pid;
+   return $pid if $pid;
+
+   # In the worker: no returning from here, and no destructors (which
+   # would remove the parent's temporary files) on the way out.
+   my $status = 255;
+   if (open (STDOUT, '>&', $task->{stdout}) &&
+       open (STDERR, '>&', $task->{stderr}))
+   {
+      STDERR->autoflush (1);
+      $status = eval { $work->($task->{file}, $task->{options}) || 0 };
+      unless (defined $status)
+      {
+         print STDERR $@;
+         $status = 255;
+      }
+   }
+   close (STDOUT);
+   close (STDERR);
+   POSIX::_exit ($status);
+}
+
+
+# ----------------------------------------------------------------------
+# NAME       : copy_output
+# INPUT      : $from - temporary file written by a worker
+#              $to   - filehandle
+# DESCRIPTION: Copies everything the worker wrote to $to.
+# CREATED    : 2026/10/19
+# ----------------------------------------------------------------------
+sub copy_output
+{
+   my ($from, $to) = @_;
+   my $buf;
+
+   seek ($from, 0, 0);
+   print $to $buf while (read ($from, $buf, 65536));
+   close ($from);
+}
+
+
+sub run
+{
+   my (%args) = @_;
+
+   my $work = $args{work} or croak "Text::BibTeX::Parallel::run: no work";
+   my $jobs = $args{jobs} || 1;
+   my $output = $args{output} || \*STDOUT;
+   my @tasks = plan_tasks ($args{files} || [], $jobs,
+                           $args{min_shard} || 1024*1024);
+
+   my (%running, $started, $finished);
+   my $status = 0;
+
+   $started = $finished = 0;
+   while ($finished < @tasks)
+   {
+      while ($started < @tasks && keys %running < $jobs)
+      {
+         my $task = $tasks[$started++];
+         $running{start_task ($task, $work)} = $task;
+      }
+
+      my $pid = waitpid (-1, 0);
+      croak "Text::BibTeX::Parallel: lost track of workers" if $pid < 0;
+      my $task = delete $running{$pid} or next;
+      $task->{status} = ($? & 127) ? 255 : ($? >> 8);
+
+      # Pass on the output of every finished task that isn't waiting
+      # for an earlier one.
+      while ($finished < @tasks && defined $tasks[$finished]{status})
+      {
+         $task = $tasks[$finished++];
+         if ($args{collect})
+         {
+            seek ($task->{stdout}, 0, 0);
+            $args{collect}->($task->{stdout});
+            close ($task->{stdout});
+         }
+         else
+         {
+            copy_output ($task->{stdout}, $output);
+         }
+         copy_output ($task->{stderr}, \*STDERR);
+         delete @{$task}{qw(stdout stderr)};
+         $status = $task->{status} if $task->{status} > $status;
+      }
+   }
+   eval { $output->flush };
+   return $status;
+}
+
+1;
+
+=head1 SEE ALSO
+
+L<Text::BibTeX>, L<Text::BibTeX::File>, L<btcheck>, L<btformat>
+
+=head1 COPYRIGHT
+
+This file is part of the Text::BibTeX library.  This library is free
+software; you may redistribute it and/or modify it under the same terms
+as Perl itself.
+
+=cut
@@ -0,0 +1,131 @@
+# -*- cperl -*-
+use strict;
+use warnings;
+
+use IO::Handle;
+use Test::More tests => 33;
+
+use vars qw($DEBUG);
+use Cwd;
+BEGIN {
+    use_ok('Text::BibTeX');
+    use_ok('Text::BibTeX::Crossref');
+    my $common = getcwd()."/t/common.pl";
+    require $common;
+}
+
+#
+# crossref.t
+#
+# Text::BibTeX test program -- resolving crossref fields.
+#
+
+$DEBUG = 1;
+
+my ($xref, $bibfile, $entry, %entries, @warnings);
+
+sub read_entries
+{
+   my %options = @_;
+   my %entries;
+
+   $xref = Text::BibTeX::Crossref->new (%options);
+   is ($xref->index ('t/crossref.bib'), 10);
+   $bibfile = Text::BibTeX::File->new ('t/crossref.bib',
+                                       { crossrefs => $xref, quiet => 1 });
+   while ($entry = Text::BibTeX::Entry->new ($bibfile))
+   {
+      $entries{$entry->key} = $entry if $entry->key;
+   }
+   %entries;
+}
+
+%entries = read_entries ();
+
+# keys are matched in any case; the parent's own parent is inherited from
+$entry = $entries{paper1};
+is ($entry->get ('title'), 'First Paper');
+is ($entry->get ('publisher'), 'ACM Press');
+is ($entry->get ('editor'), 'Dan Green');
+is ($entry->get ('series'), 'Lecture Notes');
+is ($entry->get ('crossref'), 'Proc99');          # two children: kept
+is_deeply ([$entry->fieldlist],
+           [qw(author title pages crossref editor publisher year series
+               address)]);
+is ($entries{paper2}->get ('year'), '2000');
+
+# only one child: the crossref field goes
+$entry = $entries{chapter};
+is ($entry->get ('title'), 'A Book');
+ok (! $entry->exists ('crossref'));
+is ($xref->children ('BOOK'), 1);
+is ($xref->children ('proc99'), 2);
+is ($xref->children ('paper1'), 0);
+
+# missing parents and cycles
+ok (! $entries{orphan}->exists ('publisher'));
+like (($entries{orphan}->errors)[0]->{message},
+      qr/crossref to undefined entry "nowhere"/);
+ok (! $entries{loop1}->exists ('note'));
+like (($entries{loop2}->errors)[0]->{message}, qr/crossref cycle/);
+
+# rules
+%entries = read_entries
+   (min_crossrefs => 1,
+    rules => [['inproceedings', 'proceedings', 'title', 'booktitle'],
+              ['*', '*', 'address', undef]]);
+$entry = $entries{paper1};
+is ($entry->get ('title'), 'First Paper');
+is ($entry->get ('booktitle'), 'Proceedings of the Conference');
+ok (! $entry->exists ('address'));
+ok ($entries{chapter}->exists ('crossref'));
+
+%entries = read_entries (min_crossrefs => 100,
+                         rules => [['*', '*', 'year', '*'],
+                                   ['*', '*', '*', undef]]);
+is_deeply ([$entries{paper1}->fieldlist], [qw(author title pages year)]);
+
+# parents that come before their children are read again at the end of
+# the first pass, so they needn't be read in the second
+my $early = 't/crossref-early.bib';
+my $parents = 't/crossref-parents.bib';
+END { unlink $early, $parents }
+open (BIB, ">$early") || die "couldn't create $early: $!\n";
+print BIB <<'BIB';
+@proceedings{conf, title = {Early Proceedings}, year = 2001}
+@inproceedings{talk, title = {A Talk}, crossref = {conf}}
+@inproceedings{talk2, title = {Another}, crossref = {conf}}
+BIB
+close (BIB);
+
+sub read_early
+{
+   my ($files, $options) = @_;
+   my %entries;
+
+   $xref = Text::BibTeX::Crossref->new;
+   $xref->index (@$files);
+   $bibfile = Text::BibTeX::File->new ($files->[-1],
+                                       { crossrefs => $xref, %$options });
+   while ($entry = Text::BibTeX::Entry->new ($bibfile))
+   {
+      $entries{$entry->key} = $entry;
+   }
+   %entries;
+}
+
+%entries = read_early ([$early], { select_types => ['inproceedings'] });
+ok (! exists $entries{conf}, 'parent not read');
+is ($entries{talk}->get ('year'), '2001', '... but inherited from');
+is_deeply ([$entries{talk}->errors], []);
+%entries = read_early ([$early], { projection => ['title', 'crossref'] });
+is ($entries{talk}->get ('year'), '2001', 'parent\'s fields not projected');
+is ($entries{conf}->get ('year'), undef);
+
+# ... and so are parents in an earlier file
+open (BIB, ">$parents") || die "couldn't create $parents: $!\n";
+print BIB "\@proceedings{conf, title = {Earlier}, year = 2002}\n";
+close (BIB);
+%entries = read_early ([$parents, $early], {});
+is ($entries{talk}->get ('year'), '2002', 'the first definition wins');
+is ($xref->children ('conf'), 2);
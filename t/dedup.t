@@ -0,0 +1,108 @@
+# -*- cperl -*-
+use strict;
+use warnings;
+
+use IO::Handle;
+use Test::More tests => 28;
+
+use vars qw($DEBUG);
+use Cwd;
+BEGIN {
+    use_ok('Text::BibTeX', ':metatypes');
+    use_ok('Text::BibTeX::Dedup');
+    my $common = getcwd()."/t/common.pl";
+    require $common;
+}
+
+#
+# dedup.t
+#
+# Text::BibTeX test program -- fingerprints of entries, and finding
+# duplicates with them.
+#
+
+$DEBUG = 1;
+
+# Fingerprints: folded title and last names, and year
+is (Text::BibTeX::fingerprint ('The {A}rt of {C}omputer {P}rogramming',
+                               'Knuth, Donald E.', '1968'),
+    'the art of computer programming|knuth|1968');
+is (Text::BibTeX::fingerprint ("{\\\"U}ber die   Gr{\\\"o}{\\ss}e -- eine~Studie",
+                               'Ludwig van Beethoven and J. R. R. Tolkien ' .
+                               'and others', 'c. 2010'),
+    'uber die grosse eine studie|beethoven tolkien|2010');
+is (Text::BibTeX::fingerprint (undef, undef, undef), '||');
+
+# the same, whether in TeX or in UTF-8 (or Latin-1)
+is (Text::BibTeX::fingerprint ("\xc3\x9cber Gr\xc3\xb6\xc3\x9fe",
+                               "M\xc3\xbcller, Hans", '2010'),
+    Text::BibTeX::fingerprint ("{\\\"U}ber Gr{\\\"o}{\\ss}e",
+                               "M{\\\"u}ller, Hans", '2010'));
+is (Text::BibTeX::fingerprint ("\xdcber", "M\xfcller", '2010'),
+    'uber|muller|2010');
+is (Text::BibTeX::fingerprint ('X', 'A and B and C and D and E and F and ' .
+                                    'G and H and I and J', 'n.d.'),
+    'x|a b c d e f g h|');
+
+# bad names are used quietly
+my $fingerprint;
+no_err (sub { $fingerprint = Text::BibTeX::fingerprint
+                 ('T', 'Smith, John, Jr., III and {Jones', '2000') });
+like ($fingerprint, qr/^t\|smith /);
+
+# ... and so are entries
+my $entry = Text::BibTeX::Entry->new ({}, <<'ENTRY');
+@book{knuth,
+  title = {The {A}rt of {C}omputer {P}rogramming},
+  editor = {D. E. Knuth}, date = {1968-01}}
+ENTRY
+is ($entry->fingerprint, 'the art of computer programming|knuth|1968');
+
+# fingerprinting leaves the (cached) names alone
+$entry = Text::BibTeX::Entry->new ({}, <<'ENTRY');
+@article{muller, title = {T}, author = {Hans M{\"u}ller}, year = 2001}
+ENTRY
+is ($entry->fingerprint, 't|muller|2001');
+is (($entry->names ('author'))[0]->part ('last'), 'M{\"u}ller');
+
+# The index
+my $dedup = Text::BibTeX::Dedup->new;
+my @fingerprints =
+  ('the art of computer programming|knuth|1968',
+   'something else entirely|smith jones|2001',
+   'the art of computer programming|knuth|1968',
+   'somethng else entirely|smith jones|2001',
+   'a completely different title|doe|1999',
+   'something else entirely|smith jones|2001');
+is ($dedup->add ($fingerprints[0]), 0);
+is ($dedup->add ($fingerprints[1]), 1);
+$dedup->add ($_) for @fingerprints[2..5];
+is ($dedup->count, 6);
+is ($dedup->cluster (2), 0);
+is ($dedup->cluster (3), 1);
+is ($dedup->cluster (5), 1);
+is ($dedup->cluster (4), 4);
+ok (! defined $dedup->cluster (6));
+is ($dedup->similarity (0, 2), 1);
+my $similarity = $dedup->similarity (1, 3);
+ok ($similarity > 0.7 && $similarity < 1);
+ok ($dedup->similarity (0, 4) < 0.3);
+is_deeply ([$dedup->clusters], [[0, 2], [1, 3, 5]]);
+
+# With threshold 1, only exact matches count
+$dedup = Text::BibTeX::Dedup->new (threshold => 1);
+$dedup->add ($_) for @fingerprints;
+is_deeply ([$dedup->clusters], [[0, 2], [1, 5]]);
+
+# Entries, from a file
+my $bibfile = Text::BibTeX::File->new ('t/corpora.bib');
+$dedup = Text::BibTeX::Dedup->new;
+my $count = 0;
+while ($entry = Text::BibTeX::Entry->new ($bibfile))
+{
+   next unless $entry->parse_ok && $entry->metatype == BTE_REGULAR;
+   $dedup->add ($entry);
+   $count++;
+}
+is ($dedup->count, $count);
+is ($dedup->add ($fingerprints[0]), $count);
@@ -0,0 +1,117 @@
+# -*- cperl -*-
+use strict;
+use warnings;
+
+use IO::Handle;
+use File::Temp;
+use Test::More tests => 39;
+
+use vars qw($DEBUG);
+BEGIN {
+    use_ok('Text::BibTeX', qw(:metatypes :errclasses));
+    require "t/common.pl";
+}
+
+$DEBUG = 0;
+
+
+# ----------------------------------------------------------------------
+# errors and warnings returned as data by Entry::errors
+
+my ($entry, @errors, $bib);
+
+# a clean entry has no errors
+no_err sub { $entry = Text::BibTeX::Entry->new ('@foo{key, a = {b}}') };
+ok($entry->parse_ok);
+is(scalar ($entry->errors), 0);
+
+# warnings are printed as usual, and also recorded
+err_like sub { $entry = Text::BibTeX::Entry->new ('@foo{key, a = undefmac}') },
+  qr/warning: undefined macro "undefmac"/;
+ok($entry->parse_ok);
+@errors = $entry->errors;
+is(scalar @errors, 1);
+is($errors[0]{class}, BTERR_CONTENT);
+is($errors[0]{line}, 1);
+like($errors[0]{message}, qr/undefined macro "undefmac"/);
+
+# with 'quiet', errors are recorded but not printed
+no_err sub {
+    $entry = Text::BibTeX::Entry->new ({ quiet => 1 },
+                                       '@foo{key, a = {b} c = {d}}');
+};
+ok(! $entry->parse_ok);
+@errors = grep { $_->{class} == BTERR_SYNTAX } $entry->errors;
+is(scalar @errors, 1);
+like($errors[0]{message}, qr/found "c", expected/);
+
+# messages are recorded in full, however long
+my $long = 'm' x 3000;
+no_err sub {
+    $entry = Text::BibTeX::Entry->new ({ quiet => 1 }, "\@foo{key, a = $long}");
+};
+@errors = $entry->errors;
+is($errors[0]{message}, "undefined macro \"$long\"");
+
+# messages with numbers in them are the same printed and recorded
+my $junk = File::Temp->new (SUFFIX => '.bib');
+print $junk "xyz \@foo{key, a = {b}}\n";
+close ($junk);
+$bib = Text::BibTeX::File->new ($junk->filename);
+err_like sub { $entry = Text::BibTeX::Entry->new ($bib) },
+  qr/line 1, warning: 3 characters of junk seen at toplevel/;
+@errors = $entry->errors;
+is($errors[0]{message}, '3 characters of junk seen at toplevel');
+$bib->close;
+
+# errors from the previous entry don't stick around
+no_err sub { $entry->parse_s ('@foo{key, a = {b}}') };
+is(scalar ($entry->errors), 0);
+
+# errors come with filenames when reading from a file; and the 'quiet'
+# option of a File is passed on to its entries
+$bib = Text::BibTeX::File->new ('btparse/tests/data/overflow.bib',
+                                   { quiet => 1 });
+ok($bib);
+no_err sub { $entry = Text::BibTeX::Entry->new ($bib) };
+ok(! $entry->parse_ok);
+@errors = $entry->errors;
+ok(@errors > 0);
+is($errors[-1]{filename}, 'btparse/tests/data/overflow.bib');
+is($errors[-1]{class}, BTERR_SYNTAX);
+like($errors[-1]{message}, qr/at end of input/);
+
+
+# ----------------------------------------------------------------------
+# check_only: errors as usual, but no values and no macro processing
+
+no_err sub {
+    $entry = Text::BibTeX::Entry->new ({ check_only => 1 },
+                                       '@foo{key, a = {b} # undefmac, c = 3}');
+};
+ok($entry->parse_ok);
+is($entry->key, 'key');
+is_deeply([$entry->fieldlist], ['a', 'c']);
+ok(! defined $entry->get('a'));
+
+# structure checks only need the type and field names, so they work on
+# the skeleton entries (as "btcheck -s" has them do)
+$bib = Text::BibTeX::File->new ('t/corpora.bib', { check_only => 1 });
+$bib->set_structure ('Bib');
+$entry = Text::BibTeX::Entry->new ($bib);
+$entry->delete ('year');
+err_like sub { $entry->check }, qr/required field 'year' not present/;
+$bib->close;
+
+no_err sub {
+    $entry = Text::BibTeX::Entry->new ({ check_only => 1, quiet => 1 },
+                                       '@foo{key, a = {b} c = {d}}');
+};
+ok(! $entry->parse_ok);
+is(scalar (grep { $_->{class} == BTERR_SYNTAX } $entry->errors), 1);
+
+$bib = Text::BibTeX::File->new ('btparse/tests/data/overflow.bib',
+                                { quiet => 1, check_only => 1 });
+no_err sub { $entry = Text::BibTeX::Entry->new ($bib) };
+ok(! $entry->parse_ok);
+like(($entry->errors)[-1]{message}, qr/at end of input/);
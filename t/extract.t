@@ -0,0 +1,84 @@
+# -*- cperl -*-
+use strict;
+use warnings;
+
+use IO::Handle;
+use Test::More;
+use File::Spec;
+use Capture::Tiny 'capture';
+
+use vars qw($DEBUG $btextract);
+use Cwd;
+BEGIN {
+    $btextract = File::Spec->catfile ('btparse', 'progs', 'btextract');
+    $btextract .= '.exe' if $^O =~ /mswin32|cygwin/i;
+    plan skip_all => "btextract not built" unless -x $btextract;
+    plan tests => 15;
+    use_ok('Text::BibTeX');
+    my $common = getcwd()."/t/common.pl";
+    require $common;
+}
+
+#
+# extract.t
+#
+# Text::BibTeX test program -- extracting the entries cited by a LaTeX
+# document with the btextract program (which has to have been built
+# first).
+#
+
+$DEBUG = 1;
+
+# runs btextract, and returns the entries it wrote (type and key, or
+# just the type), its warnings, and its exit status
+sub extract
+{
+   my @args = @_;
+   my ($out, $err, $status) = capture { system ($btextract, @args) };
+   my @entries = map { /^\@(\w+)[{(]\s*([^,\s]*)/
+                          ? (lc $1 eq 'string' || lc $1 eq 'preamble'
+                                ? lc $1 : "$1 $2")
+                          : () }
+                     split (/\n/, $out);
+   return (\@entries, [split (/\n/, $err)], $status >> 8, $out);
+}
+
+my ($entries, $warnings, $status, $out);
+
+# citations from the .aux file and the one it \@input's; the .bib file
+# comes from \bibdata (found relative to the current directory)
+chdir ('t') or die "couldn't chdir to t: $!\n";
+$btextract = File::Spec->catfile (File::Spec->updir, $btextract);
+($entries, $warnings, $status, $out) = extract ('extract.aux');
+is ($status, 0);
+is_deeply ($entries,
+           [qw(preamble string string),
+            'article Knuth84', 'inproceedings lamport-paxos',
+            'book dijkstra76', 'misc alone',
+            'proceedings podc01', 'misc series'],
+           'cited entries in order, then their crossref parents');
+like ($out, qr/^\@string\{pub = acm # " Press", unused = \{Unused\}\}$/m,
+      'macros used by macros');
+unlike ($out, qr/tcs|unused1/, 'nothing that isn\'t needed');
+like ($out, qr/^\@book\(dijkstra76, title = "A Discipline of Programming",\n      publisher = pub\)$/m,
+      'entries copied as they are');
+is_deeply ($warnings, ['warning: no entry for citation "nowhere"']);
+
+# citations given on the command line, and the .bib file too
+($entries, $warnings, $status) = extract ('-c', 'SERIES', 'extract.bib');
+is ($status, 0);
+is_deeply ($entries, [qw(preamble), 'misc series'], 'keys match in any case');
+is_deeply ($warnings, []);
+
+($entries, $warnings, $status) = extract ('-c', '*', 'extract.bib');
+is (scalar (grep { !/^(string|preamble)$/ } @$entries), 7, '\citation{*}');
+is (scalar (grep { /^string$/ } @$entries), 3);
+
+# errors
+($entries, $warnings, $status) = extract ('-c', 'x', 'nonexistent.bib');
+is ($status, 1, 'missing file');
+($entries, $warnings, $status) = extract ('-c', 'x', 'errors.bib');
+is ($status, 0, 'entries that aren\'t cited aren\'t even parsed');
+($entries, $warnings, $status) = extract ('-c', 'error1', 'errors.bib');
+is ($status, 1, 'syntax errors');
+chdir (File::Spec->updir);
@@ -0,0 +1,113 @@
+# -*- cperl -*-
+use strict;
+use warnings;
+
+use IO::Handle;
+use Test::More;
+use File::Spec;
+use File::Temp 'tempfile';
+use Capture::Tiny 'capture';
+
+use vars qw($DEBUG $btindex);
+use Cwd;
+BEGIN {
+    $btindex = File::Spec->catfile ('btparse', 'progs', 'btindex');
+    $btindex .= '.exe' if $^O =~ /mswin32|cygwin/i;
+    plan skip_all => "btindex not built" unless -x $btindex;
+    plan tests => 27;
+    use_ok('Text::BibTeX');
+    my $common = getcwd()."/t/common.pl";
+    require $common;
+}
+
+#
+# index.t
+#
+# Text::BibTeX test program -- building and searching full-text indexes
+# with the btindex program (which has to have been built first).
+#
+
+$DEBUG = 1;
+
+my $bibfile = 't/index.bib';
+my (undef, $index) = tempfile (UNLINK => 1);
+my %keys;                               # by offset
+
+# the offsets of the entries, found by looking for them
+{
+   open (my $fh, '<', $bibfile) or die "$bibfile: $!\n";
+   my $text = do { local $/; <$fh> };
+   while ($text =~ /\@\w+\{(\w+),/g)
+   {
+      $keys{$-[0]} = $1;
+   }
+}
+
+# runs btindex; returns its output, errors and exit status
+sub btindex
+{
+   my @args = @_;
+   my ($out, $err, $status) = capture { system ($btindex, @args) };
+   return ($out, $err, $status >> 8);
+}
+
+# searches the index; returns the keys of the entries found
+sub search
+{
+   my ($query) = @_;
+   my ($out, $err, $status) = btindex ('-q', $query, $index);
+   return join (' ', map { $keys{$_} || "?$_" } split (/\n/, $out));
+}
+
+my ($out, $err, $status);
+
+($out, $err, $status) = btindex ('-o', $index, $bibfile);
+is ($status, 0, 'index built');
+is ($err, '', 'quietly');
+
+is (search ('knuth'), 'knuth84 mueller', 'a word, in any field');
+is (search ('KNUTH'), 'knuth84 mueller', 'case makes no difference');
+is (search ('title:literate'), 'knuth84 mueller', 'title, with macros expanded');
+is (search ('literate'), 'knuth84 beethoven mueller', 'any field');
+is (search ('author:beethoven'), 'beethoven', 'last names');
+is (search ('author:ludwig'), '', 'but not first names');
+is (search ('author:"van beethoven"'), 'beethoven', 'von part');
+is (search ('author:"beethoven others"'), '', 'phrases stop at a name');
+is (search ('muller'), 'mueller utf8', 'purified');
+is (search ("author:m\xc3\xbcller"), 'mueller utf8', 'TeX or UTF-8, accents or not');
+is (search ("author:M\xc3\x9cLLER"), 'mueller utf8');
+is (search ('title:"angstrom units"'), 'utf8');
+is (search ('title:"literate programming"'), 'knuth84 mueller', 'phrase');
+is (search ('title:"programming literate"'), '', 'phrase in order');
+is (search ('keywords:"programming literate"'), 'mueller');
+is (search ('knuth AND title:uber'), 'mueller', 'AND');
+is (search ('title:symphony OR author:muller'), 'beethoven mueller utf8', 'OR');
+
+($out, $err, $status) = btindex ('-q', 'journal:computer', $index);
+is ($status, 1, 'field not indexed');
+like ($err, qr/field not indexed/);
+
+($out, $err, $status) = btindex ('-e', '-q', 'symphony', $index);
+like ($out, qr/^\@book\{beethoven,.*\}\n\n\z/s, 'entry printed');
+
+# built in parallel, in ranges, the index is just the same
+sub slurp
+{
+   my ($file) = @_;
+   open (my $fh, '<', $file) or die "$file: $!\n";
+   binmode ($fh);
+   local $/;
+   return <$fh>;
+}
+
+{
+   my (undef, $parallel) = tempfile (UNLINK => 1);
+   ($out, $err, $status) = btindex ('-j', 3, '-o', $parallel, $bibfile);
+   is ($status, 0, 'index built in parallel');
+   ok (slurp ($parallel) eq slurp ($index), 'the same index');
+
+   btindex ('-o', $index, 't/corpora.bib');
+   btindex ('-j', 4, '-o', $parallel, 't/corpora.bib');
+   ok (slurp ($parallel) eq slurp ($index), 'the same for a bigger file');
+   ok (! -e "$parallel.0", 'ranges cleaned up');
+}
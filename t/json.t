@@ -0,0 +1,120 @@
+# -*- cperl -*-
+use strict;
+use warnings;
+
+use IO::Handle;
+use Test::More;
+use File::Spec;
+use Capture::Tiny 'capture';
+
+use vars qw($DEBUG);
+use Cwd;
+BEGIN {
+    eval { require JSON::PP; 1 }
+       or plan skip_all => 'JSON::PP is needed to check the output';
+    plan tests => 31;
+    use_ok('Text::BibTeX');
+    use_ok('Text::BibTeX::File');
+    my $common = getcwd()."/t/common.pl";
+    require $common;
+}
+
+#
+# json.t
+#
+# Text::BibTeX test program -- writing files as JSON Lines and CSL-JSON.
+#
+
+$DEBUG = 1;
+
+sub to_json
+{
+   my ($opts, $filename) = @_;
+   my ($bibfile, $text, $count);
+
+   $bibfile = Text::BibTeX::File->new ($filename || 't/json.bib',
+                                       { reset_macros => 1 });
+   open (my $out, '>', \$text) or die "in-memory file: $!\n";
+   $count = $bibfile->to_json ($out, $opts);
+   close ($out);
+   $bibfile->close;
+   ($count, $text);
+}
+
+my ($count, $text, @lines, @items, $json);
+
+# JSON Lines: every entry, every field
+($count, $text) = to_json ();
+is ($count, 6, 'six entries');
+@lines = split (/\n/, $text);
+is (@lines, 6, 'one line each');
+@items = map { JSON::PP::decode_json ($_) } @lines;
+is ($items[0]{type}, 'string');
+is ($items[0]{fields}{cj}, 'The Computer Journal');
+is ($items[1]{value}, '\newcommand{\noopsort}[1]{}', 'preamble');
+is ($items[2]{key}, 'knuth84');
+is ($items[2]{fields}{journal}, 'The Computer Journal', 'macro expanded');
+is ($items[2]{fields}{month}, 'May', 'month macro');
+is ($items[3]{value}, 'not an entry', 'comment');
+
+# ... with Unicode
+($count, $text) = to_json ({ unicode => 1 });
+@items = map { JSON::PP::decode_json ($_) } split (/\n/, $text);
+is ($items[2]{fields}{title},
+    "Literate Programming: \x{dc}ber \x{e9}t\x{e9} \x{2013} na\x{ef}ve \$x^2\$ \\foo{bar}",
+    'TeX converted; math and unknown macros left alone');
+is ($items[1]{value}, '\newcommand{\noopsort}[1]{}', 'preamble untouched');
+
+# CSL-JSON: regular entries only, as an array
+($count, $text) = to_json ({ csl => 1, unicode => 1 });
+is ($count, 3, 'three items');
+$json = JSON::PP::decode_json ($text);
+is (ref $json, 'ARRAY');
+my %items = map { ($_->{id} => $_) } @$json;
+is ($items{knuth84}{type}, 'article-journal');
+is_deeply ($items{knuth84}{author},
+           [ { family => 'Knuth', given => 'Donald E.' },
+             { family => 'Beethoven', given => 'Ludwig',
+               'non-dropping-particle' => 'van' },
+             { literal => 'World Health Organization' },
+             { family => 'Smith', given => 'John', suffix => 'Jr.' } ],
+           'names split; others dropped');
+is_deeply ($items{knuth84}{issued}, { 'date-parts' => [[1984, 5]] });
+is ($items{knuth84}{'container-title'}, 'The Computer Journal');
+is ($items{knuth84}{issue}, '2', 'number is an article\'s issue');
+is ($items{knuth84}{page}, '97-111');
+is ($items{thesis}{genre}, 'PhD thesis');
+is_deeply ($items{thesis}{issued}, { literal => 'circa 1990' });
+is ($items{talk}{author}[0]{family}, "M\x{fc}ller", 'names converted');
+is ($items{talk}{title}, "On \x{df} and \x{f8}");
+
+# bytes that aren't UTF-8 are taken as Latin-1, so the JSON is still valid
+my $latin1 = 't/json-latin1.bib';
+END { unlink $latin1 }
+open (BIB, ">$latin1") || die "couldn't create $latin1: $!\n";
+print BIB "\@misc{cafe, title = {caf\xe9 au lait}, note = {M\xc3\xbcller}}\n";
+close (BIB);
+($count, $text) = to_json ({}, $latin1);
+$json = eval { JSON::PP::decode_json ($text) };
+ok ($json, 'Latin-1 makes valid JSON');
+is ($json->{fields}{title}, "caf\x{e9} au lait", 'Latin-1 transcoded');
+is ($json->{fields}{note}, "M\x{fc}ller", 'UTF-8 kept');
+
+# the btjson program leaves out entries with syntax errors, but still
+# fails
+my $broken = 't/json-broken.bib';
+END { unlink $broken }
+open (BIB, ">$broken") || die "couldn't create $broken: $!\n";
+print BIB "\@misc{,title={no key}}\n\@misc{ok,title={fine}}\n";
+close (BIB);
+SKIP:
+{
+   my $btjson = File::Spec->catfile ('btparse', 'progs', 'btjson');
+   $btjson .= '.exe' if $^O =~ /mswin32|cygwin/i;
+   skip "btjson not built", 3 unless -x $btjson;
+   my ($out, $err, $status) = capture { system ($btjson, $broken) };
+   is ($status >> 8, 1, 'btjson fails on a syntax error');
+   @lines = split (/\n/, $out);
+   is (@lines, 1, 'the broken entry is left out');
+   is (JSON::PP::decode_json ($lines[0])->{key}, 'ok');
+}
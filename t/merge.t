@@ -0,0 +1,122 @@
+# -*- cperl -*-
+use strict;
+use warnings;
+
+use IO::Handle;
+use Test::More;
+use File::Spec;
+use File::Temp 'tempfile';
+use Capture::Tiny 'capture';
+
+use vars qw($DEBUG $btmerge);
+use Cwd;
+BEGIN {
+    $btmerge = File::Spec->catfile ('btparse', 'progs', 'btmerge');
+    $btmerge .= '.exe' if $^O =~ /mswin32|cygwin/i;
+    plan skip_all => "btmerge not built" unless -x $btmerge;
+    plan tests => 27;
+    use_ok('Text::BibTeX');
+    my $common = getcwd()."/t/common.pl";
+    require $common;
+}
+
+#
+# merge.t
+#
+# Text::BibTeX test program -- merging files with the btmerge program
+# (which has to have been built first).
+#
+
+$DEBUG = 1;
+
+my @files = ('t/merge1.bib', 't/merge2.bib');
+
+# runs btmerge; returns the entries written (type and key, or just the
+# type), the macros they define, the warnings, and the exit status
+sub merge
+{
+   my @args = @_;
+   my ($fh, $output) = tempfile (UNLINK => 1);
+   my (undef, $err, $status) =
+      capture { system ($btmerge, @args, '-o', $output, @files) };
+   my ($out, @entries, @macros);
+
+   $out = do { local $/; <$fh> };
+   my $bibfile = Text::BibTeX::File->new ($output, { quiet => 1 });
+   my $entry;
+   while ($entry = Text::BibTeX::Entry->new ($bibfile))
+   {
+      push (@entries, $entry->metatype == BTE_REGULAR
+                         ? $entry->type . ' ' . $entry->key
+                         : $entry->type);
+      push (@macros, $entry->fieldlist) if $entry->metatype == BTE_MACRODEF;
+   }
+   Text::BibTeX::delete_all_macros ();
+   return (\@entries, \@macros, [split (/\n/, $err)], $status >> 8, $out);
+}
+
+my ($entries, $macros, $warnings, $status, $out);
+
+# -first: later entries with a key already seen are dropped, and so are
+# macros defined again (differently, or not)
+($entries, $macros, $warnings, $status, $out) = merge ('-first');
+is ($status, 0, 'no syntax errors');
+is_deeply ($entries,
+           [qw(string preamble string),
+            'article Knuth84', 'comment', 'book lamport94',
+            'misc fresh', 'misc knuth84-2'],
+           'strings and preambles first, duplicates dropped');
+is_deeply ($macros, [qw(acm ieee new)], 'each macro defined once');
+is (scalar @$warnings, 3, 'three conflicts');
+like ($warnings->[0], qr/merge2\.bib, line 2, warning: macro "ieee" already defined differently \(t\/merge1\.bib, line 2\): definition skipped/);
+like ($warnings->[1], qr/duplicate key "knuth84" \(t\/merge1\.bib, line 4\): entry skipped/);
+like ($out, qr/^\@book\(lamport94, title = "A \(paren\) book", note = \{x\)y\}\)$/m,
+      'entries copied as they are');
+like ($out, qr/^\@article\{Knuth84,\n  author = \{Donald Knuth\},\n/m);
+unlike ($out, qr/junk|oops/, 'junk between entries dropped');
+like ($out, qr/^\@misc\{ fresh , % a comment with a \} in it\n  title = \{Fresh\}\}$/m,
+      'braces in comments are not counted');
+
+# -rename: they get new keys instead
+($entries, $macros, $warnings, $status, $out) = merge ('-rename');
+is ($status, 0);
+is_deeply ($entries,
+           [qw(string preamble string),
+            'article Knuth84', 'comment', 'book lamport94',
+            'article knuth84-3', 'misc fresh', 'book lamport94-2',
+            'misc knuth84-2'],
+           'duplicate keys renamed to keys no input uses');
+like ($warnings->[1], qr/duplicate key "knuth84" .*: renamed to "knuth84-3"/);
+is (scalar @$warnings, 3, 'a key like a new one is left alone');
+like ($out, qr/^\@Article\{knuth84-3, title = \{Other\}\}$/m,
+      'only the key changes');
+
+# -report: everything is kept, and the exit status says so
+($entries, $macros, $warnings, $status, $out) = merge ('-report');
+is ($status, 1, 'conflicts are errors under -report');
+is (scalar @$entries, 10);
+is_deeply ($macros, [qw(acm ieee ieee new)]);
+is (scalar @$warnings, 3);
+unlike ($warnings->[0], qr/skipped/);
+
+# the same file twice: nothing but duplicates, all of them identical
+my ($err);
+($out, $err, $status) = capture { system ($btmerge, '-first', 't/merge1.bib', 't/merge1.bib') };
+is (($out =~ tr/@//), 6, 'a file merged with itself (comments and all)');
+is (scalar (() = $err =~ /duplicate key/g), 2);
+
+# a file with no macros or preambles at all
+($out, $err, $status) = capture { system ($btmerge, 't/corpora.bib') };
+is ($status, 0);
+is (($out =~ tr/@//), 25, 'every entry of a file without @strings');
+
+# a %-comment between entries hides an '@' in it, as it does from the parser
+{
+   my ($fh, $commented) = tempfile (UNLINK => 1);
+   print $fh "% \@article{hidden, title = {Hidden}}\n",
+             "\@misc{shown, title = {Shown}} %\@misc{also, title = {Hidden}}\n";
+   close ($fh);
+   ($out, $err, $status) = capture { system ($btmerge, $commented) };
+   is ($status, 0);
+   is ($out, "\@misc{shown, title = {Shown}}\n\n", 'commented-out entries skipped');
+}
@@ -2,7 +2,7 @@
 use strict;
 use vars qw($DEBUG);
 use IO::Handle;
-use Test::More tests=>27;
+use Test::More tests=>28;
 use utf8;
 use Encode 'decode';
 use Unicode::Normalize;
@@ -128,6 +128,11 @@ $DEBUG = 1;
     my $name13   = Text::BibTeX::Name->new({binmode=>'utf-8'},'A̧̦̓ Smith');
     is $formatterlast->apply($name13), 'A̧̦̓.', "utf-8 [3]";
 
+    # Initial is 4 bytes long in UTF8 (outside the BMP)
+    $formatterlast = Text::BibTeX::NameFormat->new('f', 1);
+    my $name13a  = Text::BibTeX::Name->new({binmode=>'utf-8'},'𝔄lbert Smith');
+    is $formatterlast->apply($name13a), '𝔄.', "utf-8 [4]";
+
 }
 
 {
@@ -3,7 +3,7 @@ use strict;
 use warnings;
 
 use IO::Handle;
-use Test::More tests => 13;
+use Test::More tests => 19;
 
 use vars qw($DEBUG);
 use Cwd;
@@ -31,6 +31,9 @@ my (@names);
     'K. Herterich and S. Determann and B. Grieger and I. Hansen and P. Helbig and S. Lorenz and A. Manschke' => ['K. Herterich', 'S. Determann', 'B. Grieger', 'I. Hansen', 'P. Helbig', 'S. Lorenz', 'A. Manschke'],
     'A. Manschke and M. Matthies and A. Paul and R. Schlotte and U. Wyputta' => ['A. Manschke', 'M. Matthies', 'A. Paul', 'R. Schlotte', 'U. Wyputta'],
     'S. Lorenz and A. Manschke and M. Matthies' => ['S. Lorenz', 'A. Manschke', 'M. Matthies'],
+    'and Joe Q. Blow and and Smith, Jr., John' => ['and Joe Q. Blow', undef, 'Smith, Jr., John'],
+    '{Barnes and Noble} AND J. Smith and' => ['{Barnes and Noble}', 'J. Smith and'],
+    'Strand and Anderson aNd Sand' => ['Strand', 'Anderson', 'Sand'],
     'K. Herterich and S. Determann and B. Grieger and I. Hansen and P. Helbig and S. Lorenz and A. Manschke and M. Matthies and A. Paul and R. Schlotte and U. Wyputta' => ['K. Herterich', 'S. Determann', 'B. Grieger', 'I. Hansen', 'P. Helbig', 'S. Lorenz', 'A. Manschke', 'M. Matthies', 'A. Paul', 'R. Schlotte', 'U. Wyputta'],
    );
 
@@ -56,3 +59,11 @@ while (@names) {
 
   ok(slist_equal ($should_split, $actual_split));
 }
+
+# long lists, and nothing to split
+{
+  my @long = map { "A. Author$_" } 1 .. 500;
+  my @split = Text::BibTeX::split_list (join (' and ', @long), 'and');
+  ok(slist_equal (\@long, \@split));
+  is(scalar (Text::BibTeX::split_list ('', 'and')), 0);
+}
@@ -4,7 +4,8 @@ use warnings;
 use vars qw($DEBUG);
 
 use IO::Handle;
-use Test::More tests => 61;
+use Test::More tests => 69;
+use Capture::Tiny 'capture';
 use utf8;
 use Encode 'encode';
 use Text::BibTeX;
@@ -136,3 +137,31 @@ ok (@names == 3);
 test_name ($names[0], [['Homer'], undef, ['Simpson'], undef]);
 test_name ($names[1], [['Ned', 'Q.'], undef, ['Flanders'], ['Jr.']]);
 test_name ($names[2], [undef, undef, ['{Foo Bar and Co.}']]);
+
+
+# ----------------------------------------------------------------------
+# the name cache: a name seen again isn't split again, and shares the
+# split form; names with warnings aren't kept, and are always warned about
+
+Text::BibTeX::Name->set_cache (2);
+is (join (' ', Text::BibTeX::Name->cache_stats), '0 0');
+my $knuth1 = Text::BibTeX::Name->new ('Knuth, Donald E.');
+my $knuth2 = Text::BibTeX::Name->new ('Knuth, Donald E.');
+is (join (' ', Text::BibTeX::Name->cache_stats), '1 1');
+is ($knuth1->{_cstruct}, $knuth2->{_cstruct});
+undef $knuth1;
+Text::BibTeX::Name->new ($_) for ('A B', 'C D', 'E F');     # drops Knuth
+test_name ($knuth2, [['Donald', 'E.'], undef, ['Knuth'], undef]);
+is (join (' ', Text::BibTeX::Name->cache_stats), '1 4');
+
+my (undef, $once) = capture { Text::BibTeX::Name->new ('Foo Bar}') };
+my (undef, $twice) = capture {
+   Text::BibTeX::Name->new ('Foo Bar}') for 1 .. 2;
+};
+is ($twice, $once x 2);
+
+Text::BibTeX::Name->set_cache (0);
+test_name (Text::BibTeX::Name->new ('Knuth, Donald E.'),
+           [['Donald', 'E.'], undef, ['Knuth'], undef]);
+is (join (' ', Text::BibTeX::Name->cache_stats), '0 0');
+Text::BibTeX::Name->set_cache (4096);
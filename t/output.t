@@ -3,7 +3,7 @@ use strict;
 use warnings;
 
 use IO::Handle;
-use Test::More tests => 20;
+use Test::More tests => 30;
 
 use vars qw($DEBUG);
 
@@ -94,3 +94,71 @@ is $clone->get('title') => 'Territorial Imperatives in Modern Suburbia';
 $clone->set('title', 'Changed title');
 is $clone->get('title') => 'Changed title';
 is $entry->get('title') => 'Territorial Imperatives in Modern Suburbia';
+
+# output options
+$text = <<'TEXT';
+@misc{opts,
+  title = {A "quoted" word},
+  note = {plain},
+  year = 1999,
+  month = jan,
+}
+TEXT
+$entry = Text::BibTeX::Entry->new ($text);
+is $entry->print_s ({ quote => 'quotes', order => ['year', 'note'] }),
+   <<'OUT', 'quotes, and field order';
+@misc{opts,
+  year = "1999",
+  note = "plain",
+  title = {A "quoted" word},
+  month = "January",
+}
+
+OUT
+is $entry->print_s ({ indent => "\t", align => 5 }), <<"OUT", 'indent and align';
+\@misc{opts,
+\ttitle = {A "quoted" word},
+\tnote  = {plain},
+\tyear  = {1999},
+\tmonth = {January},
+}
+
+OUT
+is $entry->print_s ({ quote => 'bare', indent => '' }), <<'OUT', 'bare';
+@misc{opts,
+title = A "quoted" word,
+note = plain,
+year = 1999,
+month = January,
+}
+
+OUT
+eval { $entry->print_s ({ quote => 'single' }) };
+like $@, qr/unknown quote style/;
+
+# with values preserved, numbers and macros are left bare
+$entry = Text::BibTeX::Entry->new;
+ok $entry->parse_s ($text, 1);
+is $entry->print_s ({ quote => 'quotes', order => ['month'] }), <<'OUT';
+@misc{opts,
+  month = jan,
+  title = {A "quoted" word},
+  note = "plain",
+  year = 1999,
+}
+
+OUT
+
+# comments, preambles and macro definitions
+$entry = Text::BibTeX::Entry->new ('@comment{a comment}');
+is $entry->print_s, "\@comment{{a comment}}\n\n";
+$entry = Text::BibTeX::Entry->new ('@preamble{"\newcommand{\x}{y}"}');
+is $entry->print_s ({ quote => 'quotes' }),
+   "\@preamble{\"\\newcommand{\\x}{y}\"}\n\n";
+$entry = Text::BibTeX::Entry->new ('@string{foo = "bar"}');
+is $entry->print_s, "\@string{\n  foo = {bar},\n}\n\n";
+
+# characters are written as UTF-8
+$entry = Text::BibTeX::Entry->new ({ binmode => 'utf-8' },
+                                   "\@misc{k, title = {Gr\x{c3}\x{b6}\x{c3}\x{9f}e}}");
+is $entry->print_s, "\@misc{k,\n  title = {Gr\x{f6}\x{df}e},\n}\n\n";
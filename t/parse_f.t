@@ -3,13 +3,14 @@ use strict;
 use warnings;
 
 use IO::Handle;
-use Test::More tests => 73;
+use Test::More tests => 151;
 
 use vars qw($DEBUG);
 use Cwd;
+use File::Temp;
 
 BEGIN {
-    use_ok('Text::BibTeX');
+    use_ok('Text::BibTeX', ':metatypes');
     my $common = getcwd()."/t/common.pl";
     require $common;
 
@@ -85,3 +86,189 @@ test_entry ($entry, 'book', 'abook',
 ok(!  Text::BibTeX::Entry->new( $regular_file, $fh));
 
 $fh->close;
+
+# ----------------------------------------------------------------------
+# field projection: only the requested fields of regular entries are kept
+
+my $bib = Text::BibTeX::File->new ($regular_file,
+                                   { projection => [qw(Title YEAR)] });
+no_err sub { $entry = Text::BibTeX::Entry->new ($bib); };
+test_entry ($entry, 'book', 'abook', [qw(title year)], ['A Book', '1922']);
+$bib->close;
+
+# unwanted values aren't processed -- so no warning for 'undefmac'
+no_err sub {
+    $entry = Text::BibTeX::Entry->new
+      ({ projection => [qw(title year)] },
+       "\@foo{key, abstract = {long {nested}\n text, a = b} # undefmac,\n" .
+       "  title = \"T\", note = 3, year = 2000}");
+};
+test_entry ($entry, 'foo', 'key', [qw(title year)], ['T', '2000']);
+
+# unwanted fields are dropped whole, wherever they are, as the lexer
+# reads them: the parser never sees them
+no_err sub {
+    $entry = Text::BibTeX::Entry->new
+      ({ projection => ['year'] },
+       "\@foo(key, a = \"x)\" % a comment, with )\n # {y}, year = 2000,\n" .
+       "  b = {z})");
+};
+test_entry ($entry, 'foo', 'key', ['year'], ['2000']);
+
+# @string entries are not affected
+$entry = Text::BibTeX::Entry->new ({ projection => ['title'] },
+                                   '@string{foo = "bar"}');
+test_entry ($entry, 'string', undef, ['foo'], ['bar']);
+
+# an empty projection leaves no fields at all
+$entry = Text::BibTeX::Entry->new ({ projection => [] }, '@foo{key, a = {b}}');
+ok($entry->parse_ok);
+is(scalar ($entry->fieldlist), 0);
+
+# a syntax error in a dropped field is still an error: an entry parses
+# OK with a projection just when it does without one
+foreach my $text ('@foo{key, a = }', '@foo{key, a = , title = {T}}',
+                  '@foo{key, a = b c, title = {T}}', '@foo{key, a}',
+                  '@foo{key, a = {b, title = {T}}')
+{
+    my $whole;
+    err_like sub { $whole = Text::BibTeX::Entry->new ($text); },
+      qr/syntax error/;
+    err_like sub {
+        $entry = Text::BibTeX::Entry->new ({ projection => ['title'] }, $text);
+    }, qr/syntax error/;
+    ok(!$whole->parse_ok && !$entry->parse_ok, "error in \"$text\"");
+}
+
+# ----------------------------------------------------------------------
+# entry selection: unwanted entries are skipped without being parsed
+
+my (@keys, %lines);
+$bib = Text::BibTeX::File->new ('t/corpora.bib',
+                                { select_types => ['InProceedings'] });
+no_err sub {
+    while ($entry = Text::BibTeX::Entry->new ($bib)) {
+        push @keys, $entry->key;
+        $lines{$entry->key} = [$entry->line];
+    }
+};
+is_deeply(\@keys, [qw(ester1996density huynh2012scientific
+                      pham2012enhancing sculley2010web
+                      wagstaff2001constrained xia2014folksonomy
+                      xia2013socially)]);
+is_deeply($lines{huynh2012scientific}, [79, 85]);   # lines still counted
+$bib->close;
+
+@keys = ();
+$bib = Text::BibTeX::File->new ('t/corpora.bib',
+                                { select_types => [qw(article proceedings)],
+                                  select_keys  => [qw(aime2 Arbelatz13
+                                                      ester1996density)] });
+no_err sub {
+    while ($entry = Text::BibTeX::Entry->new ($bib)) {
+        push @keys, $entry->key;
+    }
+};
+is_deeply(\@keys, [qw(Arbelatz13 aime2)]);
+$bib->close;
+
+# a '}' or ')' in a %-comment doesn't end a skipped entry
+my $commented = File::Temp->new (SUFFIX => '.bib');
+print $commented "\@misc{a, % not the end }\n  title = {A}}\n",
+                 "\@misc(b, % nor this )\n  title = {B})\n",
+                 "\@book{c, title = {C}}\n";
+close ($commented);
+@keys = ();
+$bib = Text::BibTeX::File->new ($commented->filename,
+                                { select_types => ['book'] });
+no_err sub {
+    while ($entry = Text::BibTeX::Entry->new ($bib)) {
+        push @keys, $entry->key;
+        is($entry->line, 5);
+    }
+};
+is_deeply(\@keys, ['c']);
+$bib->close;
+
+
+# ----------------------------------------------------------------------
+# shards: runs of entries between two byte offsets, read by seeking
+
+require Text::BibTeX::Parallel;
+my (@all, @sharded, @tasks);
+$bib = Text::BibTeX::File->new ('t/corpora.bib');
+while ($entry = Text::BibTeX::Entry->new ($bib)) {
+    push @all, $entry->key . ':' . $entry->line
+        if $entry->metatype == BTE_REGULAR;
+}
+$bib->close;
+
+@tasks = Text::BibTeX::Parallel::plan_tasks (['t/corpora.bib'], 3, 1024);
+is(scalar @tasks, 3);
+for my $task (@tasks) {
+    my $keys = @sharded;
+    $bib = Text::BibTeX::File->new ('t/corpora.bib', $task->{options});
+    no_err sub {
+        while ($entry = Text::BibTeX::Entry->new ($bib)) {
+            push @sharded, $entry->key . ':' . $entry->line
+                if $entry->metatype == BTE_REGULAR;
+        }
+    };
+    is_deeply([ map { "$_:" } @{ $task->{options}{preceding_keys} } ],
+              [ map { /^(.*:)/ } @all[0 .. $keys-1] ]);
+    $bib->close;
+}
+is_deeply(\@sharded, \@all);
+
+# nothing after the end of a shard is read (not even macro definitions),
+# and the ones before its start are passed in
+my $late = File::Temp->new (SUFFIX => '.bib');
+print $late "\@misc{a, title = {A}}\n\@misc{b, title = {B}}\n",
+            "\@string{late = {Late}}\n\@misc{c, title = late}\n";
+close ($late);
+Text::BibTeX::delete_macro ('late');
+$bib = Text::BibTeX::File->new ($late->filename, { shard => [0, 22] });
+@sharded = ();
+while ($entry = Text::BibTeX::Entry->new ($bib)) {
+    push @sharded, $entry->key;
+}
+is_deeply(\@sharded, ['a']);
+is(Text::BibTeX::macro_length ('late'), 0);
+$bib->close;
+
+$bib = Text::BibTeX::File->new
+   ($late->filename, { shard => [67, undef, 4, ['@string{late = {Late}}']] });
+no_err sub { $entry = Text::BibTeX::Entry->new ($bib) };
+is($entry->key, 'c');
+is($entry->line, 4);
+is($entry->get ('title'), 'Late');
+$bib->close;
+
+# a shard past the end of the file is empty
+$bib = Text::BibTeX::File->new ('t/corpora.bib',
+                                { shard => [1000000, undef] });
+no_err sub { $entry = Text::BibTeX::Entry->new ($bib) };
+ok(! $entry);
+$bib->close;
+
+# Text::BibTeX::Parallel puts the output of the shards back in order
+my $output = File::Temp->new;
+my $status = Text::BibTeX::Parallel::run
+   (files     => ['t/corpora.bib', 't/errors.bib'],
+    jobs      => 3,
+    min_shard => 2048,
+    output    => $output,
+    work      => sub {
+        my ($filename, $options) = @_;
+        my $bib = Text::BibTeX::File->new ($filename,
+                                           { %$options, quiet => 1 });
+        while (my $entry = Text::BibTeX::Entry->new ($bib)) {
+            print $entry->key, ':', scalar $entry->line, "\n"
+               if $entry->parse_ok && $entry->metatype == BTE_REGULAR;
+        }
+        return $filename =~ /errors/ ? 3 : 0;
+    });
+is($status, 3);
+seek ($output, 0, 0);
+my @printed = map { chomp; $_ } <$output>;
+is_deeply([@printed[0 .. $#all]], \@all);
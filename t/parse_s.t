@@ -3,7 +3,7 @@ use strict;
 use warnings;
 use utf8;
 use IO::Handle;
-use Test::More tests => 54;
+use Test::More tests => 67;
 
 use vars qw($DEBUG);
 use Cwd;
@@ -117,3 +117,30 @@ no_err sub { $entry = Text::BibTeX::Entry->new($text); };
 ok($entry->parse_ok);
 test_entry ($entry, 'foo', 'key', 
             ['title'], ['{System}- und {Signaltheorie}']);
+
+# Entries with many fields used to overflow the parser's attribute and
+# AST stacks (at about 90 fields), as the grammar recursed once per field.
+
+$text = '@foo{key, ' . join (', ', map ("f$_ = {v$_}", 1 .. 500)) .
+        ', big = ' . join (' # ', map ("{$_}", 1 .. 500)) . ',}';
+
+no_err sub { $entry = Text::BibTeX::Entry->new($text); };
+ok($entry->parse_ok);
+is(scalar (my @fields = $entry->fieldlist), 501);
+is($entry->get ('f500') . $entry->get ('big'), 'v500' . join ('', 1 .. 500));
+
+# UTF-8 values are decoded and normalized; plain ASCII and already
+# normalized strings skip Unicode::Normalize, but must come out the same.
+
+$text = "\@foo{key, a = {plain}, b = {Erd\x{151}s}, c = {Erde\x{301}}, d = {\x{fb01}}}";
+for my $norm (qw(NFC NFD NFKC)) {
+    no_err sub {
+        $entry = Text::BibTeX::Entry->new
+          ({ binmode => 'utf-8', normalization => $norm }, $text);
+    };
+    my %want = (NFC  => ["Erd\x{151}s",   "Erd\x{e9}",  "\x{fb01}"],
+                NFD  => ["Erdo\x{30b}s",  "Erde\x{301}", "\x{fb01}"],
+                NFKC => ["Erd\x{151}s",   "Erd\x{e9}",  "fi"]);
+    is_deeply([$entry->get ('a', 'b', 'c', 'd')], ['plain', @{$want{$norm}}]);
+    ok(utf8::is_utf8 ($entry->get ('a')));
+}
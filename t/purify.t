@@ -3,12 +3,12 @@ use strict;
 use warnings;
 
 use IO::Handle;
-use Test::More tests => 110;
+use Test::More tests => 122;
 
 use vars qw($DEBUG);
 use Cwd;
 BEGIN {
-    use_ok('Text::BibTeX', qw(purify_string));
+    use_ok('Text::BibTeX', qw(purify_string change_case));
     my $common = getcwd()."/t/common.pl";
     require $common;
 }
@@ -121,7 +121,13 @@ my @tests =
     q[\TeX] => [3, 'TeX'],
     q[{\TeX}] => [0, ''],
     q[{{\TeX}}] => [3, 'TeX'],
-    q[{\foobar}] => [0, '']
+    q[{\foobar}] => [0, ''],
+
+    # not BibTeX 0.99's, but LaTeX 2e's: T1 foreign letters
+    q[{\th}orn] => [5, 'thorn'],
+    q[{\DH}] => [2, 'Dh'],
+    q[{\ng}] => [2, 'ng'],
+    q[{\oa}] => [0, '']                # not a foreign letter
     );
 
 while (@tests)
@@ -140,3 +146,8 @@ while (@tests)
    is($length, $exp_length);
 }
 
+# foreign letters in case changes
+is(change_case ('u', '{\ss}'), '{SS}');
+is(change_case ('u', '{\i}gloo'), '{I}GLOO');
+is(change_case ('l', '{\TH}orn'), '{\th}orn');
+is(change_case ('t', '{\DH}ONG'), '{\DH}ong');
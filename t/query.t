@@ -0,0 +1,146 @@
+# -*- cperl -*-
+use strict;
+use warnings;
+
+use IO::Handle;
+use Test::More tests => 33;
+use File::Spec;
+use Capture::Tiny 'capture';
+
+use vars qw($DEBUG);
+use Cwd;
+BEGIN {
+    use_ok('Text::BibTeX', ':metatypes');
+    use_ok('Text::BibTeX::Crossref');
+    my $common = getcwd()."/t/common.pl";
+    require $common;
+}
+
+#
+# query.t
+#
+# Text::BibTeX test program -- reading only the entries that match a
+# query on their fields, through Text::BibTeX::File and the btquery
+# program.
+#
+
+$DEBUG = 1;
+
+my $bibfile = 't/query.bib';
+
+# the keys of the regular entries read with a query (and any options)
+sub matching
+{
+   my ($query, %options) = @_;
+   my ($file, $entry, @keys);
+
+   $file = Text::BibTeX::File->new ($bibfile, { reset_macros => 1,
+                                                query => $query,
+                                                %options });
+   while ($entry = Text::BibTeX::Entry->new ($file))
+   {
+      push (@keys, $entry->key) if $entry->metatype == BTE_REGULAR;
+   }
+   join (' ', @keys);
+}
+
+is (matching ('type=article'), 'knuth84 lamport94');
+is (matching ('TYPE = Article AND year >= 1990'), 'lamport94');
+is (matching ('type=article year<1990'), 'knuth84');     # implicit and
+is (matching ('author~knuth'), 'knuth84 Mueller2015');
+is (matching ('author=knuth'), 'knuth84 Mueller2015');
+is (matching ('author="van beethoven"'), 'beethoven');
+is (matching ('author=beethoven'), '');                  # von and last
+is (matching ('author!=knuth'), 'beethoven lamport94');
+is (matching ('note'), 'lamport94');
+is (matching ('not note and type=article'), 'knuth84');
+is (matching ('(type=book or type=misc) and not year<1900'), 'nodate');
+is (matching ('journal="The Computer Journal"'),         # macros expanded
+    'knuth84 lamport94');
+is (matching ('title~uber'), 'Mueller2015');             # TeX purified
+is (matching ("author~M\xc3\xbcller"), 'Mueller2015');   # ... and UTF-8
+is (matching ("author=m\xc3\xbcller"), 'Mueller2015');
+is (matching ("title~\"\xc3\x9cber lit\""), 'Mueller2015');
+is (matching ("title~\xc3\xa9"), '');                     # accents kept
+is (matching ('key=mueller2015'), 'Mueller2015');
+is (matching ('month=May'), 'knuth84');
+is (matching ('year>1000'),                              # numbers only
+    'knuth84 beethoven Mueller2015 lamport94');
+is (matching ('year=forthcoming'), 'nodate');
+
+# other entries are still read, and macros defined
+{
+   my $file = Text::BibTeX::File->new ($bibfile,
+                                       { reset_macros => 1,
+                                         query => 'type=misc' });
+   my @types;
+   while (my $entry = Text::BibTeX::Entry->new ($file))
+   {
+      push (@types, $entry->type);
+   }
+   is ("@types", 'string comment misc');
+}
+
+# with a projection, the fields the query needs are read too
+{
+   my $file = Text::BibTeX::File->new ($bibfile,
+                                       { reset_macros => 1,
+                                         query => 'year<1900',
+                                         projection => ['title'] });
+   my $entry;
+   $entry = Text::BibTeX::Entry->new ($file)
+      until defined $entry && $entry->metatype == BTE_REGULAR;
+   is ($entry->key, 'beethoven');
+   is_deeply ([$entry->fieldlist], [qw(title year)]);
+}
+
+# a bad query is warned about, and open croaks
+{
+   my $error;
+   my ($out, $err) = capture {
+      eval { Text::BibTeX::File->new ($bibfile, { query => 'year >' }) };
+      $error = $@;
+   };
+   like ($error, qr/bad query/);
+   like ($err, qr/at character 7: expected a value/);
+
+   ($out, $err) = capture {
+      eval { Text::BibTeX::File->new ($bibfile, { query => 'title~"{}"' }) };
+   };
+   like ($err, qr/nothing to look for/);
+}
+
+# queries and crossrefs: fields are inherited before entries are matched
+{
+   my $xref = Text::BibTeX::Crossref->new;
+   $xref->index ('t/crossref.bib');
+   my $file = Text::BibTeX::File->new ('t/crossref.bib',
+                                       { crossrefs => $xref, quiet => 1,
+                                         query => 'publisher~acm' });
+   my @keys;
+   while (my $entry = Text::BibTeX::Entry->new ($file))
+   {
+      push (@keys, lc $entry->key) if $entry->metatype == BTE_REGULAR;
+   }
+   ok (grep { $_ eq 'paper1' } @keys);
+}
+
+# the btquery program
+SKIP:
+{
+   my $btquery = File::Spec->catfile ('btparse', 'progs', 'btquery');
+   $btquery .= '.exe' if $^O =~ /mswin32|cygwin/i;
+   skip "btquery not built", 3 unless -x $btquery;
+
+   my @args = ('type=article and year>=1990', $bibfile);
+   my ($out, $err, $status) = capture { system ($btquery, @args) };
+   is ($out, "lamport94\n");
+
+   @args = ('-e', 'key=nodate', $bibfile);
+   ($out, $err, $status) = capture { system ($btquery, @args) };
+   like ($out, qr/^\@misc\{nodate,.*forthcoming\}\n\}\n\n$/s);
+
+   @args = ('year<1000', $bibfile);
+   ($out, $err, $status) = capture { system ($btquery, @args) };
+   is ($status >> 8, 2);
+}
@@ -0,0 +1,72 @@
+# -*- cperl -*-
+use strict;
+use warnings;
+
+use IO::Handle;
+use Test::More tests => 29;
+use Unicode::Normalize qw(NFC);
+
+use vars qw($DEBUG);
+use Cwd;
+BEGIN {
+    use_ok('Text::BibTeX', qw(tex_to_unicode));
+    my $common = getcwd()."/t/common.pl";
+    require $common;
+}
+
+#
+# unicode.t
+#
+# Text::BibTeX test program -- converting TeX to Unicode with
+# tex_to_unicode.
+#
+
+$DEBUG = 0;
+
+my @tests =
+   (q[G{\"o}del]                => "G\x{f6}del",
+    q[Caf\'{e}]                 => "Caf\x{e9}",
+    q[{\ss}uper]                => "\x{df}uper",
+    q[{\ss }uper]               => "\x{df}uper",        # control word eats space
+    q[Tom{\'a}{\v s}]           => "Tom\x{e1}\x{161}",
+    q[\d{s}]                    => "\x{1e63}",          # beyond Latin-1/Ext-A
+    q[\c{S}\k{e}]               => "\x{15e}\x{119}",
+    q[\'{\i}\v{\i}]             => "\x{ed}\x{1d0}",     # dotless i
+    q[na\"\i ve]                => "na\x{ef}ve",        # \i eats the space
+    q[\v{q}]                    => "q\x{30c}",          # no precomposed form
+    q[{\AE}sop {\o}ster {\th}orn] => "\x{c6}sop \x{f8}ster \x{fe}orn",
+    q[A--B---C ``q'' ?`Qu\'e?]  => "A\x{2013}B\x{2014}C \x{201c}q\x{201d} \x{bf}Qu\x{e9}?",
+    q[Knuth~D.\,E.]             => "Knuth\x{a0}D.\x{2009}E.",
+    q[\textsection 3, \S 4]     => "\x{a7}3, \x{a7}4",
+    q[\emph{Big} \textbf{Data}] => "Big Data",
+    q[{\noopsort{a}}Zebra]      => "Zebra",
+    q[50\% of R\&D]             => "50% of R&D",
+    q[hy\-phen]                 => "hyphen",
+    q[$\alpha + \beta$]         => q[$\alpha + \beta$], # math left alone
+    q[\foo{bar} baz]            => q[\foo{bar} baz],    # unknown left alone
+    q[\t{oo}]                   => q[\t{oo}],           # so is what we can't do
+   );
+
+while (@tests)
+{
+   my ($tex, $expected) = (shift @tests, shift @tests);
+   my $unicode = tex_to_unicode ($tex);
+   printf "[%s] -> [%s]\n", $tex, $unicode if $DEBUG;
+   is ($unicode, $expected, $tex);
+}
+
+# the results are characters, in NFC
+{
+   my $unicode = tex_to_unicode (q[\"{U}ber \'{e}t\'{e} \d{h}\={o}]);
+   ok (utf8::is_utf8 ($unicode));
+   is ($unicode, NFC ($unicode));
+}
+
+# bytes are taken as UTF-8, and characters as characters
+is (tex_to_unicode ("M\xc3\xbcller {\\\"o}"), "M\x{fc}ller \x{f6}");
+is (tex_to_unicode ("\x{141}\x{f3}d\x{17a} \\'{e}"), "\x{141}\x{f3}d\x{17a} \x{e9}");
+ok (! defined tex_to_unicode (undef));
+
+# nothing to convert
+is (tex_to_unicode ('plain text'), 'plain text');
+is (tex_to_unicode (''), '');
@@ -12,6 +12,7 @@
                  Text::BibTeX::purify_string
                  Text::BibTeX::Entry::_parse_s
                  Text::BibTeX::Entry::_parse
+                 Text::BibTeX::Entry::_write
                  Text::BibTeX::Name::split
                  Text::BibTeX::Name::free
                  Text::BibTeX::add_macro_text
@@ -40,6 +41,7 @@ MODULE = Text::BibTeX           PACKAGE = Text::BibTeX
 # XSUBs with no corresponding functions in the C library (hence no prefix
 # for this section):
 #    constant
+#    _decode_utf8
 
 SV *
 constant(name)
@@ -52,6 +54,28 @@ char *   name
 	    ST(0) = &PL_sv_undef;
 
 
+# Decodes a UTF-8 result for Perl; returns the decoded string and a flag
+# telling whether it still has to be normalized (or the empty list if it
+# is undef or malformed)
+
+void
+_decode_utf8 (result, norm="NFC")
+    SV *     result
+    char *   norm
+
+    PREINIT:
+       SV *     decoded;
+       boolean  normal;
+
+    PPCODE:
+       decoded = decode_utf8_result (result, norm, &normal);
+       if (decoded == NULL)
+          XSRETURN_EMPTY;
+       EXTEND (sp, 2);
+       PUSHs (sv_2mortal (decoded));
+       PUSHs (normal ? &PL_sv_no : &PL_sv_yes);
+
+
 MODULE = Text::BibTeX           PACKAGE = Text::BibTeX          PREFIX = bt_
 
 # XSUBs that consist solely of calls to corresponding C functions in the
@@ -82,28 +106,32 @@ bt_isplit_list (string, delim, filename=NULL, line=0, description=NULL)
     char *   description
 
     PREINIT:
-       bt_stringlist *
-             names;
+       bt_span *
+             spans;
+       int   num_spans;
        int   i;
        SV *  sv_name;
 
     PPCODE:
-       names = bt_split_list (string, delim, filename, line, description);
-       if (names == NULL)
+       /* the pieces are copied straight out of string: one SV each */
+       spans = bt_split_spans (string, delim, filename, line, description,
+                               &num_spans);
+       if (spans == NULL)
           XSRETURN_EMPTY;       /* return empty list to perl */
 
-       EXTEND (sp, names->num_items);
-       for (i = 0; i < names->num_items; i++)
+       EXTEND (sp, num_spans);
+       for (i = 0; i < num_spans; i++)
        {
-          if (names->items[i] == NULL)
+          if (spans[i].length == 0)
              sv_name = &PL_sv_undef;
           else
-             sv_name = sv_2mortal (newSVpv (names->items[i], 0));
+             sv_name = sv_2mortal (newSVpvn (string + spans[i].offset,
+                                             spans[i].length));
 
           PUSHs (sv_name);
        }
 
-       bt_free_list (names);
+       free (spans);
 
 
 SV *
@@ -156,6 +184,47 @@ bt_change_case (transform, string, options=0)
           XSRETURN_EMPTY;
        RETVAL = newSVpv (string, 0);
        bt_change_case (transform, SvPVX (RETVAL), (btshort) options);
+       SvCUR_set (RETVAL, strlen (SvPVX (RETVAL))); /* it can shrink */
+
+    OUTPUT:
+       RETVAL
+
+
+SV *
+bt_tex_to_unicode (string)
+    SV *   string
+
+    PREINIT:
+       char *  converted;
+
+    CODE:
+       if (! SvOK (string))             /* undef in, undef out */
+          XSRETURN_UNDEF;
+
+       /* bytes are taken to be UTF-8, as they are when parsed */
+       converted = bt_tex_to_unicode (SvPV_nolen (string));
+       RETVAL = newSVpv (converted, 0);
+       free (converted);
+       if (is_utf8_string ((U8 *) SvPVX (RETVAL), SvCUR (RETVAL)))
+          SvUTF8_on (RETVAL);
+
+    OUTPUT:
+       RETVAL
+
+
+SV *
+bt_fingerprint (title, names, year)
+    char * title
+    char * names
+    char * year
+
+    PREINIT:
+       char * fingerprint;
+
+    CODE:
+       fingerprint = bt_fingerprint (title, names, year);
+       RETVAL = newSVpv (fingerprint, 0);
+       free (fingerprint);
 
     OUTPUT:
        RETVAL
@@ -174,29 +243,79 @@ MODULE = Text::BibTeX   	PACKAGE = Text::BibTeX::Entry
 #    _reset_parse_s
 
 int
-_parse (entry_ref, filename, file, preserve=FALSE)
+_parse (entry_ref, filename, file, preserve=FALSE, quiet=FALSE, check=FALSE, fields=NULL, types=NULL, keys=NULL, shard=NULL, xref=NULL, query=NULL)
     SV *    entry_ref;
     char *  filename;
     FILE *  file;
     boolean preserve;
+    boolean quiet;
+    boolean check;
+    SV *    fields;
+    SV *    types;
+    SV *    keys;
+    SV *    shard;
+    SV *    xref;
+    SV *    query;
 
     PREINIT:
         btshort  options = 0;
         boolean status;
         AST *   top;
+        bt_errlist * prev_errors;
+        boolean projected;
+        boolean selected;
+        boolean sharded;
+        bt_query * q;
 
     CODE:
 
-        top = bt_parse_entry (file, filename, options, &status);
+        if (check)
+           options |= BTO_CHECKONLY;
+        q = (query != NULL && SvOK (query)) ? (bt_query *) SvIV (query) : NULL;
+        projected = set_projection (fields, q);
+        selected = set_entry_selection (types, keys);
+        sharded = (shard != NULL && SvOK (shard));
+
+        /* 
+         * Regular entries that don't match a query (which are matched
+         * after inheriting their crossref's fields) are dropped here, and
+         * so are their messages: which means holding on to the messages,
+         * and printing them at the end.
+         */
+        prev_errors = start_error_capture (quiet || q);
+        for (;;)
+        {
+           if (sharded)
+              top = parse_shard_entry (shard, file, filename, options,
+                                       &status);
+           else
+              top = bt_parse_entry (file, filename, options, &status);
+           if (top && xref != NULL && SvOK (xref))
+              bt_xref_resolve ((bt_xref *) SvIV (xref), top);
+           if (q && top && bt_entry_metatype (top) == BTE_REGULAR &&
+               !bt_query_match (q, top))
+           {
+              bt_free_ast (top);
+              discard_captured_errors ();
+              continue;
+           }
+           break;
+        }
+
+        if (projected)
+           bt_set_projection (NULL, 0);
+        if (selected)
+           finish_entry_selection ();
         DBG_ACTION 
            (2, dump_ast ("BibTeX.xs:parse: AST from bt_parse_entry():\n", top))
 
+        if (top)
+           ast_to_hash (entry_ref, top, status, preserve);
+        if (q && !quiet)
+           echo_captured_errors ();
+        finish_error_capture (entry_ref, prev_errors);
         if (!top)                  /* at EOF -- return false to perl */
-        {
            XSRETURN_NO;
-        }
-
-        ast_to_hash (entry_ref, top, status, preserve);
         XSRETURN_YES;              /* OK -- return true to perl */
 
 
@@ -215,25 +334,38 @@ _reset_parse ()
 
 
 int
-_parse_s (entry_ref, text, preserve=FALSE)
+_parse_s (entry_ref, text, preserve=FALSE, quiet=FALSE, check=FALSE, fields=NULL)
     SV *    entry_ref;
     char *  text;
     boolean preserve;
+    boolean quiet;
+    boolean check;
+    SV *    fields;
 
     PREINIT:
         btshort  options = 0;
         boolean status;
         AST *   top;
+        bt_errlist * prev_errors;
+        boolean projected;
 
     CODE:
 
+        if (check)
+           options |= BTO_CHECKONLY;
+        projected = set_projection (fields, NULL);
+        prev_errors = start_error_capture (quiet);
         top = bt_parse_entry_s (text, NULL, 1, options, &status);
+        if (projected)
+           bt_set_projection (NULL, 0);
         if (!top)                  /* no entry found -- return false to perl */
         {
+           finish_error_capture (entry_ref, prev_errors);
            XSRETURN_NO;
         }
 
         ast_to_hash (entry_ref, top, status, preserve);
+        finish_error_capture (entry_ref, prev_errors);
         XSRETURN_YES;              /* OK -- return true to perl */
 
 
@@ -251,6 +383,30 @@ _reset_parse_s ()
         XSRETURN_NO;              /* cleanup -- return false to perl */
 
 
+SV *
+_write (entry_ref, options=NULL)
+    SV *    entry_ref;
+    SV *    options;
+
+    PREINIT:
+        HV *    opts = NULL;
+
+    CODE:
+
+        if (! (SvROK (entry_ref) && SvTYPE (SvRV (entry_ref)) == SVt_PVHV))
+           croak ("entry must be a hash ref");
+        if (options != NULL && SvOK (options))
+        {
+           if (! (SvROK (options) && SvTYPE (SvRV (options)) == SVt_PVHV))
+              croak ("options must be a hash ref");
+           opts = (HV *) SvRV (options);
+        }
+        RETVAL = hash_to_bibtex ((HV *) SvRV (entry_ref), opts);
+
+    OUTPUT:
+        RETVAL
+
+
 MODULE = Text::BibTeX           PACKAGE = Text::BibTeX::Name
 
 # The XSUBs that go in the Text::BibTeX::Name package (ie. that operate
@@ -330,7 +486,7 @@ _split (name_hashref, name, filename, line, name_num, keep_cstruct)
           bt_free_name (old_name);
        }
 
-       name_split = bt_split_name (name, filename, line, name_num);
+       name_split = bt_split_name_cached (name, filename, line, name_num);
        DBG_ACTION (1, printf ("XS Name::_split: back from bt_split_name, "
                               "calling store_stringlist x 4\n"))
 
@@ -398,6 +554,31 @@ free (name_hashref)
 #endif
 
 
+# The cache of split names (see bt_set_name_cache()): its size, and its
+# hits and misses so far
+
+void
+_set_cache (size)
+    int    size
+
+    CODE:
+       bt_set_name_cache (size);
+
+
+void
+_cache_stats ()
+
+    PREINIT:
+       unsigned long hits;
+       unsigned long misses;
+
+    PPCODE:
+       bt_name_cache_stats (&hits, &misses);
+       EXTEND (sp, 2);
+       PUSHs (sv_2mortal (newSVuv (hits)));
+       PUSHs (sv_2mortal (newSVuv (misses)));
+
+
 MODULE = Text::BibTeX           PACKAGE = Text::BibTeX::NameFormat
 
 IV
@@ -530,6 +711,235 @@ format_name (name, format)
        RETVAL
 
 
+MODULE = Text::BibTeX           PACKAGE = Text::BibTeX::Dedup
+
+IV
+create (bands=0, rows=0, threshold=0.0)
+    int     bands
+    int     rows
+    double  threshold
+
+    CODE:
+       RETVAL = (IV) bt_dedup_new (bands, rows, threshold);
+
+    OUTPUT:
+       RETVAL
+
+
+void
+free (index)
+    bt_dedup * index
+
+    CODE:
+       bt_dedup_free (index);
+
+
+int
+_add (index, fingerprint)
+    bt_dedup * index
+    char *     fingerprint
+
+    CODE:
+       RETVAL = bt_dedup_add (index, fingerprint);
+
+    OUTPUT:
+       RETVAL
+
+
+int
+_cluster (index, id)
+    bt_dedup * index
+    int        id
+
+    CODE:
+       RETVAL = bt_dedup_cluster (index, id);
+
+    OUTPUT:
+       RETVAL
+
+
+double
+_similarity (index, id1, id2)
+    bt_dedup * index
+    int        id1
+    int        id2
+
+    CODE:
+       RETVAL = bt_dedup_similarity (index, id1, id2);
+
+    OUTPUT:
+       RETVAL
+
+
+int
+_count (index)
+    bt_dedup * index
+
+    CODE:
+       RETVAL = bt_dedup_count (index);
+
+    OUTPUT:
+       RETVAL
+
+
+MODULE = Text::BibTeX           PACKAGE = Text::BibTeX::Crossref
+
+IV
+create (min_crossrefs=0)
+    int     min_crossrefs
+
+    CODE:
+       RETVAL = (IV) bt_xref_new (min_crossrefs);
+
+    OUTPUT:
+       RETVAL
+
+
+void
+free (xref)
+    bt_xref * xref
+
+    CODE:
+       bt_xref_free (xref);
+
+
+void
+_add_rule (xref, child_type, parent_type, parent_field, child_field)
+    bt_xref * xref
+    char *    child_type
+    char *    parent_type
+    char *    parent_field
+    char *    child_field
+
+    CODE:
+       bt_xref_add_rule (xref, child_type, parent_type, parent_field,
+                         child_field);
+
+
+int
+_index_file (xref, file, filename)
+    bt_xref * xref
+    FILE *    file
+    char *    filename
+
+    CODE:
+       RETVAL = bt_xref_index_file (xref, file, filename);
+
+    OUTPUT:
+       RETVAL
+
+
+int
+_children (xref, key)
+    bt_xref * xref
+    char *    key
+
+    CODE:
+       RETVAL = bt_xref_children (xref, key);
+
+    OUTPUT:
+       RETVAL
+
+
+MODULE = Text::BibTeX           PACKAGE = Text::BibTeX::File
+
+# Plans the shards of a big file, for Text::BibTeX::Parallel (see
+# plan_shards() in btxs_support.c).
+
+SV *
+_plan_shards (filename, size, num_shards)
+    char *  filename;
+    long    size;
+    int     num_shards;
+
+    CODE:
+        RETVAL = newRV_noinc ((SV *) plan_shards (filename, size,
+                                                  num_shards));
+
+    OUTPUT:
+        RETVAL
+
+
+# Stops reading a shard before its end.
+
+void
+_close_shard (shard)
+    SV *    shard;
+
+    CODE:
+        close_shard (shard);
+
+
+# Parses entries from a file until one is written as JSON (only regular
+# entries are, as CSL-JSON), and returns its object; undef at EOF.
+
+SV *
+_json (filename, file, csl=FALSE, unicode=FALSE, xref=NULL)
+    char *  filename;
+    FILE *  file;
+    boolean csl;
+    boolean unicode;
+    SV *    xref;
+
+    PREINIT:
+        bt_json_options options;
+        bt_buffer  buf;
+        boolean    status;
+        AST *      top;
+
+    CODE:
+        options.style = csl ? BTJS_CSL : BTJS_PLAIN;
+        options.unicode = unicode;
+        memset (&buf, 0, sizeof (buf));
+        while ((top = bt_parse_entry (file, filename, 0, &status)))
+        {
+           if (xref != NULL && SvOK (xref))
+              bt_xref_resolve ((bt_xref *) SvIV (xref), top);
+           bt_postprocess_entry (top, BTO_NOSTORE |
+                                 (bt_entry_metatype (top) == BTE_MACRODEF
+                                  ? BTO_MACRO : BTO_FULL));
+           bt_json_entry_s (&buf, top, &options);
+           bt_free_ast (top);
+           if (buf.length > 0)
+              break;
+        }
+        if (!top)                  /* at EOF */
+           XSRETURN_UNDEF;
+        RETVAL = newSVpvn (buf.text, buf.length);
+        bt_free_buffer (&buf);
+
+    OUTPUT:
+        RETVAL
+
+
+# Compiles a query on the fields of entries (see bt_query_new()), or
+# returns undef on a syntax error (which has been warned about).
+
+SV *
+_query_new (text)
+    char *  text;
+
+    PREINIT:
+        bt_query * query;
+
+    CODE:
+        query = bt_query_new (text);
+        if (query == NULL)
+           XSRETURN_UNDEF;
+        RETVAL = newSViv ((IV) query);
+
+    OUTPUT:
+        RETVAL
+
+
+void
+_query_free (query)
+    bt_query * query
+
+    CODE:
+       bt_query_free (query);
+
+
 MODULE = Text::BibTeX           PACKAGE = Text::BibTeX          PREFIX = bt_
 
 void
@@ -569,4 +979,5 @@ BOOT:
     bt_set_stringopts (BTE_REGULAR, 0);
     bt_set_stringopts (BTE_COMMENT, 0);
     bt_set_stringopts (BTE_PREAMBLE, 0);
+    bt_set_name_cache (4096);           /* see Text::BibTeX::Name */
 
@@ -45,6 +45,15 @@ constant (char * name, IV * arg)
          if (strEQ (name, "BTE_COMMENT"))  { *arg = BTE_COMMENT;  ok = TRUE; }
          if (strEQ (name, "BTE_PREAMBLE")) { *arg = BTE_PREAMBLE; ok = TRUE; }
          if (strEQ (name, "BTE_MACRODEF")) { *arg = BTE_MACRODEF; ok = TRUE; }
+                                        /* error classes */
+         if (strEQ (name, "BTERR_NOTIFY"))    { *arg = BTERR_NOTIFY;    ok = TRUE; }
+         if (strEQ (name, "BTERR_CONTENT"))   { *arg = BTERR_CONTENT;   ok = TRUE; }
+         if (strEQ (name, "BTERR_LEXWARN"))   { *arg = BTERR_LEXWARN;   ok = TRUE; }
+         if (strEQ (name, "BTERR_USAGEWARN")) { *arg = BTERR_USAGEWARN; ok = TRUE; }
+         if (strEQ (name, "BTERR_LEXERR"))    { *arg = BTERR_LEXERR;    ok = TRUE; }
+         if (strEQ (name, "BTERR_SYNTAX"))    { *arg = BTERR_SYNTAX;    ok = TRUE; }
+         if (strEQ (name, "BTERR_USAGEERR"))  { *arg = BTERR_USAGEERR;  ok = TRUE; }
+         if (strEQ (name, "BTERR_INTERNAL"))  { *arg = BTERR_INTERNAL;  ok = TRUE; }
          break;
       case 'A':                         /* AST nodetypes (not all of them) */
          if (strEQ (name, "BTAST_STRING")) { *arg = BTAST_STRING; ok = TRUE; }
@@ -486,3 +495,692 @@ store_stringlist (HV *hash, char *key, char **list, int num_strings)
    }
 
 } /* store_stringlist() */
+
+
+/* ----------------------------------------------------------------------
+ * Recording errors and warnings while parsing an entry, and handing
+ * them to Perl as data:
+ *   start_error_capture()
+ *   discard_captured_errors()
+ *   echo_captured_errors()
+ *   finish_error_capture()
+ */
+
+static bt_errlist * captured_errors = NULL;
+
+bt_errlist *
+start_error_capture (boolean quiet)
+{
+   if (captured_errors == NULL)
+      captured_errors = bt_new_errlist (TRUE);
+   bt_clear_errlist (captured_errors);
+   captured_errors->echo = !quiet;
+   return bt_set_errlist (captured_errors);
+}
+
+
+void
+discard_captured_errors (void)
+{
+   bt_clear_errlist (captured_errors);
+}
+
+
+void
+echo_captured_errors (void)
+{
+   char  msg[1024];
+   char *buf;
+   int   len;
+   int   i;
+
+   for (i = 0; i < captured_errors->num_errors; i++)
+   {
+      buf = msg;
+      len = bt_format_error (&captured_errors->errors[i], msg, sizeof (msg));
+      if (len >= (int) sizeof (msg))
+      {
+         New (0, buf, len + 1, char);
+         bt_format_error (&captured_errors->errors[i], buf, len + 1);
+      }
+      fprintf (stderr, "%s\n", buf);
+      if (buf != msg)
+         Safefree (buf);
+   }
+}
+
+
+void
+finish_error_capture (SV * entry_ref, bt_errlist * previous)
+{
+   HV *  entry;
+   AV *  errors;
+   int   i;
+
+   bt_set_errlist (previous);
+   if (! (SvROK (entry_ref) && (SvTYPE (SvRV (entry_ref)) == SVt_PVHV)))
+      croak ("entry_ref must be a hash ref");
+   entry = (HV *) SvRV (entry_ref);
+
+   errors = newAV ();
+   av_extend (errors, captured_errors->num_errors);
+   for (i = 0; i < captured_errors->num_errors; i++)
+   {
+      bt_error * err = &captured_errors->errors[i];
+      HV *       error = newHV ();
+
+      hv_store (error, "class", 5, newSViv ((IV) err->errclass), 0);
+      if (err->filename)
+         hv_store (error, "filename", 8, newSVpv (err->filename, 0), 0);
+      if (err->line > 0)
+         hv_store (error, "line", 4, newSViv ((IV) err->line), 0);
+      if (err->item_desc && err->item > 0)
+      {
+         hv_store (error, "item_desc", 9, newSVpv (err->item_desc, 0), 0);
+         hv_store (error, "item", 4, newSViv ((IV) err->item), 0);
+      }
+      hv_store (error, "message", 7,
+                newSVpv (bt_error_message (captured_errors, err), 0), 0);
+      av_push (errors, newRV_noinc ((SV *) error));
+   }
+   hv_store (entry, "errors", 6, newRV_noinc ((SV *) errors), 0);
+   bt_clear_errlist (captured_errors);
+
+} /* finish_error_capture() */
+
+
+
+/* ----------------------------------------------------------------------
+ * Setting the field projection for one parse from a Perl list of field
+ * names (or undef, meaning all fields), plus the fields a query (if
+ * any) needs to match entries:
+ *   set_projection()
+ */
+
+boolean
+set_projection (SV * fields, bt_query * query)
+{
+   AV *    list;
+   SV **   name;
+   char ** names;
+   char ** query_fields;
+   int     num_names;
+   int     num_query_fields;
+   int     i;
+
+   if (fields == NULL || !SvOK (fields))
+      return FALSE;
+   if (! (SvROK (fields) && SvTYPE (SvRV (fields)) == SVt_PVAV))
+      croak ("field projection must be a list ref");
+
+   list = (AV *) SvRV (fields);
+   num_names = av_len (list) + 1;
+   num_query_fields = 0;
+   query_fields = query ? bt_query_fields (query, &num_query_fields) : NULL;
+   Newx (names, num_names + num_query_fields + 1, char *);
+   for (i = 0; i < num_names; i++)
+   {
+      name = av_fetch (list, i, 0);
+      names[i] = (name && SvOK (*name)) ? SvPV_nolen (*name) : "";
+   }
+   for (i = 0; i < num_query_fields; i++)
+      names[num_names++] = query_fields[i];
+   bt_set_projection (names, num_names);
+   Safefree (names);
+   return TRUE;
+}
+
+
+/* ----------------------------------------------------------------------
+ * Selecting the regular entries read from a file by type and/or key,
+ * given as Perl hashes (or undef, meaning any type or key):
+ *   set_entry_selection()
+ *   finish_entry_selection()
+ */
+
+typedef struct
+{
+   HV *    types;
+   HV *    keys;
+} entry_selection;
+
+static entry_selection selection;
+
+static boolean
+select_entry (char * type, char * key, void * data)
+{
+   entry_selection * sel = (entry_selection *) data;
+
+   if (sel->types && !hv_exists (sel->types, type, strlen (type)))
+      return FALSE;
+   if (sel->keys && !hv_exists (sel->keys, key, strlen (key)))
+      return FALSE;
+   return TRUE;
+}
+
+static HV *
+selection_hash (SV * set, char * what)
+{
+   if (set == NULL || !SvOK (set))
+      return NULL;
+   if (! (SvROK (set) && SvTYPE (SvRV (set)) == SVt_PVHV))
+      croak ("entry selection by %s must be a hash ref", what);
+   return (HV *) SvRV (set);
+}
+
+boolean
+set_entry_selection (SV * types, SV * keys)
+{
+   selection.types = selection_hash (types, "type");
+   selection.keys = selection_hash (keys, "key");
+   if (selection.types == NULL && selection.keys == NULL)
+      return FALSE;
+   bt_set_entry_filter (select_entry, &selection);
+   return TRUE;
+}
+
+void
+finish_entry_selection (void)
+{
+   bt_set_entry_filter (NULL, NULL);
+}
+
+
+/* ----------------------------------------------------------------------
+ * Reading a big file in shards, one per process (see
+ * Text::BibTeX::Parallel):
+ *   plan_shards()
+ *   parse_shard_entry()
+ *   close_shard()
+ *
+ * plan_shards() makes one quick pass over a file with bt_read_entry_text(),
+ * parsing nothing, to find where to cut it into shards of about the same
+ * size, each starting with an entry.  Each shard is then read by seeking
+ * straight to it, with a reader restricted to its range: a shard is
+ * given as a Perl list [start, end, line, reader], where start and end
+ * are the byte offsets of its first entry and of the next shard's (end
+ * is -1 for the last shard), and line is the line number of its first
+ * entry.  The reader is made on the first read, and kept (as an IV) in
+ * the list until the shard is done.
+ */
+
+/* ------------------------------------------------------------------------
+@NAME       : plan_shards()
+@INPUT      : filename
+              size       - of the file, in bytes
+              num_shards - how many shards to cut it into
+@RETURNS    : a new list with one element for each cut: a list
+              [start, line, strings, keys], where start and line are
+              those of the first entry of a shard, and strings and keys
+              are lists of the @string entries (their text) and the keys
+              of the regular entries since the cut before
+@DESCRIPTION: Plans the shards of a file.  There are fewer than
+              num_shards if there are too few entries; an empty list
+              means the file is best read whole.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+AV *
+plan_shards (char * filename, long size, int num_shards)
+{
+   FILE *         infile;
+   bt_reader *    reader;
+   bt_entry_text  text;
+   AV *           plan;
+   AV *           cut;
+   AV *           strings;
+   AV *           keys;
+   long           next;
+   int            i;
+
+   plan = newAV ();
+   if (num_shards < 2 || (infile = fopen (filename, "rb")) == NULL)
+      return plan;
+
+   reader = bt_open_reader (infile);
+   strings = newAV ();
+   keys = newAV ();
+   i = 1;
+   next = size / num_shards;
+   while (bt_read_entry_text (reader, &text))
+   {
+      if (i < num_shards && text.offset >= next && text.offset > 0)
+      {
+         cut = newAV ();
+         av_push (cut, newSViv ((IV) text.offset));
+         av_push (cut, newSViv ((IV) text.line));
+         av_push (cut, newRV_noinc ((SV *) strings));
+         av_push (cut, newRV_noinc ((SV *) keys));
+         av_push (plan, newRV_noinc ((SV *) cut));
+         strings = newAV ();
+         keys = newAV ();
+         while (i < num_shards && text.offset >= next)
+            next = size / num_shards * ++i;
+      }
+      if (text.metatype == BTE_MACRODEF)
+         av_push (strings, newSVpvn (text.text, text.length));
+      else if (text.metatype == BTE_REGULAR && text.key != NULL)
+         av_push (keys, newSVpvn (text.key, text.key_length));
+   }
+   SvREFCNT_dec ((SV *) strings);
+   SvREFCNT_dec ((SV *) keys);
+   bt_close_reader (reader);
+   fclose (infile);
+   return plan;
+}
+
+
+static IV
+shard_number (AV * shard, int i, IV dflt)
+{
+   SV ** num = av_fetch (shard, i, 0);
+
+   return (num && SvOK (*num)) ? SvIV (*num) : dflt;
+}
+
+static AV *
+shard_list (SV * shard)
+{
+   if (! (SvROK (shard) && SvTYPE (SvRV (shard)) == SVt_PVAV))
+      croak ("shard must be a list ref");
+   return (AV *) SvRV (shard);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : parse_shard_entry()
+@INPUT      : shard    - the shard list (see above)
+              file     - the file it's in
+              filename
+              options
+@OUTPUT     : *status
+@RETURNS    : the next entry of the shard, or NULL when it's done
+@DESCRIPTION: Parses the next entry of a shard with bt_parse_next_entry()
+              -- seeking to the shard first, if this is the first one.
+@CREATED    : 2026/10/19
+@MODIFIED   :
+-------------------------------------------------------------------------- */
+AST *
+parse_shard_entry (SV * shard, FILE * file, char * filename,
+                   btshort options, boolean * status)
+{
+   AV *         list = shard_list (shard);
+   bt_reader *  reader;
+   AST *        top;
+
+   reader = INT2PTR (bt_reader *, shard_number (list, 3, 0));
+   if (reader == NULL)
+   {
+      reader = bt_open_reader (file);
+      if (!bt_set_reader_range (reader,
+                                (long) shard_number (list, 0, 0),
+                                (long) shard_number (list, 1, -1),
+                                (int) shard_number (list, 2, 1)))
+      {
+         bt_close_reader (reader);
+         croak ("can't seek to the shard of %s", filename);
+      }
+      av_store (list, 3, newSViv (PTR2IV (reader)));
+   }
+
+   top = bt_parse_next_entry (reader, filename, options, status);
+   if (top == NULL)                     /* done, and cleaned up after */
+   {
+      bt_close_reader (reader);
+      av_store (list, 3, newSV (0));
+   }
+   return top;
+}
+
+
+/* Frees the reader of a shard, if it's still being read. */
+void
+close_shard (SV * shard)
+{
+   AV *         list = shard_list (shard);
+   bt_reader *  reader = INT2PTR (bt_reader *, shard_number (list, 3, 0));
+
+   if (reader != NULL)
+   {
+      bt_parse_next_entry (NULL, NULL, 0, NULL);
+      bt_close_reader (reader);
+      av_store (list, 3, newSV (0));
+   }
+}
+
+
+/* ----------------------------------------------------------------------
+ * Decoding UTF-8 results for Perl, with a quick check for strings that
+ * are already in the requested normalization form:
+ *   decode_utf8_result()
+ */
+
+#ifdef is_strict_utf8_string
+# define UTF8_STRING_OK(s,len) is_strict_utf8_string (s, len)
+#else
+# define UTF8_STRING_OK(s,len) is_utf8_string (s, len)
+#endif
+
+
+/* ------------------------------------------------------------------------
+@NAME       : decode_utf8_result()
+@INPUT      : result - string (as bytes or as characters) to be decoded
+              norm   - name of the normalization form wanted ("NFC", ...)
+@OUTPUT     : *normal - set to TRUE if the string is certainly in
+                        normalization form norm already; FALSE if it
+                        may have to be normalized
+@RETURNS    : a new SV holding the decoded string (with the UTF8 flag
+              on); NULL if result is undef or is not valid UTF-8
+@DESCRIPTION: Replaces Encode::decode followed by Unicode::Normalize with
+              a single scan over the bytes, which is all most strings
+              need.  The normalization forms are only sensitive to
+              characters from a certain point on: nothing below U+0300
+              (the first combining mark) is changed by NFC, nothing
+              below U+00C0 (the first precomposed letter) by NFD, and
+              nothing below U+00A0 by the compatibility forms.  In UTF-8
+              these limits are the lead bytes 0xCC and 0xC3 (and simply
+              ASCII for NFKC/NFKD), so one byte comparison per character
+              decides whether the caller has to normalize at all.
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+SV *
+decode_utf8_result (SV * result, char * norm, boolean * normal)
+{
+   SV *    decoded;
+   U8 *    bytes;
+   STRLEN  len;
+   STRLEN  ascii;
+   STRLEN  i;
+   U8      limit;
+
+   if (result == NULL || !SvOK (result))
+      return NULL;
+
+   if (strEQ (norm, "NFC"))
+      limit = 0xCC;
+   else if (strEQ (norm, "NFD"))
+      limit = 0xC3;
+   else
+      limit = 0x80;
+
+   bytes = (U8 *) SvPV (result, len);
+   for (i = 0; i < len && bytes[i] < 0x80; i++)
+      ;
+   ascii = i;
+   while (i < len && bytes[i] < limit)
+      i++;
+   *normal = (i == len);
+
+   /* 
+    * The leading ASCII is valid UTF-8 by definition, so only the rest of
+    * the string needs validating -- and not even that if Perl already
+    * holds it as characters.
+    */
+   if (! SvUTF8 (result) && ascii < len &&
+       ! UTF8_STRING_OK (bytes + ascii, len - ascii))
+      return NULL;
+
+   decoded = newSVpvn ((char *) bytes, len);
+   SvUTF8_on (decoded);
+   return decoded;
+
+} /* decode_utf8_result() */
+
+
+/* ----------------------------------------------------------------------
+ * Writing an entry hash back out as BibTeX (for Entry::print_s), with
+ * the bt_write functions of btparse:
+ *   sv_text() [private]
+ *   write_options() [private]
+ *   write_value() [private]
+ *   write_hash() [private]
+ *   hash_to_bibtex()
+ */
+
+static char *
+sv_text (SV * sv, boolean utf8, boolean * saw_utf8)
+{
+   if (sv == NULL || !SvOK (sv))
+      return "";
+   if (SvUTF8 (sv))
+      *saw_utf8 = TRUE;
+   return utf8 ? SvPVutf8_nolen (sv) : SvPV_nolen (sv);
+}
+
+
+static void
+write_options (HV * opts, bt_write_options * options, AV ** order)
+{
+   SV **  svp;
+   char * quote;
+
+   options->flat = FALSE;
+   options->quote = BTW_BRACES;
+   options->indent = "  ";
+   options->align = 0;
+   options->field_order = NULL;
+   options->num_ordered = 0;
+   *order = NULL;
+   if (opts == NULL)
+      return;
+
+   if ((svp = hv_fetch (opts, "quote", 5, 0)) && SvOK (*svp))
+   {
+      quote = SvPV_nolen (*svp);
+      if (strEQ (quote, "braces"))
+         options->quote = BTW_BRACES;
+      else if (strEQ (quote, "quotes"))
+         options->quote = BTW_QUOTES;
+      else if (strEQ (quote, "bare"))
+         options->quote = BTW_BARE;
+      else
+         croak ("unknown quote style \"%s\" (must be braces, quotes or bare)",
+                quote);
+   }
+   if ((svp = hv_fetch (opts, "indent", 6, 0)) && SvOK (*svp))
+      options->indent = SvPV_nolen (*svp);
+   if ((svp = hv_fetch (opts, "align", 5, 0)) && SvOK (*svp))
+      options->align = SvIV (*svp);
+   if ((svp = hv_fetch (opts, "order", 5, 0)) && SvOK (*svp))
+   {
+      if (! (SvROK (*svp) && SvTYPE (SvRV (*svp)) == SVt_PVAV))
+         croak ("field order must be a list ref");
+      *order = (AV *) SvRV (*svp);
+   }
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : write_value()
+@INPUT      : buf
+              name    - field name (NULL for a comment or preamble)
+              value   - a plain string, or a Text::BibTeX::Value object
+              options
+              utf8    - whether to get all text as UTF-8
+@OUTPUT     : *saw_utf8 - set TRUE if any text was held as characters
+@DESCRIPTION: Writes a field from an entry hash, getting the simple
+              values out of a Text::BibTeX::Value object (a list of
+              [type, text] lists) if need be.
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+static void
+write_value (bt_buffer * buf, char * name, SV * value,
+             bt_write_options * options, boolean utf8, boolean * saw_utf8)
+{
+   static bt_nodetype * types = NULL;
+   static char **       texts = NULL;
+   static int           max = 0;
+   bt_nodetype          type;
+   char *               text;
+   AV *                 simple_values;
+   int                  num, i;
+
+   if (value == NULL || !SvROK (value))
+   {
+      type = BTAST_STRING;
+      text = sv_text (value, utf8, saw_utf8);
+      bt_write_field (buf, name, 1, &type, &text, options);
+      return;
+   }
+
+   if (! sv_derived_from (value, "Text::BibTeX::Value"))
+      croak ("value is a reference, but not to Text::BibTeX::Value object");
+   simple_values = (AV *) SvRV (value);
+   num = av_len (simple_values) + 1;
+   if (num > max)
+   {
+      max = num + 16;
+      types = (bt_nodetype *) realloc (types, max * sizeof (bt_nodetype));
+      texts = (char **) realloc (texts, max * sizeof (char *));
+   }
+
+   for (i = 0; i < num; i++)
+   {
+      SV ** simple = av_fetch (simple_values, i, 0);
+      SV ** part;
+      AV *  pair;
+
+      types[i] = BTAST_STRING;
+      texts[i] = "";
+      if (! (simple && SvROK (*simple) &&
+             SvTYPE (SvRV (*simple)) == SVt_PVAV))
+         continue;
+      pair = (AV *) SvRV (*simple);
+      if ((part = av_fetch (pair, 0, 0)) && SvOK (*part))
+         types[i] = (bt_nodetype) SvIV (*part);
+      part = av_fetch (pair, 1, 0);
+      texts[i] = sv_text (part ? *part : NULL, utf8, saw_utf8);
+   }
+   bt_write_field (buf, name, num, types, texts, options);
+}
+
+
+static void
+write_hash (bt_buffer * buf, HV * entry, bt_write_options * options,
+            AV * order, boolean utf8, boolean * saw_utf8)
+{
+   SV **       svp;
+   bt_metatype metatype;
+   char *      type;
+   char *      key;
+   AV *        fields;
+   HV *        values;
+   HV *        ordered;
+   I32         num_fields, num_ordered, i;
+
+   svp = hv_fetch (entry, "metatype", 8, 0);
+   metatype = (svp && SvOK (*svp)) ? (bt_metatype) SvIV (*svp) : BTE_UNKNOWN;
+   svp = hv_fetch (entry, "type", 4, 0);
+   type = sv_text (svp ? *svp : NULL, utf8, saw_utf8);
+   svp = hv_fetch (entry, "key", 3, 0);
+   key = sv_text (svp ? *svp : NULL, utf8, saw_utf8);
+
+   bt_write_head (buf, metatype, type, key, options);
+   if (metatype != BTE_REGULAR && metatype != BTE_MACRODEF)
+   {
+      svp = hv_fetch (entry, "value", 5, 0);
+      write_value (buf, NULL, svp ? *svp : NULL, options, utf8, saw_utf8);
+      bt_write_tail (buf, options);
+      return;
+   }
+
+   svp = hv_fetch (entry, "fields", 6, 0);
+   fields = (svp && SvROK (*svp) && SvTYPE (SvRV (*svp)) == SVt_PVAV)
+      ? (AV *) SvRV (*svp) : NULL;
+   svp = hv_fetch (entry, "values", 6, 0);
+   values = (svp && SvROK (*svp) && SvTYPE (SvRV (*svp)) == SVt_PVHV)
+      ? (HV *) SvRV (*svp) : NULL;
+   num_fields = fields ? av_len (fields) + 1 : 0;
+
+   /* 
+    * The fields named in `order' come first (if the entry has them),
+    * then the rest, as they come; `ordered' remembers which is which.
+    */
+   ordered = NULL;
+   num_ordered = order ? av_len (order) + 1 : 0;
+   if (num_ordered > 0)
+   {
+      ordered = (HV *) sv_2mortal ((SV *) newHV ());
+      for (i = 0; i < num_fields; i++)
+      {
+         SV ** field = av_fetch (fields, i, 0);
+         if (field && SvOK (*field))
+            hv_store_ent (ordered, *field, newSViv (i), 0);
+      }
+      for (i = 0; i < num_ordered; i++)
+      {
+         SV ** field = av_fetch (order, i, 0);
+         HE *  he;
+
+         if (! (field && SvOK (*field)) ||
+             ! (he = hv_fetch_ent (ordered, *field, 0, 0)) ||
+             ! SvOK (HeVAL (he)))
+            continue;
+         he = values ? hv_fetch_ent (values, *field, 0, 0) : NULL;
+         write_value (buf, sv_text (*field, utf8, saw_utf8),
+                      he ? HeVAL (he) : NULL, options, utf8, saw_utf8);
+         hv_store_ent (ordered, *field, &PL_sv_undef, 0);
+      }
+   }
+
+   for (i = 0; i < num_fields; i++)
+   {
+      SV ** field = av_fetch (fields, i, 0);
+      HE *  he;
+
+      if (! (field && SvOK (*field)))
+         continue;
+      if (ordered && (he = hv_fetch_ent (ordered, *field, 0, 0)) &&
+          ! SvOK (HeVAL (he)))
+         continue;                      /* already written */
+      he = values ? hv_fetch_ent (values, *field, 0, 0) : NULL;
+      write_value (buf, sv_text (*field, utf8, saw_utf8),
+                   he ? HeVAL (he) : NULL, options, utf8, saw_utf8);
+   }
+   bt_write_tail (buf, options);
+}
+
+
+/* ------------------------------------------------------------------------
+@NAME       : hash_to_bibtex()
+@INPUT      : entry - the hash of a Text::BibTeX::Entry object
+              opts  - hash of options (quote, indent, align, order), or
+                      NULL
+@RETURNS    : a new SV holding the entry as BibTeX
+@DESCRIPTION: The C side of Entry::print_s.  Strings held as bytes are
+              written as they are, unless some other string in the entry
+              is held as characters: then everything is written as UTF-8
+              (and the result is flagged as such), just as if the pieces
+              had been joined in Perl.
+@CALLS      : bt_write_head(), bt_write_field(), bt_write_tail()
+@CREATED    : 2026/10/19
+@MODIFIED   : 
+-------------------------------------------------------------------------- */
+SV *
+hash_to_bibtex (HV * entry, HV * opts)
+{
+   static bt_buffer  buf;
+   bt_write_options  options;
+   AV *              order;
+   boolean           saw_utf8;
+   SV *              result;
+
+   write_options (opts, &options, &order);
+   saw_utf8 = FALSE;
+   buf.length = 0;
+   write_hash (&buf, entry, &options, order, FALSE, &saw_utf8);
+   if (saw_utf8)
+   {
+      buf.length = 0;
+      write_hash (&buf, entry, &options, order, TRUE, &saw_utf8);
+   }
+
+   result = newSVpvn (buf.text ? buf.text : "", buf.length);
+   if (saw_utf8)
+      SvUTF8_on (result);
+   if (buf.size > 65536)
+      bt_free_buffer (&buf);
+   return result;
+}
@@ -41,5 +41,18 @@ void ast_to_hash (SV *    entry_ref,
                   boolean parse_status,
                   boolean preserve);
 int constant (char * name, IV * arg);
+bt_errlist * start_error_capture (boolean quiet);
+void discard_captured_errors (void);
+void echo_captured_errors (void);
+void finish_error_capture (SV * entry_ref, bt_errlist * previous);
+boolean set_projection (SV * fields, bt_query * query);
+boolean set_entry_selection (SV * types, SV * keys);
+void finish_entry_selection (void);
+AV * plan_shards (char * filename, long size, int num_shards);
+AST * parse_shard_entry (SV * shard, FILE * file, char * filename,
+                         btshort options, boolean * status);
+void close_shard (SV * shard);
+SV * decode_utf8_result (SV * result, char * norm, boolean * normal);
+SV * hash_to_bibtex (HV * entry, HV * opts);
 
 #endif /* BTXS_SUPPORT_H */